@@ -28,6 +28,9 @@ ENDIF(MSVC)
 # Option for tracing.
 OPTION ( USUL_USE_TRACING "Should tracing be enabled?" OFF )
 
+# Option for the job manager's thread pool.
+OPTION ( USUL_USE_WORK_STEALING_POOL "Should the job manager use the work-stealing thread pool?" OFF )
+
 # We don't want RPath.
 SET ( CMAKE_SKIP_RPATH ON )
 
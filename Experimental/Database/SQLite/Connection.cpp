@@ -196,6 +196,39 @@ Result::RefPtr Connection::_execute ( const std::string &sql, const Binders &bin
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make a statement to bind and execute many times.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Result::RefPtr Connection::prepare ( const std::string &sql )
+{
+  Guard guard ( this );
+
+  // Handle bad state.
+  if ( 0x0 == _db )
+    throw Usul::Exceptions::Exception ( "Error 2716843394: null database" );
+
+  // Lock the database.
+  Helper::Guard dbGuard ( _db );
+
+  ::sqlite3_stmt *statement ( 0x0 );
+  const char *leftOver ( 0x0 );
+
+  const int resultCode ( ::sqlite3_prepare_v2 ( _db, sql.c_str(), -1, &statement, &leftOver ) );
+  if ( SQLITE_OK != resultCode )
+  {
+    throw Usul::Exceptions::Exception ( Usul::Strings::format
+      ( "Error 3026483173: Result Code: ", resultCode, 
+        ", Message: '", Helper::errorMessage ( _db ), "'",
+        ", SQL: ", sql ) );
+  }
+
+  return Result::RefPtr ( new Result ( sql, _db, statement ) );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Get the file name.
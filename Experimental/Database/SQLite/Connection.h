@@ -65,6 +65,10 @@ public:
   template < class T1, class T2, class T3, class T4, class T5 > 
   Result::RefPtr          execute ( const std::string &sql, const T1 &, const T2 &, const T3 &, const T4 &, const T5 & );
 
+  // Make a statement to bind and execute many times. The statement is 
+  // not run until Result::execute() or Result::prepareNextRow() is called.
+  Result::RefPtr          prepare ( const std::string &sql );
+
   // Get the file name.
   std::string             file() const;
 
@@ -117,6 +117,127 @@ bool Result::prepareNextRow()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run a statement that does not return rows, and reset it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Result::execute()
+{
+  Guard guard ( this );
+
+  if ( 0x0 == _statement )
+    throw Usul::Exceptions::Exception ( "Error 1591638402: Null statement pointer" );
+
+  // Step until it's done, waiting if the database is busy.
+  while ( true )
+  {
+    const int result ( ::sqlite3_step ( _statement ) );
+    if ( SQLITE_DONE == result || SQLITE_ROW == result )
+      break;
+
+    if ( SQLITE_BUSY == result )
+    {
+      ::sqlite3_reset ( _statement );
+      Usul::System::Sleep::milliseconds ( 100 );
+      continue;
+    }
+
+    const std::string message ( Helper::errorMessage ( _database ) );
+    ::sqlite3_reset ( _statement );
+    throw Usul::Exceptions::Exception ( Usul::Strings::format
+      ( "Error 2887913066: Result Code: ", result, 
+        ", Message: '", message, "'",
+        ", SQL: ", _sql ) );
+  }
+
+  this->reset();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reset the statement so that it can be bound and run again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Result::reset()
+{
+  Guard guard ( this );
+
+  _currentColumn = 0;
+
+  if ( 0x0 == _statement )
+    return;
+
+  ::sqlite3_reset ( _statement );
+  ::sqlite3_clear_bindings ( _statement );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Bind the values.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Result &Result::bind ( unsigned int which, double value )
+{
+  Guard guard ( this );
+  Helper::call ( boost::bind<int> ( ::sqlite3_bind_double, _statement, which + 1, value ), 
+    "Error 1158437460: Failed to bind double", _sql, _database );
+  return *this;
+}
+Result &Result::bind ( unsigned int which, int value )
+{
+  Guard guard ( this );
+  Helper::call ( boost::bind<int> ( ::sqlite3_bind_int, _statement, which + 1, value ), 
+    "Error 3478102938: Failed to bind integer", _sql, _database );
+  return *this;
+}
+Result &Result::bind ( unsigned int which, Usul::Types::Int64 value )
+{
+  Guard guard ( this );
+  Helper::call ( boost::bind<int> ( ::sqlite3_bind_int64, _statement, which + 1, static_cast < sqlite3_int64 > ( value ) ), 
+    "Error 2209157732: Failed to bind integer", _sql, _database );
+  return *this;
+}
+Result &Result::bind ( unsigned int which, Usul::Types::Uint64 value )
+{
+  // Stored as signed, like operator >> reads it.
+  return this->bind ( which, static_cast < Usul::Types::Int64 > ( value ) );
+}
+Result &Result::bind ( unsigned int which, const std::string &value )
+{
+  Guard guard ( this );
+  Helper::call ( boost::bind<int> ( ::sqlite3_bind_text, _statement, which + 1, value.c_str(), static_cast < int > ( value.size() ), SQLITE_TRANSIENT ), 
+    "Error 4106927455: Failed to bind text", _sql, _database );
+  return *this;
+}
+Result &Result::bind ( unsigned int which, const Blob &value )
+{
+  Guard guard ( this );
+  const void *data ( ( false == value.empty() ) ? &value[0] : 0x0 );
+  Helper::call ( boost::bind<int> ( ::sqlite3_bind_blob, _statement, which + 1, data, static_cast < int > ( value.size() ), SQLITE_TRANSIENT ), 
+    "Error 1793345016: Failed to bind blob", _sql, _database );
+  return *this;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Bind with the binder.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Result::_bind ( Binder &binder, unsigned int which )
+{
+  Guard guard ( this );
+  binder.bind ( _sql, which, _statement, _database );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Get the number of columns.
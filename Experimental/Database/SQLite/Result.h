@@ -16,6 +16,7 @@
 #ifndef _SQL_LITE_WRAP_RESULTS_H_
 #define _SQL_LITE_WRAP_RESULTS_H_
 
+#include "Database/SQLite/Binder.h"
 #include "Database/SQLite/Export.h"
 #include "Database/SQLite/Types.h"
 
@@ -47,10 +48,28 @@ public:
   // Smart-pointer definitions.
   USUL_DECLARE_REF_POINTERS ( Result );
 
+  // Bind the value to the statement's parameter. The first one is zero. 
+  // Strings and blobs are copied. Use Connection::prepare() to make a 
+  // statement that is bound, executed and reset many times.
+  Result &                bind ( unsigned int which, double );
+  Result &                bind ( unsigned int which, int );
+  Result &                bind ( unsigned int which, Usul::Types::Int64 );
+  Result &                bind ( unsigned int which, Usul::Types::Uint64 );
+  Result &                bind ( unsigned int which, const std::string & );
+  Result &                bind ( unsigned int which, const Blob & );
+
+  // Bind with the type's binder. The data is not copied, so it has to 
+  // exist until the statement is executed or reset.
+  template < class T >
+  Result &                bindData ( unsigned int which, const T & );
+
   // Return the column name or empty string if index is out of range.
   // Valid range is [0,numColumns()-1].
   std::string             columnName ( unsigned int index ) const;
 
+  // Run a statement that does not return rows, and reset it.
+  void                    execute();
+
   // Finalize the statement now. No need to call for ordinary usage.
   void                    finalize();
 
@@ -61,6 +80,9 @@ public:
   // Get the number of columns.
   unsigned int            numColumns() const;
 
+  // Reset the statement so that it can be bound and run again.
+  void                    reset();
+
   // Input operator for copying the results.
   Result &                operator >> ( std::string & );
   Result &                operator >> ( double & );
@@ -90,6 +112,8 @@ private:
   Result ( const Result & );
   Result &operator = ( const Result & );
 
+  void                    _bind ( Binder &, unsigned int which );
+
   void                    _destroy();
 
   ::sqlite3 *_database;
@@ -99,6 +123,23 @@ private:
 };
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Bind with the type's binder.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline Result &Result::bindData ( unsigned int which, const T &t )
+{
+  Binder::RefPtr binder ( CadKit::Database::SQLite::BinderTraits<T>::makeBinder ( t ) );
+  if ( true == binder.valid() )
+  {
+    this->_bind ( *binder, which );
+  }
+  return *this;
+}
+
+
 } // namespace SQLite
 } // namespace Database
 } // namespace CadKit
@@ -0,0 +1,383 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  One file holding the points of every octree node.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "NodePages.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Strings/Format.h"
+#include "Usul/Trace/Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace Detail
+{
+  const char MAGIC[8] = { 'O', 'O', 'C', 'P', 'A', 'G', 'E', 'S' };
+  const Usul::Types::Uint32 VERSION ( 1 );
+}
+
+const NodePages::Uint32 NodePages::INVALID ( std::numeric_limits < NodePages::Uint32 >::max() );
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor. Writes room for the header.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Writer::Writer ( const std::string &file, Uint32 pageSize ) :
+  _file ( file ),
+  _out ( file.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc ),
+  _nodes(),
+  _pageSize ( std::max < Uint32 > ( pageSize, sizeof ( Header ) ) ),
+  _end ( 0 )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( false == _out.is_open() )
+    throw std::runtime_error ( "Error 2007513868: Failed to open node page file for writing: " + file );
+
+  const Header header = { { 0 }, 0, 0, 0, 0 };
+  _out.write ( reinterpret_cast < const char * > ( &header ), sizeof ( Header ) );
+  _end = sizeof ( Header );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Writer::~Writer()
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write zeros up to the next page.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void NodePages::Writer::_pad()
+{
+  const Uint64 remainder ( _end % _pageSize );
+  if ( 0 == remainder )
+    return;
+
+  const std::vector < char > zeros ( static_cast < unsigned int > ( _pageSize - remainder ), 0 );
+  _out.write ( &zeros[0], zeros.size() );
+  _end += zeros.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start a node on the next page.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint32 NodePages::Writer::_begin ( const osg::BoundingBox &bb, Uint32 depth )
+{
+  if ( false == _out.is_open() )
+    throw std::runtime_error ( "Error 1666472866: Node page file is closed: " + _file );
+
+  this->_pad();
+
+  Node node;
+  node.offset = _end;
+  node.numPoints = 0;
+  node.bounds[0] = bb.xMin(); node.bounds[1] = bb.yMin(); node.bounds[2] = bb.zMin();
+  node.bounds[3] = bb.xMax(); node.bounds[4] = bb.yMax(); node.bounds[5] = bb.zMax();
+  node.depth = depth;
+  node.reserved = 0;
+  _nodes.push_back ( node );
+
+  return static_cast < Uint32 > ( _nodes.size() - 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the node's points.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint32 NodePages::Writer::add ( const osg::BoundingBox &bb, Uint32 depth, const Point *points, Uint64 numPoints )
+{
+  const Uint32 page ( this->_begin ( bb, depth ) );
+
+  if ( ( 0x0 != points ) && ( numPoints > 0 ) )
+  {
+    const Uint64 bytes ( numPoints * sizeof ( Point ) );
+    _out.write ( reinterpret_cast < const char * > ( points ), bytes );
+    _end += bytes;
+    _nodes.back().numPoints = numPoints;
+  }
+
+  return page;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the node's points from a file of raw points.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint32 NodePages::Writer::add ( const osg::BoundingBox &bb, Uint32 depth, const std::string &pointsFile )
+{
+  const Uint32 page ( this->_begin ( bb, depth ) );
+
+  std::ifstream in ( pointsFile.c_str(), std::ifstream::in | std::ifstream::binary );
+  if ( false == in.is_open() )
+    return page;
+
+  // Copy whole points only.
+  std::vector < char > buffer ( 1024 * 1024 - ( ( 1024 * 1024 ) % sizeof ( Point ) ) );
+  Uint64 bytes ( 0 );
+  while ( in )
+  {
+    in.read ( &buffer[0], buffer.size() );
+    const std::streamsize count ( in.gcount() );
+    if ( count <= 0 )
+      break;
+
+    _out.write ( &buffer[0], count );
+    bytes += count;
+  }
+
+  const Uint64 numPoints ( bytes / sizeof ( Point ) );
+  const Uint64 extra ( bytes - numPoints * sizeof ( Point ) );
+  _end += bytes;
+  _nodes.back().numPoints = numPoints;
+
+  // Pad a partial point so the next node still starts on a page.
+  if ( extra > 0 )
+  {
+    const std::vector < char > zeros ( static_cast < unsigned int > ( sizeof ( Point ) - extra ), 0 );
+    _out.write ( &zeros[0], zeros.size() );
+    _end += zeros.size();
+  }
+
+  return page;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the directory and the header.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void NodePages::Writer::close()
+{
+  USUL_TRACE_SCOPE;
+
+  if ( false == _out.is_open() )
+    return;
+
+  this->_pad();
+
+  Header header;
+  std::copy ( Detail::MAGIC, Detail::MAGIC + 8, header.magic );
+  header.version = Detail::VERSION;
+  header.pageSize = _pageSize;
+  header.numNodes = _nodes.size();
+  header.directory = _end;
+
+  if ( false == _nodes.empty() )
+  {
+    _out.write ( reinterpret_cast < const char * > ( &_nodes[0] ), _nodes.size() * sizeof ( Node ) );
+  }
+
+  _out.seekp ( 0 );
+  _out.write ( reinterpret_cast < const char * > ( &header ), sizeof ( Header ) );
+  _out.close();
+
+  if ( true == _out.fail() )
+    throw std::runtime_error ( "Error 1824641658: Failed to write node page file: " + _file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::NodePages ( const std::string &file ) : BaseClass(),
+  _map ( new Usul::File::MemoryMap ( file ) ),
+  _nodes ( 0x0 ),
+  _numNodes ( 0 )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( _map->size() < sizeof ( Header ) )
+    throw std::runtime_error ( "Error 1265860906: Node page file is too small: " + file );
+
+  Header header;
+  std::memcpy ( &header, _map->begin(), sizeof ( Header ) );
+
+  if ( ( false == std::equal ( Detail::MAGIC, Detail::MAGIC + 8, header.magic ) ) || ( Detail::VERSION != header.version ) )
+    throw std::runtime_error ( "Error 1609215672: Not a node page file: " + file );
+
+  const Uint64 end ( header.directory + header.numNodes * sizeof ( Node ) );
+  if ( ( header.directory < sizeof ( Header ) ) || ( end > _map->size() ) || ( header.numNodes > INVALID ) )
+    throw std::runtime_error ( "Error 1411208234: Node page file is truncated: " + file );
+
+  _nodes = reinterpret_cast < const Node * > ( _map->begin() + header.directory );
+  _numNodes = static_cast < Uint32 > ( header.numNodes );
+
+  // Every node's points have to be in the file.
+  for ( Uint32 i = 0; i < _numNodes; ++i )
+  {
+    if ( _nodes[i].offset + _nodes[i].numPoints * sizeof ( Point ) > header.directory )
+      throw std::runtime_error ( Usul::Strings::format ( "Error 3103896519: Node ", i, " is past the end of the points in file: ", file ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::~NodePages()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &NodePages::_destroy ), "2474318402" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void NodePages::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  _nodes = 0x0;
+  _numNodes = 0;
+  _map = 0x0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the node's directory entry. The map does not change, so there is
+//  no need to lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const NodePages::Node &NodePages::_node ( Uint32 page ) const
+{
+  if ( page >= _numNodes )
+    throw std::out_of_range ( Usul::Strings::format ( "Error 3919186730: Page ", page, " is out of range in file: ", this->file() ) );
+
+  return _nodes[page];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the node's bounds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+osg::BoundingBox NodePages::bounds ( Uint32 page ) const
+{
+  const Node &node ( this->_node ( page ) );
+  return osg::BoundingBox ( node.bounds[0], node.bounds[1], node.bounds[2], node.bounds[3], node.bounds[4], node.bounds[5] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the node's depth in the tree.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint32 NodePages::depth ( Uint32 page ) const
+{
+  return this->_node ( page ).depth;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the file name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string NodePages::file() const
+{
+  return ( ( true == _map.valid() ) ? _map->file() : std::string() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of nodes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint32 NodePages::numNodes() const
+{
+  return _numNodes;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of points in the node.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodePages::Uint64 NodePages::numPoints ( Uint32 page ) const
+{
+  return this->_node ( page ).numPoints;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy the node's points into a new array. This touches only the node's
+//  pages of the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+osg::Vec3Array *NodePages::load ( Uint32 page ) const
+{
+  USUL_TRACE_SCOPE;
+
+  const Node &node ( this->_node ( page ) );
+  osg::ref_ptr < osg::Vec3Array > points ( new osg::Vec3Array ( static_cast < unsigned int > ( node.numPoints ) ) );
+
+  if ( node.numPoints > 0 )
+  {
+    std::memcpy ( &( ( *points )[0] ), _map->begin() + node.offset, static_cast < std::size_t > ( node.numPoints * sizeof ( Point ) ) );
+  }
+
+  return points.release();
+}
@@ -0,0 +1,147 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  One file holding the points of every octree node.
+//
+//  Each node's points start on a page boundary, and a directory at the end
+//  of the file has the offset, number of points, bounds and depth of every
+//  node. The file is memory mapped, so a node is loaded by copying its
+//  pages and the operating system only reads the pages that are used.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __EXPERIMENTAL_POINT_DOCUMENT_NODE_PAGES_H__
+#define __EXPERIMENTAL_POINT_DOCUMENT_NODE_PAGES_H__
+
+#include "Usul/Base/Object.h"
+#include "Usul/File/MemoryMap.h"
+#include "Usul/Pointers/Pointers.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Array"
+#include "osg/BoundingBox"
+#include "osg/Vec3"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+class NodePages : public Usul::Base::Object
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 Uint64;
+  typedef osg::Vec3f Point;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( NodePages );
+
+  // The page of a node that has none.
+  static const Uint32 INVALID;
+
+  // The directory entry of one node.
+  struct Node
+  {
+    Uint64 offset;
+    Uint64 numPoints;
+    float bounds[6];
+    Uint32 depth;
+    Uint32 reserved;
+  };
+  typedef std::vector < Node > Nodes;
+
+  // What is at the start of the file.
+  struct Header
+  {
+    char magic[8];
+    Uint32 version;
+    Uint32 pageSize;
+    Uint64 numNodes;
+    Uint64 directory;
+  };
+
+  // Writes the file one node at a time.
+  class Writer
+  {
+  public:
+
+    Writer ( const std::string &file, Uint32 pageSize = 4096 );
+    ~Writer();
+
+    // Add the node's points and return its page.
+    Uint32            add ( const osg::BoundingBox &, Uint32 depth, const Point *points, Uint64 numPoints );
+    Uint32            add ( const osg::BoundingBox &, Uint32 depth, const std::string &pointsFile );
+
+    // Write the directory. Nothing can be added after.
+    void              close();
+
+  private:
+
+    Writer ( const Writer & );
+    Writer &operator = ( const Writer & );
+
+    Uint32            _begin ( const osg::BoundingBox &, Uint32 depth );
+    void              _pad();
+
+    std::string _file;
+    std::ofstream _out;
+    Nodes _nodes;
+    Uint32 _pageSize;
+    Uint64 _end;
+  };
+
+  // Map the file. Throws if it is not a node page file.
+  NodePages ( const std::string &file );
+
+  // Get the node's bounds.
+  osg::BoundingBox        bounds ( Uint32 page ) const;
+
+  // Get the node's depth in the tree.
+  Uint32                  depth ( Uint32 page ) const;
+
+  // Get the file name.
+  std::string             file() const;
+
+  // Copy the node's points into a new array.
+  osg::Vec3Array *        load ( Uint32 page ) const;
+
+  // Get the number of nodes.
+  Uint32                  numNodes() const;
+
+  // Get the number of points in the node.
+  Uint64                  numPoints ( Uint32 page ) const;
+
+protected:
+
+  // Use reference counting.
+  virtual ~NodePages();
+
+private:
+
+  // No copying or assignment.
+  NodePages ( const NodePages & );
+  NodePages &operator = ( const NodePages & );
+
+  void                    _destroy();
+
+  const Node &            _node ( Uint32 page ) const;
+
+  Usul::File::MemoryMap::RefPtr _map;
+  const Node *_nodes;
+  Uint32 _numNodes;
+};
+
+
+#endif // __EXPERIMENTAL_POINT_DOCUMENT_NODE_PAGES_H__
@@ -19,6 +19,7 @@
 #include "Usul/File/Make.h"
 #include "Usul/File/Remove.h"
 #include "Usul/Jobs/Manager.h"
+#include "Usul/Predicates/FileExists.h"
 #include "Usul/Threads/ThreadId.h"
 
 #include "osg/Geometry"
@@ -46,6 +47,8 @@ OctTree::OctTree ( Usul::Jobs::Manager *jm ):
   _buffer ( new StreamBuffer ( 4096 ) ),
   _workingDir(),
   _baseName(),
+  _pages ( 0x0 ),
+  _residency ( new Residency ),
   _jobManager ( jm )
 {
   if ( 0x0 == _jobManager )
@@ -215,6 +218,51 @@ void OctTree::split(  Usul::Documents::Document* document, Unknown *caller, Unkn
   // create the lod files from the leaf nodes
   _tree->createLodLevels();
 
+  // Move the points of every node into one page file and map it
+  {
+    NodePages::Writer writer ( this->_pagesFile() );
+    _tree->writePages( writer );
+    writer.close();
+  }
+  this->_openPages();
+
+#if 1
+  // Some debugging stuff
+  std::cout << "Tree Depth: " << _tree->getTreeDepth() << std::endl;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create the octree from all of the points at once, writing the points of
+//  every node straight to the page file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTree::build( const Point *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller, Unknown *progress )
+{
+  Guard guard ( this );
+  document->setStatusBar( "Step 2/2: Building Spatial Parameters...", progress );
+
+  // Sort the points into the tree with the threads of the job manager
+  OsgTools::Points::MortonOctree::RefPtr tree ( new OsgTools::Points::MortonOctree ( _tree->boundingBox(), _tree->capacity() ) );
+  if( false == tree->build( points, numPoints, Usul::Jobs::Job::RefPtr ( 0x0 ), *_jobManager ) )
+    return;
+
+  // Name the tree and seed the counts
+  _tree->name( Usul::Strings::format( _baseName, "_files/" ) );
+  _tree->numLeafNodes( 0 );
+
+  // Move the points of every node into one page file and map it
+  {
+    NodePages::Writer writer ( this->_pagesFile() );
+    _tree->build( *tree, 0, writer );
+    writer.close();
+  }
+  _tree->setTreeDepth( tree->maxDepth() );
+  this->_openPages();
+
 #if 1
   // Some debugging stuff
   std::cout << "Tree Depth: " << _tree->getTreeDepth() << std::endl;
@@ -258,6 +306,8 @@ void OctTree::read ( std::ifstream* ifs, Usul::Documents::Document* document, Un
  
   _tree->read( ifs, document, caller, progress );
 
+  // Map the page file if there is one
+  this->_openPages();
 }
 
 
@@ -409,3 +459,60 @@ std::string OctTree::workingDir()
   return _workingDir;
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the memory budget for loaded points
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTree::residentBytes( Usul::Types::Uint64 bytes )
+{
+  Guard guard ( this );
+  _residency->maxBytes( bytes );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the memory budget for loaded points
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Types::Uint64 OctTree::residentBytes() const
+{
+  Guard guard ( this );
+  return _residency->maxBytes();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the name of the page file
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string OctTree::_pagesFile() const
+{
+  Guard guard ( this );
+  return Usul::Strings::format( _workingDir, _baseName, ".pages" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Map the page file and give it to the nodes. Without one the nodes load
+//  their own points files, as files written before the page file do.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTree::_openPages()
+{
+  Guard guard ( this );
+
+  const std::string file ( this->_pagesFile() );
+  _pages = ( ( true == Usul::Predicates::FileExists::test( file ) ) ? new NodePages ( file ) : 0x0 );
+
+  _residency->clear();
+  _tree->pages( _pages.get(), _residency.get() );
+}
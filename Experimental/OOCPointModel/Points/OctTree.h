@@ -17,6 +17,7 @@
 #ifndef __EXPERIMENTAL_POINT_DOCUMENT_OCTTREE_H__
 #define __EXPERIMENTAL_POINT_DOCUMENT_OCTTREE_H__
 
+#include "NodePages.h"
 #include "OctTreeNode.h"
 #include "PointSetRecords.h"
 
@@ -70,6 +71,7 @@ public:
   unsigned int                  capacity();
 
   void                          split( Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
+  void                          build( const Point *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
 
   void                          write( std::ofstream* ofs, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 ) const;
   void                          read ( std::ifstream* ifs, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
@@ -81,10 +83,17 @@ public:
   void                          baseName( const std::string& name );
   std::string                   baseName();
 
+  // Set/get the memory budget for loaded points.
+  void                          residentBytes( Usul::Types::Uint64 bytes );
+  Usul::Types::Uint64           residentBytes() const;
+
 protected:
   
   void                          _partition();
   osg::Node*                    _buildTransparentPlane();
+
+  void                          _openPages();
+  std::string                   _pagesFile() const;
   
 private:
 
@@ -98,6 +107,8 @@ private:
   std::string                   _tempPath;
   std::string                   _workingDir;
   std::string                   _baseName;
+  NodePages::RefPtr             _pages;
+  Residency::RefPtr             _residency;
   Usul::Jobs::Manager *         _jobManager;
 };
 #endif // __EXPERIMENTAL_POINT_DOCUMENT_OCTTREE_H__
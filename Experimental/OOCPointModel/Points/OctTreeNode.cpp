@@ -19,6 +19,7 @@
 
 #include "osgUtil/CullVisitor"
 
+#include "osg/FrameStamp"
 #include "osg/Vec3d"
 #include "osg/Plane"
 #include "osg/Group"
@@ -52,9 +53,12 @@ USUL_IMPLEMENT_TYPE_ID ( OctTreeNode );
 class CustomLODCallback : public osg::NodeCallback
 {
 public:
-  CustomLODCallback( Usul::Jobs::Manager &jm, const std::string& p, osg::Geode* geode, unsigned int level, osg::BoundingBox bb ) :
+  CustomLODCallback( Usul::Jobs::Manager &jm, const std::string& p, NodePages *pages, Usul::Types::Uint32 page, Residency *residency, osg::Geode* geode, unsigned int level, osg::BoundingBox bb ) :
           _mutex(),
           _path( p ),
+          _pages( pages ),
+          _page( page ),
+          _residency( residency ),
           _geode( geode ),
           _level( level ),
           _fileSize( 0 ),
@@ -64,6 +68,14 @@ public:
           _bb ( bb ),
           _jobManager ( jm )
 		  {
+         // Use the page file if the node is in it.
+         if( true == _pages.valid() && NodePages::INVALID != _page )
+         {
+           _numPoints = static_cast< float > ( _pages->numPoints( _page ) );
+           _fileSize = _pages->numPoints( _page ) * sizeof( OctTreeNode::Point );
+           return;
+         }
+
          // Get the size of the lod file
          _fileSize = Usul::File::size( _path );
          
@@ -125,9 +137,10 @@ public:
           traverse( node, nv );
           return;
         }
-        if( vertices->size() == 0 )
+        if( vertices->size() > 0 && true == _residency.valid() )
         {
-          std::cout << "";
+          // Keep our points while we are in view.
+          _residency->touch( geodeGeometry.get() );
         }
         if( _fileSize > 0 )
         {
@@ -161,7 +174,10 @@ public:
               Guard guard ( this );
 
               // Create my job
-              _myJob = new PointLoader( _path, _numPoints );
+              if( true == _pages.valid() && NodePages::INVALID != _page )
+                _myJob = new PointLoader( _pages.get(), _page );
+              else
+                _myJob = new PointLoader( _path, _numPoints );
             
               // Set the priority level
               _myJob->priority( static_cast< int > ( _level ) );
@@ -188,6 +204,10 @@ public:
                   {
                     Guard guard ( this );
 
+                    // They no longer count against the budget
+                    if( true == _residency.valid() )
+                      _residency->remove( childGeometry.get() );
+
                     // Remove the vertices
                     childGeometry->setVertexArray( new osg::Vec3Array );
                     
@@ -214,6 +234,11 @@ public:
               // Add the points to the geode
               _geode->removeDrawables( 0, _geode->getNumDrawables() );
               _geode->addDrawable( geometry.get() );
+
+              // Count the points against the budget. This may drop the
+              // points of nodes that have not been drawn lately.
+              if( true == _residency.valid() )
+                _residency->add( geometry.get(), points->size() * sizeof( OctTreeNode::Point ) );
             
               // Reset the job
               _myJob = 0x0;
@@ -249,6 +274,9 @@ public:
   
     mutable Mutex                _mutex;
     std::string                  _path;
+    NodePages::RefPtr            _pages;
+    Usul::Types::Uint32          _page;
+    Residency::RefPtr            _residency;
     osg::ref_ptr< osg::Geode >   _geode;
     unsigned int                 _level;
     Usul::Types::Uint64          _fileSize;
@@ -288,7 +316,10 @@ OctTreeNode::OctTreeNode ( Usul::Jobs::Manager *jm, StreamBufferPtr buffer, cons
   _workingDir(),
   _baseName(),
   _jobManager ( jm ),
-  _nodeDepth( 0 )
+  _nodeDepth( 0 ),
+  _pages( 0x0 ),
+  _residency( 0x0 ),
+  _page( NodePages::INVALID )
 {
   
   _tempFilename = Usul::Strings::format ( tempPath, '/', Usul::Convert::Type< unsigned int, std::string >::convert ( reinterpret_cast < unsigned int > ( this ) ), ".tmp" );
@@ -536,7 +567,7 @@ osg::Node* OctTreeNode::buildScene( Unknown *caller, Unknown *progress )
     std::string lodName ( Usul::Strings::format( _workingDir, _name, "_points" ) );
 
     // Add the cull callback so vertices can be added and deleted at run time
-    geode->setCullCallback( new CustomLODCallback( *_jobManager, lodName, geode.get(), lodLevel, _bb ) );
+    geode->setCullCallback( new CustomLODCallback( *_jobManager, lodName, _pages.get(), _page, _residency.get(), geode.get(), lodLevel, _bb ) );
 
     // Dynamically create lod level distance definitions
     float minLevel ( static_cast< float > ( lodLevel ) / static_cast< float > ( numLODs ) );
@@ -840,7 +871,7 @@ void OctTreeNode::write( std::ofstream* ofs, unsigned int numerator, unsigned in
     Usul::Types::Uint64 nameSize( _name.size() );
 
     // write the record information
-    Usul::Types::Uint64 recordSize ( ( sizeof( Usul::Types::Uint64 ) * 2 ) + nameSize + sizeof( Usul::Types::Uint32 ) );
+    Usul::Types::Uint64 recordSize ( ( sizeof( Usul::Types::Uint64 ) * 2 ) + nameSize + ( sizeof( Usul::Types::Uint32 ) * 2 ) );
     this->_writeRecord( ofs, PointSetRecords::Record::OOC_VERTICES, recordSize );
 
     // Write the node name
@@ -856,7 +887,7 @@ void OctTreeNode::write( std::ofstream* ofs, unsigned int numerator, unsigned in
     Usul::Types::Uint64 nameSize( _name.size() );
 
     // write the record information    
-    Usul::Types::Uint64 recordSize ( ( sizeof( Usul::Types::Uint64 ) * 2 ) + nameSize + sizeof( Usul::Types::Uint32 ) );
+    Usul::Types::Uint64 recordSize ( ( sizeof( Usul::Types::Uint64 ) * 2 ) + nameSize + ( sizeof( Usul::Types::Uint32 ) * 2 ) );
     this->_writeRecord( ofs, PointSetRecords::Record::CHILDREN, recordSize );
 
     // Write the node information
@@ -917,7 +948,7 @@ void OctTreeNode::read( std::ifstream* ifs, Usul::Documents::Document* document,
       case PointSetRecords::Record::OOC_VERTICES:
       {
         // Read the name from the restart file
-        this->name( _readOOCNodeInfo( ifs ) );
+        this->name( _readOOCNodeInfo( ifs, rs ) );
 
         ++_numerator;
         document->setProgressBar( true, _numerator, _denominator, progress );
@@ -932,7 +963,7 @@ void OctTreeNode::read( std::ifstream* ifs, Usul::Documents::Document* document,
       case PointSetRecords::Record::CHILDREN:
       {
         // Read the name from the restart file
-        this->name( _readOOCNodeInfo( ifs ) );
+        this->name( _readOOCNodeInfo( ifs, rs ) );
 
         // tell children to read
         _children.resize( 8 );
@@ -1120,7 +1151,7 @@ void OctTreeNode::_readPoints( std::ifstream* ifs )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-std::string OctTreeNode::_readOOCNodeInfo( std::ifstream* ifs )
+std::string OctTreeNode::_readOOCNodeInfo( std::ifstream* ifs, Usul::Types::Uint64 recordSize )
 {
   Guard guard ( this );
   
@@ -1142,6 +1173,13 @@ std::string OctTreeNode::_readOOCNodeInfo( std::ifstream* ifs )
   // Set the node's depth
   this->setNodeDepth( depth );
 
+  // Read the page if the file has one. Older files do not.
+  _page = NodePages::INVALID;
+  if( recordSize >= ( sizeof( Usul::Types::Uint64 ) * 2 ) + size + ( sizeof( Usul::Types::Uint32 ) * 2 ) )
+  {
+    ifs->read( reinterpret_cast< char* > ( &_page ), sizeof( Usul::Types::Uint32 ) );
+  }
+
   return std::string ( name.begin(), name.end() );
 }
 
@@ -1172,6 +1210,10 @@ void OctTreeNode::_writeOOCNodeInfo( std::ofstream* ofs ) const
   //write the node depth
   Usul::Types::Uint32 depth ( _nodeDepth );
   ofs->write( reinterpret_cast< char* > ( &depth ), sizeof( Usul::Types::Uint32 ) );
+
+  // write the page
+  Usul::Types::Uint32 page ( _page );
+  ofs->write( reinterpret_cast< char* > ( &page ), sizeof( Usul::Types::Uint32 ) );
   
 }
 
@@ -1749,6 +1791,100 @@ std::string OctTreeNode::baseName()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the page file and budget of this node and its children
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTreeNode::pages( NodePages *pages, Residency *residency )
+{
+  Guard guard ( this );
+
+  for( unsigned int i = 0; i < _children.size(); ++i )
+  {
+    _children.at( i )->pages( pages, residency );
+  }
+
+  _pages = pages;
+  _residency = residency;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Take the node of a built tree and its children. Every node's points go
+//  to the page file, so nodes that are not leaves have a sample of their
+//  children's points to draw from far away.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTreeNode::build( const OsgTools::Points::MortonOctree &tree, Usul::Types::Uint32 index, NodePages::Writer &writer )
+{
+  Guard guard ( this );
+
+  const OsgTools::Points::MortonOctree::Node &node ( tree.nodes().at( index ) );
+  _bb = node.bounds;
+  _nodeDepth = node.depth;
+  _children.clear();
+
+  const bool hasPoints ( true == node.points.valid() && false == node.points->empty() );
+  _page = writer.add( _bb, _nodeDepth, ( hasPoints ? &( ( *node.points )[0] ) : 0x0 ), ( hasPoints ? node.points->size() : 0 ) );
+
+  if( true == node.leaf() )
+  {
+    this->type( POINT_HOLDER );
+    _numPoints = node.numPoints;
+    ++_numLeafNodes;
+    return;
+  }
+
+  this->type( NODE_HOLDER );
+  _numPoints = 0;
+  _children.resize( 8 );
+
+  for( unsigned int i = 0; i < 8; ++i )
+  {
+    _children.at( i ) = new OctTreeNode ( _jobManager, _streamBuffer, _tempPath );
+    _children.at( i )->distance( _distance );
+    _children.at( i )->capacity( _capacity );
+    _children.at( i )->workingDir( _workingDir );
+    _children.at( i )->name( Usul::Strings::format( _name, "C", i, "/" ) );
+    _children.at( i )->build( tree, node.children[i], writer );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the points of this node and its children to the page file, parents
+//  first. The node's own points file is removed once it is in the page file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTreeNode::writePages( NodePages::Writer &writer )
+{
+  Guard guard ( this );
+
+  const std::string lodName ( Usul::Strings::format( _workingDir, "/", _name, "_points" ) );
+
+  if( true == Usul::Predicates::FileExists::test( lodName ) )
+  {
+    _page = writer.add( _bb, _nodeDepth, lodName );
+    Usul::File::remove ( lodName, false, 0x0 );
+  }
+  else
+  {
+    _page = NodePages::INVALID;
+  }
+
+  for( unsigned int i = 0; i < _children.size(); ++i )
+  {
+    _children.at( i )->writePages( writer );
+  }
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -1963,74 +2099,29 @@ void OctTreeNode::setTreeDepth( Usul::Types::Uint32 d )
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Close the streams of all children
+//  Traverse the children. The cull visitor only reaches the nodes that are
+//  in view, and their level of detail callbacks load the points from the
+//  page file. The root tells the budget which frame it is, so that points
+//  of the nodes that were not reached can be dropped.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void OctTreeNode::traverse ( osg::NodeVisitor &nv )
 {
-  #if 0
-  // If it's a cull visitor...
-  if ( osg::NodeVisitor::CULL_VISITOR == nv.getVisitorType() )
+  if ( osg::NodeVisitor::CULL_VISITOR == nv.getVisitorType() && 0 == _nodeDepth )
   {
-    // Get cull visitor.
-    osgUtil::CullVisitor *cv ( dynamic_cast < osgUtil::CullVisitor * > ( &nv ) );
-    
-    // Check for a valid cull visitor object.
-    if ( 0x0 == cv )
-      return;
-
-    // If we are a leaf node
-    if( this->type() == POINT_HOLDER ) 
+    Residency::RefPtr residency ( 0x0 );
     {
-      // If we aren't culled...
-      if( true == cv->isCulled ( _bb ) )
-      {
-        Guard guard ( this );
-
-        // Get the lod node
-        osg::ref_ptr< osg::LOD > lod ( dynamic_cast< osg::LOD* > ( this->getChild( 0 ) ) );
-
-        // Make sure we got it
-        if( 0x0 == lod )
-        {
-          BaseClass::traverse ( nv );
-          return;
-        }
-
-        for( unsigned int i = 0; i < lod->getNumChildren(); ++i )
-        {
-          osg::ref_ptr< osg::Geode > child ( dynamic_cast< osg::Geode* > ( lod->getChild( i ) ) );
-          
-          // make sure the child is a geode
-          if( 0x0 == child )
-          {
-            BaseClass::traverse ( nv );
-            return;
-          }
-
-          // get the geometry
-          osg::ref_ptr< osg::Geometry > geometry ( dynamic_cast< osg::Geometry* > ( child->getDrawable( 0 ) ) );
-          
-          // make sure the geometry is valid
-          if( 0x0 == geometry )
-          {
-            BaseClass::traverse ( nv );
-            return;
-          }
-          
-          // clear out the vertices
-          geometry->setVertexArray( new osg::Vec3Array );
-
-          // dirty the display lists to be sure the scene is rebuilt
-          geometry->dirtyDisplayList();
+      Guard guard ( this );
+      residency = _residency;
+    }
 
-        }
-      }
+    const osg::FrameStamp *stamp ( nv.getFrameStamp() );
+    if ( 0x0 != stamp && true == residency.valid() )
+    {
+      residency->frame ( stamp->getFrameNumber() );
     }
   }
-  #endif
+
   BaseClass::traverse ( nv );
-  
 }
-
@@ -10,7 +10,11 @@
 #ifndef __EXPERIMENTAL_POINT_DOCUMENT_OCTTREENODE_H__
 #define __EXPERIMENTAL_POINT_DOCUMENT_OCTTREENODE_H__
 
+#include "NodePages.h"
 #include "PointSetRecords.h"
+#include "Residency.h"
+
+#include "OsgTools/Points/MortonOctree.h"
 
 #include "Usul/Pointers/Pointers.h"
 #include "Usul/Interfaces/IUnknown.h"
@@ -120,6 +124,16 @@ public:
   void                              baseName( const std::string& name );
   std::string                       baseName();
 
+  // Set the page file and budget of this node and its children.
+  void                              pages( NodePages *pages, Residency *residency );
+
+  // Add the points of this node and its children to the page file.
+  void                              writePages( NodePages::Writer &writer );
+
+  // Take the node of a built tree and its children, adding their points
+  // to the page file.
+  void                              build( const OsgTools::Points::MortonOctree &tree, Usul::Types::Uint32 node, NodePages::Writer &writer );
+
   // Traverse the children.
   virtual void                      traverse ( osg::NodeVisitor & );
 
@@ -150,7 +164,7 @@ protected:
   void                              _readPoints( std::ifstream* ifs );
   Usul::Types::Uint64               _readToRecord( std::ifstream* ifs, Usul::Types::Uint32 type );
   void                              _readOctreeRecord ( std::ifstream* ifs, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
-  std::string                       _readOOCNodeInfo( std::ifstream* ifs );
+  std::string                       _readOOCNodeInfo( std::ifstream* ifs, Usul::Types::Uint64 recordSize );
   
 
   bool                              _contains( OctTreeNode::Point p );
@@ -219,6 +233,9 @@ private:
   static Usul::Types::Uint32      _treeDepth;
   static Usul::Types::Uint32      _depthCount;
   Usul::Types::Uint32             _nodeDepth;
+  NodePages::RefPtr               _pages;
+  Residency::RefPtr               _residency;
+  Usul::Types::Uint32             _page;
 
 };
 #endif // __EXPERIMENTAL_POINT_DOCUMENT_OCTTREENODE_H__
@@ -39,6 +39,27 @@ PointLoader::PointLoader ( const std::string &path, Usul::Types::Uint64 numPoint
   BaseClass ( false ),
   _path( path ),
   _numPoints( numPoints ),
+  _pages( 0x0 ),
+  _page( NodePages::INVALID ),
+  _foundNewData( false ),
+  _vertices( new osg::Vec3Array )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor for loading a node from the page file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PointLoader::PointLoader ( NodePages *pages, Usul::Types::Uint32 page ) :
+  BaseClass ( false ),
+  _path(),
+  _numPoints( ( 0x0 != pages ) ? pages->numPoints ( page ) : 0 ),
+  _pages( pages ),
+  _page( page ),
   _foundNewData( false ),
   _vertices( new osg::Vec3Array )
 {
@@ -92,6 +113,19 @@ void PointLoader::_started ()
 {
   Helper::checkCancelledState ( this );
 
+  // Copy the node's pages if there is a page file.
+  if( true == _pages.valid() )
+  {
+    osg::ref_ptr< osg::Vec3Array > points ( _pages->load( _page ) );
+
+    Helper::checkCancelledState ( this );
+
+    Guard guard ( this->mutex() );
+    _vertices = points;
+    _foundNewData = true;
+    return;
+  }
+
   // Read the file
   std::ifstream infile ( _path.c_str(),  std::ofstream::in | std::ofstream::binary );
 
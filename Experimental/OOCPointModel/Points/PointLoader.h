@@ -11,6 +11,8 @@
 #ifndef __POINT_DOCUMENT_JOB_LOADING_H__
 #define __POINT_DOCUMENT_JOB_LOADING_H__
 
+#include "NodePages.h"
+
 #include "Usul/Commands/Command.h"
 #include "Usul/Documents/Document.h"
 #include "Usul/Jobs/Job.h"
@@ -37,6 +39,7 @@ class PointLoader : public Usul::Jobs::Job
       typedef DocManager::DocumentInfo Info;
       
       PointLoader ( const std::string &path, Usul::Types::Uint64 numPoints );
+      PointLoader ( NodePages *pages, Usul::Types::Uint32 page );
 
       osg::ref_ptr< osg::Vec3Array >      getData();
       
@@ -51,6 +54,8 @@ class PointLoader : public Usul::Jobs::Job
     private:
       std::string                         _path;
       Usul::Types::Uint64                 _numPoints;
+      NodePages::RefPtr                   _pages;
+      Usul::Types::Uint32                 _page;
       bool                                _foundNewData;
       osg::ref_ptr< osg::Vec3Array >      _vertices;
   };
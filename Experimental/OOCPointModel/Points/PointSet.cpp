@@ -215,6 +215,20 @@ void PointSet::split( Usul::Documents::Document* document, Unknown *caller, Unkn
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create the octree from all of the points at once. Use instead of adding
+//  the points and splitting.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PointSet::build( const osg::Vec3f *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller, Unknown *progress )
+{
+  Guard guard ( this );
+  _tree->build( points, numPoints, document, caller, progress );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Write the binary restart file for this point set
@@ -341,3 +355,17 @@ std::string PointSet::workingDir()
 
   return _workingDir;
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the memory budget for loaded points
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PointSet::residentBytes( Usul::Types::Uint64 bytes )
+{
+  Guard guard ( this );
+
+  _tree->residentBytes( bytes );
+}
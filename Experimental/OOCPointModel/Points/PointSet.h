@@ -79,6 +79,7 @@ public:
   void                    buildVectors();
 
   void                    split( Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
+  void                    build( const osg::Vec3f *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
 
   void                    write( std::ofstream* ofs, Usul::Types::Uint64  numPoints, Usul::Documents::Document* document = 0x0, Unknown *caller = 0x0, Unknown *progress = 0x0 ) const;
   void                    read ( std::ifstream* ifs, Usul::Types::Uint64 &numPoints,Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
@@ -89,6 +90,9 @@ public:
   void                    baseName( const std::string& name );
   std::string             baseName();
 
+  // Set the memory budget for loaded points.
+  void                    residentBytes( Usul::Types::Uint64 bytes );
+
  
 protected:
 
@@ -0,0 +1,278 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Keeps the loaded point geometry under a memory budget.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Residency.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Trace/Trace.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Residency::Residency ( SizeType maxBytes ) : BaseClass(),
+  _entries  (),
+  _order    (),
+  _bytes    ( 0 ),
+  _maxBytes ( maxBytes ),
+  _frame    ( 0 )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Residency::~Residency()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &Residency::_destroy ), "2657012838" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  _entries.clear();
+  _order.clear();
+  _bytes = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add loaded geometry. It counts as drawn this frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::add ( osg::Geometry *geometry, SizeType bytes )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( 0x0 == geometry )
+    return;
+
+  Guard guard ( this );
+
+  this->remove ( geometry );
+
+  _order.push_front ( geometry );
+
+  Entry entry;
+  entry.geometry = geometry;
+  entry.bytes = bytes;
+  entry.frame = _frame;
+  entry.used = _order.begin();
+  _entries.insert ( Entries::value_type ( geometry, entry ) );
+  _bytes += bytes;
+
+  this->_evict();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the bytes of all the geometry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Residency::SizeType Residency::bytes() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _bytes;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget all geometry without dropping it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::clear()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _entries.clear();
+  _order.clear();
+  _bytes = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the current frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::frame ( unsigned int f )
+{
+  Guard guard ( this );
+  _frame = f;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the current frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Residency::frame() const
+{
+  Guard guard ( this );
+  return _frame;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the budget.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::maxBytes ( SizeType bytes )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _maxBytes = bytes;
+  this->_evict();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the budget.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Residency::SizeType Residency::maxBytes() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _maxBytes;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget the geometry without dropping it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::remove ( osg::Geometry *geometry )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  Entries::iterator i ( _entries.find ( geometry ) );
+  if ( _entries.end() == i )
+    return;
+
+  _bytes -= i->second.bytes;
+  _order.erase ( i->second.used );
+  _entries.erase ( i );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of geometries.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Residency::size() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _entries.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Mark the geometry as drawn this frame. Called for every visible node, so
+//  it does not trace.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::touch ( osg::Geometry *geometry )
+{
+  Guard guard ( this );
+
+  Entries::iterator i ( _entries.find ( geometry ) );
+  if ( _entries.end() == i )
+    return;
+
+  i->second.frame = _frame;
+  _order.splice ( _order.begin(), _order, i->second.used );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Drop the geometry drawn the longest ago until under the budget. Caller
+//  has to lock the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::_evict()
+{
+  while ( ( _bytes > _maxBytes ) && ( false == _order.empty() ) )
+  {
+    Entries::iterator i ( _entries.find ( _order.back() ) );
+
+    // Keep what was drawn this frame or the one before.
+    if ( i->second.frame + 1 >= _frame )
+      return;
+
+    Residency::_unload ( *i->second.geometry );
+
+    _bytes -= i->second.bytes;
+    _order.pop_back();
+    _entries.erase ( i );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Drop the points of the geometry. The node loads them again when needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Residency::_unload ( osg::Geometry &geometry )
+{
+  geometry.setVertexArray ( new osg::Vec3Array );
+  geometry.removePrimitiveSet ( 0, geometry.getNumPrimitiveSets() );
+  geometry.dirtyDisplayList();
+  geometry.dirtyBound();
+}
@@ -0,0 +1,112 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Keeps the loaded point geometry under a memory budget.
+//
+//  Loaded geometry is added with its size, and marked each frame that it
+//  is drawn. When the total is over the budget, the geometry that was drawn
+//  the longest ago has its points dropped. Geometry drawn this frame or the
+//  one before is never dropped, so the budget can be passed for a while
+//  when that much is in view.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __EXPERIMENTAL_POINT_DOCUMENT_RESIDENCY_H__
+#define __EXPERIMENTAL_POINT_DOCUMENT_RESIDENCY_H__
+
+#include "Usul/Base/Object.h"
+#include "Usul/Pointers/Pointers.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Geometry"
+
+#include <list>
+#include <map>
+
+
+class Residency : public Usul::Base::Object
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Types::Uint64 SizeType;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( Residency );
+
+  // Constructor.
+  Residency ( SizeType maxBytes = 512 * 1024 * 1024 );
+
+  // Add loaded geometry and drop old geometry if needed.
+  void                      add ( osg::Geometry *, SizeType bytes );
+
+  // Get the bytes of all the geometry.
+  SizeType                  bytes() const;
+
+  // Forget all geometry without dropping it.
+  void                      clear();
+
+  // Set/get the current frame.
+  void                      frame ( unsigned int );
+  unsigned int              frame() const;
+
+  // Set/get the budget. Setting it drops old geometry if needed.
+  void                      maxBytes ( SizeType );
+  SizeType                  maxBytes() const;
+
+  // Forget the geometry without dropping it.
+  void                      remove ( osg::Geometry * );
+
+  // Get the number of geometries.
+  unsigned int              size() const;
+
+  // Mark the geometry as drawn this frame.
+  void                      touch ( osg::Geometry * );
+
+protected:
+
+  // Use reference counting.
+  virtual ~Residency();
+
+private:
+
+  // No copying or assignment.
+  Residency ( const Residency & );
+  Residency &operator = ( const Residency & );
+
+  typedef osg::ref_ptr < osg::Geometry > GeometryPtr;
+  typedef std::list < osg::Geometry * > Order;
+
+  struct Entry
+  {
+    GeometryPtr geometry;
+    SizeType bytes;
+    unsigned int frame;
+    Order::iterator used;
+  };
+
+  typedef std::map < osg::Geometry *, Entry > Entries;
+
+  void                      _destroy();
+  void                      _evict();
+
+  static void               _unload ( osg::Geometry & );
+
+  Entries _entries;
+  Order _order;
+  SizeType _bytes;
+  SizeType _maxBytes;
+  unsigned int _frame;
+};
+
+
+#endif // __EXPERIMENTAL_POINT_DOCUMENT_RESIDENCY_H__
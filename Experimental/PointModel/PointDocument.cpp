@@ -29,6 +29,7 @@
 #include "Usul/File/Stats.h"
 #include "Usul/File/Temp.h"
 #include "Usul/File/Find.h"
+#include "Usul/File/MemoryMap.h"
 #include "Usul/Functions/SafeCall.h"
 #include "Usul/Convert/Convert.h"
 #include "Usul/Math/MinMax.h"
@@ -40,6 +41,7 @@
 
 #include "OsgTools/State/StateSet.h"
 
+#include <cstring>
 #include <fstream>
 #include <algorithm>
 #include <iostream>
@@ -266,14 +268,16 @@ void PointDocument::_read ( const std::string &name, Unknown *caller, Unknown *p
       this->_readAndSetBounds( name, binaryFilename, caller, progress  );
     }
  
-    // Read binary file.
-    this->_readPoint3DFile( binaryFilename, caller, progress );
+    // Stop here if the load was canceled while converting.
+    this->checkLoadCanceled();
 
-    // Create the octree
-    this->_split( caller, progress );
+    // Read binary file and build the octree from its points.
+    this->_readPoint3DFile( binaryFilename, caller, progress );
+    this->checkLoadCanceled();
 
     // Build the vectors from the linked lists
     this->_buildVectors( caller, progress );
+    this->checkLoadCanceled();
 
     // debug info
     std::cout << Usul::Strings::format( "Writing binary restart file: ", restartFilename ) << std::endl;
@@ -412,81 +416,50 @@ osg::Node *PointDocument::buildScene ( const BaseClass::Options &opt, Unknown *c
 
 void PointDocument::_readPoint3DFile( const std::string &filename, Unknown *caller, Unknown *progress )
 {
- 
   this->setStatusBar ( "Step 1/2: Reading file...", progress );
 
-  // Open a stream with a large buffer.
-  const unsigned long int bufSize ( 4095 );
-  char fileBuffer[bufSize+1];
-  std::ifstream in;
-  in.rdbuf()->pubsetbuf ( fileBuffer, bufSize );
-  in.open ( filename.c_str(), std::ifstream::in | std::ifstream::binary );
-  if ( !in.is_open() )
-    throw std::runtime_error ( "Error 4073898430: Failed to open file: " + filename );
+  // Map the file so the octree is built straight from its points.
+  Usul::File::MemoryMap::RefPtr file ( new Usul::File::MemoryMap ( filename ) );
 
-  
-  // Read binary header
+  // Check the binary header
   const std::string id ( "f2775490-ecf0-4362-8c81-7c1693e0736c" );
-  std::vector<char> header ( id.size() );
-  in.read ( &header[0], header.size() );
-  const bool same ( id == std::string ( header.begin(), header.end() ) );
-  if( false == same )
+  const Usul::Types::Uint64 headerSize ( id.size() + 2 * sizeof ( osg::Vec3f ) + sizeof ( unsigned int ) );
+  if( ( file->size() < headerSize ) || ( id != std::string ( file->begin(), file->begin() + id.size() ) ) )
   {
     throw std::runtime_error ( "Error 2348749452: Invalid binary file format: " + filename );
-   
   }
 
   // Get the min/max bounds and the number of points
+  const char *position ( file->begin() + id.size() );
+
   osg::Vec3f minCorner( 0.0, 0.0, 0.0 );
-  in.read ( reinterpret_cast<char *> ( &minCorner ), sizeof ( osg::Vec3f ) );
+  std::memcpy ( &minCorner, position, sizeof ( osg::Vec3f ) );
+  position += sizeof ( osg::Vec3f );
 
   osg::Vec3f maxCorner( 0.0, 0.0, 0.0 );
-  in.read ( reinterpret_cast<char *> ( &maxCorner ), sizeof ( osg::Vec3f ) );
+  std::memcpy ( &maxCorner, position, sizeof ( osg::Vec3f ) );
+  position += sizeof ( osg::Vec3f );
 
-  // Get the number of points
-  in.read ( reinterpret_cast<char *> ( &_numPoints ), sizeof ( unsigned int ) );
+  unsigned int numPoints ( 0 );
+  std::memcpy ( &numPoints, position, sizeof ( unsigned int ) );
+  position += sizeof ( unsigned int );
+  _numPoints = numPoints;
+
+  // Give proper feedback.
+  const Usul::Types::Uint64 count ( ( file->size() - headerSize ) / sizeof ( osg::Vec3f ) );
+  if ( count < _numPoints )
+  {
+    std::cout << Usul::Strings::format ( "Only loaded ", count, " of ", _numPoints, " points" ) << std::endl;
+    _numPoints = count;
+  }
 
   // Set the bounds of the pointset octree and the point capacity
   _pointSet->bounds( minCorner, maxCorner );
   unsigned int capacity = Usul::Math::minimum( static_cast< unsigned int > ( _numPoints / 400 ), static_cast< unsigned int > ( std::numeric_limits< short >::max() ) );
   _pointSet->capacity( capacity );
-  
-  // Setup progress bars
-  Usul::Policies::TimeBased update ( 1000 ); // Every second.
 
-  // Needed for progress.
-  unsigned int count ( 0 );
-
-  try
-  {
-    // Read the rest of the file.
-    // If the x, y, or z header wasn't found then set
-    // their corresponding values to 0  
-    while( false == in.eof() )
-    {
-      osg::Vec3f value;
-
-      in.read ( reinterpret_cast<char *> ( &value ), sizeof ( osg::Vec3f ) );
-    
-      if( false == _pointSet->addPoint( value ) )
-      {
-        std::cout << "Failed to insert point in PointDocument! " << std::endl;
-      }
-
-      ++count;
-
-      // Feedback.
-      this->setProgressBar( update(), _numPoints + count, _numPoints * 2, progress );
-      
-    }
-  }
-  USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "1302438923" );
-  --count;
-  // Give proper feedback.
-  if ( count != _numPoints )
-  {
-    std::cout << Usul::Strings::format ( "Only loaded ", count, " of ", _numPoints, " points" ) << std::endl;
-  }
+  // The points start right after the header, which keeps them aligned.
+  _pointSet->build( reinterpret_cast < const osg::Vec3f * > ( position ), _numPoints, this, caller, progress );
 }
 
 
@@ -803,18 +776,6 @@ void PointDocument::_buildVectors( Unknown *caller, Unknown *progress )
 }
 
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Create the octree
-//
-///////////////////////////////////////////////////////////////////////////////
-
-void PointDocument::_split( Unknown *caller, Unknown *progress )
-{
-  _pointSet->split( this, caller, progress );
-}
-
-
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Read the binary restart file format
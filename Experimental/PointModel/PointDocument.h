@@ -108,7 +108,6 @@ protected:
   void                        _readAndSetBounds( const std::string &filename, const std::string &binaryFilename, Unknown *caller = 0x0, Unknown *progress = 0x0 );
   void                        _readBinaryRestartFile( const std::string &filename, Unknown *caller = 0x0, Unknown *progress = 0x0 );
   void                        _buildVectors( Unknown *caller = 0x0, Unknown *progress = 0x0 );
-  void                        _split( Unknown *caller = 0x0, Unknown *progress = 0x0 );
   void                        _editPointColor();
 
 
@@ -24,8 +24,11 @@
 #include "GN/Algorithms/Copy.h"
 #include "GN/Evaluate/Point.h"
 #include "GN/Tessellate/Bisect.h"
+#include "GN/Tessellate/Grid.h"
 #include "GN/Interpolate/Global.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <list>
@@ -357,6 +360,67 @@ template < class SplineType > void inline testSurfacePoint ( const SplineType &s
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test that the grid tessellation gives the same points as evaluating
+//  them one at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType > void inline testSurfaceGrid ( const SplineType &s )
+{
+  typedef typename SplineType::SizeType SizeType;
+  typedef typename SplineType::IndependentSequence IndependentSequence;
+  typedef typename SplineType::DependentType DependentType;
+  typedef typename SplineType::ErrorCheckerType ErrorCheckerType;
+  typedef typename SplineType::Vector Point;
+  typedef std::vector < Point > Points;
+  GN_CAN_BE_SURFACE ( SplineType );
+
+  OUTPUT << "<testSurfaceGrid>\n";
+
+  if ( 2 == s.numIndepVars() )
+  {
+    const SizeType numPointsU ( 17 );
+    const SizeType numPointsV ( 13 );
+    const SizeType dimension ( s.dimension() );
+
+    IndependentSequence u, v;
+    Points points;
+    GN::Tessellate::grid ( s, numPointsU, numPointsV, u, v, points );
+    GN_ERROR_CHECK ( numPointsU * numPointsV == points.size() );
+
+    // The blending is done in another order, so allow for rounding.
+    const DependentType tolerance ( std::numeric_limits<DependentType>::epsilon() * 64 );
+
+    Point pt;
+    pt.resize ( dimension );
+    DependentType largest ( 0 );
+    for ( SizeType j = 0; j < numPointsV; ++j )
+    {
+      for ( SizeType i = 0; i < numPointsU; ++i )
+      {
+        GN::Evaluate::point ( s, u[i], v[j], pt );
+        const Point &gridPoint ( points[j * numPointsU + i] );
+        GN_ERROR_CHECK ( dimension == gridPoint.size() );
+
+        for ( SizeType d = 0; d < dimension; ++d )
+        {
+          const DependentType scale ( std::max<DependentType> ( 1, std::fabs ( pt[d] ) ) );
+          const DependentType difference ( std::fabs ( gridPoint[d] - pt[d] ) / scale );
+          GN_ERROR_CHECK ( difference <= tolerance );
+          largest = std::max ( largest, difference );
+        }
+      }
+    }
+
+    OUTPUT << "  <largestDifference>" << largest << "</largestDifference>\n";
+  }
+
+  OUTPUT << "</testSurfaceGrid>\n";
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Test interpolating points.
@@ -722,6 +786,7 @@ template < class SplineType > void inline testSurface ( SplineType &s )
 {
   ::testSphere ( s );
   ::testSurfacePoint ( s );
+  ::testSurfaceGrid ( s );
 #if 1
   ::testDtNurbsCarray ( s );
   ::testSpline ( s );
@@ -328,6 +328,47 @@ void basisFunctions ( const SplineType &spline,
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+//  Compute the non-vanishing basis functions using the caller's work space
+//  instead of the spline's, so that threads can share the spline.
+//
+//  spline:         The spline.
+//  whichIndepVar:  The independent variable (which knot vector).
+//  span:           The knot span corresponding to the given parameter.
+//  u:              The parameter we are finding the basis functions for.
+//  N:              The basis functions.
+//  left:           Work space.
+//  right:          Work space.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+template
+<
+  class SplineType, 
+  class BlendingCoefficients
+>
+inline
+void basisFunctions ( const SplineType &spline,
+                      typename SplineType::SizeType whichIndepVar,
+                      typename SplineType::SizeType span,
+                      typename SplineType::IndependentArgument u,
+                      BlendingCoefficients &N,
+                      typename SplineType::WorkSpace &left,
+                      typename SplineType::WorkSpace &right )
+{
+  // Declare types.
+  typedef typename SplineType::IndependentSequence IndependentSequence;
+  typedef typename SplineType::SizeType SizeType;
+  typedef typename SplineType::ErrorCheckerType ErrorCheckerType;
+  typedef typename SplineType::WorkSpace WorkSpace;
+  typedef Detail::BasisFunctions<IndependentSequence,SizeType,BlendingCoefficients,WorkSpace,ErrorCheckerType> BasisFunctions;
+
+  // Call helper function.
+  BasisFunctions::calculate ( spline.knotVector ( whichIndepVar ), spline.order ( whichIndepVar ), span, u, N, left, right );
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 //  Compute the non-vanishing basis functions.
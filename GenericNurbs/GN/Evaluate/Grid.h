@@ -0,0 +1,621 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2004, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Batched NURBS surface evaluators.
+//
+//  These do not touch the spline's mutable work-space, so any number of
+//  threads can evaluate the same surface as long as each has its own
+//  SurfaceWork. For a grid of parameters the knot spans and basis functions
+//  are found once per column and once per row, and each row first blends
+//  the control points in the v-direction so that every point in the row
+//  only blends in the u-direction.
+//
+//  GridRows and PointList are functors that take a half-open range, which
+//  is what Usul::Algorithms::parallelFor wants:
+//
+//    GN::Evaluate::SurfaceGrid<Surface> grid ( surface );
+//    grid.parameters ( u, v );
+//    Usul::Algorithms::parallelFor ( 0, grid.numRows(), 1,
+//      GN::Evaluate::GridRows<Surface,Points> ( grid, points ) );
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _GENERIC_NURBS_LIBRARY_EVALUATE_GRID_H_
+#define _GENERIC_NURBS_LIBRARY_EVALUATE_GRID_H_
+
+#include "GN/Macros/ErrorCheck.h"
+#include "GN/MPL/TypeCheck.h"
+#include "GN/Algorithms/FindSpan.h"
+#include "GN/Algorithms/BasisFunctions.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace GN {
+namespace Evaluate {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Work-space owned by the caller. Use one per thread.
+//
+//  The span and basis functions of the last parameters are kept, so a list
+//  where u or v repeats (like a grid flattened into a list) reuses them.
+//  Call reset() after changing the surface.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType > struct SurfaceWork
+{
+  typedef typename SplineType::SizeType SizeType;
+  typedef typename SplineType::IndependentType IndependentType;
+  typedef typename SplineType::WorkSpace WorkSpace;
+
+  SurfaceWork() :
+    Nu(), Nv(), left(), right(), pw(), row(),
+    spanU ( 0 ), spanV ( 0 ), u ( 0 ), v ( 0 ),
+    surface ( 0x0 ), hasU ( false ), hasV ( false )
+  {
+  }
+
+  void reset()
+  {
+    surface = 0x0;
+    hasU = false;
+    hasV = false;
+  }
+
+  WorkSpace Nu;
+  WorkSpace Nv;
+  WorkSpace left;
+  WorkSpace right;
+  WorkSpace pw;
+  WorkSpace row;
+  SizeType spanU;
+  SizeType spanV;
+  IndependentType u;
+  IndependentType v;
+  const SplineType *surface;
+  bool hasU;
+  bool hasV;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start of namespace Detail.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper struct for the tensor-product evaluation.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType > struct Tensor
+{
+  typedef typename SplineType::ErrorCheckerType ErrorCheckerType;
+  typedef typename SplineType::SizeType SizeType;
+  typedef typename SplineType::SizeContainer SizeContainer;
+  typedef typename SplineType::IndependentArgument IndependentArgument;
+  typedef typename SplineType::DependentType DependentType;
+  typedef typename SplineType::Vector Vector;
+  typedef typename SplineType::WorkSpace WorkSpace;
+  typedef typename WorkSpace::value_type WorkSpaceValueType;
+  typedef std::vector < WorkSpace > BasisRows;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Find the span and basis functions of each parameter.
+  //
+  //  surface:        The surface.
+  //  whichIndepVar:  The independent variable (which knot vector).
+  //  params:         The parameters.
+  //  spans:          The knot spans (the answer).
+  //  basis:          The basis functions (the answer).
+  //  left:           Work space.
+  //  right:          Work space.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class ParamSequence >
+  static void basisRows ( const SplineType &surface,
+                          SizeType whichIndepVar,
+                          const ParamSequence &params,
+                          SizeContainer &spans,
+                          BasisRows &basis,
+                          WorkSpace &left,
+                          WorkSpace &right )
+  {
+    const SizeType size ( params.size() );
+    spans.resize ( size );
+    basis.resize ( size );
+
+    for ( SizeType i = 0; i < size; ++i )
+    {
+      GN_ERROR_CHECK ( params[i] >= surface.firstKnot ( whichIndepVar ) );
+      GN_ERROR_CHECK ( params[i] <= surface.lastKnot  ( whichIndepVar ) );
+
+      spans[i] = GN::Algorithms::findKnotSpan ( surface, whichIndepVar, params[i] );
+      GN::Algorithms::basisFunctions ( surface, whichIndepVar, spans[i], params[i], basis[i], left, right );
+    }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Blend the control points of columns [first,last) in the v-direction.
+  //  The answer has numDepVars values per column, starting with column
+  //  "first". See "The NURBS Book", page 103.
+  //
+  //  surface: The surface.
+  //  spanV:   The knot span in the v-direction.
+  //  Nv:      The basis functions in the v-direction.
+  //  first:   The first control point column.
+  //  last:    One past the last control point column.
+  //  row:     The blended control points (the answer).
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void blendRow ( const SplineType &surface,
+                         SizeType spanV,
+                         const WorkSpace &Nv,
+                         SizeType first,
+                         SizeType last,
+                         WorkSpace &row )
+  {
+    GN_ERROR_CHECK ( first <= last );
+    GN_ERROR_CHECK ( last <= surface.numControlPoints ( 0 ) );
+
+    const SizeType orderV ( surface.order ( 1 ) );
+    const SizeType degreeV ( surface.degree ( 1 ) );
+    const SizeType numCtrPtsU ( surface.numControlPoints ( 0 ) );
+    const SizeType numDepVars ( surface.numDepVars() );
+
+    row.accommodate ( ( last - first ) * numDepVars );
+
+    for ( SizeType c = first; c < last; ++c )
+    {
+      const SizeType offset ( ( c - first ) * numDepVars );
+      for ( SizeType i = 0; i < numDepVars; ++i )
+      {
+        WorkSpaceValueType value ( static_cast<WorkSpaceValueType> ( 0 ) );
+        for ( SizeType ii = 0; ii < orderV; ++ii )
+        {
+          const SizeType index ( ( spanV - degreeV + ii ) * numCtrPtsU + c );
+          GN_ERROR_CHECK ( index < surface.totalNumControlPoints() );
+          value += ( Nv[ii] * surface.controlPoint ( i, index ) );
+        }
+        row[offset + i] = value;
+      }
+    }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Evaluate the point from control points already blended in the
+  //  v-direction.
+  //
+  //  surface: The surface.
+  //  spanU:   The knot span in the u-direction.
+  //  Nu:      The basis functions in the u-direction.
+  //  row:     The blended control points from blendRow().
+  //  first:   The first control point column in the row.
+  //  pw:      Work space.
+  //  pt:      The point (the answer).
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void rowPoint ( const SplineType &surface,
+                         SizeType spanU,
+                         const WorkSpace &Nu,
+                         const WorkSpace &row,
+                         SizeType first,
+                         WorkSpace &pw,
+                         Vector &pt )
+  {
+    const SizeType orderU ( surface.order ( 0 ) );
+    const SizeType degreeU ( surface.degree ( 0 ) );
+    const SizeType numDepVars ( surface.numDepVars() );
+
+    GN_ERROR_CHECK ( spanU - degreeU >= first );
+    const SizeType offset ( ( spanU - degreeU - first ) * numDepVars );
+
+    pw.accommodate ( numDepVars );
+    for ( SizeType i = 0; i < numDepVars; ++i )
+    {
+      WorkSpaceValueType value ( static_cast<WorkSpaceValueType> ( 0 ) );
+      for ( SizeType k = 0; k < orderU; ++k )
+      {
+        value += ( Nu[k] * row[offset + k * numDepVars + i] );
+      }
+      pw[i] = value;
+    }
+
+    Tensor::project ( surface, pw, pt );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Evaluate the point given the spans and basis functions.
+  //
+  //  surface: The surface.
+  //  spanU:   The knot span in the u-direction.
+  //  Nu:      The basis functions in the u-direction.
+  //  spanV:   The knot span in the v-direction.
+  //  Nv:      The basis functions in the v-direction.
+  //  pw:      Work space.
+  //  pt:      The point (the answer).
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void point ( const SplineType &surface,
+                      SizeType spanU,
+                      const WorkSpace &Nu,
+                      SizeType spanV,
+                      const WorkSpace &Nv,
+                      WorkSpace &pw,
+                      Vector &pt )
+  {
+    const SizeType orderU ( surface.order ( 0 ) );
+    const SizeType orderV ( surface.order ( 1 ) );
+    const SizeType degreeU ( surface.degree ( 0 ) );
+    const SizeType degreeV ( surface.degree ( 1 ) );
+    const SizeType numCtrPtsU ( surface.numControlPoints ( 0 ) );
+    const SizeType numDepVars ( surface.numDepVars() );
+    const SizeType indexU ( spanU - degreeU );
+
+    pw.accommodate ( numDepVars );
+    for ( SizeType i = 0; i < numDepVars; ++i )
+    {
+      pw[i] = static_cast<WorkSpaceValueType> ( 0 );
+    }
+
+    for ( SizeType ii = 0; ii < orderV; ++ii )
+    {
+      const SizeType index ( ( spanV - degreeV + ii ) * numCtrPtsU + indexU );
+      for ( SizeType i = 0; i < numDepVars; ++i )
+      {
+        WorkSpaceValueType temp ( static_cast<WorkSpaceValueType> ( 0 ) );
+        for ( SizeType k = 0; k < orderU; ++k )
+        {
+          GN_ERROR_CHECK ( ( index + k ) < surface.totalNumControlPoints() );
+          temp += ( Nu[k] * surface.controlPoint ( i, index + k ) );
+        }
+        pw[i] += ( Nv[ii] * temp );
+      }
+    }
+
+    Tensor::project ( surface, pw, pt );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Copy the blended point into the answer, dividing out the weight if it
+  //  is rational. See "The NURBS Book", page 134.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void project ( const SplineType &surface, const WorkSpace &pw, Vector &pt )
+  {
+    const SizeType dimension ( surface.dimension() );
+    const SizeType dimensionsToCalculate ( std::min<SizeType> ( pt.size(), dimension ) );
+
+    std::fill ( pt.begin(), pt.end(), static_cast<DependentType> ( 0 ) );
+
+    if ( surface.rational() )
+    {
+      // Note: use the real dimension.
+      const DependentType weight ( static_cast<DependentType> ( 1 ) / pw[dimension] );
+      for ( SizeType i = 0; i < dimensionsToCalculate; ++i )
+      {
+        pt[i] = pw[i] * weight;
+      }
+    }
+    else
+    {
+      for ( SizeType i = 0; i < dimensionsToCalculate; ++i )
+      {
+        pt[i] = pw[i];
+      }
+    }
+  }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  End of namespace Detail.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluate the point on the surface given the parameters, using the
+//  caller's work-space instead of the surface's.
+//
+//  s:    Must be a surface.
+//  u:    The u-direction parameter we are evaluating the point at.
+//  v:    The v-direction parameter we are evaluating the point at.
+//  pt:   The point being evaluated (the answer).
+//  work: The work-space.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType >
+void point ( const SplineType &s,
+             typename SplineType::IndependentArgument u,
+             typename SplineType::IndependentArgument v,
+             typename SplineType::Vector &pt,
+             SurfaceWork < typename SplineType::SplineClass > &work )
+{
+  GN_CAN_BE_SURFACE ( SplineType );
+  typedef typename SplineType::SplineClass SplineClass;
+  typedef typename SplineType::ErrorCheckerType ErrorCheckerType;
+  typedef Detail::Tensor<SplineClass> Tensor;
+
+  GN_ERROR_CHECK ( u >= s.firstKnot ( 0 ) );
+  GN_ERROR_CHECK ( u <= s.lastKnot  ( 0 ) );
+  GN_ERROR_CHECK ( v >= s.firstKnot ( 1 ) );
+  GN_ERROR_CHECK ( v <= s.lastKnot  ( 1 ) );
+  GN_ERROR_CHECK ( 2 == s.numIndepVars() );
+
+  // What we kept is only good for the same surface.
+  if ( &s != work.surface )
+  {
+    work.reset();
+    work.surface = &s;
+  }
+
+  if ( false == work.hasU || u != work.u )
+  {
+    work.spanU = GN::Algorithms::findKnotSpan ( s, 0, u );
+    GN::Algorithms::basisFunctions ( s, 0, work.spanU, u, work.Nu, work.left, work.right );
+    work.u = u;
+    work.hasU = true;
+  }
+
+  if ( false == work.hasV || v != work.v )
+  {
+    work.spanV = GN::Algorithms::findKnotSpan ( s, 1, v );
+    GN::Algorithms::basisFunctions ( s, 1, work.spanV, v, work.Nv, work.left, work.right );
+    work.v = v;
+    work.hasV = true;
+  }
+
+  Tensor::point ( s, work.spanU, work.Nu, work.spanV, work.Nv, work.pw, pt );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The spans and basis functions of a grid of parameters on a surface.
+//  Once the parameters are set it is only read, so threads can share it.
+//  Points are stored by row: the point at (u[i],v[j]) is at
+//  j * numColumns() + i. The caller sizes the points and each point.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType > class SurfaceGrid
+{
+public:
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Useful typedefs.
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  typedef typename SplineType::SplineClass                 SplineClass;
+  typedef typename SplineType::ErrorCheckerType            ErrorCheckerType;
+  typedef typename SplineType::SizeType                    SizeType;
+  typedef typename SplineType::SizeContainer               SizeContainer;
+  typedef typename SplineType::WorkSpace                   WorkSpace;
+  typedef Detail::Tensor<SplineClass>                      Tensor;
+  typedef typename Tensor::BasisRows                       BasisRows;
+  typedef SurfaceWork<SplineClass>                         Work;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Constructor. The surface has to live longer than the grid.
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  SurfaceGrid ( const SplineType &surface ) :
+    _surface ( surface ),
+    _spansU  (),
+    _spansV  (),
+    _basisU  (),
+    _basisV  (),
+    _first   ( 0 ),
+    _last    ( 0 )
+  {
+    GN_CAN_BE_SURFACE ( SplineType );
+    GN_ERROR_CHECK ( 2 == surface.numIndepVars() );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Set the parameters, which finds their spans and basis functions.
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class ParamSequence > void parameters ( const ParamSequence &u, const ParamSequence &v )
+  {
+    Work work;
+    Tensor::basisRows ( _surface, 0, u, _spansU, _basisU, work.left, work.right );
+    Tensor::basisRows ( _surface, 1, v, _spansV, _basisV, work.left, work.right );
+
+    // The control point columns that the u-parameters use.
+    const SizeType degreeU ( _surface.degree ( 0 ) );
+    _first = _last = 0;
+    if ( false == _spansU.empty() )
+    {
+      _first = *std::min_element ( _spansU.begin(), _spansU.end() ) - degreeU;
+      _last  = *std::max_element ( _spansU.begin(), _spansU.end() ) + 1;
+    }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Get the number of columns (u-parameters) and rows (v-parameters).
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  SizeType numColumns() const
+  {
+    return _spansU.size();
+  }
+  SizeType numRows() const
+  {
+    return _spansV.size();
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Evaluate the points of rows [firstRow,lastRow).
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class PointSequence > void evaluate ( SizeType firstRow, SizeType lastRow, PointSequence &points, Work &work ) const
+  {
+    GN_ERROR_CHECK ( firstRow <= lastRow );
+    GN_ERROR_CHECK ( lastRow <= this->numRows() );
+
+    const SizeType numColumns ( this->numColumns() );
+    GN_ERROR_CHECK ( points.size() >= this->numRows() * numColumns );
+
+    for ( SizeType j = firstRow; j < lastRow; ++j )
+    {
+      Tensor::blendRow ( _surface, _spansV[j], _basisV[j], _first, _last, work.row );
+
+      const SizeType offset ( j * numColumns );
+      for ( SizeType i = 0; i < numColumns; ++i )
+      {
+        Tensor::rowPoint ( _surface, _spansU[i], _basisU[i], work.row, _first, work.pw, points[offset + i] );
+      }
+    }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Evaluate all the points.
+  ///
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class PointSequence > void evaluate ( PointSequence &points, Work &work ) const
+  {
+    this->evaluate ( 0, this->numRows(), points, work );
+  }
+
+private:
+
+  // No assignment.
+  SurfaceGrid &operator = ( const SurfaceGrid & );
+
+  const SplineType &_surface;
+  SizeContainer _spansU;
+  SizeContainer _spansV;
+  BasisRows _basisU;
+  BasisRows _basisV;
+  SizeType _first;
+  SizeType _last;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluates rows [first,last) of the grid with its own work-space.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType, class PointSequence > struct GridRows
+{
+  typedef SurfaceGrid<SplineType> Grid;
+  typedef typename Grid::SizeType SizeType;
+  typedef typename Grid::Work Work;
+
+  GridRows ( const Grid &grid, PointSequence &points ) : _grid ( &grid ), _points ( &points )
+  {
+  }
+
+  void operator () ( SizeType first, SizeType last ) const
+  {
+    Work work;
+    _grid->evaluate ( first, last, *_points, work );
+  }
+
+private:
+
+  const Grid *_grid;
+  PointSequence *_points;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluates the points at (u[i],v[i]) for i in [first,last) with its own
+//  work-space.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SplineType, class ParamSequence, class PointSequence > struct PointList
+{
+  typedef typename SplineType::ErrorCheckerType ErrorCheckerType;
+  typedef typename SplineType::SizeType SizeType;
+  typedef SurfaceWork<typename SplineType::SplineClass> Work;
+
+  PointList ( const SplineType &surface, const ParamSequence &u, const ParamSequence &v, PointSequence &points ) :
+    _surface ( &surface ), _u ( &u ), _v ( &v ), _points ( &points )
+  {
+    GN_ERROR_CHECK ( u.size() == v.size() );
+    GN_ERROR_CHECK ( points.size() >= u.size() );
+  }
+
+  void operator () ( SizeType first, SizeType last ) const
+  {
+    Work work;
+    for ( SizeType i = first; i < last; ++i )
+    {
+      GN::Evaluate::point ( *_surface, (*_u)[i], (*_v)[i], (*_points)[i], work );
+    }
+  }
+
+private:
+
+  const SplineType *_surface;
+  const ParamSequence *_u;
+  const ParamSequence *_v;
+  PointSequence *_points;
+};
+
+
+}; // namespace Evaluate
+}; // namespace GN
+
+
+#endif // _GENERIC_NURBS_LIBRARY_EVALUATE_GRID_H_
@@ -108,7 +108,7 @@ template < class SplineType > struct Calculate
     const SizeType dimensionsToCalculate ( std::min<SizeType> ( pt.size(), dimension ) );
 
     // Needed in the loop.
-    SizeType index ( 0 ), indexU ( 0 ), indexV ( 0 ), i ( 0 ), ii ( 0 ), k ( 0 );
+    SizeType index ( 0 ), indexU ( spanU - degreeU ), indexV ( 0 ), i ( 0 ), ii ( 0 ), k ( 0 );
 
 		// If it is rational. See "The NURBS Book", page 134.
 		if ( surface.rational() )
@@ -0,0 +1,114 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2004, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Tessellation of a surface at a grid of parameters.
+//
+//  The points are stored by row: the point at (u[i],v[j]) is at
+//  j * u.size() + i. To evaluate the rows in parallel, set up a
+//  GN::Evaluate::SurfaceGrid and hand GN::Evaluate::GridRows to the loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _GENERIC_NURBS_LIBRARY_GRID_TESSELLATION_H_
+#define _GENERIC_NURBS_LIBRARY_GRID_TESSELLATION_H_
+
+#include "GN/Evaluate/Grid.h"
+#include "GN/Macros/ErrorCheck.h"
+#include "GN/MPL/TypeCheck.h"
+
+
+namespace GN {
+namespace Tessellate {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluate the surface at every pair of the given parameters.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SurfaceType, class IndependentSequenceType, class PointSequenceType > inline
+void grid ( const SurfaceType &surface,
+            const IndependentSequenceType &u,
+            const IndependentSequenceType &v,
+            PointSequenceType &points )
+{
+  GN_CAN_BE_SURFACE ( SurfaceType );
+  typedef typename SurfaceType::SplineClass SplineClass;
+  typedef typename SurfaceType::SizeType SizeType;
+  typedef GN::Evaluate::SurfaceGrid<SplineClass> SurfaceGrid;
+
+  SurfaceGrid evaluator ( surface );
+  evaluator.parameters ( u, v );
+
+  // Size the answer.
+  const SizeType dimension ( surface.dimension() );
+  points.resize ( evaluator.numRows() * evaluator.numColumns() );
+  for ( SizeType i = 0; i < points.size(); ++i )
+  {
+    points[i].resize ( dimension );
+  }
+
+  typename SurfaceGrid::Work work;
+  evaluator.evaluate ( points, work );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluate the surface at a grid of evenly spaced parameters that spans
+//  the knot vectors. The parameters are appended to u and v.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class SurfaceType, class IndependentSequenceType, class PointSequenceType > inline
+void grid ( const SurfaceType &surface,
+            typename SurfaceType::SizeType numU,
+            typename SurfaceType::SizeType numV,
+            IndependentSequenceType &u,
+            IndependentSequenceType &v,
+            PointSequenceType &points )
+{
+  GN_CAN_BE_SURFACE ( SurfaceType );
+  typedef typename SurfaceType::ErrorCheckerType ErrorCheckerType;
+  typedef typename SurfaceType::SizeType SizeType;
+  typedef typename SurfaceType::IndependentType IndependentType;
+
+  GN_ERROR_CHECK ( numU > 1 );
+  GN_ERROR_CHECK ( numV > 1 );
+
+  const SizeType counts[2] = { numU, numV };
+  IndependentSequenceType *params[2] = { &u, &v };
+
+  for ( SizeType d = 0; d < 2; ++d )
+  {
+    const IndependentType first ( surface.firstKnot ( d ) );
+    const IndependentType last  ( surface.lastKnot  ( d ) );
+    const SizeType count ( counts[d] );
+
+    params[d]->clear();
+    for ( SizeType i = 0; i < count; ++i )
+    {
+      // The ends are exactly the first and last knots.
+      const IndependentType t ( ( count - 1 == i ) ? last : first + ( last - first ) * ( IndependentType ( i ) / IndependentType ( count - 1 ) ) );
+      params[d]->insert ( params[d]->end(), t );
+    }
+  }
+
+  GN::Tessellate::grid ( surface, u, v, points );
+}
+
+
+}; // namespace Tessellate
+}; // namespace GN
+
+
+#endif // _GENERIC_NURBS_LIBRARY_GRID_TESSELLATION_H_
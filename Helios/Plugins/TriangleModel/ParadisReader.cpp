@@ -695,29 +695,17 @@ void ParadisReader::_buildSharedVerticesVector()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Build the map of shared vertices.
+//  Give the shared vertices to the triangle set.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void ParadisReader::_buildSharedVerticesMap()
 {
-  // Get the number of vertices.
-  Vertices &vertices ( *_triangles->vertices() );
-  const unsigned int numVertices ( vertices.size() );
-
-  // Shortcut to the map.
-  typedef OsgTools::Triangles::TriangleSet::SharedVertices VertexMap;
-  VertexMap &shared ( _triangles->sharedVertices() );
-
   // Feedback.
-  _document->setStatusBar ( "Building map of shared vertices..." );
+  _document->setStatusBar ( "Indexing shared vertices..." );
 
-  // Loop through the vertices.
-  for ( unsigned int i = 0; i < numVertices; ++i )
-  {
-    // Add it to the map.
-    shared.insert ( VertexMap::value_type ( vertices[i], _shared[i].get() ) );
-  }
+  // They are in the same order as the vertices.
+  _triangles->sharedVertices ( _shared );
 }
 
 
@@ -746,9 +734,9 @@ void ParadisReader::_buildTriangles()
     const Indices::value_type &index ( _indices[i] );
 
     // Get the shared vertices.
-    SharedVertex::ValidRefPtr &sv0 ( _shared.at ( index[0] ) );
-    SharedVertex::ValidRefPtr &sv1 ( _shared.at ( index[1] ) );
-    SharedVertex::ValidRefPtr &sv2 ( _shared.at ( index[2] ) );
+    SharedVertex *sv0 ( _shared.at ( index[0] ) );
+    SharedVertex *sv1 ( _shared.at ( index[1] ) );
+    SharedVertex *sv2 ( _shared.at ( index[2] ) );
 
     // Append new triangle to the list.
     Triangle::ValidRefPtr t ( _triangles->newTriangle ( sv0, sv1, sv2, i ) );
@@ -42,7 +42,7 @@ public:
   typedef std::vector< Usul::Types::Uint32 > UintVector;
   typedef OsgTools::Triangles::Triangle Triangle;
   typedef OsgTools::Triangles::SharedVertex SharedVertex;
-  typedef std::vector < SharedVertex::ValidRefPtr > SharedVertices;
+  typedef TriangleSet::SharedVertices SharedVertices;
   typedef std::vector < unsigned int > Counts;
   typedef std::vector < Usul::Math::Vec3ui > Indices;
 
@@ -26,6 +26,7 @@
 #include "TriangleReaderOFF.h"
 #include "TriangleReaderFieldViewAscii.h"
 
+#include "OsgTools/Triangles/Decimate.h"
 #include "OsgTools/Triangles/FindAllConnected.h"
 #include "OsgTools/Triangles/LoopSplitter.h"
 #include "OsgTools/Triangles/FindLoops.h"
@@ -34,7 +35,6 @@
 #include "Usul/Interfaces/IStatusBar.h"
 #include "Usul/Interfaces/IProgressBar.h"
 #include "Usul/Interfaces/ISmoothTriangles.h"
-#include "Usul/Interfaces/IDecimateTriangles.h"
 #include "Usul/Interfaces/ISubdivideTriangles.h"
 
 #include "Usul/Adaptors/Random.h"
@@ -42,6 +42,7 @@
 #include "Usul/Documents/Manager.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/File/Path.h"
+#include "Usul/Memory/Arena.h"
 #include "Usul/Policies/Update.h"
 #include "Usul/Strings/Case.h"
 #include "Usul/Trace/Trace.h"
@@ -66,11 +67,12 @@ USUL_IMPLEMENT_TYPE_ID ( TriangleDocument );
 TriangleDocument::TriangleDocument() : BaseClass ( "Triangle Document" ),
   _triangles ( new OsgTools::Triangles::TriangleSet ),
   _uncapped (),
-  _capped ()
+  _capped (),
+  _chunks ()
 {
-#if 1
-  _triangles->factory()->usePool ( false );
-#endif
+  // The arena hands slots back as soon as the objects are deleted, which
+  // the pool does not, and it is safe for the reader jobs to share.
+  _triangles->factory()->useArena ( new Usul::Memory::Arena );
 
   // Default options.
   this->setOption ( "normals", "per-vertex" );
@@ -115,6 +117,8 @@ Usul::Interfaces::IUnknown *TriangleDocument::queryInterface ( unsigned long iid
     return static_cast < Usul::Interfaces::IGetBoundingBox* > ( this );
   case Usul::Interfaces::IMemoryPool::IID:
     return static_cast < Usul::Interfaces::IMemoryPool* > ( this );
+  case Usul::Interfaces::ISceneChunks::IID:
+    return static_cast < Usul::Interfaces::ISceneChunks* > ( this );
   default:
     return BaseClass::queryInterface ( iid );
   }
@@ -274,6 +278,10 @@ void TriangleDocument::clear ( Usul::Interfaces::IUnknown *caller )
   // Clear the triangle set.
   _triangles->clear ( caller );
   _triangles->purge();
+
+  // A viewer may still be asking for the chunks of a load that was canceled.
+  if ( false == this->loading() )
+    this->_clearSceneChunks();
 }
 
 
@@ -348,11 +356,107 @@ TriangleDocument::Filters TriangleDocument::filtersExport() const
 osg::Node *TriangleDocument::buildScene ( const BaseClass::Options &opt, Unknown *caller )
 {
   USUL_TRACE_SCOPE;
+
+  // The chunks shown while loading are not needed once the whole scene is built.
+  if ( false == this->loading() )
+    this->_clearSceneChunks();
+
   // Redirect to triangle set
   return _triangles->buildScene ( opt, caller );
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build the scene after reading. This is in its own job, so the viewer's
+//  call to buildScene() only has to hand over the blocks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleDocument::_loadBuild ( Unknown *caller )
+{
+  USUL_TRACE_SCOPE;
+  _triangles->buildScene ( this->options(), caller );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make a geode from the triangles and publish it. The arrays belong to the
+//  geode after this, so the caller should not change them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleDocument::addSceneChunk ( osg::Vec3Array *vertices, osg::Vec3Array *normals )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( ( false == this->loading() ) || ( 0x0 == vertices ) || ( 0x0 == normals ) || ( true == normals->empty() ) )
+    return;
+
+  osg::ref_ptr < osg::Geometry > geometry ( new osg::Geometry );
+  geometry->setVertexArray ( vertices );
+  geometry->setNormalArray ( normals );
+  geometry->setNormalBinding ( osg::Geometry::BIND_PER_PRIMITIVE );
+  geometry->addPrimitiveSet ( new osg::DrawArrays ( osg::PrimitiveSet::TRIANGLES, 0, vertices->size() ) );
+
+  osg::ref_ptr < osg::Geode > geode ( new osg::Geode );
+  geode->addDrawable ( geometry.get() );
+
+  {
+    Guard guard ( this );
+    _chunks.push_back ( geode.get() );
+  }
+
+  this->publishScene();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of chunks published while loading.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int TriangleDocument::numSceneChunks() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _chunks.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the i'th chunk published while loading.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+osg::Node *TriangleDocument::sceneChunk ( unsigned int i )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return ( ( i < _chunks.size() ) ? _chunks[i].get() : 0x0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Let go of the chunks published while loading.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleDocument::_clearSceneChunks()
+{
+  USUL_TRACE_SCOPE;
+  SceneChunks chunks;
+  {
+    Guard guard ( this );
+    chunks.swap ( _chunks );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Flip the normals in this document.
@@ -403,6 +507,34 @@ void TriangleDocument::reserveTriangles ( unsigned int num )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add many triangles at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int TriangleDocument::addTriangles ( const osg::Vec3Array &vertices, const osg::Vec3Array &normals, bool original, Usul::Interfaces::IUnknown *caller )
+{
+  USUL_TRACE_SCOPE;
+
+  const unsigned int first ( _triangles->numTriangles() );
+  const unsigned int added ( _triangles->addTriangles ( vertices, normals, false, caller ) );
+
+  // Mark the new ones.
+  if ( true == original )
+  {
+    const TriangleSet &ts ( *_triangles );
+    const TriangleSet::TriangleVector &triangles ( ts.triangles() );
+    for ( unsigned int i = first; i < triangles.size(); ++i )
+    {
+      triangles[i]->original ( true );
+    }
+  }
+
+  return added;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Add the triangles.
@@ -449,23 +581,33 @@ void TriangleDocument::findLoops ( Usul::Interfaces::IUnknown* caller )
   // Update for finding inner loops
   Usul::Interfaces::IProgressBar::UpdateProgressBar updateProgress ( 0.0, 1.0, caller );
 
-  // Need to make sure all triangles and shared vertices are unvisited
-  _triangles->setAllUnvisited();
+  // Clear our uncapped loops.
+  _uncapped.clear();
 
-  // Reset the on edge flags.
-  _triangles->resetOnEdge();
+  // The mesh keeps its open edges until the triangles change, and carries
+  // them over when triangles are removed.
+  if ( true == _triangles->useMesh() )
+  {
+    const TriangleSet &triangles ( *_triangles );
+    OsgTools::Triangles::boundaryLoops ( *_triangles->mesh(), triangles.triangles(), _uncapped );
+  }
+  else
+  {
+    // Need to make sure all triangles and shared vertices are unvisited
+    _triangles->setAllUnvisited();
 
-  // Need to get triangles
-  TriangleSet::TriangleVector &triangles ( _triangles->triangles() );
+    // Reset the on edge flags.
+    _triangles->resetOnEdge();
 
-  // The adjacency test
-  AdjacencyTest adjacent;
+    // Need to get triangles
+    TriangleSet::TriangleVector &triangles ( _triangles->triangles() );
 
-  // Clear our uncapped loops.
-  _uncapped.clear();
+    // The adjacency test
+    AdjacencyTest adjacent;
 
-  // Find the loops that need to be triangulated.
-  OsgTools::Triangles::capPolygons ( triangles, _uncapped, adjacent, 3, updateProgress );
+    // Find the loops that need to be triangulated.
+    OsgTools::Triangles::capPolygons ( triangles, _uncapped, adjacent, 3, updateProgress );
+  }
 
   // Functor for updating the status bar
   Usul::Interfaces::IStatusBar::UpdateStatusBar status ( caller );
@@ -826,14 +968,13 @@ void TriangleDocument::smoothModel ( )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void TriangleDocument::decimateModel ( )
+void TriangleDocument::decimateModel ( Usul::Interfaces::IUnknown *caller )
 {
-  Usul::Interfaces::IUnknown *unknown ( Usul::Components::Manager::instance().getInterface ( Usul::Interfaces::IDecimateTriangles::IID ) );
-  Usul::Interfaces::IDecimateTriangles::QueryPtr plugin ( unknown );
+  USUL_TRACE_SCOPE;
 
-  if ( plugin.valid() )
+  OsgTools::Triangles::Decimate decimate ( 0.5f );
+  if ( true == decimate ( *_triangles, caller ) )
   {
-    plugin->decimateTriangles( _triangles.get(), 0.50 );
     this->modified( true );
   }
 }
@@ -907,6 +1048,19 @@ void TriangleDocument::usePool ( bool use )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Use the index-based mesh for connectivity queries.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleDocument::useMesh ( bool use )
+{
+  USUL_TRACE_SCOPE;
+  _triangles->useMesh ( use );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Use memory pool
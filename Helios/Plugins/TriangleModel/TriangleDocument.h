@@ -28,6 +28,7 @@
 #include "Usul/Interfaces/IGetBoundingBox.h"
 #include "Usul/Interfaces/IAddSharedVertex.h"
 #include "Usul/Interfaces/IMemoryPool.h"
+#include "Usul/Interfaces/ISceneChunks.h"
 
 #include "Usul/Types/Types.h"
 
@@ -42,7 +43,8 @@ class TriangleDocument : public Usul::Documents::Document,
                          public Usul::Interfaces::IBuildScene,
                          public Usul::Interfaces::IGetBoundingBox,
                          public Usul::Interfaces::IAddSharedVertex,
-                         public Usul::Interfaces::IMemoryPool
+                         public Usul::Interfaces::IMemoryPool,
+                         public Usul::Interfaces::ISceneChunks
 {
 public:
 
@@ -78,6 +80,13 @@ public:
   /// Add an entire triangle set. Assumes the triangle set has been constructed properly.
   void                        addTriangleSet ( TriangleSet * );
 
+  // Show the triangles while the rest of the file is read. There are three
+  // vertices and one normal per triangle. Does nothing unless loading.
+  void                        addSceneChunk ( osg::Vec3Array *vertices, osg::Vec3Array *normals );
+
+  // Add many triangles at once. See TriangleSet::addTriangles().
+  unsigned int                addTriangles ( const osg::Vec3Array &vertices, const osg::Vec3Array &normals, bool original, Usul::Interfaces::IUnknown *caller );
+
   // Set the dirty flag.
   virtual void                dirtyColorsV ( bool );
 
@@ -149,6 +158,10 @@ public:
   /// Get the number of triangles.
   unsigned int                numTriangles() const;
 
+  // Usul::Interfaces::ISceneChunks
+  virtual unsigned int        numSceneChunks() const;
+  virtual osg::Node *         sceneChunk ( unsigned int i );
+
   /// Read the file and add it to document's data.
   virtual void                read ( const std::string &filename, Unknown *caller = 0x0, Unknown *progress = 0x0 );
 
@@ -163,8 +176,9 @@ public:
   virtual SharedVertex*       sharedVertex1 ( const osg::Geode *g, const osg::Drawable* d, unsigned int i )       { return _triangles->sharedVertex1 ( g, d, i ); }
   virtual SharedVertex*       sharedVertex2 ( const osg::Geode *g, const osg::Drawable* d, unsigned int i )       { return _triangles->sharedVertex2 ( g, d, i ); }
 
-  // Get the triangles. Use with caution.
-  const TriangleVector &      triangles() const { return _triangles->triangles(); }
+  // Get the triangles. Use with caution. The non-const one marks the mesh
+  // as dirty, see TriangleSet::triangles().
+  const TriangleVector &      triangles() const { const TriangleSet &ts ( *_triangles ); return ts.triangles(); }
   TriangleVector &            triangles()       { return _triangles->triangles(); }
 
   // Get the triangle set.
@@ -176,6 +190,9 @@ public:
   // Use memory pool
   void                        usePool ( bool use );
 
+  // Use the index-based mesh for connectivity queries.
+  void                        useMesh ( bool use );
+
   // Usul::Interfaces::Materials
   virtual void                useMaterial( bool use );
 
@@ -207,8 +224,13 @@ protected:
   /// Use reference counting.
   virtual ~TriangleDocument();
 
+  void                        _clearSceneChunks();
+
   void                        _findAllConnected ( Usul::Interfaces::IUnknown* caller, Connected& connected, Usul::Types::Uint32 seed, bool showProgress, bool clearFlags );
 
+  /// Build the scene after reading.
+  virtual void                _loadBuild ( Unknown *caller );
+
   /// Usul::Interfaces::IKeepAllConnected
   virtual void                keepAllConnected ( Usul::Interfaces::IUnknown *caller, const osgUtil::LineSegmentIntersector::Intersection &hit );
 
@@ -227,7 +249,7 @@ protected:
   virtual void                smoothModel();
 
   /// Usul::Interfaces::IDecimateModel
-  virtual void                decimateModel();
+  virtual void                decimateModel ( Usul::Interfaces::IUnknown *caller );
 
   /// Usul::Interfaces::ISubdivideModel
   virtual void                subdivideModel ( unsigned int numSubdivisions);
@@ -237,9 +259,12 @@ protected:
 
 private:
 
+  typedef std::vector < osg::ref_ptr < osg::Node > > SceneChunks;
+
   TriangleSet::ValidRefPtr _triangles;
   Loops _uncapped;
   Loops _capped;
+  SceneChunks _chunks;
 };
 
 
@@ -11,25 +11,51 @@
 //
 //  STL reader class.
 //
+//  The file is memory mapped. Binary facets are decoded in parallel in
+//  fixed-size ranges. ASCII files are cut into pieces at "facet" keywords
+//  and the pieces are parsed in parallel. Either way, the file is done in
+//  chunks of about 64 MB. Each chunk is welded into the document and, when
+//  the document is loading in jobs, published so that it can be seen while
+//  the rest is read.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "TriangleReaderSTL.h"
 
-#include "Usul/File/Stats.h"
-#include "Usul/File/Contents.h"
-#include "Usul/Policies/Update.h"
-#include "Usul/IO/BinaryReader.h"
+#include "Usul/Algorithms/Parallel.h"
 #include "Usul/Types/Types.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/System/Clock.h"
 #include "Usul/Endian/Endian.h"
 
-#include <iostream>
-#include <fstream>
+#include "osg/Array"
+#include "osg/ref_ptr"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <algorithm>
-#include <limits>
-#include <cstring>
+#include <string>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constants for this file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  const unsigned int HEADER_SIZE ( 84 );
+  const unsigned int FACET_SIZE ( 50 );
+  const unsigned int BINARY_GRAIN ( 65536 );
+  const unsigned int ASCII_PIECE_SIZE ( 4 * 1024 * 1024 );
+  const unsigned int CHUNK_SIZE ( 64 * 1024 * 1024 );
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -62,102 +88,341 @@ TriangleReaderSTL::~TriangleReaderSTL()
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-bool TriangleReaderSTL::_isAscii() const
+bool TriangleReaderSTL::_isAscii ( const MemoryMap &file ) const
+{
+  // Look at the end of the file.
+  const MemoryMap::SizeType size ( file.size() );
+  const MemoryMap::SizeType tail ( ( size > 100 ) ? 100 : size );
+  const std::string end ( file.end() - tail, file.end() );
+
+  // Can we find the word "endsolid"?
+  return ( std::string::npos != end.find ( "endsolid" ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleReaderSTL::operator()()
 {
-  // Get the size of the file.
-  Usul::Types::Uint64 size ( Usul::File::size ( _file ) );
+  // Set initial progress and range.
+  _document->setProgressBar ( true, 0, 100, _caller );
 
-  // Open the file in binary.
-  std::ifstream in ( _file.c_str(), std::ifstream::in | std::ifstream::binary );
+  // Initialize start time.
+  Usul::Types::Uint64 start ( Usul::System::Clock::milliseconds() );
 
-  // Move the cursor so that it's almost to the end.
-  in.seekg ( static_cast < std::streamoff > ( ( size > 100 ) ? size - 100 : size * 0.9 ) );
+  // Map the whole file.
+  MemoryMap::RefPtr file ( new MemoryMap ( _file ) );
 
-  // Get the remainder of the file as a string.
-  std::string file;
-  Usul::File::contents ( in, file );
+  // Read the data.
+  if ( this->_isAscii ( *file ) )
+    this->_readAscii ( *file );
+  else 
+    this->_readBinary ( *file );
 
-  // Can we find the word "endsolid"?
-  return ( std::string::npos != file.find ( "endsolid" ) );
+  // Feedback.
+  const double total ( static_cast < double > ( Usul::System::Clock::milliseconds() - start ) * 0.001 );
+  const double megabytes ( static_cast < double > ( file->size() ) / ( 1024.0 * 1024.0 ) );
+  const double rate ( ( total > 0 ) ? ( megabytes / total ) : 0 );
+  ::printf ( "%8.4f seconds .... Time to read file (%.1f MB at %.1f MB/s).\n", total, megabytes, rate ); ::fflush ( stdout );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Count the triangles in the file. Note: tried to pass in the already-opened 
-//  ifstream object, but while I could easily reset the stream position, I was 
-//  unable to reset the state so that "in.eof()" would return false.
+//  Weld the triangles into the document.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-unsigned int TriangleReaderSTL::_countAcsiiFacets()
+void TriangleReaderSTL::_addTriangles ( osg::Vec3Array *vertices, osg::Vec3Array *normals )
 {
-  // Get the size of the file.
-  const Usul::Types::Uint64 fileSize ( Usul::File::size ( _file ) );
+  // Add the triangles. Mark as orginal.
+  _document->addTriangles ( *vertices, *normals, true, _caller );
 
-  // Open the file.
-  std::ifstream in ( _file.c_str() );
-  if ( !in.is_open() )
-    throw std::runtime_error ( "Error 4181036950: Failed to open ASCII STL file: " + _file );
+  // Show them while the rest is read. The document keeps the arrays.
+  _document->addSceneChunk ( vertices, normals );
+}
 
-  // Feedback.
-  _document->setStatusBar ( "Counting ASCII triangles..." );
 
-  // Update progress bar every second.
-  Usul::Policies::TimeBased elapsed ( 1000 );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Scan a float. Handles what printf writes, which is all that STL files
+//  have in practice. Anything else goes to strtod. Returns the character
+//  after the number, or the start if there was no number.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-  // Make a buffer for the lines.
-  const unsigned int bufSize ( 1023 );
-  char buffer[bufSize+1];
+namespace Detail
+{
+  inline bool isSpace ( char c )
+  {
+    return ( ' ' == c ) || ( '\n' == c ) || ( '\r' == c ) || ( '\t' == c ) || ( '\v' == c ) || ( '\f' == c );
+  }
 
-  // Initialize the count.
-  unsigned int count ( 0 );
+  inline bool isDigit ( char c )
+  {
+    return ( c >= '0' ) && ( c <= '9' );
+  }
 
-  // While we're not at the end...
-  while ( !in.eof() )
+  inline const char *skipSpace ( const char *p, const char *end )
   {
-    // Get the type.
-    in.getline ( buffer, bufSize );
+    while ( ( p < end ) && ( true == Detail::isSpace ( *p ) ) )
+      ++p;
+    return p;
+  }
 
-    // If the type is a facet...
-    if ( 0 == ::strcmp ( "endfacet", buffer ) )
+  inline const char *skipToken ( const char *p, const char *end )
+  {
+    while ( ( p < end ) && ( false == Detail::isSpace ( *p ) ) )
+      ++p;
+    return p;
+  }
+
+  const char *scanFloatSlow ( const char *p, const char *end, float &value )
+  {
+    const std::string token ( p, Detail::skipToken ( p, end ) );
+    char *stop ( 0x0 );
+    value = static_cast < float > ( std::strtod ( token.c_str(), &stop ) );
+    return p + ( stop - token.c_str() );
+  }
+
+  const char *scanFloat ( const char *p, const char *end, float &value )
+  {
+    // Powers of ten that are exact in a double.
+    static const double powers[] =
     {
-      // Increment the count.
-      ++count;
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
 
-      // Show progress.
-      _document->setProgressBar ( elapsed(), in, fileSize, _caller );
+    p = Detail::skipSpace ( p, end );
+    const char *start ( p );
+
+    bool negative ( false );
+    if ( ( p < end ) && ( ( '-' == *p ) || ( '+' == *p ) ) )
+    {
+      negative = ( '-' == *p );
+      ++p;
     }
+
+    // Keep up to 19 significant digits. That is more than a float can use.
+    Usul::Types::Uint64 mantissa ( 0 );
+    unsigned int significant ( 0 );
+    int exponent ( 0 );
+    bool digits ( false );
+
+    while ( ( p < end ) && ( true == Detail::isDigit ( *p ) ) )
+    {
+      digits = true;
+      if ( significant < 19 )
+      {
+        mantissa = mantissa * 10 + ( *p - '0' );
+        significant += ( 0 != mantissa ) ? 1 : 0;
+      }
+      else
+      {
+        ++exponent;
+      }
+      ++p;
+    }
+
+    if ( ( p < end ) && ( '.' == *p ) )
+    {
+      ++p;
+      while ( ( p < end ) && ( true == Detail::isDigit ( *p ) ) )
+      {
+        digits = true;
+        if ( significant < 19 )
+        {
+          mantissa = mantissa * 10 + ( *p - '0' );
+          significant += ( 0 != mantissa ) ? 1 : 0;
+          --exponent;
+        }
+        ++p;
+      }
+    }
+
+    // Things like "nan" and "inf".
+    if ( false == digits )
+      return Detail::scanFloatSlow ( start, end, value );
+
+    if ( ( p < end ) && ( ( 'e' == *p ) || ( 'E' == *p ) ) )
+    {
+      const char *e ( p + 1 );
+      bool negativeExponent ( false );
+      if ( ( e < end ) && ( ( '-' == *e ) || ( '+' == *e ) ) )
+      {
+        negativeExponent = ( '-' == *e );
+        ++e;
+      }
+
+      // An "e" without digits is not part of the number.
+      if ( ( e < end ) && ( true == Detail::isDigit ( *e ) ) )
+      {
+        int n ( 0 );
+        while ( ( e < end ) && ( true == Detail::isDigit ( *e ) ) )
+        {
+          n = ( n < 10000 ) ? ( n * 10 + ( *e - '0' ) ) : n;
+          ++e;
+        }
+        exponent += ( negativeExponent ) ? -n : n;
+        p = e;
+      }
+    }
+
+    double v ( static_cast < double > ( mantissa ) );
+    if ( ( exponent >= 0 ) && ( exponent <= 22 ) )
+      v *= powers[exponent];
+    else if ( ( exponent < 0 ) && ( exponent >= -22 ) )
+      v /= powers[-exponent];
+    else
+      return Detail::scanFloatSlow ( start, end, value );
+
+    value = static_cast < float > ( ( negative ) ? -v : v );
+    return p;
   }
 
-  // Return the count.
-  return count;
+  inline bool tokenIs ( const char *first, const char *last, const char *word, unsigned int length )
+  {
+    return ( static_cast < unsigned int > ( last - first ) == length ) && ( 0 == std::memcmp ( first, word, length ) );
+  }
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Read the file.
+//  Find the first "facet" keyword at or after p. Returns end if there is none.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void TriangleReaderSTL::operator()()
+namespace Detail
 {
-  // Set initial progress and range.
-  _document->setProgressBar ( true, 0, 100, _caller );
+  const char *findFacet ( const char *begin, const char *p, const char *end )
+  {
+    const char *word ( "facet" );
+    while ( p < end )
+    {
+      p = std::search ( p, end, word, word + 5 );
+      if ( p == end )
+        return end;
+
+      // It has to start a token, which also rules out "endfacet".
+      const char *after ( p + 5 );
+      if ( ( ( p == begin ) || ( true == Detail::isSpace ( *( p - 1 ) ) ) ) &&
+           ( ( after == end ) || ( true == Detail::isSpace ( *after ) ) ) )
+      {
+        return p;
+      }
+      ++p;
+    }
+    return end;
+  }
+}
 
-  // Initialize start time.
-  Usul::Types::Uint64 start ( Usul::System::Clock::milliseconds() );
 
-  // Read the data.
-  if ( this->_isAscii() )
-    this->_readAscii();
-  else 
-    this->_readBinary();
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parses the facets of one piece of an ASCII file.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-  // Feedback.
-  const double total ( static_cast < double > ( Usul::System::Clock::milliseconds() - start ) * 0.001 );
-  ::printf ( "%8.4f seconds .... Time to read file.\n", total ); ::fflush ( stdout );
+namespace Detail
+{
+  typedef std::vector < osg::Vec3f > Vectors;
+
+  struct Piece
+  {
+    Piece() : first ( 0x0 ), last ( 0x0 ), vertices(), normals(){}
+    const char *first;
+    const char *last;
+    Vectors vertices;
+    Vectors normals;
+  };
+  typedef std::vector < Piece > Pieces;
+
+  struct ParseAscii
+  {
+    ParseAscii ( Pieces &pieces ) : _pieces ( &pieces )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      for ( unsigned int i = first; i < last; ++i )
+      {
+        this->_parse ( _pieces->at ( i ) );
+      }
+    }
+
+  private:
+
+    static const char *_vector ( const char *p, const char *end, osg::Vec3f &v )
+    {
+      for ( unsigned int i = 0; i < 3; ++i )
+      {
+        const char *next ( Detail::scanFloat ( p, end, v[i] ) );
+        if ( next == p )
+          throw std::runtime_error ( "Error 2613590774: Failed to read number in ASCII STL file" );
+        p = next;
+      }
+      return p;
+    }
+
+    static void _parse ( Piece &piece )
+    {
+      const char *p ( piece.first );
+      const char *end ( piece.last );
+
+      // Assume about 250 bytes per facet.
+      piece.normals.reserve ( ( end - p ) / 250 );
+      piece.vertices.reserve ( piece.normals.capacity() * 3 );
+
+      osg::Vec3f n, v[3];
+      unsigned int count ( 0 );
+
+      while ( p < end )
+      {
+        p = Detail::skipSpace ( p, end );
+        const char *token ( p );
+        p = Detail::skipToken ( p, end );
+
+        // The normal follows "facet normal".
+        if ( true == Detail::tokenIs ( token, p, "facet", 5 ) )
+        {
+          p = Detail::skipToken ( Detail::skipSpace ( p, end ), end );
+          p = ParseAscii::_vector ( p, end, n );
+          n.normalize();
+          count = 0;
+        }
+
+        // More than three vertices are ignored.
+        else if ( true == Detail::tokenIs ( token, p, "vertex", 6 ) )
+        {
+          osg::Vec3f temp;
+          p = ParseAscii::_vector ( p, end, temp );
+          if ( count < 3 )
+            v[count++] = temp;
+        }
+
+        else if ( true == Detail::tokenIs ( token, p, "endfacet", 8 ) )
+        {
+          if ( 3 == count )
+          {
+            piece.vertices.push_back ( v[0] );
+            piece.vertices.push_back ( v[1] );
+            piece.vertices.push_back ( v[2] );
+            piece.normals.push_back ( n );
+          }
+          count = 0;
+        }
+      }
+    }
+
+    Pieces *_pieces;
+  };
 }
 
 
@@ -167,72 +432,111 @@ void TriangleReaderSTL::operator()()
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void TriangleReaderSTL::_readAscii()
+void TriangleReaderSTL::_readAscii ( const MemoryMap &file )
 {
   // The document is not binary.
   _document->binary ( false );
 
-  // Count the triangles.
-  const unsigned int numTriangles ( this->_countAcsiiFacets() );
+  const char *begin ( file.begin() );
+  const char *end ( file.end() );
 
-  // Get the size of the file.
-  const Usul::Types::Uint64 fileSize ( Usul::File::size ( _file ) );
+  // Cut the file into pieces that start at a facet.
+  Detail::Pieces pieces;
+  {
+    const MemoryMap::SizeType numPieces ( std::max < MemoryMap::SizeType > ( 1, file.size() / Detail::ASCII_PIECE_SIZE ) );
+    const MemoryMap::SizeType step ( file.size() / numPieces );
+    const char *first ( Detail::findFacet ( begin, begin, end ) );
+    while ( first < end )
+    {
+      const char *guess ( ( static_cast < MemoryMap::SizeType > ( end - first ) > step ) ? first + step : end );
+      const char *last ( Detail::findFacet ( begin, guess, end ) );
+      pieces.push_back ( Detail::Piece() );
+      pieces.back().first = first;
+      pieces.back().last = last;
+      first = last;
+    }
+  }
 
-  // Open the file.
-  std::ifstream in ( _file.c_str() );
-  if ( !in.is_open() )
-    throw std::runtime_error ( "Error 1022444721: Failed to open ASCII STL file: " + _file );
+  // Parse the pieces a chunk at a time.
+  _document->setStatusBar ( "Reading ASCII triangle data..." );
+  const unsigned int numPieces ( static_cast < unsigned int > ( pieces.size() ) );
+  const unsigned int piecesPerChunk ( Detail::CHUNK_SIZE / Detail::ASCII_PIECE_SIZE );
+  for ( unsigned int first = 0; first < numPieces; first += piecesPerChunk )
+  {
+    _document->checkLoadCanceled();
 
-  // Reserve space in the document.
-  _document->setStatusBar ( "Reserving space for new triangles..." );
-  _document->reserveTriangles ( _document->numTriangles() + numTriangles );
+    const unsigned int last ( std::min ( first + piecesPerChunk, numPieces ) );
+    Usul::Algorithms::parallelFor ( first, last, 1u, Detail::ParseAscii ( pieces ) );
 
-  // Needed in the loop. Declared here for speed.
-  osg::Vec3f v0, v1, v2, n;
-  std::string type, temp;
-  type.reserve ( 1024 );
-  temp.reserve ( 1024 );
+    // Put them together in order.
+    unsigned int numTriangles ( 0 );
+    for ( unsigned int i = first; i < last; ++i )
+    {
+      numTriangles += pieces[i].normals.size();
+    }
 
-  // Feedback.
-  _document->setStatusBar ( "Reading ASCII triangle data..." );
+    osg::ref_ptr < osg::Vec3Array > vertices ( new osg::Vec3Array );
+    osg::ref_ptr < osg::Vec3Array > normals ( new osg::Vec3Array );
+    vertices->reserve ( numTriangles * 3 );
+    normals->reserve ( numTriangles );
+    for ( unsigned int i = first; i < last; ++i )
+    {
+      Detail::Piece &piece ( pieces[i] );
+      vertices->insert ( vertices->end(), piece.vertices.begin(), piece.vertices.end() );
+      normals->insert ( normals->end(), piece.normals.begin(), piece.normals.end() );
+      Detail::Vectors().swap ( piece.vertices );
+      Detail::Vectors().swap ( piece.normals );
+    }
 
-  // Update progress bar every second.
-  Usul::Policies::TimeBased elapsed ( 1000 );
+    this->_addTriangles ( vertices.get(), normals.get() );
+    _document->setProgressBar ( true, last, numPieces, _caller );
+  }
+}
 
-  // While we're not at the end...
-  while ( !in.eof() )
-  {
-    // Get the type.
-    in >> type;
 
-    // If the type is a facet...
-    if ( "facet" == type )
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Decodes a range of binary facets. A facet is the normal, three vertices,
+//  and a two-byte attribute, all little endian and packed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  struct DecodeBinary
+  {
+    DecodeBinary ( const char *facets, osg::Vec3Array &vertices, osg::Vec3Array &normals ) :
+      _facets   ( facets ),
+      _vertices ( &vertices ),
+      _normals  ( &normals )
     {
-      // Read the normal.
-      in >> temp >> n[0] >> n[1] >> n[2];
-      n.normalize();
     }
 
-    // If the type is a vertex...
-    else if ( "vertex" == type )
+    void operator () ( unsigned int first, unsigned int last ) const
     {
-      // Read all 3 vertices. Note: more than 3 will break this...
-      in >> v0[0] >> v0[1] >> v0[2] >> temp;
-      in >> v1[0] >> v1[1] >> v1[2] >> temp;
-      in >> v2[0] >> v2[1] >> v2[2];
+      float values[12];
+      for ( unsigned int i = first; i < last; ++i )
+      {
+        // The facets are not aligned.
+        std::memcpy ( values, _facets + static_cast < std::size_t > ( i ) * FACET_SIZE, sizeof ( values ) );
+        for ( unsigned int j = 0; j < 12; ++j )
+        {
+          Usul::Endian::FromLittleToSystem::convert ( values[j] );
+        }
+
+        (*_normals)[i].set ( values[0], values[1], values[2] );
+        (*_vertices)[ i * 3     ].set ( values[3], values[4],  values[5] );
+        (*_vertices)[ i * 3 + 1 ].set ( values[6], values[7],  values[8] );
+        (*_vertices)[ i * 3 + 2 ].set ( values[9], values[10], values[11] );
+      }
     }
 
-    // If this is the end of the facet...
-    else if ( "endfacet" == type )
-    {
-      // Add the triangle.  Mark as orginal.
-      OsgTools::Triangles::Triangle* t ( _document->addTriangle ( v0, v1, v2, n, false, true ) );
-      t->original ( true );
+  private:
 
-      // Show progress.
-      _document->setProgressBar ( elapsed(), in, fileSize, _caller );
-    }
-  }
+    const char *_facets;
+    osg::Vec3Array *_vertices;
+    osg::Vec3Array *_normals;
+  };
 }
 
 
@@ -242,94 +546,44 @@ void TriangleReaderSTL::_readAscii()
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void TriangleReaderSTL::_readBinary()
+void TriangleReaderSTL::_readBinary ( const MemoryMap &file )
 {
   // The document is binary.
   _document->binary ( true );
 
-  // Create a larger buffer.
-  const unsigned long int bufSize ( 50 );
-  char buffer[bufSize];
-  
-  // Set the buffer.
-  std::ifstream in;
-  in.rdbuf()->pubsetbuf ( buffer, bufSize );
-  
-  // Open the file in binary.
-  in.open ( _file.c_str(), std::ifstream::in | std::ifstream::binary );
-  
-  // Make sure it's open.
-  if ( !in.is_open() )
-    throw std::runtime_error ( "Error 3151797946: Failed to open binary STL file: " + _file );
-
-  // Skip the header.
-  in.seekg ( 80 );
-
-  // Get the total number of triangles.
+  if ( file.size() < Detail::HEADER_SIZE )
+    throw std::runtime_error ( "Error 3151797946: Binary STL file is too small: " + _file );
+
+  // Get the total number of triangles. It follows the 80-byte header.
   Usul::Types::Uint32 numTriangles ( 0 );
-  Usul::IO::Binary::ReadLittleEndian::read ( in, numTriangles );
+  std::memcpy ( &numTriangles, file.begin() + 80, sizeof ( numTriangles ) );
+  Usul::Endian::FromLittleToSystem::convert ( numTriangles );
+
+  // Make sure they are all there.
+  const MemoryMap::SizeType needed ( static_cast < MemoryMap::SizeType > ( Detail::HEADER_SIZE ) +
+                                     static_cast < MemoryMap::SizeType > ( numTriangles ) * Detail::FACET_SIZE );
+  if ( needed > file.size() )
+    throw std::runtime_error ( "Error 1397203576: Binary STL file is truncated: " + _file );
 
   // Reserve space in the document.
   _document->setStatusBar ( "Reserving space for new triangles..." );
   _document->reserveTriangles ( _document->numTriangles() + numTriangles );
 
-  // Initialize.
-  unsigned int count ( 0 );
-  std::ifstream::pos_type position ( in.tellg() );
-
-  // Update progress bar every second.
-  Usul::Policies::TimeBased elapsed ( 1000 );
-
-  // Feedback.
+  // Decode the facets a chunk at a time.
   _document->setStatusBar ( "Reading binary triangle data..." );
-
-  // Size of the facet.
-  const unsigned int size ( 50 );
-
-  // Struct to hold triangle info
-  struct Facet
+  const char *facets ( file.begin() + Detail::HEADER_SIZE );
+  const unsigned int facetsPerChunk ( Detail::CHUNK_SIZE / Detail::FACET_SIZE );
+  for ( unsigned int first = 0; first < numTriangles; first += facetsPerChunk )
   {
-    osg::Vec3 n, v0, v1, v2;
-    char p0, p1;
-  };
+    _document->checkLoadCanceled();
 
-  // While there are still facets to read...
-  while ( count < numTriangles )
-  {
-    // Read the facet.
-    Facet facet;
-    in.read( (char*) &facet, size );
-
-    // Swap v0
-    Usul::Endian::FromLittleToSystem::convert ( facet.v0[0] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v0[1] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v0[2] );
-
-    // Swap v1
-    Usul::Endian::FromLittleToSystem::convert ( facet.v1[0] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v1[1] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v1[2] );
-
-    // Swap v2
-    Usul::Endian::FromLittleToSystem::convert ( facet.v2[0] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v2[1] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.v2[2] );
-
-    // Swap normal
-    Usul::Endian::FromLittleToSystem::convert ( facet.n[0] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.n[1] );
-    Usul::Endian::FromLittleToSystem::convert ( facet.n[2] );
-
-    // Should be true.
-    position += 50;
-    USUL_ASSERT ( in.tellg() == position );
-
-    // Add the triangle.  Mark as orginal.
-    OsgTools::Triangles::Triangle *t ( _document->addTriangle ( facet.v0, facet.v1, facet.v2, facet.n, false, true ) );
-    t->original ( true );
-
-    // Show progress.
-    _document->setProgressBar ( elapsed(), count, numTriangles, _caller );
-    ++count;
+    const unsigned int count ( std::min < unsigned int > ( facetsPerChunk, numTriangles - first ) );
+    osg::ref_ptr < osg::Vec3Array > vertices ( new osg::Vec3Array ( count * 3 ) );
+    osg::ref_ptr < osg::Vec3Array > normals ( new osg::Vec3Array ( count ) );
+    Usul::Algorithms::parallelFor ( 0u, count, Detail::BINARY_GRAIN,
+                                    Detail::DecodeBinary ( facets + static_cast < std::size_t > ( first ) * Detail::FACET_SIZE, *vertices, *normals ) );
+
+    this->_addTriangles ( vertices.get(), normals.get() );
+    _document->setProgressBar ( true, first + count, numTriangles, _caller );
   }
 }
@@ -18,6 +18,8 @@
 
 #include "TriangleDocument.h"
 
+#include "Usul/File/MemoryMap.h"
+
 #include <string>
 #include <iosfwd>
 
@@ -29,6 +31,7 @@ public:
   // Typedefs.
   typedef TriangleDocument::ValidRefPtr TriangleDocumentPtr;
   typedef Usul::Interfaces::IUnknown Unknown;
+  typedef Usul::File::MemoryMap MemoryMap;
 
   // Construction/destruction.
   TriangleReaderSTL ( const std::string &file, Unknown *caller, TriangleDocument *doc );
@@ -39,12 +42,12 @@ public:
 
 protected:
 
-  bool                  _isAscii() const;
+  void                  _addTriangles ( osg::Vec3Array *vertices, osg::Vec3Array *normals );
 
-  unsigned int          _countAcsiiFacets();
+  bool                  _isAscii ( const MemoryMap &file ) const;
 
-  void                  _readAscii();
-  void                  _readBinary();
+  void                  _readAscii ( const MemoryMap &file );
+  void                  _readBinary ( const MemoryMap &file );
 
 private:
 
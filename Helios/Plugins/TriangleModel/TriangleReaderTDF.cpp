@@ -159,7 +159,7 @@ void TriangleReaderTDF::_read()
 
   // Set the progress numbers.
   _progress.first = 0;
-  _progress.second = 2 * _triangles->vertices()->size() + 2 * _indices.size();
+  _progress.second = _triangles->vertices()->size() + 2 * _indices.size();
 }
 
 
@@ -353,7 +353,8 @@ void TriangleReaderTDF::_readSortOrder ( std::ifstream &in )
   // Make sure we support the floating-point size.
   Detail::checkSizes ( in, "vertex index", sizeof ( SortOrder::value_type ), indexSize, _file );
 
-  // Read the indices.
+  // Read the indices. They are not needed now that the shared vertices are
+  // kept in index order, but older files have them.
   Detail::Read<SortOrder>::sequence ( in, "sorted vertex indices", numVertices, _sortOrder );
 }
 
@@ -644,68 +645,17 @@ void TriangleReaderTDF::_buildSharedVerticesVector()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Build the map of shared vertices.
-//  See http://gcc.gnu.org/onlinedocs/libstdc++/23_containers/howto.html#4
+//  Give the shared vertices to the triangle set.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void TriangleReaderTDF::_buildSharedVerticesMap()
 {
-  // Get the number of vertices.
-  Vertices &vertices ( *_triangles->vertices() );
-  const unsigned int numVertices ( vertices.size() );
-
-  // Use this switch to turn on/off the use of a sorted vector.
-  const bool useSortOrder ( numVertices == _sortOrder.size() );
-
-  // Shortcut to the map.
-  typedef OsgTools::Triangles::TriangleSet::SharedVertices VertexMap;
-  VertexMap &shared ( _triangles->sharedVertices() );
-
-  // Progress.
-  Usul::Policies::TimeBased update ( Detail::_milliseconds );
-
   // Feedback.
-  _document->setStatusBar ( "Building map of shared vertices..." );
-
-  // Use the sequence of sorted indices.
-  if ( useSortOrder )
-  {
-    // Loop through the vertices.
-    for ( unsigned int i = 0; i < numVertices; ++i )
-    {
-      // Get the proper index.
-      const unsigned int index ( _sortOrder[i] );
+  _document->setStatusBar ( "Indexing shared vertices..." );
 
-      // Add it to the map.
-      shared.insert ( shared.end(), VertexMap::value_type ( vertices.at ( index ), _shared.at ( index ).get() ) );
-
-      // Progress.
-      this->_incrementProgress ( update() );
-    }
-
-    // If we don't get as many as we are supposed to, do it again the long way.
-    if ( shared.size() != numVertices )
-    {
-      USUL_ASSERT ( 0 ); // Heads up.
-      _sortOrder.clear();
-      this->_buildSharedVerticesMap();
-    }
-  }
-
-  // Otherwise, insert without hinting.
-  else
-  {
-    // Loop through the vertices.
-    for ( unsigned int i = 0; i < numVertices; ++i )
-    {
-      // Add it to the map.
-      shared.insert ( VertexMap::value_type ( vertices[i], _shared[i].get() ) );
-
-      // Progress.
-      this->_incrementProgress ( update() );
-    }
-  }
+  // They are in the same order as the vertices.
+  _triangles->sharedVertices ( _shared );
 }
 
 
@@ -737,9 +687,9 @@ void TriangleReaderTDF::_buildTriangles()
     const Indices::value_type &index ( _indices[i] );
 
     // Get the shared vertices.
-    SharedVertex::ValidRefPtr &sv0 ( _shared.at ( index[0] ) );
-    SharedVertex::ValidRefPtr &sv1 ( _shared.at ( index[1] ) );
-    SharedVertex::ValidRefPtr &sv2 ( _shared.at ( index[2] ) );
+    SharedVertex *sv0 ( _shared.at ( index[0] ) );
+    SharedVertex *sv1 ( _shared.at ( index[1] ) );
+    SharedVertex *sv2 ( _shared.at ( index[2] ) );
 
     // Append new triangle to the list.
     Triangle::ValidRefPtr t ( _triangles->newTriangle ( sv0, sv1, sv2, i ) );
@@ -46,7 +46,7 @@ public:
   typedef std::vector < unsigned int > SortOrder;
   typedef OsgTools::Triangles::SharedVertex SharedVertex;
   typedef OsgTools::Triangles::Triangle Triangle;
-  typedef std::vector < SharedVertex::ValidRefPtr > SharedVertices;
+  typedef TriangleSet::SharedVertices SharedVertices;
   typedef std::vector < unsigned int > Counts;
   typedef std::pair < unsigned int, unsigned int > Progress;
 
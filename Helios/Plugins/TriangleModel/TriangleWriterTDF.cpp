@@ -89,7 +89,7 @@ void TriangleWriterTDF::operator()()
                              _document->triangleSet()->sharedVertices().size() + 
                              _document->normalsV()->size() + 
                              _document->normalsT()->size() + 
-                             _document->triangles().size() );
+                             _document->numTriangles() );
 
   // Write the header.
   {
@@ -169,7 +169,7 @@ void TriangleWriterTDF::operator()()
 
     for ( SharedVertices::const_iterator i = sv.begin(); i != sv.end(); ++i )
     {
-      WRITE_SCALAR ( static_cast < unsigned int > ( i->second->index() ) );
+      WRITE_SCALAR ( static_cast < unsigned int > ( (*i)->index() ) );
       _document->setProgressBar ( update(), count++, total, _caller );
     }
   }
@@ -246,7 +246,8 @@ void TriangleWriterTDF::operator()()
   // Write the triangles, which is just each vertex's index.
   {
     typedef TriangleDocument::TriangleVector TriangleVector;
-    const TriangleVector &triangles ( _document->triangles() );
+    const TriangleDocument &document ( *_document );
+    const TriangleVector &triangles ( document.triangles() );
     const FileFormat::Size::Sequence numTriangles ( triangles.size() );
     const FileFormat::Size::Scalar indexSize  ( sizeof ( TriangleVector::value_type::element_type::IndexType ) );
     const FileFormat::Size::Record recordSize ( sequenceSize + scalarSize + numTriangles * indexSize * 3 );
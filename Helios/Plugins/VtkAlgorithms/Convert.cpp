@@ -36,10 +36,10 @@ void Convert::polyDataToTriangleSet ( vtkPolyData *data, OsgTools::Triangles::Tr
 {
   // Typedefs
   typedef OsgTools::Triangles::SharedVertex SharedVertex;
-  typedef std::vector < SharedVertex::ValidRefPtr > SharedVertices;
+  typedef OsgTools::Triangles::TriangleSet TriangleSet;
+  typedef TriangleSet::SharedVertices SharedVertices;
   typedef std::vector < Usul::Math::Vec3ui > Indices;
   typedef std::vector < unsigned int > Counts;
-  typedef OsgTools::Triangles::TriangleSet TriangleSet;
   typedef TriangleSet::VerticesPtr::element_type Vertices;
   typedef TriangleSet::NormalsPtr::element_type Normals;
 
@@ -111,16 +111,8 @@ void Convert::polyDataToTriangleSet ( vtkPolyData *data, OsgTools::Triangles::Tr
     shared.push_back ( triangleSet->newSharedVertex ( i, counts[i] ) );
   }
 
-  // Shortcut to the map.
-  typedef TriangleSet::SharedVertices VertexMap;
-  VertexMap &sharedMap ( triangleSet->sharedVertices() );
-
-  // Build the map of shared vertices.
-  for ( unsigned int i = 0; i < numVertices; ++i )
-  {
-    // Add it to the map.
-    sharedMap.insert ( VertexMap::value_type ( vertices[i], shared[i].get() ) );
-  }
+  // Hand them to the triangle set.
+  triangleSet->sharedVertices ( shared );
 
   typedef TriangleSet::TriangleVector TriangleVector;
   typedef OsgTools::Triangles::Triangle Triangle;
@@ -137,9 +129,9 @@ void Convert::polyDataToTriangleSet ( vtkPolyData *data, OsgTools::Triangles::Tr
     const Indices::value_type &index ( indices[i] );
 
     // Get the shared vertices.
-    SharedVertex::ValidRefPtr &sv0 ( shared.at ( index[0] ) );
-    SharedVertex::ValidRefPtr &sv1 ( shared.at ( index[1] ) );
-    SharedVertex::ValidRefPtr &sv2 ( shared.at ( index[2] ) );
+    SharedVertex *sv0 ( shared.at ( index[0] ) );
+    SharedVertex *sv1 ( shared.at ( index[1] ) );
+    SharedVertex *sv2 ( shared.at ( index[2] ) );
 
     // Append new triangle to the list.
     Triangle::ValidRefPtr t ( triangleSet->newTriangle ( sv0, sv1, sv2, i ) );
@@ -188,7 +180,8 @@ void Convert::triangleSetToPolyData ( OsgTools::Triangles::TriangleSet *triangle
   tris->Allocate ( numTriangles );
 
   typedef OsgTools::Triangles::TriangleSet::TriangleVector TriangleVector;
-  TriangleVector &triangles ( triangleSet->triangles() );
+  const OsgTools::Triangles::TriangleSet &ts ( *triangleSet );
+  const TriangleVector &triangles ( ts.triangles() );
   osg::ref_ptr < osg::Vec3Array > vertices ( triangleSet->vertices() );
 
   //USUL_ASSERT ( sizeof ( osg::Vec3Array::value_type::value_type ) == sizeof ( points->GetData()->GetDataTypeSize() ) );
@@ -199,7 +192,7 @@ void Convert::triangleSetToPolyData ( OsgTools::Triangles::TriangleSet *triangle
     points->InsertNextPoint ( iter->ptr() );
   }
 
-  for ( TriangleVector::iterator iter = triangles.begin(); iter != triangles.end(); ++iter )
+  for ( TriangleVector::const_iterator iter = triangles.begin(); iter != triangles.end(); ++iter )
   {
     vtkIdType pts[3];
     pts[0] = (*iter)->vertex0()->index();
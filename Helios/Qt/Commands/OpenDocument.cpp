@@ -100,10 +100,11 @@ OpenDocument::~OpenDocument()
 ///////////////////////////////////////////////////////////////////////////////
 
 OpenDocument::Job::Job ( Document::RefPtr doc, const std::string &name, IUnknown::RefPtr caller ) : 
-  OpenDocument::Job::BaseClass( caller ),
+  OpenDocument::Job::BaseClass( caller, false ),
   _document ( doc ),
   _name     ( name ),
-  _caller   ( caller )
+  _caller   ( caller ),
+  _start    ( Usul::System::Clock::milliseconds() )
 {
   USUL_TRACE_SCOPE;
 }
@@ -205,8 +206,11 @@ void OpenDocument::_startJob ( const std::string& file )
   // Set the delegate.
   info.document->delegate ( info.delegate );
 
-  // Create and add the job to the job manager.
-  Usul::Jobs::Manager::instance().addJob ( Usul::Jobs::Job::RefPtr ( new OpenDocument::Job ( info.document, file, this->caller() ) ) );
+  // Feedback.
+  std::cout << Usul::Strings::format ( "Opening file: ", file ) << Usul::Resources::TextWindow::endl;
+
+  // The document reads and builds in its own jobs. Ours runs when they are done.
+  info.document->openAsync ( file, this->caller(), Usul::Jobs::Job::RefPtr ( new OpenDocument::Job ( info.document, file, this->caller() ) ) );
 }
 
 
@@ -249,20 +253,7 @@ void OpenDocument::Job::_started()
   if ( _document.valid() )
   {
     // Feedback.
-    std::cout << Usul::Strings::format ( "Opening file: ", _name );
-    #ifdef _DEBUG
-    //std::cout << Usul::Strings::format ( ", thread = ", this->thread()->id() );
-    #endif
-    std::cout << Usul::Resources::TextWindow::endl;
-    
-    // Initialize start time.
-    Usul::Types::Uint64 start ( Usul::System::Clock::milliseconds() );
-
-    // Lets open the document.
-    _document->open ( _name, _caller, this->progress() );
-
-    // Feedback.
-    const double seconds ( static_cast < double > ( Usul::System::Clock::milliseconds() - start ) * 0.001 );
+    const double seconds ( static_cast < double > ( Usul::System::Clock::milliseconds() - _start ) * 0.001 );
     std::cout << Usul::Strings::format ( seconds, " seconds ... Time to open ", _name ) << Usul::Resources::TextWindow::endl;
 
     // See if the caller wants to be notified when the document finishes loading.
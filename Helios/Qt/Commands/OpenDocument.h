@@ -22,6 +22,7 @@
 #include "Usul/Interfaces/ILoadFileDialog.h"
 #include "Usul/Jobs/Job.h"
 #include "Usul/Documents/Document.h"
+#include "Usul/Types/Types.h"
 
 #include <vector>
 
@@ -62,7 +63,7 @@ protected:
   OpenDocument ( const OpenDocument & );
   OpenDocument &operator = ( const OpenDocument & );
 
-  // Internal job class.
+  // Internal job class. Runs after the document's load jobs are done.
   class Job : public Usul::Jobs::Job
   {
   public:
@@ -75,6 +76,7 @@ protected:
     Document::RefPtr _document;
     std::string _name;
     IUnknown::RefPtr _caller;
+    Usul::Types::Uint64 _start;
   };
 
   FileNames                 _askForFileNames ( const std::string &title );
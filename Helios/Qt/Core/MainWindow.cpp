@@ -990,6 +990,8 @@ Usul::Interfaces::IUnknown *MainWindow::queryInterface ( unsigned long iid )
     return static_cast < Usul::Interfaces::Qt::IWorkspace* > ( this );
   case Usul::Interfaces::IGUIDelegateNotify::IID:
     return static_cast < Usul::Interfaces::IGUIDelegateNotify* > ( this );
+  case Usul::Interfaces::IScenePublished::IID:
+    return static_cast < Usul::Interfaces::IScenePublished* > ( this );
   case Usul::Interfaces::IStreamListenerChar::IID:
     return static_cast < Usul::Interfaces::IStreamListenerChar* > ( this );
   case Usul::Interfaces::IProgressBarFactory::IID:
@@ -1705,6 +1707,28 @@ void MainWindow::_notifyFinishedLoading ( Usul::Documents::Document *document )
   while ( _recentFiles.size() > maxRecentFiles )
     _recentFiles.pop_back();
 
+  // Create the GUI, unless it was made when the first part of the scene was published.
+  this->_createDefaultGUI ( document );
+
+  // Unreference.
+  // The reason for this is no longer true. -- Perry, 30-Mar-2009.
+  //document->unref();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create the document's default GUI if it does not have a window yet.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::_createDefaultGUI ( Usul::Documents::Document *document )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( 0x0 == document || document->numWindows() > 0 )
+    return;
+
   // Typedefs.
   typedef Usul::Documents::Document Document;
   typedef Document::Delegate        Delegate;
@@ -1716,10 +1740,54 @@ void MainWindow::_notifyFinishedLoading ( Usul::Documents::Document *document )
     // Create the GUI.
     delegate->createDefaultGUI ( document, this->queryInterface ( Usul::Interfaces::IUnknown::IID ) );
   }
+}
 
-  // Unreference.
-  // The reason for this is no longer true. -- Perry, 30-Mar-2009.
-  //document->unref();
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The document being loaded has something to show. Called from the loading
+//  thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::scenePublished ( Usul::Documents::Document *document, bool finished )
+{
+  USUL_TRACE_SCOPE;
+
+  // The finished load is handled by notifyDocumentFinishedLoading().
+  if ( 0x0 == document || true == finished )
+    return;
+
+  DocumentProxy proxy ( document );
+  QMetaObject::invokeMethod ( this, "_notifyDocumentScenePublished", Qt::QueuedConnection, 
+                              Q_ARG ( DocumentProxy, proxy ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the window for the document being loaded, so that the viewer can 
+//  show the scene as it comes in. This function cannot throw!
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::_notifyDocumentScenePublished ( DocumentProxy proxy )
+{
+  USUL_TRACE_SCOPE;
+
+  // If we get this far it should be the gui thread.
+  USUL_THREADS_ENSURE_GUI_THREAD ( return );
+
+  // The load may have been canceled since.
+  typedef Usul::Documents::Document Document;
+  Document::RefPtr document ( proxy.getDocument() );
+  if ( true == document.valid() && true == document->loading() )
+  {
+    Usul::Functions::safeCallV1 ( Usul::Adaptors::memberFunction ( this, &MainWindow::_createDefaultGUI ), document.get(), "2650913847" );
+  }
+
+  // Safely set the proxy's document to null.
+  Usul::Functions::safeCallV1 ( Usul::Adaptors::memberFunction ( &proxy, &DocumentProxy::setDocument ), Document::RefPtr ( 0x0 ), "3904172665" );
 }
 
 
@@ -32,6 +32,7 @@
 #include "Usul/Interfaces/IGUIDelegateNotify.h"
 #include "Usul/Interfaces/IProgressBarFactory.h"
 #include "Usul/Interfaces/IQuestion.h"
+#include "Usul/Interfaces/IScenePublished.h"
 #include "Usul/Interfaces/Qt/IMainWindow.h"
 #include "Usul/Interfaces/Qt/IWorkspace.h"
 #include "Usul/Interfaces/IQtDockWidgetMenu.h"
@@ -80,7 +81,8 @@ class HELIOS_QT_CORE_EXPORT MainWindow :
   public Usul::Interfaces::IQtDockWidgetMenu,
   public Usul::Interfaces::IActiveDocumentListener,
   public Usul::Interfaces::IActiveViewListener,
-  public Usul::Interfaces::IQuestion
+  public Usul::Interfaces::IQuestion,
+  public Usul::Interfaces::IScenePublished
 {
   Q_OBJECT
 
@@ -220,6 +222,9 @@ protected:
   // Usul::Interfaces::IGUIDelegateNotify
   virtual void                      notifyDocumentFinishedLoading ( Usul::Documents::Document* document );
 
+  // Usul::Interfaces::IScenePublished
+  virtual void                      scenePublished ( Usul::Documents::Document *document, bool finished );
+
   // Usul::Interfaces::IStreamListenerChar
   virtual void                      notify ( Usul::Interfaces::IUnknown *caller, const char *values, unsigned int numValues );
 
@@ -244,6 +249,8 @@ private slots:
 
   void                              _notifyDocumentFinishedLoading ( DocumentProxy proxy );
 
+  void                              _notifyDocumentScenePublished ( DocumentProxy proxy );
+
 private:
 
   typedef std::queue<std::string> StringQueue;
@@ -260,6 +267,7 @@ private:
   void                              _destroy();
 
   void                              _notifyFinishedLoading ( Usul::Documents::Document * );
+  void                              _createDefaultGUI ( Usul::Documents::Document * );
 
   mutable Mutex *_mutex;
   Actions _toolBarActions;
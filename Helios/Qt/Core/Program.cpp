@@ -45,6 +45,7 @@
 #include "Usul/Threads/Mutex.h"
 #include "Usul/Threads/Named.h"
 #include "Usul/Trace/Print.h"
+#include "Usul/Trace/Recorder.h"
 #include "Usul/User/Directory.h"
 
 #include "boost/concept_check.hpp"
@@ -112,6 +113,22 @@ namespace Helper
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the recorded events.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  void writeEvents ( const std::string &file )
+  {
+    Usul::Trace::Recorder::enabled ( false );
+    Usul::Trace::Recorder::write ( file );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Helper object to clean up after the application.
@@ -255,6 +272,11 @@ void Program::run ( int argc, char **argv,
   std::ofstream traceStream ( traceFile.c_str() );
   Usul::Trace::Print::stream ( &traceStream );
 
+  // Record timed events. They are written when the program ends and can be 
+  // viewed with chrome://tracing.
+  const std::string eventsFile ( persistantDir + machine + "_events.json" );
+  Usul::Trace::Recorder::enabled ( true );
+
   // Set job manager's log file.
   const std::string logFile ( persistantDir + machine + "_jobs.csv" );
   Usul::Jobs::Manager::instance().logSet ( new Usul::File::Log ( logFile, false ) );
@@ -295,6 +317,7 @@ void Program::run ( int argc, char **argv,
         {
           std::cout << "Text output: " << output << std::endl;
           std::cout << "Debug trace: " << traceFile << std::endl;
+          std::cout << "Timed events: " << eventsFile << std::endl;
           std::cout << "Settings file: " << mw.settingsFileName() << std::flush;
         }
 
@@ -319,4 +342,7 @@ void Program::run ( int argc, char **argv,
       }
     }
   }
+
+  // Write the recorded events.
+  Usul::Functions::safeCallV1 ( &Helper::writeEvents, eventsFile, "1408722516" );
 }
@@ -132,6 +132,14 @@ Delegate::QtViewer* Delegate::_makeViewer ( Usul::Documents::Document *document,
 
 void Delegate::_buildScene ( QtViewer &viewer, Usul::Documents::Document *document, Usul::Interfaces::IUnknown* caller )
 {
+  // Still loading, so show what has been read so far. The viewer builds
+  // the whole scene when the load is done.
+  if ( 0x0 != document && true == document->loading() )
+  {
+    viewer.sceneChunksAdd();
+    return;
+  }
+
   // Build the scene.
   Usul::Interfaces::IBuildScene::QueryPtr build ( document );
   if ( 0x0 != viewer.viewer() && build.valid () && 0x0 != document )
@@ -11,13 +11,16 @@
 #include "Helios/Qt/Views/OSG/Viewer.h"
 #include "Helios/Qt/Views/OSG/EditBackground.h"
 
+#include "Usul/Adaptors/MemberFunction.h"
 #include "Usul/App/Application.h"
 #include "Usul/Bits/Bits.h"
 #include "Usul/Cast/Cast.h"
 #include "Usul/Documents/Manager.h"
 #include "Usul/File/Make.h"
 #include "Usul/Functions/SafeCall.h"
+#include "Usul/Interfaces/IBuildScene.h"
 #include "Usul/Interfaces/IContextMenuAdd.h"
+#include "Usul/Interfaces/ISceneChunks.h"
 #include "Usul/Interfaces/IKeyListener.h"
 #include "Usul/Jobs/Manager.h"
 #include "Usul/Registry/Constants.h"
@@ -84,7 +87,8 @@ Viewer::Viewer ( Document *doc, const QGLFormat& format, QWidget* parent, IUnkno
   _threadId ( Usul::Threads::currentThreadId() ),
   _mutex ( new Viewer::Mutex ),
   _mouseWheelPosition ( 0 ),
-  _mouseWheelSensitivity ( Reg::instance()[Sections::VIEWER_SETTINGS]["mouse_wheel_sensitivity"].get<float> ( 5.0f, true ) )
+  _mouseWheelSensitivity ( Reg::instance()[Sections::VIEWER_SETTINGS]["mouse_wheel_sensitivity"].get<float> ( 5.0f, true ) ),
+  _chunks ( 0x0 )
 {
   USUL_TRACE_SCOPE;
   Guard guard ( this );
@@ -262,6 +266,8 @@ Usul::Interfaces::IUnknown * Viewer::queryInterface ( unsigned long iid )
     return static_cast < Usul::Interfaces::ISaveFileDialog * > ( this );
   case Usul::Interfaces::IToolBarAdd::IID:
     return static_cast < Usul::Interfaces::IToolBarAdd * > ( this );
+  case Usul::Interfaces::IScenePublished::IID:
+    return static_cast < Usul::Interfaces::IScenePublished * > ( this );
   default:
     return 0x0;
   }
@@ -964,6 +970,95 @@ void Viewer::subjectModified ( Usul::Interfaces::IUnknown * )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The document has more to show. Called from the loading thread, so hand
+//  it to the GUI thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::scenePublished ( Usul::Documents::Document *, bool finished )
+{
+  USUL_TRACE_SCOPE;
+  QMetaObject::invokeMethod ( this, "_onScenePublished", Qt::QueuedConnection, Q_ARG ( bool, finished ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Show the new chunks, or the whole scene once the load is done.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::_onScenePublished ( bool finished )
+{
+  USUL_TRACE_SCOPE;
+  USUL_THREADS_ENSURE_GUI_THREAD ( return );
+
+  if ( false == finished )
+  {
+    Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &Viewer::sceneChunksAdd ), "1189364203" );
+    return;
+  }
+
+  // Nothing to swap if we never showed chunks.
+  if ( false == _chunks.valid() )
+    return;
+  _chunks = 0x0;
+
+  Document::RefPtr document ( this->document() );
+  OsgTools::Render::Viewer::RefPtr viewer ( this->viewer() );
+  Usul::Interfaces::IBuildScene::QueryPtr build ( document );
+  if ( true == document.valid() && true == viewer.valid() && true == build.valid() )
+  {
+    viewer->scene ( build->buildScene ( document->options(), _caller ) );
+  }
+
+  this->update();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Show the document's scene chunks that are not shown yet. The chunks go
+//  under their own group, which is the scene until the load is done.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::sceneChunksAdd()
+{
+  USUL_TRACE_SCOPE;
+  USUL_THREADS_ENSURE_GUI_THREAD ( return );
+
+  Usul::Interfaces::ISceneChunks::QueryPtr chunks ( this->document() );
+  OsgTools::Render::Viewer::RefPtr viewer ( this->viewer() );
+  if ( false == chunks.valid() || false == viewer.valid() )
+    return;
+
+  if ( false == _chunks.valid() )
+  {
+    _chunks = new osg::Group;
+    viewer->scene ( _chunks.get() );
+  }
+
+  const unsigned int before ( _chunks->getNumChildren() );
+  const unsigned int num ( chunks->numSceneChunks() );
+  for ( unsigned int i = before; i < num; ++i )
+  {
+    osg::ref_ptr<osg::Node> node ( chunks->sceneChunk ( i ) );
+    if ( false == node.valid() )
+      break;
+    _chunks->addChild ( node.get() );
+  }
+
+  // Frame the first chunks we get.
+  if ( 0 == before && _chunks->getNumChildren() > 0 )
+    viewer->camera ( OsgTools::Render::Viewer::FIT );
+
+  this->update();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Get the mutex.
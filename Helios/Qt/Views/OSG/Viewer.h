@@ -25,11 +25,14 @@
 #include "Usul/Interfaces/IRedraw.h"
 #include "Usul/Interfaces/IMenuAdd.h"
 #include "Usul/Interfaces/IToolBarAdd.h"
+#include "Usul/Interfaces/IScenePublished.h"
 #include "Usul/Threads/RecursiveMutex.h"
 #include "Usul/Threads/Guard.h"
 
 #include "OsgTools/Render/Viewer.h"
 
+#include "osg/Group"
+
 #include "QtOpenGL/QGLWidget"
 
 #include <map>
@@ -53,7 +56,8 @@ class HELIOS_QT_VIEWS_OSG_EXPORT Viewer : public QGLWidget,
                                           public Usul::Interfaces::IMenuAdd,
                                           public Usul::Interfaces::IQuestion,
                                           public Usul::Interfaces::ISaveFileDialog,
-                                          public Usul::Interfaces::IToolBarAdd
+                                          public Usul::Interfaces::IToolBarAdd,
+                                          public Usul::Interfaces::IScenePublished
 {
   Q_OBJECT
 
@@ -115,6 +119,12 @@ public:
 
   /// Called when the document is modified (Usul::Interfaces::IModifiedObserver).
   virtual void                            subjectModified ( Usul::Interfaces::IUnknown *caller = 0x0 );
+
+  /// Called from the loading thread when the document has more to show (IScenePublished).
+  virtual void                            scenePublished ( Usul::Documents::Document *document, bool finished );
+
+  /// Show the document's scene chunks that are not shown yet.
+  void                                    sceneChunksAdd();
   
   virtual QSize                           sizeHint() const;
 
@@ -190,6 +200,7 @@ private slots:
   void                                    _onTimeoutSpin();
   void                                    _onTimeoutRenderLoop();
   void                                    _onContextMenuShow ( const QPoint& pos );
+  void                                    _onScenePublished ( bool finished );
 
 private:
 
@@ -205,6 +216,7 @@ private:
   mutable Mutex *_mutex;
   int _mouseWheelPosition;
   float _mouseWheelSensitivity;
+  osg::ref_ptr<osg::Group> _chunks;
 };
 
 
@@ -7,143 +7,711 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Morphology and convolution of one channel of rows x columns values.
+//
+//  Erode and dilate use a rectangle, done as a pass along the rows and then
+//  one along the columns. Each pass uses van Herk/Gil-Werman: the line is
+//  cut into pieces as long as the window, and every window is made of the
+//  end of one piece and the start of the next, so a value costs three
+//  comparisons whatever the window size. Values outside the image do not
+//  count.
+//
+//  Convolution uses two passes when the mask is the product of a column
+//  and a row, and one pass of the mask's rows otherwise. The mask is not
+//  flipped. Values outside the image are the nearest edge value.
+//
+//  Rows are split between threads with Usul::Algorithms::parallelFor. The
+//  column passes work on whole rows at a time, so their inner loops run
+//  along memory; on SSE2 the minimum and maximum of 8 and 16 bit and float
+//  values use vector instructions. If a job is given and it is canceled
+//  then the functions return false and the channel is not complete.
+//
+///////////////////////////////////////////////////////////////////////////////
+
 #ifndef __IMAGES_MORPHOLOGY_H__
 #define __IMAGES_MORPHOLOGY_H__
 
-#include "Images/Matrix.h"
+#include "Usul/Algorithms/Parallel.h"
+#include "Usul/Jobs/Job.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+# define IMAGES_MORPHOLOGY_SSE2
+# include <emmintrin.h>
+#endif
+
 
 namespace Images {
+namespace Algorithms {
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Erode the image
-//  TODO should have option on whether or not to expand the borders
+//  A convolution mask.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-template < class Image > void  erode   ( Image& image, unsigned int r, unsigned int c )
+class Mask
 {
-  // Make a copy to work from
-  Image copy ( image );
+public:
+
+  typedef std::vector < float > Weights;
+
+  Mask ( unsigned int rows, unsigned int columns, float value = 0.0f ) :
+    _rows ( rows ),
+    _columns ( columns ),
+    _weights ( rows * columns, value )
+  {
+  }
+
+  float &               operator () ( unsigned int r, unsigned int c )       { return _weights.at ( r * _columns + c ); }
+  float                 operator () ( unsigned int r, unsigned int c ) const { return _weights.at ( r * _columns + c ); }
+
+  unsigned int          rows() const { return _rows; }
+  unsigned int          columns() const { return _columns; }
 
-  const unsigned int centerX ( r/2 );
-  const unsigned int centerY ( c/2 );
+  // The weights of row r.
+  const float *         row ( unsigned int r ) const { return &_weights[r * _columns]; }
 
-  for( unsigned int i = 1; i < copy.width() - 1; ++ i )
+  // Is the mask a column times a row? If so, get them.
+  bool                  separable ( Weights &column, Weights &row ) const
   {
-    for ( unsigned int j = 1; j < copy.height() - 1; ++j )
+    if ( _weights.empty() )
+      return false;
+
+    // Use the biggest weight as the pivot.
+    unsigned int pivot ( 0 );
+    for ( unsigned int i = 1; i < _weights.size(); ++i )
+    {
+      if ( std::fabs ( _weights[i] ) > std::fabs ( _weights[pivot] ) )
+        pivot = i;
+    }
+
+    const float p ( _weights[pivot] );
+    if ( 0.0f == p )
+      return false;
+
+    const unsigned int pr ( pivot / _columns ), pc ( pivot % _columns );
+    column.resize ( _rows );
+    row.resize ( _columns );
+    for ( unsigned int r = 0; r < _rows; ++r )
+      column[r] = (*this) ( r, pc ) / p;
+    for ( unsigned int c = 0; c < _columns; ++c )
+      row[c] = (*this) ( pr, c );
+
+    const float tolerance ( 1e-5f * std::fabs ( p ) );
+    for ( unsigned int r = 0; r < _rows; ++r )
     {
-      if ( copy( i - 1, j - 1 ) == 0 &&
-           copy( i,     j - 1 ) == 0 &&
-           copy( i + 1, j - 1 ) == 0 &&
-           copy( i - 1, j )     == 0 &&
-           copy( i,     j )     == 0 &&
-           copy( i + 1, j )     == 0 &&
-           copy( i - 1, j + 1 ) == 0 &&
-           copy( i,     j + 1 ) == 0 &&
-           copy( i + 1, j + 1 ) == 0 )
+      for ( unsigned int c = 0; c < _columns; ++c )
       {
-        image( i, j ) = 0;
-        
+        if ( std::fabs ( column[r] * row[c] - (*this) ( r, c ) ) > tolerance )
+          return false;
       }
-      else
+    }
+    return true;
+  }
+
+private:
+
+  unsigned int _rows;
+  unsigned int _columns;
+  Weights _weights;
+};
+
+
+namespace Detail
+{
+  // Rows per task.
+  const unsigned int MORPHOLOGY_GRAIN ( 16 );
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Minimum and maximum of single values and of whole rows.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T > struct Min
+  {
+    static T identity()
+    {
+      return std::numeric_limits < T >::max();
+    }
+
+    static T one ( T a, T b )
+    {
+      return ( ( b < a ) ? b : a );
+    }
+
+    static void row ( const T *a, const T *b, T *out, unsigned int n )
+    {
+      for ( unsigned int i = 0; i < n; ++i )
+        out[i] = Min::one ( a[i], b[i] );
+    }
+  };
+
+  template < class T > struct Max
+  {
+    static T identity()
+    {
+      return ( ( true == std::numeric_limits < T >::is_integer ) ? std::numeric_limits < T >::min() : -std::numeric_limits < T >::max() );
+    }
+
+    static T one ( T a, T b )
+    {
+      return ( ( a < b ) ? b : a );
+    }
+
+    static void row ( const T *a, const T *b, T *out, unsigned int n )
+    {
+      for ( unsigned int i = 0; i < n; ++i )
+        out[i] = Max::one ( a[i], b[i] );
+    }
+  };
+
+
+#ifdef IMAGES_MORPHOLOGY_SSE2
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Vector rows. There is no unsigned 16 bit min or max in SSE2, so those
+  //  values are shifted into the signed range and back.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  #define IMAGES_MORPHOLOGY_ROW_SSE2(Op,Type,Width,Load,Store,Kernel)   \
+  template <> inline void Op < Type >::row ( const Type *a, const Type *b, Type *out, unsigned int n ) \
+  {                                                                     \
+    unsigned int i ( 0 );                                               \
+    for ( ; i + Width <= n; i += Width )                                \
+      Store ( out + i, Kernel ( Load ( a + i ), Load ( b + i ) ) );     \
+    for ( ; i < n; ++i )                                                \
+      out[i] = Op::one ( a[i], b[i] );                                  \
+  }
+
+  inline __m128i loadInteger ( const void *p ) { return _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( p ) ); }
+  inline void storeInteger ( void *p, __m128i v ) { _mm_storeu_si128 ( reinterpret_cast < __m128i * > ( p ), v ); }
+  inline __m128i minUint16 ( __m128i a, __m128i b )
+  {
+    const __m128i sign ( _mm_set1_epi16 ( static_cast < short > ( 0x8000 ) ) );
+    return _mm_xor_si128 ( _mm_min_epi16 ( _mm_xor_si128 ( a, sign ), _mm_xor_si128 ( b, sign ) ), sign );
+  }
+  inline __m128i maxUint16 ( __m128i a, __m128i b )
+  {
+    const __m128i sign ( _mm_set1_epi16 ( static_cast < short > ( 0x8000 ) ) );
+    return _mm_xor_si128 ( _mm_max_epi16 ( _mm_xor_si128 ( a, sign ), _mm_xor_si128 ( b, sign ) ), sign );
+  }
+
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Min, unsigned char,  16, loadInteger, storeInteger, _mm_min_epu8 )
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Max, unsigned char,  16, loadInteger, storeInteger, _mm_max_epu8 )
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Min, unsigned short,  8, loadInteger, storeInteger, minUint16 )
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Max, unsigned short,  8, loadInteger, storeInteger, maxUint16 )
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Min, float,           4, _mm_loadu_ps, _mm_storeu_ps, _mm_min_ps )
+  IMAGES_MORPHOLOGY_ROW_SSE2 ( Max, float,           4, _mm_loadu_ps, _mm_storeu_ps, _mm_max_ps )
+
+  #undef IMAGES_MORPHOLOGY_ROW_SSE2
+
+#endif
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Van Herk/Gil-Werman along one row. The scratch arrays hold n + k - 1
+  //  values each.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class Op, class T >
+  inline void vanHerkRow ( const T *in, T *out, unsigned int n, unsigned int k, T *p, T *g, T *h )
+  {
+    const unsigned int a ( k / 2 );
+    const unsigned int m ( n + k - 1 );
+
+    std::fill ( p, p + a, Op::identity() );
+    std::copy ( in, in + n, p + a );
+    std::fill ( p + a + n, p + m, Op::identity() );
+
+    // Running values from the start and from the end of each piece.
+    for ( unsigned int start = 0; start < m; start += k )
+    {
+      const unsigned int end ( std::min ( m, start + k ) );
+      g[start] = p[start];
+      for ( unsigned int i = start + 1; i < end; ++i )
+        g[i] = Op::one ( g[i - 1], p[i] );
+      h[end - 1] = p[end - 1];
+      for ( unsigned int i = end - 1; i-- > start; )
+        h[i] = Op::one ( h[i + 1], p[i] );
+    }
+
+    Op::row ( h, g + k - 1, out, n );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  The pass along the rows.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class Op, class T > struct VanHerkRows
+  {
+    VanHerkRows ( const T *in, T *out, unsigned int columns, unsigned int k ) :
+      _in ( in ), _out ( out ), _columns ( columns ), _k ( k )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      const unsigned int m ( _columns + _k - 1 );
+      std::vector < T > scratch ( 3 * m );
+      for ( unsigned int r = first; r < last; ++r )
+        Detail::vanHerkRow < Op > ( _in + r * _columns, _out + r * _columns, _columns, _k, &scratch[0], &scratch[m], &scratch[2 * m] );
+    }
+
+    const T *_in;
+    T *_out;
+    unsigned int _columns;
+    unsigned int _k;
+  };
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  The pass along the columns, a row at a time. Padded row i is input row
+  //  i - k / 2. The first part makes the running rows of each piece, the
+  //  second combines them.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class Op, class T > struct VanHerkColumns
+  {
+    VanHerkColumns ( const T *in, unsigned int rows, unsigned int columns, unsigned int k, const T *identity, T *g, T *h ) :
+      _in ( in ), _rows ( rows ), _columns ( columns ), _k ( k ), _identity ( identity ), _g ( g ), _h ( h )
+    {
+    }
+
+    const T *padded ( unsigned int i ) const
+    {
+      const unsigned int a ( _k / 2 );
+      return ( ( i < a || i - a >= _rows ) ? _identity : _in + ( i - a ) * _columns );
+    }
+
+    // Pieces [first,last).
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      const unsigned int m ( _rows + _k - 1 );
+      const unsigned int n ( _columns );
+      for ( unsigned int piece = first; piece < last; ++piece )
       {
-        image( i, j ) = 1.0;
+        const unsigned int start ( piece * _k );
+        const unsigned int end ( std::min ( m, start + _k ) );
+
+        std::copy ( this->padded ( start ), this->padded ( start ) + n, _g + start * n );
+        for ( unsigned int i = start + 1; i < end; ++i )
+          Op::row ( _g + ( i - 1 ) * n, this->padded ( i ), _g + i * n, n );
+
+        std::copy ( this->padded ( end - 1 ), this->padded ( end - 1 ) + n, _h + ( end - 1 ) * n );
+        for ( unsigned int i = end - 1; i-- > start; )
+          Op::row ( _h + ( i + 1 ) * n, this->padded ( i ), _h + i * n, n );
       }
     }
+
+    const T *_in;
+    unsigned int _rows;
+    unsigned int _columns;
+    unsigned int _k;
+    const T *_identity;
+    T *_g;
+    T *_h;
+  };
+
+  template < class Op, class T > struct VanHerkCombine
+  {
+    VanHerkCombine ( const T *g, const T *h, T *out, unsigned int columns, unsigned int k ) :
+      _g ( g ), _h ( h ), _out ( out ), _columns ( columns ), _k ( k )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      for ( unsigned int r = first; r < last; ++r )
+        Op::row ( _h + r * _columns, _g + ( r + _k - 1 ) * _columns, _out + r * _columns, _columns );
+    }
+
+    const T *_g;
+    const T *_h;
+    T *_out;
+    unsigned int _columns;
+    unsigned int _k;
+  };
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Minimum or maximum over a rectangle.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class Op, class T >
+  inline bool rectangle ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                          unsigned int kernelRows, unsigned int kernelColumns, Usul::Jobs::Job::RefPtr job )
+  {
+    if ( channel.size() < static_cast < std::size_t > ( rows ) * columns )
+      throw std::invalid_argument ( "Error 1482253076: Channel is smaller than its rows and columns" );
+
+    if ( 0 == rows || 0 == columns )
+      return true;
+
+    const std::size_t size ( static_cast < std::size_t > ( rows ) * columns );
+    std::vector < T > temp;
+    const T *source ( &channel[0] );
+
+    if ( kernelColumns > 1 )
+    {
+      temp.resize ( size );
+      if ( false == Usul::Algorithms::parallelFor ( 0u, rows, MORPHOLOGY_GRAIN, VanHerkRows < Op, T > ( &channel[0], &temp[0], columns, kernelColumns ), job ) )
+        return false;
+      source = &temp[0];
+    }
+
+    if ( kernelRows > 1 )
+    {
+      const unsigned int k ( kernelRows );
+      const unsigned int m ( rows + k - 1 );
+      const unsigned int pieces ( ( m + k - 1 ) / k );
+      const std::vector < T > identity ( columns, Op::identity() );
+      std::vector < T > g ( static_cast < std::size_t > ( m ) * columns );
+      std::vector < T > h ( g.size() );
+
+      const unsigned int grain ( std::max ( 1u, MORPHOLOGY_GRAIN / k ) );
+      if ( false == Usul::Algorithms::parallelFor ( 0u, pieces, grain, VanHerkColumns < Op, T > ( source, rows, columns, k, &identity[0], &g[0], &h[0] ), job ) )
+        return false;
+      return Usul::Algorithms::parallelFor ( 0u, rows, MORPHOLOGY_GRAIN, VanHerkCombine < Op, T > ( &g[0], &h[0], &channel[0], columns, k ), job );
+    }
+
+    if ( false == temp.empty() )
+      std::copy ( temp.begin(), temp.end(), channel.begin() );
+
+    return true;
   }
-}
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Dilate the image
-//  TODO should have option on whether or not to expand the borders
-//
-///////////////////////////////////////////////////////////////////////////////
 
-template < class Image > void  dilate  ( Image& image, unsigned int r, unsigned int c )
-{
-  // Make a copy to work from
-  Image copy ( image );
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Rounds and clamps a row of sums to the channel's type.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T > inline void convertRow ( const float *in, T *out, unsigned int n )
+  {
+    if ( true == std::numeric_limits < T >::is_integer )
+    {
+      const float low ( static_cast < float > ( std::numeric_limits < T >::min() ) );
+      const float high ( static_cast < float > ( std::numeric_limits < T >::max() ) );
+      for ( unsigned int i = 0; i < n; ++i )
+      {
+        const float v ( std::floor ( in[i] + 0.5f ) );
+        out[i] = static_cast < T > ( ( v < low ) ? low : ( ( v > high ) ? high : v ) );
+      }
+    }
+    else
+    {
+      for ( unsigned int i = 0; i < n; ++i )
+        out[i] = static_cast < T > ( in[i] );
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Add one row, convolved with the weights, to the sums. The scratch array
+  //  holds n + k - 1 values.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T >
+  inline void convolveRow ( const T *in, unsigned int n, const float *weights, unsigned int k, float *p, float *sums )
+  {
+    const unsigned int a ( k / 2 );
+    std::fill ( p, p + a, static_cast < float > ( in[0] ) );
+    for ( unsigned int i = 0; i < n; ++i )
+      p[a + i] = static_cast < float > ( in[i] );
+    std::fill ( p + a + n, p + n + k - 1, static_cast < float > ( in[n - 1] ) );
+
+    for ( unsigned int j = 0; j < k; ++j )
+    {
+      const float w ( weights[j] );
+      if ( 0.0f == w )
+        continue;
+      const float *q ( p + j );
+      for ( unsigned int x = 0; x < n; ++x )
+        sums[x] += w * q[x];
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Add rows y - k / 2 ... y - k / 2 + k - 1, scaled by the weights, to the
+  //  sums. Rows outside the image are the nearest edge row.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T >
+  inline void convolveColumn ( const T *in, unsigned int rows, unsigned int n, unsigned int y, const float *weights, unsigned int k, float *sums )
+  {
+    const int a ( static_cast < int > ( k / 2 ) );
+    for ( unsigned int i = 0; i < k; ++i )
+    {
+      const float w ( weights[i] );
+      if ( 0.0f == w )
+        continue;
+      const int r ( std::min ( std::max ( static_cast < int > ( y + i ) - a, 0 ), static_cast < int > ( rows ) - 1 ) );
+      const T *row ( in + r * n );
+      for ( unsigned int x = 0; x < n; ++x )
+        sums[x] += w * static_cast < float > ( row[x] );
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  The passes of a separable convolution.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T > struct ConvolveRows
+  {
+    ConvolveRows ( const T *in, float *out, unsigned int columns, const Mask::Weights &weights ) :
+      _in ( in ), _out ( out ), _columns ( columns ), _weights ( &weights )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      const unsigned int k ( static_cast < unsigned int > ( _weights->size() ) );
+      std::vector < float > scratch ( _columns + k - 1 );
+      for ( unsigned int r = first; r < last; ++r )
+      {
+        float *sums ( _out + r * _columns );
+        std::fill ( sums, sums + _columns, 0.0f );
+        Detail::convolveRow ( _in + r * _columns, _columns, &(*_weights)[0], k, &scratch[0], sums );
+      }
+    }
+
+    const T *_in;
+    float *_out;
+    unsigned int _columns;
+    const Mask::Weights *_weights;
+  };
+
+  template < class T > struct ConvolveColumns
+  {
+    ConvolveColumns ( const float *in, T *out, unsigned int rows, unsigned int columns, const Mask::Weights &weights ) :
+      _in ( in ), _out ( out ), _rows ( rows ), _columns ( columns ), _weights ( &weights )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      const unsigned int k ( static_cast < unsigned int > ( _weights->size() ) );
+      std::vector < float > sums ( _columns );
+      for ( unsigned int r = first; r < last; ++r )
+      {
+        std::fill ( sums.begin(), sums.end(), 0.0f );
+        Detail::convolveColumn ( _in, _rows, _columns, r, &(*_weights)[0], k, &sums[0] );
+        Detail::convertRow ( &sums[0], _out + r * _columns, _columns );
+      }
+    }
+
+    const float *_in;
+    T *_out;
+    unsigned int _rows;
+    unsigned int _columns;
+    const Mask::Weights *_weights;
+  };
 
-  const int centerX ( r/2 );
-  const int centerY ( c/2 );
 
-  for( unsigned int i = centerX; i < copy.width() - centerX; ++ i )
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  A mask that is not separable: each output row adds up every mask row
+  //  convolved with its input row.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T > struct ConvolveMask
   {
-    for ( unsigned int j = centerY; j < copy.height() - centerY; ++j )
+    ConvolveMask ( const T *in, T *out, unsigned int rows, unsigned int columns, const Mask &mask ) :
+      _in ( in ), _out ( out ), _rows ( rows ), _columns ( columns ), _mask ( &mask )
     {
-      if ( copy( i, j ) == 0 )
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      const unsigned int kr ( _mask->rows() ), kc ( _mask->columns() );
+      const int a ( static_cast < int > ( kr / 2 ) );
+      std::vector < float > scratch ( _columns + kc - 1 );
+      std::vector < float > sums ( _columns );
+      for ( unsigned int y = first; y < last; ++y )
       {
-        for( int s = -centerX; s < centerX; ++s )
+        std::fill ( sums.begin(), sums.end(), 0.0f );
+        for ( unsigned int i = 0; i < kr; ++i )
         {
-          for( int t = -centerY; t < centerY; ++t )
-          {
-            image( i + s, j + t ) = 0;
-          }
+          const int r ( std::min ( std::max ( static_cast < int > ( y + i ) - a, 0 ), static_cast < int > ( _rows ) - 1 ) );
+          Detail::convolveRow ( _in + r * _columns, _columns, _mask->row ( i ), kc, &scratch[0], &sums[0] );
         }
+        Detail::convertRow ( &sums[0], _out + y * _columns, _columns );
       }
     }
+
+    const T *_in;
+    T *_out;
+    unsigned int _rows;
+    unsigned int _columns;
+    const Mask *_mask;
+  };
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Convolve with a column times a row.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  template < class T >
+  inline bool convolveSeparable ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                                  const Mask::Weights &column, const Mask::Weights &row, Usul::Jobs::Job::RefPtr job )
+  {
+    std::vector < float > temp ( static_cast < std::size_t > ( rows ) * columns );
+    if ( false == Usul::Algorithms::parallelFor ( 0u, rows, MORPHOLOGY_GRAIN, ConvolveRows < T > ( &channel[0], &temp[0], columns, row ), job ) )
+      return false;
+    return Usul::Algorithms::parallelFor ( 0u, rows, MORPHOLOGY_GRAIN, ConvolveColumns < T > ( &temp[0], &channel[0], rows, columns, column ), job );
   }
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Convolve the image
-//  TODO should have option on whether or not to expand the borders
+//  Erode the channel: each value becomes the smallest in the rectangle
+//  around it.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-template < class Image > void  convolve  ( Image& image, const Matrix<int>& mask )
+template < class T >
+inline bool erode ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                    unsigned int kernelRows, unsigned int kernelColumns,
+                    Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
 {
-  // make a copy to work from
-  Image copy ( image );
+  return Detail::rectangle < Detail::Min < T > > ( channel, rows, columns, kernelRows, kernelColumns, job );
+}
 
-  const unsigned int centerX ( 1 );
-  const unsigned int centerY ( 1 );
 
-  // Resize the image
-  image.allocate( image.width() - centerX, image.height() - centerY, image.pixelFormat() );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Dilate the channel: each value becomes the largest in the rectangle
+//  around it.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-  for( unsigned int i = 1; i < copy.width() - 1; ++ i )
-  {
-    for ( unsigned int j = 1; j < copy.height() - 1; ++j )
-    {
-      Image::ValueType value ( 0 );
-      value += mask(0,0) * copy( i - 1, j - 1 );
-      value += mask(1,0) * copy( i,     j - 1 );
-      value += mask(2,0) * copy( i + 1, j - 1 );
+template < class T >
+inline bool dilate ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                     unsigned int kernelRows, unsigned int kernelColumns,
+                     Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
+{
+  return Detail::rectangle < Detail::Max < T > > ( channel, rows, columns, kernelRows, kernelColumns, job );
+}
 
-      value += mask(0,1) * copy( i - 1, j );
-      value += mask(1,1) * copy( i,     j );
-      value += mask(2,1) * copy( i + 1, j );
 
-      value += mask(0,2) * copy( i - 1, j + 1 );
-      value += mask(1,2) * copy( i,     j + 1 );
-      value += mask(2,2) * copy( i + 1, j + 1 );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Erode then dilate. Removes bright specks smaller than the rectangle.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-      image( i - 1, j - 1 ) = value;
-    }
-  }
+template < class T >
+inline bool open ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                   unsigned int kernelRows, unsigned int kernelColumns,
+                   Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
+{
+  return ( Images::Algorithms::erode  ( channel, rows, columns, kernelRows, kernelColumns, job ) &&
+           Images::Algorithms::dilate ( channel, rows, columns, kernelRows, kernelColumns, job ) );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Smooth image
+//  Dilate then erode. Fills dark holes smaller than the rectangle.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-template < class Image > void  smooth    ( Image& image, const Matrix<int>& mask )
+template < class T >
+inline bool close ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                    unsigned int kernelRows, unsigned int kernelColumns,
+                    Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
 {
+  return ( Images::Algorithms::dilate ( channel, rows, columns, kernelRows, kernelColumns, job ) &&
+           Images::Algorithms::erode  ( channel, rows, columns, kernelRows, kernelColumns, job ) );
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Convolve the channel with the mask. Integer results are rounded and
+//  clamped to the type's range.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T >
+inline bool convolve ( std::vector < T > &channel, unsigned int rows, unsigned int columns, const Mask &mask,
+                       Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
+{
+  if ( channel.size() < static_cast < std::size_t > ( rows ) * columns )
+    throw std::invalid_argument ( "Error 3350627818: Channel is smaller than its rows and columns" );
+
+  if ( 0 == rows || 0 == columns || 0 == mask.rows() || 0 == mask.columns() )
+    return true;
+
+  Mask::Weights column, row;
+  if ( true == mask.separable ( column, row ) )
+    return Detail::convolveSeparable ( channel, rows, columns, column, row, job );
+
+  const std::vector < T > copy ( channel );
+  return Usul::Algorithms::parallelFor ( 0u, rows, Detail::MORPHOLOGY_GRAIN, Detail::ConvolveMask < T > ( &copy[0], &channel[0], rows, columns, mask ), job );
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Smooth the channel with the average of the rectangle around each value.
+//
+///////////////////////////////////////////////////////////////////////////////
 
+template < class T >
+inline bool smooth ( std::vector < T > &channel, unsigned int rows, unsigned int columns,
+                     unsigned int kernelRows, unsigned int kernelColumns,
+                     Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ) )
+{
+  if ( channel.size() < static_cast < std::size_t > ( rows ) * columns )
+    throw std::invalid_argument ( "Error 2197466502: Channel is smaller than its rows and columns" );
 
-#endif // __IMAGES_MORPHOLOGY_H__
+  if ( 0 == rows || 0 == columns || 0 == kernelRows || 0 == kernelColumns )
+    return true;
 
+  const Mask::Weights column ( kernelRows, 1.0f / kernelRows );
+  const Mask::Weights row ( kernelColumns, 1.0f / kernelColumns );
+  return Detail::convolveSeparable ( channel, rows, columns, column, row, job );
+}
+
+
+} // namespace Algorithms
+} // namespace Images
+
+
+#endif // __IMAGES_MORPHOLOGY_H__
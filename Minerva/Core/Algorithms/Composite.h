@@ -18,19 +18,230 @@
 #include "Usul/Math/MinMax.h"
 #include "Usul/Math/Vector4.h"
 #include "Usul/Trace/Trace.h"
+#include "Usul/Types/Types.h"
 
 #include "osg/Image"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined ( __AVX2__ )
+# define MINERVA_COMPOSITE_AVX2
+# include <immintrin.h>
+#endif
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+# define MINERVA_COMPOSITE_SSE2
+# include <emmintrin.h>
+#endif
+
 namespace Minerva {
 namespace Core {
 namespace Algorithms {
 namespace Composite {
 
+namespace Detail
+{
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  The alpha table in a form that is fast to search. A bit per hash of the
+  //  color rules out almost every pixel, and the rest search sorted colors.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  class AlphaTable
+  {
+  public:
+
+    typedef Usul::Types::Uint32 Color;
+    typedef std::pair < Color, unsigned char > Entry;
+    typedef std::vector < Entry > Entries;
+
+    template < class Alphas > AlphaTable ( const Alphas &alphas ) : _bits ( FILTER_WORDS, 0 ), _entries()
+    {
+      _entries.reserve ( alphas.size() );
+      for ( typename Alphas::const_iterator i = alphas.begin(); i != alphas.end(); ++i )
+      {
+        const Color color ( static_cast < Color > ( i->first ) );
+        _entries.push_back ( Entry ( color, static_cast < unsigned char > ( i->second ) ) );
+        const Color h ( AlphaTable::_hash ( color ) );
+        _bits[h >> 5] |= ( 1u << ( h & 31 ) );
+      }
+      std::sort ( _entries.begin(), _entries.end() );
+    }
+
+    bool empty() const
+    {
+      return _entries.empty();
+    }
+
+    bool find ( Color color, unsigned char &alpha ) const
+    {
+      const Color h ( AlphaTable::_hash ( color ) );
+      if ( 0 == ( _bits[h >> 5] & ( 1u << ( h & 31 ) ) ) )
+        return false;
+
+      Entries::const_iterator i ( std::lower_bound ( _entries.begin(), _entries.end(), Entry ( color, 0 ) ) );
+      if ( ( _entries.end() == i ) || ( color != i->first ) )
+        return false;
+
+      alpha = i->second;
+      return true;
+    }
+
+  private:
+
+    enum { FILTER_BITS = 12, FILTER_WORDS = ( 1 << FILTER_BITS ) / 32 };
+
+    static Color _hash ( Color color )
+    {
+      return ( ( color >> 8 ) * 2654435761u ) >> ( 32 - FILTER_BITS );
+    }
+
+    std::vector < Color > _bits;
+    Entries _entries;
+  };
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  //
+  //  Blend a row of colors into the destination, which is RGBA. Each color
+  //  is RGBx with its weight in [0,ONE]. A weight of ONE copies the color.
+  //  Pixels with a weight above zero become opaque. The blend is in 16-bit
+  //  integers, dst * ( ONE - w ) + src * w never needs more than 16 bits,
+  //  so the kernels give the same bytes on every compiler and machine.
+  //
+  ///////////////////////////////////////////////////////////////////////////
+
+  typedef Usul::Types::Uint16 Weight;
+  enum { WEIGHT_BITS = 8, ONE = ( 1 << WEIGHT_BITS ) };
+
+  inline void blendScalar ( unsigned char *dst, const unsigned char *src, const Weight *weights, unsigned int num )
+  {
+    for ( unsigned int i = 0; i < num; ++i )
+    {
+      const unsigned int a ( weights[i] );
+      const unsigned int b ( ONE - a );
+
+      dst[0] = static_cast < unsigned char > ( ( dst[0] * b + src[0] * a ) >> WEIGHT_BITS );
+      dst[1] = static_cast < unsigned char > ( ( dst[1] * b + src[1] * a ) >> WEIGHT_BITS );
+      dst[2] = static_cast < unsigned char > ( ( dst[2] * b + src[2] * a ) >> WEIGHT_BITS );
+
+      // Since the alpha has been accounted for above, make the pixel completely opaque.
+      if ( a > 0 )
+        dst[3] = 255;
+
+      dst += 4;
+      src += 4;
+    }
+  }
+
+#ifdef MINERVA_COMPOSITE_SSE2
+
+  // Four pixels at a time, two in each half.
+  inline void blendSSE2 ( unsigned char *dst, const unsigned char *src, const Weight *weights, unsigned int num )
+  {
+    const __m128i zero ( _mm_setzero_si128() );
+    const __m128i one ( _mm_set1_epi16 ( ONE ) );
+    const __m128i alphaMask ( _mm_set1_epi32 ( 0xFF000000 ) );
+
+    unsigned int i ( 0 );
+    for ( ; i + 4 <= num; i += 4, dst += 16, src += 16 )
+    {
+      const __m128i d ( _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( dst ) ) );
+      const __m128i s ( _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( src ) ) );
+      const __m128i w ( _mm_loadl_epi64 ( reinterpret_cast < const __m128i * > ( weights + i ) ) );
+
+      // Each weight for all four channels of its pixel.
+      const __m128i pairs ( _mm_unpacklo_epi16 ( w, w ) );
+      const __m128i wLow ( _mm_unpacklo_epi32 ( pairs, pairs ) ), wHigh ( _mm_unpackhi_epi32 ( pairs, pairs ) );
+
+      const __m128i dLow ( _mm_unpacklo_epi8 ( d, zero ) ), dHigh ( _mm_unpackhi_epi8 ( d, zero ) );
+      const __m128i sLow ( _mm_unpacklo_epi8 ( s, zero ) ), sHigh ( _mm_unpackhi_epi8 ( s, zero ) );
+
+      const __m128i low  ( _mm_srli_epi16 ( _mm_add_epi16 ( _mm_mullo_epi16 ( dLow,  _mm_sub_epi16 ( one, wLow  ) ), _mm_mullo_epi16 ( sLow,  wLow  ) ), WEIGHT_BITS ) );
+      const __m128i high ( _mm_srli_epi16 ( _mm_add_epi16 ( _mm_mullo_epi16 ( dHigh, _mm_sub_epi16 ( one, wHigh ) ), _mm_mullo_epi16 ( sHigh, wHigh ) ), WEIGHT_BITS ) );
+      __m128i result ( _mm_packus_epi16 ( low, high ) );
+
+      // The alpha is opaque where the weight is above zero, or unchanged.
+      const __m128i opaque ( _mm_cmpgt_epi32 ( _mm_unpacklo_epi16 ( w, zero ), zero ) );
+      const __m128i alpha ( _mm_or_si128 ( _mm_and_si128 ( opaque, alphaMask ), _mm_andnot_si128 ( opaque, _mm_and_si128 ( d, alphaMask ) ) ) );
+      result = _mm_or_si128 ( _mm_andnot_si128 ( alphaMask, result ), alpha );
+
+      _mm_storeu_si128 ( reinterpret_cast < __m128i * > ( dst ), result );
+    }
+
+    Detail::blendScalar ( dst, src, weights + i, num - i );
+  }
+
+#endif
+
+#ifdef MINERVA_COMPOSITE_AVX2
+
+  // Eight pixels at a time, widened four pixels at a time.
+  inline void blendAVX2 ( unsigned char *dst, const unsigned char *src, const Weight *weights, unsigned int num )
+  {
+    const __m256i zero ( _mm256_setzero_si256() );
+    const __m256i one ( _mm256_set1_epi16 ( ONE ) );
+    const __m256i alphaMask ( _mm256_set1_epi32 ( 0xFF000000 ) );
+
+    // Copies the weight at the bottom of each 64 bits to all four 16-bit channels.
+    const __m256i spread ( _mm256_setr_epi8 ( 0, 1, 0, 1, 0, 1, 0, 1, 8, 9, 8, 9, 8, 9, 8, 9,
+                                              0, 1, 0, 1, 0, 1, 0, 1, 8, 9, 8, 9, 8, 9, 8, 9 ) );
+
+    unsigned int i ( 0 );
+    for ( ; i + 8 <= num; i += 8, dst += 32, src += 32 )
+    {
+      __m256i p[2];
+      for ( unsigned int j = 0; j < 2; ++j )
+      {
+        const __m256i d ( _mm256_cvtepu8_epi16 ( _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( dst + 16 * j ) ) ) );
+        const __m256i s ( _mm256_cvtepu8_epi16 ( _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( src + 16 * j ) ) ) );
+        const __m256i w ( _mm256_shuffle_epi8 ( _mm256_cvtepu16_epi64 ( _mm_loadl_epi64 ( reinterpret_cast < const __m128i * > ( weights + i + 4 * j ) ) ), spread ) );
+        p[j] = _mm256_srli_epi16 ( _mm256_add_epi16 ( _mm256_mullo_epi16 ( d, _mm256_sub_epi16 ( one, w ) ), _mm256_mullo_epi16 ( s, w ) ), WEIGHT_BITS );
+      }
+
+      // The pack works within each half, which leaves the pixel pairs in the order 0 2 1 3.
+      __m256i result ( _mm256_permute4x64_epi64 ( _mm256_packus_epi16 ( p[0], p[1] ), 0xD8 ) );
+
+      // The alpha is opaque where the weight is above zero, or unchanged.
+      const __m256i d ( _mm256_loadu_si256 ( reinterpret_cast < const __m256i * > ( dst ) ) );
+      const __m256i w ( _mm256_cvtepu16_epi32 ( _mm_loadu_si128 ( reinterpret_cast < const __m128i * > ( weights + i ) ) ) );
+      const __m256i opaque ( _mm256_cmpgt_epi32 ( w, zero ) );
+      const __m256i alpha ( _mm256_blendv_epi8 ( _mm256_and_si256 ( d, alphaMask ), alphaMask, opaque ) );
+      result = _mm256_or_si256 ( _mm256_andnot_si256 ( alphaMask, result ), alpha );
+
+      _mm256_storeu_si256 ( reinterpret_cast < __m256i * > ( dst ), result );
+    }
+
+    Detail::blendScalar ( dst, src, weights + i, num - i );
+  }
+
+#endif
+
+  // Use the widest kernel this was compiled for.
+  inline void blend ( unsigned char *dst, const unsigned char *src, const Weight *weights, unsigned int num )
+  {
+#if defined ( MINERVA_COMPOSITE_AVX2 )
+    Detail::blendAVX2 ( dst, src, weights, num );
+#elif defined ( MINERVA_COMPOSITE_SSE2 )
+    Detail::blendSSE2 ( dst, src, weights, num );
+#else
+    Detail::blendScalar ( dst, src, weights, num );
+#endif
+  }
+}
+
   
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Composite two raster images.
 //
+//  Each row finds the color and weight of its pixels, using tables for the
+//  brightness and alphas, then blends them all at once. The job is checked
+//  once per row, and compositing stops if it was canceled.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 template < class Alphas >
@@ -52,71 +263,77 @@ inline void raster ( osg::Image& result, const osg::Image& image, const Alphas &
   // We only composite images of the same size.
   if ( ( static_cast<int> ( width ) != image.s() ) || ( static_cast<int> ( height ) != image.t() ) )
     return;
+
+  if ( ( 0 == width ) || ( 0 == height ) )
+    return;
   
-  const unsigned int size ( width * height );
-  const bool alphaMapEmpty ( alphas.empty() );
-  bool hasExtraAlpha ( false );
-  typename Alphas::const_iterator iter ( alphas.end() );
+  const Detail::AlphaTable table ( alphas );
+  const bool alphaMapEmpty ( table.empty() );
   
   const bool hasOverallAlpha ( alpha < 1.0f );
   
   const bool hasAlpha ( GL_RGBA == format );
   const unsigned int offset ( ( hasAlpha ) ? 4 : 3 );
 
-  for ( unsigned int i = 0; i < size; ++i )
+  // If the image is competely opaque, the colors not in the alpha table are copied.
+  const bool opaque ( ( false == hasAlpha ) && ( false == hasOverallAlpha ) );
+
+  // Tables for what used to be calculated for each pixel. The float has to
+  // come first in the multiplications. An alpha of 255 is a weight of one.
+  unsigned char brightnessTable[256];
+  unsigned char overallTable[256];
+  Detail::Weight weightTable[256];
+  for ( unsigned int i = 0; i < 256; ++i )
+  {
+    brightnessTable[i] = static_cast < unsigned char > ( brightness * i );
+    overallTable[i] = static_cast < unsigned char > ( alpha * i );
+    weightTable[i] = static_cast < Detail::Weight > ( ( i * Detail::ONE + 127 ) / 255 );
+  }
+
+  std::vector < unsigned char > colors ( width * 4, 0 );
+  std::vector < Detail::Weight > weights ( width, 0 );
+
+  for ( unsigned int row = 0; row < height; ++row )
   {
     // Have we been cancelled?
-    if ( 0 == ( i % 10 ) )
+    if ( ( 0x0 != job ) && ( true == job->canceled() ) )
+      return;
+
+    unsigned char *color ( &colors[0] );
+    for ( unsigned int i = 0; i < width; ++i, src += offset, color += 4 )
     {
-      if ( ( 0x0 != job ) && ( true == job->canceled() ) )
-        job->cancel();
-    }
+      // Copy the color channels. Multiply by the overall (normalized) brightness.
+      const unsigned char r ( brightnessTable[src[0]] );
+      const unsigned char g ( brightnessTable[src[1]] );
+      const unsigned char b ( brightnessTable[src[2]] );
+      color[0] = r;
+      color[1] = g;
+      color[2] = b;
 
-    // Copy the color channels. Multiply by the overall (normalized) brightness.
-    // The order of the variables is important; the float has to come first.
-    unsigned char r ( static_cast<unsigned char> ( brightness * src[0] ) );
-    unsigned char g ( static_cast<unsigned char> ( brightness * src[1] ) );
-    unsigned char b ( static_cast<unsigned char> ( brightness * src[2] ) );
+      // Is the color in the alpha table?
+      unsigned char extraAlpha ( 0 );
+      const bool hasExtraAlpha ( ( false == alphaMapEmpty ) && ( true == table.find ( Usul::Functions::Color::pack ( r, g, b, 0 ), extraAlpha ) ) );
 
-    // Is the color in the alpha table?
-    if ( false == alphaMapEmpty )
-    {
-      iter = alphas.find ( Usul::Functions::Color::pack ( r, g, b, 0 ) );
-      hasExtraAlpha = ( alphas.end() != iter );
-    }
+      if ( ( true == opaque ) && ( false == hasExtraAlpha ) )
+      {
+        weights[i] = Detail::ONE;
+      }
+      else
+      {
+        // Get the current alpha.
+        const unsigned char currentAlpha ( hasAlpha ? src[3] : 255 );
 
-    // If the image is competely opaque then set the values.
-    if ( ( false == hasAlpha ) && ( false == hasExtraAlpha ) && ( false == hasOverallAlpha ) )
-    {
-      dst[0] = r;
-      dst[1] = g;
-      dst[2] = b;
-      dst[3] = 255;
-    }
-    else
-    {
-      // Get the current alpha.
-      const unsigned char currentAlpha ( hasAlpha ? src[3] : 255 );
-      
-      // Get correct alpha.
-      const unsigned char useThisAlpha ( ( hasExtraAlpha )   ? ( static_cast < unsigned char > ( iter->second ) ) : 
-                                       ( ( hasOverallAlpha ) ? ( static_cast < unsigned char > ( alpha * currentAlpha ) ) : ( currentAlpha ) ) );
-      
-      // Normalize between zero and one.
-      const float a ( static_cast < float > ( useThisAlpha ) / 255.5f );
-      
-      // Composite.
-      dst[0] = static_cast < unsigned char > ( dst[0] * ( 1 - a ) + ( r * a ) );
-      dst[1] = static_cast < unsigned char > ( dst[1] * ( 1 - a ) + ( g * a ) );
-      dst[2] = static_cast < unsigned char > ( dst[2] * ( 1 - a ) + ( b * a ) );
-      
-      // Since the alpha has been accounted for above, make the pixel completely opaque.
-      if ( a > 0.0 )
-        dst[3] = 255;
+        // Get correct alpha.
+        const unsigned char useThisAlpha ( ( hasExtraAlpha )   ? ( extraAlpha ) :
+                                         ( ( hasOverallAlpha ) ? ( overallTable[currentAlpha] ) : ( currentAlpha ) ) );
+
+        // Normalize between zero and one.
+        weights[i] = weightTable[useThisAlpha];
+      }
     }
 
-    dst += 4;
-    src += offset;
+    Detail::blend ( dst, &colors[0], &weights[0], width );
+    dst += width * 4;
   }
 }
 
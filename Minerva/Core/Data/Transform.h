@@ -118,6 +118,21 @@ public:
   }
   
   
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Transform arrays of coordinates in one call.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+  
+  void operator() ( unsigned int count, double *x, double *y, double *z ) const
+  {
+    if ( 0x0 != _transform && count > 0 )
+    {
+      _transform->Transform ( count, x, y, z );
+    }
+  }
+  
+  
   ///////////////////////////////////////////////////////////////////////////////
   //
   //  Return well known text for wgs 84.
@@ -85,11 +85,15 @@ void BuildTiles::_started()
   
   // Have we been cancelled?
   if ( true == this->canceled() )
-    this->cancel();
+    return;
 
   // Ask the tile to split.
   _tile->split ( Usul::Jobs::Job::RefPtr ( this ) );
 
+  // The tile does not keep children that were built after a cancel.
+  if ( true == this->canceled() )
+    return;
+
   // If we get to here it worked.
   Usul::Threads::Safe::set ( this->mutex(), true, _success );
 }
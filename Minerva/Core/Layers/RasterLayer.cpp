@@ -24,6 +24,7 @@
 #include "Usul/Functions/SafeCall.h"
 #include "Usul/Jobs/Job.h"
 #include "Usul/Predicates/FileExists.h"
+#include "Usul/Registry/Database.h"
 #include "Usul/Scope/Caller.h"
 #include "Usul/Strings/Split.h"
 #include "Usul/Threads/ThreadId.h"
@@ -57,6 +58,8 @@ RasterLayer::RasterLayer() :
   _alphas(),
   _alpha ( 1.0f ),
   _cacheDir ( RasterLayer::defaultCacheDirectory() ),
+  _cachePacking ( -1 ),
+  _packedTiles ( 0x0 ),
   _reader ( 0x0 ),
   _log ( 0x0 ),
   _levelRange ( 0, std::numeric_limits<unsigned int>::max() )
@@ -81,6 +84,8 @@ RasterLayer::RasterLayer ( const RasterLayer& rhs ) : BaseClass ( rhs ),
   _alphas ( rhs._alphas ),
   _alpha ( rhs._alpha ),
   _cacheDir ( rhs._cacheDir ),
+  _cachePacking ( rhs._cachePacking ),
+  _packedTiles ( rhs._packedTiles ),
   _reader ( rhs._reader ),
   _log ( rhs._log ),
   _levelRange ( rhs._levelRange )
@@ -99,6 +104,7 @@ RasterLayer::~RasterLayer()
 {
   _alphas.clear();
   _cacheDir.clear();
+  _packedTiles = 0x0;
   _reader = 0x0;
   _log = 0x0;
 }
@@ -316,11 +322,28 @@ void RasterLayer::baseCacheDirectory ( const std::string& dir, bool makeDefault
   USUL_TRACE_SCOPE;
   Guard guard ( this );
   
+  // See if the tiles go in one file.
+  std::string directory ( dir );
+  int packing ( -1 );
+  const std::string packed ( "pack:" ), raw ( "pack-raw:" );
+  if ( 0 == directory.compare ( 0, packed.size(), packed ) )
+  {
+    directory.erase ( 0, packed.size() );
+    packing = PackedTileCache::FAST;
+  }
+  else if ( 0 == directory.compare ( 0, raw.size(), raw ) )
+  {
+    directory.erase ( 0, raw.size() );
+    packing = PackedTileCache::RAW;
+  }
+
   // Only set the directory if it's not empty.
-  if ( false == dir.empty() )
+  if ( false == directory.empty() )
   {
     // Set the directory.
-    _cacheDir = dir;
+    _cacheDir = directory;
+    _cachePacking = packing;
+    _packedTiles = 0x0;
 
     // Make it the default if we should.
     if ( makeDefault )
@@ -329,6 +352,73 @@ void RasterLayer::baseCacheDirectory ( const std::string& dir, bool makeDefault
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Are the tiles cached in one file?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool RasterLayer::cachePacked() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return ( _cachePacking >= 0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the file that the tiles are cached in. Opens it the first time.
+//  Returns null if the tiles are cached in separate files or if the file
+//  could not be opened.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+RasterLayer::PackedTileCache::RefPtr RasterLayer::_packedCache()
+{
+  USUL_TRACE_SCOPE;
+
+  int packing ( -1 );
+  {
+    Guard guard ( this );
+    if ( true == _packedTiles.valid() )
+      return _packedTiles;
+    packing = _cachePacking;
+  }
+
+  if ( packing < 0 )
+    return PackedTileCache::RefPtr ( 0x0 );
+
+  const std::string cacheDir ( this->_cacheDirectory() );
+  if ( true == cacheDir.empty() )
+    return PackedTileCache::RefPtr ( 0x0 );
+
+  const unsigned int megabytes ( Usul::Registry::Database::instance()["raster_layer"]["packed_cache"]["max_megabytes"].get<unsigned int> ( 2048, true ) );
+  const PackedTileCache::SizeType maxBytes ( static_cast < PackedTileCache::SizeType > ( megabytes ) * 1024 * 1024 );
+  const std::string file ( Usul::Strings::format ( cacheDir, "tiles.pack" ) );
+
+  // Opening reads the whole file and may compact it, so don't hold the lock.
+  // Layers that open the same file at once get the same cache.
+  PackedTileCache::RefPtr cache ( 0x0 );
+  try
+  {
+    Usul::File::make ( cacheDir );
+    cache = PackedTileCache::open ( file, maxBytes, static_cast < PackedTileCache::Compression > ( packing ) );
+  }
+  catch ( const std::exception &e )
+  {
+    this->_logEvent ( Usul::Strings::format ( "Error 2245961705: Could not open packed tile cache: ", file, ". Reason: ", ( ( 0x0 != e.what() ) ? e.what() : "unknown" ) ) );
+    return PackedTileCache::RefPtr ( 0x0 );
+  }
+
+  // Keep it unless the cache directory changed while it was opening.
+  Guard guard ( this );
+  if ( ( false == _packedTiles.valid() ) && ( packing == _cachePacking ) && ( cacheDir == this->_cacheDirectory() ) )
+    _packedTiles = cache;
+  return cache;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Get the texture.
@@ -342,6 +432,13 @@ RasterLayer::ImagePtr RasterLayer::texture ( const Extents& extents, unsigned in
   // See if the job has been cancelled.
   RasterLayer::_checkForCanceledJob ( job );
 
+  // Look in the one file if we should.
+  if ( true == this->cachePacked() )
+  {
+    PackedTileCache::RefPtr cache ( this->_packedCache() );
+    return ( ( true == cache.valid() ) ? cache->find ( extents, width, height, level ) : ImagePtr ( 0x0 ) );
+  }
+
   // Make the file name.
   std::string file;
   if ( CACHE_STATUS_FILE_OK == this->_getAndCheckCacheFilename ( extents, width, height, level, file ) )
@@ -625,6 +722,15 @@ void RasterLayer::_writeImageToCache ( const Extents& extents, unsigned int widt
   if ( false == image.valid() )
     return;
 
+  // Put it in the one file if we should.
+  if ( true == this->cachePacked() )
+  {
+    PackedTileCache::RefPtr cache ( this->_packedCache() );
+    if ( true == cache.valid() )
+      cache->insert ( extents, width, height, level, *image );
+    return;
+  }
+
   // Build the file name.
   std::string cacheFile ( this->_cacheFileName ( extents, width, height, level ) );
 
@@ -14,6 +14,7 @@
 #include "Minerva/Core/Export.h"
 #include "Minerva/Core/Extents.h"
 #include "Minerva/Core/Data/Feature.h"
+#include "Minerva/Core/Utilities/PackedTileCache.h"
 #include "Minerva/Interfaces/ITileElevationData.h"
 
 #include "Serialize/XML/Macros.h"
@@ -65,6 +66,7 @@ public:
   typedef IReadImageFile::RefPtr ReaderPtr;
   typedef Usul::Interfaces::ILog::RefPtr LogPtr;
   typedef Minerva::Interfaces::IElevationData IElevationData;
+  typedef Minerva::Core::Utilities::PackedTileCache PackedTileCache;
 
   USUL_DECLARE_QUERY_POINTERS ( RasterLayer );
   
@@ -81,10 +83,14 @@ public:
   virtual Alphas        alphas() const;
   virtual void          alphas ( const Alphas& alphas );
     
-  /// Get/set the cache directory.
+  /// Get/set the cache directory. Start it with "pack:" to keep the tiles
+  /// in one compressed file, or with "pack-raw:" for one uncompressed file.
   void                  baseCacheDirectory ( const std::string& dir, bool makeDefault = false );
   std::string           baseCacheDirectory() const;
 
+  /// Are the tiles cached in one file?
+  bool                  cachePacked() const;
+
   // Clone this layer.
   virtual IUnknown*     clone() const = 0;
 
@@ -144,6 +150,7 @@ protected:
   virtual std::string   _cacheFileExtension() const;
   virtual std::string   _cacheFileName( const Extents& extents, unsigned int width, unsigned int height, unsigned int level ) const;
   static void           _checkForCanceledJob ( Usul::Jobs::Job *job );
+  PackedTileCache::RefPtr _packedCache();
   virtual ImagePtr      _createBlankImage ( unsigned int width, unsigned int height ) const;
 
   static std::size_t    _hashString ( const std::string &s );
@@ -174,6 +181,8 @@ private:
   Alphas _alphas;
   float _alpha;
   std::string _cacheDir;
+  int _cachePacking;
+  PackedTileCache::RefPtr _packedTiles;
   IReadImageFile::RefPtr _reader;
   LogPtr _log;
   Usul::Math::Vec2ui _levelRange;
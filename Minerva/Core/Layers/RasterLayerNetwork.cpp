@@ -298,6 +298,14 @@ RasterLayerNetwork::ImagePtr RasterLayerNetwork::texture ( const Extents& extent
     return ImagePtr ( 0x0 );
   }
 
+  // Move it into the one file if we should.
+  if ( true == this->cachePacked() )
+  {
+    this->_writeImageToCache ( extents, width, height, level, image );
+    Usul::File::remove ( file, false, 0x0 );
+    return image;
+  }
+
   // Set the file name and return.
   image->setFileName ( file );
   return image;
@@ -84,6 +84,8 @@ Body::Body ( LandModel *land, Usul::Jobs::Manager *manager, const MeshSize &ms,
   _elevation ( new ElevationGroup ),
   _vectorData ( new VectorGroup ),
   _manager ( manager ),
+  _requests ( new RequestScheduler ( Usul::Registry::Database::instance()["max_tile_requests_in_flight"].get<unsigned int> ( 4, true ) ) ),
+  _requestCallback ( 0x0 ),
   _maxLevel ( 50 ),
   _cacheTiles ( false ),
   _splitDistance ( splitDistance ),
@@ -141,6 +143,10 @@ Body::Body ( LandModel *land, Usul::Jobs::Manager *manager, const MeshSize &ms,
   graphic->getOrCreateStateSet()->setRenderBinDetails ( VECTOR_RENDER_BIN_NUMBER, "RenderBin" );
   _transform->addChild ( graphic.get() );
 
+  // Hand out the tile requests after the tiles are culled.
+  _requestCallback = new RequestCallback ( this );
+  _transform->setCullCallback ( _requestCallback.get() );
+
 #if 0
   // Make the sky.
   _sky = new Minerva::Core::Utilities::Atmosphere;
@@ -220,6 +226,15 @@ void Body::clear()
 
   _splitCallback = 0x0;
 
+  Helper::safeClear ( _requests );
+
+  // The scene may outlive this body.
+  if ( _requestCallback.valid() )
+  {
+    _requestCallback->_body = 0x0;
+    _requestCallback = 0x0;
+  }
+
   Usul::Functions::executeMemberFunctions ( _topTiles,    &Tile::clear, true ); _topTiles.clear();
   Usul::Functions::executeMemberFunctions ( _deleteTiles, &Tile::clear, true ); _deleteTiles.clear();
 
@@ -673,12 +688,93 @@ Minerva::Core::Jobs::BuildRaster::RefPtr Body::textureRequest ( Tile* tile )
   }
 
   BuildRaster::RefPtr job ( new BuildRaster ( Tile::RefPtr ( tile ) ) );
-  this->jobManager()->addJob ( job.get() );
+  _requests->add ( job.get(), tile, RequestScheduler::TEXTURE );
 
   return job;
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Request child tiles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Body::tilesRequest ( Usul::Jobs::Job::RefPtr job, Tile *tile )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  _requests->add ( job, tile, RequestScheduler::TILES );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget the texture or tile request.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Body::requestRemove ( Usul::Jobs::Job::RefPtr job )
+{
+  USUL_TRACE_SCOPE;
+
+  RequestScheduler::RefPtr requests ( Usul::Threads::Safe::get ( this->mutex(), _requests ) );
+  if ( true == requests.valid() )
+    requests->remove ( job );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The tile was seen with this score in this frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Body::requestScore ( Tile *tile, double score )
+{
+  USUL_TRACE_SCOPE;
+
+  RequestScheduler::RefPtr requests ( Usul::Threads::Safe::get ( this->mutex(), _requests ) );
+  if ( true == requests.valid() )
+    requests->visible ( tile, score );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Hand the waiting requests of the tiles seen in this frame to the job
+//  manager.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Body::requestUpdate ( unsigned int frame )
+{
+  USUL_TRACE_SCOPE;
+
+  RequestScheduler::RefPtr requests ( Usul::Threads::Safe::get ( this->mutex(), _requests ) );
+  if ( true == requests.valid() )
+    requests->update ( frame, this->jobManager() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cull the tiles, then hand out the requests of the ones that were seen.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Body::RequestCallback::operator() ( osg::Node *node, osg::NodeVisitor *nv )
+{
+  this->traverse ( node, nv );
+
+  if ( ( 0x0 != _body ) && ( 0x0 != nv ) && ( osg::NodeVisitor::CULL_VISITOR == nv->getVisitorType() ) )
+  {
+    _body->requestUpdate ( nv->getTraversalNumber() );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Get the maximum level.
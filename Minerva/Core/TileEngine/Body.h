@@ -19,6 +19,7 @@
 
 #include "Minerva/Core/Macros.h"
 #include "Minerva/Core/TileEngine/LandModel.h"
+#include "Minerva/Core/TileEngine/RequestScheduler.h"
 #include "Minerva/Core/TileEngine/SplitCallbacks.h"
 #include "Minerva/Core/TileEngine/Tile.h"
 #include "Minerva/Core/TileEngine/Typedefs.h"
@@ -188,6 +189,16 @@ public:
   // Get the rasters.
   void                      rasters ( Rasters& rasters ) const;
 
+  // Forget the texture or tile request. Does not cancel it.
+  void                      requestRemove ( Usul::Jobs::Job::RefPtr );
+
+  // The tile was seen with this score in this frame.
+  void                      requestScore ( Tile *, double score );
+
+  // Hand the waiting requests of the tiles seen in this frame to the job
+  // manager, best score first. Called after the tiles are culled.
+  void                      requestUpdate ( unsigned int frame );
+
   // Append raster data.
   void                      rasterAppend ( Usul::Interfaces::IRasterLayer * );
   
@@ -222,9 +233,12 @@ public:
   void                      splitDistance ( double distance, bool children = true );
   double                    splitDistance() const;
 
-  // Request texture.
+  // Request texture. The job waits until the tile is seen.
   BuildRaster::RefPtr       textureRequest ( Tile* );
 
+  // Request child tiles. The job waits until the tile is seen.
+  void                      tilesRequest ( Usul::Jobs::Job::RefPtr, Tile * );
+
   // Set/get the flag that says to use borders.
   void                      useBorders ( bool );
   bool                      useBorders() const;
@@ -280,6 +294,21 @@ private:
   typedef Usul::Interfaces::IUpdateListener IUpdateListener;
   typedef Usul::Containers::Unknowns<IUpdateListener> UpdateListeners;
 
+  // Callback to hand out the tile requests after the tiles are culled.
+  class RequestCallback : public osg::NodeCallback
+  {
+  public:
+    typedef osg::NodeCallback BaseClass;
+
+    RequestCallback ( Body *body ) : BaseClass(), _body ( body )
+    {
+    }
+
+    virtual void operator() ( osg::Node *node, osg::NodeVisitor *nv );
+
+    Body *_body;
+  };
+
   // No copying or assignment.
   Body ( const Body & );
   Body &operator = ( const Body & );
@@ -296,6 +325,8 @@ private:
   ElevationGroup::RefPtr _elevation;
   VectorGroup::RefPtr _vectorData;
   JobManager _manager;
+  RequestScheduler::RefPtr _requests;
+  osg::ref_ptr<RequestCallback> _requestCallback;
   unsigned int _maxLevel;
   bool _cacheTiles;
   double _splitDistance;
@@ -0,0 +1,340 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Holds the tile requests until the tiles are seen.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/TileEngine/RequestScheduler.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Jobs/Manager.h"
+#include "Usul/Trace/Trace.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Minerva::Core::TileEngine;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+RequestScheduler::RequestScheduler ( unsigned int maxInFlight ) : BaseClass(),
+  _pending(),
+  _inFlight(),
+  _scores(),
+  _current(),
+  _frame ( 0 ),
+  _maxInFlight ( ( 0 == maxInFlight ) ? 1 : maxInFlight )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+RequestScheduler::~RequestScheduler()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &RequestScheduler::_destroy ), "2093441764" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  this->clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a request.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::add ( Job::RefPtr job, const Tile *tile, Kind kind )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  if ( false == job.valid() )
+    return;
+
+  _pending.push_back ( Request ( job, tile, kind ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel and forget all requests.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::clear()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  for ( Requests::iterator i = _pending.begin(); i != _pending.end(); ++i )
+    i->job->cancel();
+  for ( Requests::iterator i = _inFlight.begin(); i != _inFlight.end(); ++i )
+    i->job->cancel();
+
+  _pending.clear();
+  _inFlight.clear();
+  _scores.clear();
+  _current.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the most jobs of each kind that the manager has at one time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::maxInFlight ( unsigned int num )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _maxInFlight = ( ( 0 == num ) ? 1 : num );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the most jobs of each kind that the manager has at one time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int RequestScheduler::maxInFlight() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _maxInFlight;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of requests given to the manager that are not done.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int RequestScheduler::numInFlight() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _inFlight.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of requests waiting for their tile to be seen.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int RequestScheduler::numPending() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _pending.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget the request.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::remove ( Job::RefPtr job )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  for ( Requests::iterator i = _pending.begin(); i != _pending.end(); ++i )
+  {
+    if ( i->job == job )
+    {
+      _pending.erase ( i );
+      return;
+    }
+  }
+
+  for ( Requests::iterator i = _inFlight.begin(); i != _inFlight.end(); ++i )
+  {
+    if ( i->job == job )
+    {
+      _inFlight.erase ( i );
+      return;
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Hand the requests seen since the last update to the manager. When more
+//  than one view culls in the same frame, each update adds its tiles to the
+//  ones already seen in that frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::update ( unsigned int frame, Manager *manager )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  if ( frame != _frame )
+  {
+    _scores.clear();
+    _frame = frame;
+  }
+
+  for ( Scores::const_iterator i = _current.begin(); i != _current.end(); ++i )
+    _scores[i->first] = i->second;
+  _current.clear();
+
+  this->_dispatch ( manager );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The tile was seen in this frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::visible ( const Tile *tile, double score )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _current[tile] = score;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper to sort the candidates with the best score first.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  template < class Pair > struct BetterScore
+  {
+    bool operator () ( const Pair &a, const Pair &b ) const
+    {
+      return ( a.first > b.first );
+    }
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Hand the best requests seen in this frame to the manager.
+//  Make sure the mutex is locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestScheduler::_dispatch ( Manager *manager )
+{
+  USUL_TRACE_SCOPE;
+
+  unsigned int inFlight[NUM_KINDS] = { 0, 0 };
+
+  // Forget the jobs that are done. Cancel the ones for tiles that were not
+  // seen and forget them too. One that is still queued is taken out of the
+  // queue, one that is running stops at its next check. Either way it no
+  // longer counts, and the tile asks again if it needs to.
+  for ( Requests::iterator i = _inFlight.begin(); i != _inFlight.end(); )
+  {
+    if ( true == i->job->isDone() )
+    {
+      i = _inFlight.erase ( i );
+      continue;
+    }
+
+    if ( _scores.end() == _scores.find ( i->tile ) )
+    {
+      if ( 0x0 != manager )
+        manager->cancel ( i->job );
+      else
+        i->job->cancel();
+
+      i = _inFlight.erase ( i );
+      continue;
+    }
+
+    ++inFlight[i->kind];
+    ++i;
+  }
+
+  if ( 0x0 == manager )
+    return;
+
+  // Gather the waiting requests whose tile was seen.
+  typedef std::pair < double, Requests::iterator > Candidate;
+  typedef std::vector < Candidate > Candidates;
+  Candidates candidates;
+  candidates.reserve ( _pending.size() );
+  for ( Requests::iterator i = _pending.begin(); i != _pending.end(); )
+  {
+    // Someone else canceled it.
+    if ( true == i->job->canceled() )
+    {
+      i = _pending.erase ( i );
+      continue;
+    }
+
+    Scores::const_iterator score ( _scores.find ( i->tile ) );
+    if ( _scores.end() != score )
+      candidates.push_back ( Candidate ( score->second, i ) );
+
+    ++i;
+  }
+
+  // Best first.
+  std::stable_sort ( candidates.begin(), candidates.end(), Helper::BetterScore < Candidate > () );
+
+  for ( Candidates::iterator i = candidates.begin(); i != candidates.end(); ++i )
+  {
+    Requests::iterator request ( i->second );
+    if ( inFlight[request->kind] >= _maxInFlight )
+      continue;
+
+    manager->addJob ( request->job );
+    ++inFlight[request->kind];
+
+    // Lists keep their iterators when moving elements.
+    _inFlight.splice ( _inFlight.end(), _pending, request );
+  }
+}
@@ -0,0 +1,128 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Holds the tile requests until the tiles are seen.
+//
+//  The visible tiles give a score while they are culled. After the cull,
+//  the waiting requests with the best scores in that frame are handed to
+//  the job manager, as long as there are fewer than the maximum of that
+//  kind already there. Jobs handed out for tiles that were not seen in the
+//  frame are canceled, taken out of the manager's queue, and no longer
+//  count against the maximum.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MINERVA_CORE_TILE_ENGINE_REQUEST_SCHEDULER_H_
+#define _MINERVA_CORE_TILE_ENGINE_REQUEST_SCHEDULER_H_
+
+#include "Minerva/Core/Export.h"
+
+#include "Usul/Base/Object.h"
+#include "Usul/Jobs/Job.h"
+
+#include <list>
+#include <map>
+
+namespace Usul { namespace Jobs { class Manager; } }
+namespace Minerva { namespace Core { namespace TileEngine { class Tile; } } }
+
+
+namespace Minerva {
+namespace Core {
+namespace TileEngine {
+
+
+class MINERVA_EXPORT RequestScheduler : public Usul::Base::Object
+{
+public:
+
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Jobs::Job Job;
+  typedef Usul::Jobs::Manager Manager;
+
+  // Kinds of requests. Each has its own limit.
+  enum Kind
+  {
+    TEXTURE = 0,
+    TILES,
+    NUM_KINDS
+  };
+
+  USUL_DECLARE_REF_POINTERS ( RequestScheduler );
+
+  // Constructor
+  RequestScheduler ( unsigned int maxInFlight );
+
+  // Add a request. The job is not given to the manager until the tile is seen.
+  void                      add ( Job::RefPtr, const Tile *, Kind );
+
+  // Cancel and forget all requests.
+  void                      clear();
+
+  // Set/get the most jobs of each kind that the manager has at one time.
+  void                      maxInFlight ( unsigned int );
+  unsigned int              maxInFlight() const;
+
+  // Get the number of requests.
+  unsigned int              numInFlight() const;
+  unsigned int              numPending() const;
+
+  // Forget the request. Does not cancel it.
+  void                      remove ( Job::RefPtr );
+
+  // Hand the requests seen since the last update to the manager. Call once
+  // per frame after the cull.
+  void                      update ( unsigned int frame, Manager * );
+
+  // The tile was seen in this frame. Bigger scores go first.
+  void                      visible ( const Tile *, double score );
+
+protected:
+
+  // Use reference counting.
+  virtual ~RequestScheduler();
+
+private:
+
+  // No copying or assignment.
+  RequestScheduler ( const RequestScheduler & );
+  RequestScheduler &operator = ( const RequestScheduler & );
+
+  struct Request
+  {
+    Request ( Job::RefPtr j, const Tile *t, Kind k ) : job ( j ), tile ( t ), kind ( k ){}
+    Job::RefPtr job;
+    const Tile *tile;
+    Kind kind;
+  };
+
+  typedef std::list < Request > Requests;
+  typedef std::map < const Tile *, double > Scores;
+
+  void                      _destroy();
+  void                      _dispatch ( Manager * );
+
+  Requests _pending;
+  Requests _inFlight;
+  Scores _scores;
+  Scores _current;
+  unsigned int _frame;
+  unsigned int _maxInFlight;
+};
+
+
+} // namespace TileEngine
+} // namespace Core
+} // namespace Minerva
+
+
+#endif // _MINERVA_CORE_TILE_ENGINE_REQUEST_SCHEDULER_H_
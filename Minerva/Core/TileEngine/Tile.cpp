@@ -44,6 +44,7 @@
 #include "Usul/Functions/Execute.h"
 #include "Usul/Functions/SafeCall.h"
 #include "Usul/Interfaces/ITileVectorJob.h"
+#include "Usul/Math/Absolute.h"
 #include "Usul/Math/MinMax.h"
 #include "Usul/Math/NaN.h"
 #include "Usul/Threads/Safe.h"
@@ -83,6 +84,10 @@ namespace Helper
   {
     if ( true == job.valid() )
     {
+      // The body may still be holding it until the tile is seen.
+      if ( 0x0 != body )
+        body->requestRemove ( job );
+
       // Remove the job from the queue.
       if ( 0x0 != body && 0x0 != body->jobManager() )
         body->jobManager()->removeQueuedJob ( job );
@@ -538,8 +543,9 @@ void Tile::traverse ( osg::NodeVisitor &nv )
   {
     if ( imageJob->isDone() )
     {
-      // Capture the success state.
-      const bool imageJobSuccess ( imageJob->success() );
+      // Capture the success state. One that was canceled may never have
+      // started, and built nothing.
+      const bool imageJobSuccess ( ( true == imageJob->success() ) && ( false == imageJob->canceled() ) );
       
       // Clear the image job.
       {
@@ -638,6 +644,9 @@ void Tile::traverse ( osg::NodeVisitor &nv )
       return;
     }
 
+    // Let the body know how much we need our requests.
+    body->requestScore ( this, this->_requestScore ( *cv ) );
+
     if ( false == splitIfNeeded )
     {
       const unsigned int child ( ( false == allowSplit && false == keepDetail ) ? 0 : this->getNumChildren() - 1 );
@@ -671,6 +680,7 @@ void Tile::traverse ( osg::NodeVisitor &nv )
 void Tile::_cull ( osgUtil::CullVisitor &cv )
 {
   USUL_TRACE_SCOPE;
+  USUL_TRACE_EVENT ( __USUL_FUNCTION__ );
 
   // Get needed variables.
   MeshPtr mesh_;
@@ -760,8 +770,8 @@ void Tile::_cull ( osgUtil::CullVisitor &cv )
           // Make a new job to tile the child tiles.
           _tileJob = new Minerva::Core::Jobs::BuildTiles ( Tile::RefPtr ( this ) );
         
-          // Add the job to the job manager.
-          _body->jobManager()->addJob ( _tileJob.get() );
+          // The body gives the job to the job manager when it's our turn.
+          _body->tilesRequest ( _tileJob, this );
         }
       }
 
@@ -831,6 +841,7 @@ void Tile::_cull ( osgUtil::CullVisitor &cv )
 void Tile::split ( Usul::Jobs::Job::RefPtr job )
 {
   USUL_TRACE_SCOPE;
+  USUL_TRACE_EVENT ( __USUL_FUNCTION__ );
 
   Body::RefPtr body ( Usul::Threads::Safe::get ( this->mutex(), _body ) );
   
@@ -860,9 +871,9 @@ void Tile::split ( Usul::Jobs::Job::RefPtr job )
   Tile::RefPtr t2 ( this->_buildTile ( level, ul, mul, tul, half, job, UPPER_LEFT  ) ); // upper left  tile
   Tile::RefPtr t3 ( this->_buildTile ( level, ur, mur, tur, half, job, UPPER_RIGHT ) ); // upper right tile
   
-  // Have we been cancelled?
+  // Have we been cancelled? Then nobody wants the children.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return;
   
   // Need to notify vector data so it can re-adjust.
   Minerva::Core::Data::Container::RefPtr vector ( body->vectorData() );
@@ -945,9 +956,9 @@ Tile::RefPtr Tile::_buildTile ( unsigned int level,
   // If our logic is correct, this should be true.
   USUL_ASSERT ( this->referenceCount() >= 1 );
 
-  // Have we been cancelled?
+  // Have we been cancelled? The caller checks too.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return 0x0;
 
   // Get this tile's vector data that falls within the extents.
   TileVectorData::RefPtr tvd ( new TileVectorData );
@@ -975,9 +986,9 @@ Tile::RefPtr Tile::_buildTile ( unsigned int level,
     }
   }
 
-  // Have we been cancelled?
+  // Have we been cancelled? The caller checks too.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return 0x0;
 
 #if USE_TOP_DOWN_BUILD_RASTER == 0
   // Use the specified region of our image.
@@ -995,23 +1006,23 @@ Tile::RefPtr Tile::_buildTile ( unsigned int level,
   }
 #endif
 
-  // Have we been cancelled?
+  // Have we been cancelled? The caller checks too.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return 0x0;
 
   tile->updateMesh();
   tile->updateTexture();
 
-  // Have we been cancelled?
+  // Have we been cancelled? The caller checks too.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return 0x0;
 
   // Now build the per-tile vector data.
   tile->buildPerTileVectorData ( job );
 
-  // Have we been cancelled?
+  // Have we been cancelled? The caller checks too.
   if ( job.valid() && true == job->canceled() )
-    job->cancel();
+    return 0x0;
 
 #if USE_TOP_DOWN_BUILD_RASTER == 0
   // Make sure the image is dirty.
@@ -1062,6 +1073,7 @@ Tile::ImagePtr Tile::_buildRaster ( const Extents &extents, unsigned int width,
 void Tile::buildRaster ( Usul::Jobs::Job::RefPtr job )
 {
   USUL_TRACE_SCOPE;
+  USUL_TRACE_EVENT ( __USUL_FUNCTION__ );
 
   // Get the parent.
   Tile::RefPtr parent ( Usul::Threads::Safe::get ( this->mutex(), _parent.get() ) );
@@ -1092,9 +1104,9 @@ void Tile::buildRaster ( Usul::Jobs::Job::RefPtr job )
   // Build the list of images to be composited.
   for ( Rasters::iterator iter = rasters.begin(); iter != rasters.end(); ++iter )
   {
-    // Have we been cancelled?
+    // Have we been cancelled? Leave the image dirty so that it is asked for again.
     if ( ( 0x0 != job ) && ( true == job->canceled() ) )
-      job->cancel();
+      return;
 
     // The layer.
     IRasterLayer::RefPtr raster ( *iter );
@@ -1185,6 +1197,7 @@ void Tile::buildRaster ( Usul::Jobs::Job::RefPtr job )
 void Tile::buildPerTileVectorData ( Usul::Jobs::Job::RefPtr job )
 {
   USUL_TRACE_SCOPE;
+  USUL_TRACE_EVENT ( __USUL_FUNCTION__ );
 
   // Get the body.
   Body::RefPtr body ( Usul::Threads::Safe::get ( this->mutex(), _body ) );
@@ -1487,6 +1500,35 @@ void Tile::_launchImageRequest()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  How much this tile needs its requests. The screen-space error is how
+//  many pixels the tile covers for each pixel of its image, so coarse tiles
+//  up close come first. Tiles towards the middle of the view count more
+//  than the ones at the edges.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+double Tile::_requestScore ( osgUtil::CullVisitor &cv ) const
+{
+  USUL_TRACE_SCOPE;
+
+  const ImageSize imageSize ( Usul::Threads::Safe::get ( this->mutex(), _imageSize ) );
+  const osg::BoundingSphere &bound ( this->getBound() );
+
+  // Pixels across the tile compared to pixels across the image.
+  const double pixels ( Usul::Math::absolute ( cv.pixelSize ( bound.center(), bound.radius() ) ) );
+  const double error ( pixels / static_cast < double > ( Usul::Math::maximum ( 1u, imageSize[0] ) ) );
+
+  // One when the tile is straight ahead, zero when it is behind.
+  osg::Vec3d toTile ( bound.center() - cv.getViewPointLocal() );
+  toTile.normalize();
+  const double ahead ( 0.5 * ( 1.0 + ( toTile * osg::Vec3d ( cv.getLookVectorLocal() ) ) ) );
+
+  return error * ( 0.25 + 0.75 * ahead );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Load the elevation.
@@ -2204,6 +2246,8 @@ void Tile::unref ( bool allowDeletion )
 
 void Tile::buildElevationData ( Usul::Jobs::Job::RefPtr job )
 {
+  USUL_TRACE_EVENT ( __USUL_FUNCTION__ );
+
   // Have we been cancelled?
   if ( job.valid() && true == job->canceled() )
     job->cancel();
@@ -257,11 +257,14 @@ protected:
   bool                      _perTileVectorDataIsInherited() const;
   TileVectorData::RefPtr    _perTileVectorDataGet();
 
+  // How much this tile needs its requests. Bigger is more.
+  double                    _requestScore ( osgUtil::CullVisitor &cv ) const;
+
   // Quarter the texture coordinates.
   void                      _quarterTextureCoordinates ( Usul::Math::Vec4d& ll, Usul::Math::Vec4d& lr, Usul::Math::Vec4d& ul, Usul::Math::Vec4d& ur ) const;
   static Usul::Math::Vec4d  _textureCoordinatesSubRegion ( const Usul::Math::Vec4d& region, Indices index );
 
-  // Build a tile.
+  // Build a tile. Returns null if the job is cancelled.
   Tile::RefPtr              _buildTile ( unsigned int level, 
                                          const Extents& extents, 
                                          const MeshSize& size, 
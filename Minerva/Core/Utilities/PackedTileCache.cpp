@@ -0,0 +1,879 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cache of tile images in one file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/Utilities/PackedTileCache.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/File/Remove.h"
+#include "Usul/File/Rename.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/RecursiveMutex.h"
+#include "Usul/Trace/Trace.h"
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/static_assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using namespace Minerva::Core::Utilities;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constants.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // The file starts with this, including the terminating null.
+  const char FILE_TAG[16] = "MinervaTiles 1\n";
+  const unsigned int FILE_TAG_SIZE ( sizeof ( FILE_TAG ) );
+
+  // Each record starts with this.
+  const Usul::Types::Uint32 RECORD_TAG ( 0x454c4954 );
+
+  // A record with only a header that says the tile was dropped.
+  const Usul::Types::Uint32 DROPPED_TAG ( 0x504f5244 );
+
+  // Compact when the file is bigger than this and less than half of it is used.
+  const Usul::Types::Uint64 MIN_COMPACT_BYTES ( 16 * 1024 * 1024 );
+}
+
+BOOST_STATIC_ASSERT ( 16 == sizeof ( Helper::FILE_TAG ) );
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Fast compression. The format is byte-oriented LZ77 like LZ4: each
+//  sequence is a token, whose high and low four bits are the number of
+//  literals and the match length minus four, then the literals, then a
+//  two-byte offset back to the match. Lengths of 15 or more continue in
+//  following bytes. The last sequence has only literals.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Usul::Types::Uint32 Uint32;
+  typedef std::vector < unsigned char > Buffer;
+
+  const unsigned int HASH_BITS ( 13 );
+  const unsigned int MIN_MATCH ( 4 );
+  const unsigned int MAX_OFFSET ( 65535 );
+  const Uint32 NONE ( 0xFFFFFFFF );
+
+  inline Uint32 read32 ( const unsigned char *p )
+  {
+    Uint32 v ( 0 );
+    std::memcpy ( &v, p, sizeof ( Uint32 ) );
+    return v;
+  }
+
+  inline unsigned int hash ( Uint32 v )
+  {
+    return ( ( v * 2654435761u ) >> ( 32 - HASH_BITS ) );
+  }
+
+  inline void putLength ( Buffer &out, unsigned int length )
+  {
+    while ( length >= 255 )
+    {
+      out.push_back ( 255 );
+      length -= 255;
+    }
+    out.push_back ( static_cast < unsigned char > ( length ) );
+  }
+
+  inline bool getLength ( const unsigned char *&in, const unsigned char *end, unsigned int &length, unsigned int limit )
+  {
+    unsigned int b ( 255 );
+    while ( 255 == b )
+    {
+      if ( ( in == end ) || ( length > limit ) )
+        return false;
+      b = *in++;
+      length += b;
+    }
+    return true;
+  }
+
+  // A match length of zero means the last sequence.
+  inline void putSequence ( Buffer &out, const unsigned char *literals, unsigned int numLiterals, unsigned int offset, unsigned int matchLength )
+  {
+    const unsigned int extra ( ( matchLength > 0 ) ? matchLength - MIN_MATCH : 0 );
+    const unsigned int token ( ( ( ( numLiterals < 15 ) ? numLiterals : 15 ) << 4 ) | ( ( extra < 15 ) ? extra : 15 ) );
+    out.push_back ( static_cast < unsigned char > ( token ) );
+
+    if ( numLiterals >= 15 )
+      Helper::putLength ( out, numLiterals - 15 );
+    out.insert ( out.end(), literals, literals + numLiterals );
+
+    if ( matchLength > 0 )
+    {
+      out.push_back ( static_cast < unsigned char > ( offset & 0xFF ) );
+      out.push_back ( static_cast < unsigned char > ( offset >> 8 ) );
+      if ( extra >= 15 )
+        Helper::putLength ( out, extra - 15 );
+    }
+  }
+
+  inline void compress ( const unsigned char *in, unsigned int size, Buffer &out )
+  {
+    out.clear();
+    out.reserve ( size / 2 );
+
+    std::vector < Uint32 > table ( 1u << HASH_BITS, NONE );
+    unsigned int anchor ( 0 );
+    unsigned int i ( 0 );
+    const unsigned int limit ( ( size > MIN_MATCH ) ? size - MIN_MATCH : 0 );
+
+    while ( i < limit )
+    {
+      const Uint32 v ( Helper::read32 ( in + i ) );
+      const unsigned int h ( Helper::hash ( v ) );
+      const Uint32 candidate ( table[h] );
+      table[h] = i;
+
+      if ( ( NONE != candidate ) && ( i - candidate <= MAX_OFFSET ) && ( v == Helper::read32 ( in + candidate ) ) )
+      {
+        unsigned int length ( MIN_MATCH );
+        while ( ( i + length < size ) && ( in[candidate + length] == in[i + length] ) )
+          ++length;
+
+        Helper::putSequence ( out, in + anchor, i - anchor, i - candidate, length );
+        i += length;
+        anchor = i;
+      }
+      else
+      {
+        ++i;
+      }
+    }
+
+    Helper::putSequence ( out, in + anchor, size - anchor, 0, 0 );
+  }
+
+  // Returns false if the data is not valid.
+  inline bool decompress ( const Buffer &buffer, unsigned char *out, unsigned int size )
+  {
+    const unsigned char *in ( ( buffer.empty() ) ? 0x0 : &buffer[0] );
+    const unsigned char *end ( in + buffer.size() );
+    unsigned int op ( 0 );
+
+    while ( in < end )
+    {
+      const unsigned int token ( *in++ );
+
+      unsigned int numLiterals ( token >> 4 );
+      if ( ( 15 == numLiterals ) && ( false == Helper::getLength ( in, end, numLiterals, size ) ) )
+        return false;
+      if ( ( numLiterals > static_cast < unsigned int > ( end - in ) ) || ( numLiterals > size - op ) )
+        return false;
+
+      std::memcpy ( out + op, in, numLiterals );
+      in += numLiterals;
+      op += numLiterals;
+
+      // The last sequence.
+      if ( in == end )
+        break;
+
+      if ( end - in < 2 )
+        return false;
+      const unsigned int offset ( in[0] | ( in[1] << 8 ) );
+      in += 2;
+
+      unsigned int length ( ( token & 15 ) + MIN_MATCH );
+      if ( ( 15 + MIN_MATCH == length ) && ( false == Helper::getLength ( in, end, length, size ) ) )
+        return false;
+      if ( ( 0 == offset ) || ( offset > op ) || ( length > size - op ) )
+        return false;
+
+      // The match may overlap what it writes.
+      for ( unsigned int k = 0; k < length; ++k, ++op )
+        out[op] = out[op - offset];
+    }
+
+    return ( op == size );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper function to see if the stored extents are the ones asked for.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  inline bool same ( double a, double b )
+  {
+    const double scale ( std::max ( 1.0, std::max ( std::fabs ( a ), std::fabs ( b ) ) ) );
+    return ( std::fabs ( a - b ) <= 1e-9 * scale );
+  }
+
+  inline bool sameExtents ( const double *stored, const Minerva::Core::Extents < osg::Vec2d > &e )
+  {
+    return ( Helper::same ( stored[0], e.minLon() ) && Helper::same ( stored[1], e.minLat() ) &&
+             Helper::same ( stored[2], e.maxLon() ) && Helper::same ( stored[3], e.maxLat() ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The caches that are open.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Usul::Threads::RecursiveMutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+  typedef std::map < std::string, PackedTileCache::RefPtr > Caches;
+  static Mutex mutex;
+  static Caches caches;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the key. The row and column are how many tiles of this size there
+//  are from the south and west edges.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::Key::Key() :
+  level ( 0 ),
+  row ( 0 ),
+  column ( 0 ),
+  width ( 0 ),
+  height ( 0 )
+{
+}
+
+PackedTileCache::Key::Key ( const Extents &e, unsigned int w, unsigned int h, unsigned int l ) :
+  level ( l ),
+  row ( 0 ),
+  column ( 0 ),
+  width ( w ),
+  height ( h )
+{
+  const double dLon ( e.maxLon() - e.minLon() );
+  const double dLat ( e.maxLat() - e.minLat() );
+  if ( dLon > 0 )
+    column = static_cast < Uint32 > ( std::max ( 0.0, std::floor ( ( e.minLon() + 180.0 ) / dLon + 0.5 ) ) );
+  if ( dLat > 0 )
+    row = static_cast < Uint32 > ( std::max ( 0.0, std::floor ( ( e.minLat() + 90.0 ) / dLat + 0.5 ) ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Compare keys.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PackedTileCache::Key::operator < ( const Key &k ) const
+{
+  if ( level  != k.level  ) return ( level  < k.level  );
+  if ( row    != k.row    ) return ( row    < k.row    );
+  if ( column != k.column ) return ( column < k.column );
+  if ( width  != k.width  ) return ( width  < k.width  );
+  return ( height < k.height );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::PackedTileCache ( const std::string &file, SizeType maxBytes, Compression compression ) : BaseClass(),
+  _file ( file ),
+  _stream(),
+  _index(),
+  _order(),
+  _end ( 0 ),
+  _live ( 0 ),
+  _maxBytes ( maxBytes ),
+  _compression ( compression )
+{
+  USUL_TRACE_SCOPE;
+  this->_open();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::~PackedTileCache()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &PackedTileCache::_destroy ), "1722503848" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  _stream.close();
+  _index.clear();
+  _order.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the cache for the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::RefPtr PackedTileCache::open ( const std::string &file, SizeType maxBytes, Compression compression )
+{
+  USUL_TRACE_SCOPE_STATIC;
+  Helper::Guard guard ( Helper::mutex );
+
+  PackedTileCache::RefPtr &cache ( Helper::caches[file] );
+  if ( false == cache.valid() )
+    cache = new PackedTileCache ( file, maxBytes, compression );
+
+  return cache;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget the shared cache for the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::close ( const std::string &file )
+{
+  USUL_TRACE_SCOPE_STATIC;
+  Helper::Guard guard ( Helper::mutex );
+  Helper::caches.erase ( file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Open the file and read the record headers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_open()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  // Make the file if it's not there.
+  {
+    std::ofstream touch ( _file.c_str(), std::ios::out | std::ios::binary | std::ios::app );
+    if ( false == touch.is_open() )
+      throw std::runtime_error ( "Error 4015866722: Could not open tile cache: " + _file );
+  }
+
+  const SizeType size ( static_cast < SizeType > ( boost::filesystem::file_size ( _file ) ) );
+  SizeType offset ( 0 );
+
+  // Find the records that are all there.
+  {
+    std::ifstream in ( _file.c_str(), std::ios::in | std::ios::binary );
+    char tag[Helper::FILE_TAG_SIZE];
+    if ( ( size >= Helper::FILE_TAG_SIZE ) &&
+         ( in.read ( tag, Helper::FILE_TAG_SIZE ) ) &&
+         ( 0 == std::memcmp ( tag, Helper::FILE_TAG, Helper::FILE_TAG_SIZE ) ) )
+    {
+      offset = Helper::FILE_TAG_SIZE;
+      Record record;
+      while ( offset + sizeof ( Record ) <= size )
+      {
+        in.seekg ( static_cast < std::streamoff > ( offset ) );
+        if ( false == in.read ( reinterpret_cast < char * > ( &record ), sizeof ( Record ) ).good() )
+          break;
+        if ( ( Helper::RECORD_TAG != record.tag ) && ( Helper::DROPPED_TAG != record.tag ) )
+          break;
+
+        const SizeType total ( sizeof ( Record ) + ( ( Helper::RECORD_TAG == record.tag ) ? record.storedBytes : 0 ) );
+        if ( offset + total > size )
+          break;
+
+        Key key;
+        key.level = record.level;
+        key.row = record.row;
+        key.column = record.column;
+        key.width = record.width;
+        key.height = record.height;
+
+        // A dropped tile stays dropped, unless it is added again later in the file.
+        if ( Helper::RECORD_TAG == record.tag )
+        {
+          this->_add ( key, offset, total );
+        }
+        else
+        {
+          Index::iterator i ( _index.find ( key ) );
+          if ( _index.end() != i )
+            this->_remove ( i );
+        }
+
+        offset += total;
+      }
+    }
+  }
+
+  // Drop what was not all there, like the end of a record that was being written.
+  if ( offset < size )
+    boost::filesystem::resize_file ( _file, offset );
+
+  _stream.open ( _file.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+  if ( false == _stream.is_open() )
+    throw std::runtime_error ( "Error 3328510846: Could not open tile cache: " + _file );
+
+  // Start over if it is new or not one of ours.
+  if ( 0 == offset )
+  {
+    this->_write ( 0, Helper::FILE_TAG, Helper::FILE_TAG_SIZE );
+    offset = Helper::FILE_TAG_SIZE;
+  }
+
+  _end = offset;
+
+  this->_evict();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read from the file. Make sure the mutex is locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_read ( SizeType offset, void *buffer, SizeType size )
+{
+  USUL_TRACE_SCOPE;
+
+  _stream.clear();
+  _stream.seekg ( static_cast < std::streamoff > ( offset ) );
+  _stream.read ( reinterpret_cast < char * > ( buffer ), static_cast < std::streamsize > ( size ) );
+
+  if ( static_cast < SizeType > ( _stream.gcount() ) != size )
+    throw std::runtime_error ( "Error 1935570117: Failed to read from tile cache: " + _file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write to the file. Make sure the mutex is locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_write ( SizeType offset, const void *buffer, SizeType size )
+{
+  USUL_TRACE_SCOPE;
+
+  _stream.clear();
+  _stream.seekp ( static_cast < std::streamoff > ( offset ) );
+  _stream.write ( reinterpret_cast < const char * > ( buffer ), static_cast < std::streamsize > ( size ) );
+
+  if ( false == _stream.good() )
+    throw std::runtime_error ( "Error 2470919835: Failed to write to tile cache: " + _file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add to the index as the most recently used. Make sure the mutex is
+//  locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_add ( const Key &key, SizeType offset, SizeType size )
+{
+  USUL_TRACE_SCOPE;
+
+  Index::iterator i ( _index.find ( key ) );
+  if ( _index.end() != i )
+    this->_remove ( i );
+
+  _order.push_front ( key );
+
+  Entry &entry ( _index[key] );
+  entry.offset = offset;
+  entry.size = size;
+  entry.used = _order.begin();
+
+  _live += size;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove from the index. Make sure the mutex is locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_remove ( Index::iterator i )
+{
+  USUL_TRACE_SCOPE;
+
+  _live -= i->second.size;
+  _order.erase ( i->second.used );
+  _index.erase ( i );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove from the index and write a record that says so, so that it is not
+//  found again when the file is opened. Make sure the mutex is locked before
+//  calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_drop ( Index::iterator i )
+{
+  USUL_TRACE_SCOPE;
+
+  Record record;
+  std::memset ( &record, 0, sizeof ( Record ) );
+  record.tag = Helper::DROPPED_TAG;
+  record.level = i->first.level;
+  record.row = i->first.row;
+  record.column = i->first.column;
+  record.width = i->first.width;
+  record.height = i->first.height;
+
+  this->_write ( _end, &record, sizeof ( Record ) );
+  _end += sizeof ( Record );
+
+  this->_remove ( i );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Drop the least recently used tiles until they fit, and compact if the
+//  file is mostly dropped tiles. Make sure the mutex is locked before calling.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::_evict()
+{
+  USUL_TRACE_SCOPE;
+
+  while ( ( _live > _maxBytes ) && ( false == _order.empty() ) )
+    this->_drop ( _index.find ( _order.back() ) );
+
+  if ( ( _end > Helper::MIN_COMPACT_BYTES ) && ( _end - Helper::FILE_TAG_SIZE > 2 * _live ) )
+    this->compact();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Rewrite the file with only the tiles in the index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::compact()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+
+  const std::string temp ( _file + ".compact" );
+  typedef std::vector < SizeType > Offsets;
+  Offsets offsets;
+  offsets.reserve ( _order.size() );
+  SizeType offset ( Helper::FILE_TAG_SIZE );
+
+  // Oldest first, so that the order of use is the same when the file is opened again.
+  {
+    std::ofstream out ( temp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    out.write ( Helper::FILE_TAG, Helper::FILE_TAG_SIZE );
+
+    Buffer buffer;
+    for ( Order::reverse_iterator i = _order.rbegin(); i != _order.rend(); ++i )
+    {
+      const Entry &entry ( _index[*i] );
+      buffer.resize ( static_cast < Buffer::size_type > ( entry.size ) );
+      this->_read ( entry.offset, &buffer[0], entry.size );
+      out.write ( reinterpret_cast < const char * > ( &buffer[0] ), static_cast < std::streamsize > ( entry.size ) );
+
+      offsets.push_back ( offset );
+      offset += entry.size;
+    }
+
+    if ( false == out.good() )
+    {
+      out.close();
+      Usul::File::remove ( temp, false );
+      throw std::runtime_error ( "Error 1160238493: Failed to compact tile cache: " + _file );
+    }
+  }
+
+  // Swap the files.
+  _stream.close();
+  Usul::File::remove ( _file, true );
+  Usul::File::rename ( temp, _file, true );
+  _stream.open ( _file.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+  if ( false == _stream.is_open() )
+    throw std::runtime_error ( "Error 3328510846: Could not open tile cache: " + _file );
+
+  Offsets::const_iterator o ( offsets.begin() );
+  for ( Order::reverse_iterator i = _order.rbegin(); i != _order.rend(); ++i, ++o )
+    _index[*i].offset = *o;
+
+  _end = offset;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the tile, or null if it's not there.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::ImagePtr PackedTileCache::find ( const Extents &extents, unsigned int width, unsigned int height, unsigned int level )
+{
+  USUL_TRACE_SCOPE;
+
+  const Key key ( extents, width, height, level );
+  Record record;
+  Buffer stored;
+
+  // Only the reading is guarded.
+  {
+    Guard guard ( this );
+
+    Index::iterator i ( _index.find ( key ) );
+    if ( _index.end() == i )
+      return ImagePtr ( 0x0 );
+
+    // Tiles that are laid out differently can have the same key.
+    this->_read ( i->second.offset, &record, sizeof ( Record ) );
+    if ( false == Helper::sameExtents ( record.extents, extents ) )
+      return ImagePtr ( 0x0 );
+
+    stored.resize ( record.storedBytes );
+    if ( false == stored.empty() )
+      this->_read ( i->second.offset + sizeof ( Record ), &stored[0], stored.size() );
+
+    // It is now the most recently used.
+    _order.splice ( _order.begin(), _order, i->second.used );
+  }
+
+  ImagePtr image ( new osg::Image );
+  image->allocateImage ( record.width, record.height, 1, record.pixelFormat, record.dataType, record.packing );
+  if ( ( 0x0 == image->data() ) || ( record.rawBytes != image->getImageSizeInBytes() ) )
+    return ImagePtr ( 0x0 );
+
+  if ( RAW == record.compression )
+  {
+    if ( stored.size() != record.rawBytes )
+      return ImagePtr ( 0x0 );
+    if ( false == stored.empty() )
+      std::memcpy ( image->data(), &stored[0], stored.size() );
+  }
+  else if ( false == Helper::decompress ( stored, image->data(), record.rawBytes ) )
+  {
+    return ImagePtr ( 0x0 );
+  }
+
+  image->setInternalTextureFormat ( record.internalFormat );
+  return image;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the tile.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::insert ( const Extents &extents, unsigned int width, unsigned int height, unsigned int level, const osg::Image &image )
+{
+  USUL_TRACE_SCOPE;
+
+  // Only one slice of pixels.
+  if ( ( 0x0 == image.data() ) || ( 1 != image.r() ) )
+    return;
+
+  const Key key ( extents, width, height, level );
+  const unsigned char *pixels ( image.data() );
+  const unsigned int rawBytes ( image.getImageSizeInBytes() );
+
+  // Compress without the lock. Keep it raw if that's not smaller.
+  Compression compression ( this->compression() );
+  Buffer packed;
+  if ( FAST == compression )
+  {
+    Helper::compress ( pixels, rawBytes, packed );
+    if ( packed.size() >= rawBytes )
+      compression = RAW;
+  }
+
+  const unsigned char *data ( ( RAW == compression ) ? pixels : &packed[0] );
+  const unsigned int storedBytes ( ( RAW == compression ) ? rawBytes : static_cast < unsigned int > ( packed.size() ) );
+
+  Record record;
+  std::memset ( &record, 0, sizeof ( Record ) );
+  record.tag = Helper::RECORD_TAG;
+  record.level = key.level;
+  record.row = key.row;
+  record.column = key.column;
+  record.width = key.width;
+  record.height = key.height;
+  record.pixelFormat = image.getPixelFormat();
+  record.dataType = image.getDataType();
+  record.packing = image.getPacking();
+  record.internalFormat = image.getInternalTextureFormat();
+  record.compression = compression;
+  record.rawBytes = rawBytes;
+  record.storedBytes = storedBytes;
+  record.extents[0] = extents.minLon();
+  record.extents[1] = extents.minLat();
+  record.extents[2] = extents.maxLon();
+  record.extents[3] = extents.maxLat();
+
+  Guard guard ( this );
+
+  const SizeType offset ( _end );
+  this->_write ( offset, &record, sizeof ( Record ) );
+  this->_write ( offset + sizeof ( Record ), data, storedBytes );
+  _end += sizeof ( Record ) + storedBytes;
+
+  this->_add ( key, offset, sizeof ( Record ) + storedBytes );
+  this->_evict();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the compression used for new tiles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::Compression PackedTileCache::compression() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _compression;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the file name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string PackedTileCache::file() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _file;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the size of the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::SizeType PackedTileCache::fileBytes() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _end;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the size of the tiles in the index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::SizeType PackedTileCache::liveBytes() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _live;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the size limit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedTileCache::maxBytes ( SizeType bytes )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _maxBytes = bytes;
+  this->_evict();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the size limit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PackedTileCache::SizeType PackedTileCache::maxBytes() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _maxBytes;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of tiles in the index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int PackedTileCache::numTiles() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _index.size() );
+}
@@ -0,0 +1,193 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cache of tile images in one file.
+//
+//  Tiles are appended to the file, each one a fixed-size record header
+//  followed by the pixels, either raw or fast-compressed. The index of
+//  level, row and column to file offset is kept in memory and rebuilt by
+//  reading the headers when the file is opened. The least recently used
+//  tiles are dropped from the index when the size limit is reached, and a
+//  header-only record is appended for each so that it stays dropped when
+//  the file is opened again. The file is compacted when most of it is no
+//  longer in the index.
+//
+//  The file is written in the byte order of the machine. It is a cache, and
+//  a file that does not start with the right tag is started over.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MINERVA_CORE_UTILITIES_PACKED_TILE_CACHE_H_
+#define _MINERVA_CORE_UTILITIES_PACKED_TILE_CACHE_H_
+
+#include "Minerva/Core/Export.h"
+#include "Minerva/Core/Extents.h"
+
+#include "Usul/Base/Object.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Image"
+#include "osg/ref_ptr"
+#include "osg/Vec2d"
+
+#include <fstream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace Minerva {
+namespace Core {
+namespace Utilities {
+
+
+class MINERVA_EXPORT PackedTileCache : public Usul::Base::Object
+{
+public:
+
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 SizeType;
+  typedef osg::ref_ptr < osg::Image > ImagePtr;
+  typedef Minerva::Core::Extents < osg::Vec2d > Extents;
+
+  // How the pixels are stored.
+  enum Compression
+  {
+    RAW = 0,
+    FAST = 1
+  };
+
+  USUL_DECLARE_REF_POINTERS ( PackedTileCache );
+
+  // Return the cache for the file, opening it if needed. Everyone that asks
+  // for the same file shares one cache; the size and compression given by
+  // the first one are used.
+  static RefPtr             open ( const std::string &file, SizeType maxBytes, Compression );
+
+  // Forget the shared cache for the file. It closes when the last user lets go.
+  static void               close ( const std::string &file );
+
+  // Rewrite the file with only the tiles in the index.
+  void                      compact();
+
+  // Get the compression used for new tiles.
+  Compression               compression() const;
+
+  // Get the file name.
+  std::string               file() const;
+
+  // Return the size of the file.
+  SizeType                  fileBytes() const;
+
+  // Return the tile, or null if it's not there. Counts as a use of the tile.
+  ImagePtr                  find ( const Extents &, unsigned int width, unsigned int height, unsigned int level );
+
+  // Add the tile. Replaces the one that is there.
+  void                      insert ( const Extents &, unsigned int width, unsigned int height, unsigned int level, const osg::Image & );
+
+  // Return the size of the tiles in the index.
+  SizeType                  liveBytes() const;
+
+  // Set/get the size limit.
+  void                      maxBytes ( SizeType );
+  SizeType                  maxBytes() const;
+
+  // Return the number of tiles in the index.
+  unsigned int              numTiles() const;
+
+protected:
+
+  // Open or create the file. Throws if it can't.
+  PackedTileCache ( const std::string &file, SizeType maxBytes, Compression );
+
+  // Use reference counting.
+  virtual ~PackedTileCache();
+
+private:
+
+  // No copying or assignment.
+  PackedTileCache ( const PackedTileCache & );
+  PackedTileCache &operator = ( const PackedTileCache & );
+
+  // What the tiles are looked up by.
+  struct Key
+  {
+    Key();
+    Key ( const Extents &, unsigned int width, unsigned int height, unsigned int level );
+    bool operator < ( const Key & ) const;
+    Uint32 level;
+    Uint32 row;
+    Uint32 column;
+    Uint32 width;
+    Uint32 height;
+  };
+
+  // The header written before each tile's pixels.
+  struct Record
+  {
+    Uint32 tag;
+    Uint32 level;
+    Uint32 row;
+    Uint32 column;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pixelFormat;
+    Uint32 dataType;
+    Uint32 packing;
+    Uint32 internalFormat;
+    Uint32 compression;
+    Uint32 rawBytes;
+    Uint32 storedBytes;
+    Uint32 reserved;
+    double extents[4];
+  };
+
+  typedef std::list < Key > Order;
+  typedef std::vector < unsigned char > Buffer;
+
+  struct Entry
+  {
+    SizeType offset;
+    SizeType size;
+    Order::iterator used;
+  };
+
+  typedef std::map < Key, Entry > Index;
+
+  void                      _add ( const Key &, SizeType offset, SizeType size );
+  void                      _destroy();
+  void                      _drop ( Index::iterator );
+  void                      _evict();
+  void                      _open();
+  void                      _read ( SizeType offset, void *buffer, SizeType size );
+  void                      _remove ( Index::iterator );
+  void                      _write ( SizeType offset, const void *buffer, SizeType size );
+
+  std::string _file;
+  std::fstream _stream;
+  Index _index;
+  Order _order;
+  SizeType _end;
+  SizeType _live;
+  SizeType _maxBytes;
+  Compression _compression;
+};
+
+
+} // namespace Utilities
+} // namespace Core
+} // namespace Minerva
+
+
+#endif // _MINERVA_CORE_UTILITIES_PACKED_TILE_CACHE_H_
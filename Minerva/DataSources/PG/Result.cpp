@@ -353,3 +353,69 @@ Result::BinaryString* Result::asBlob ( unsigned int column ) const
   BinaryString::RefPtr blob ( new BinaryString ( buffer, length ) );  
   return blob.release();
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the column's bytes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Result::asBytes ( const std::string& columnName, Bytes& bytes ) const
+{
+  this->asBytes ( this->columnIndex ( columnName ), bytes );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the value of a hex digit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  inline unsigned int hexValue ( char c )
+  {
+    return ( ( c <= '9' ) ? ( c - '0' ) : ( ( c | 0x20 ) - 'a' + 10 ) ) & 0x0F;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the column's bytes. The hex format that newer servers send is decoded 
+//  straight from the result, and the buffer only grows when a row is bigger 
+//  than any before it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Result::asBytes ( unsigned int column, Bytes& bytes ) const
+{
+  const char *value ( this->_getValue ( _currentRow, column ) );
+  const int length ( this->_getLength ( _currentRow, column ) );
+
+  if ( length >= 2 && '\\' == value[0] && 'x' == value[1] )
+  {
+    const unsigned int size ( ( length - 2 ) / 2 );
+    bytes.resize ( size );
+
+    const char *hex ( value + 2 );
+    for ( unsigned int i = 0; i < size; ++i, hex += 2 )
+    {
+      bytes[i] = static_cast < unsigned char > ( ( Detail::hexValue ( hex[0] ) << 4 ) | Detail::hexValue ( hex[1] ) );
+    }
+    return;
+  }
+
+  // Older servers use the escape format.
+  size_t size ( 0 );
+  unsigned char * buffer ( ::PQunescapeBytea ( reinterpret_cast < const unsigned char* > ( value ), &size ) );
+  if ( 0x0 == buffer )
+  {
+    throw std::runtime_error ( "Error 2930378461: Could not unescape binary data." );
+  }
+  Usul::Scope::Caller::RefPtr freeBuffer ( Usul::Scope::makeCaller ( Usul::Adaptors::bind1 ( buffer, ::PQfreemem ) ) );
+
+  bytes.assign ( buffer, buffer + size );
+}
@@ -73,6 +73,9 @@ public:
   
   virtual BinaryString* asBlob ( const std::string& columnName ) const;
   virtual BinaryString* asBlob ( unsigned int which ) const;
+
+  virtual void asBytes ( const std::string& columnName, Bytes& bytes ) const;
+  virtual void asBytes ( unsigned int which, Bytes& bytes ) const;
   
 protected:
   
@@ -16,6 +16,7 @@
 #include "Usul/Pointers/Pointers.h"
 
 #include <string>
+#include <vector>
 
 namespace Minerva {
 namespace DataSources {
@@ -27,6 +28,7 @@ class MINERVA_DATA_SOURCES_EXPORT Result : public Usul::Base::Referenced
 public:
 
   typedef Usul::Base::Referenced BaseClass;
+  typedef std::vector<unsigned char> Bytes;
   
   USUL_DECLARE_REF_POINTERS ( Result );
 
@@ -70,6 +72,10 @@ public:
 
   virtual BinaryString* asBlob ( const std::string& columnName ) const = 0;
   virtual BinaryString* asBlob ( unsigned int which ) const = 0;
+
+  /// Get the column's bytes. Pass the same buffer for every row to reuse its memory.
+  virtual void asBytes ( const std::string& columnName, Bytes& bytes ) const = 0;
+  virtual void asBytes ( unsigned int which, Bytes& bytes ) const = 0;
   
 protected:
   
@@ -2634,7 +2634,13 @@ void MinervaDocument::activeBody ( Body* body )
   {
     _callback = new Callback;
     _callback->_body = _activeBody;
-    _activeBody->scene()->setCullCallback ( _callback.get() );
+
+    // Keep the body's own cull callback, but not the one set here before.
+    osg::Node *scene ( _activeBody->scene() );
+    osg::ref_ptr<osg::NodeCallback> existing ( scene->getCullCallback() );
+    Callback *previous ( dynamic_cast < Callback * > ( existing.get() ) );
+    _callback->setNestedCallback ( ( 0x0 != previous ) ? previous->getNestedCallback() : existing.get() );
+    scene->setCullCallback ( _callback.get() );
   }
 }
 
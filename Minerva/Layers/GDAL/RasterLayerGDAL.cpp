@@ -157,9 +157,18 @@ RasterLayerGDAL::ImagePtr RasterLayerGDAL::texture ( const Extents& extents, uns
 {
   USUL_TRACE_SCOPE;
 
+  // See if the tile is in the one file.
+  const bool packed ( this->cachePacked() );
+  if ( true == packed )
+  {
+    ImagePtr answer ( BaseClass::texture ( extents, width, height, level, job, caller ) );
+    if ( true == answer.valid() )
+      return answer;
+  }
+
   // Get the filename for the cache.
   std::string file;
-  CacheStatus status ( this->_getAndCheckCacheFilename ( extents, width, height, level, file ) );
+  CacheStatus status ( ( true == packed ) ? CACHE_STATUS_FILE_DOES_NOT_EXIST : this->_getAndCheckCacheFilename ( extents, width, height, level, file ) );
   if ( CACHE_STATUS_FILE_OK == status )
   {
     // Open the dataset.
@@ -182,7 +191,10 @@ RasterLayerGDAL::ImagePtr RasterLayerGDAL::texture ( const Extents& extents, uns
   // Close the file.  This makes sure the data is written to disk.
   tile->close();
 
-  boost::filesystem::copy_file ( tempFilename, file );
+  if ( true == packed )
+    this->_writeImageToCache ( extents, width, height, level, image );
+  else
+    boost::filesystem::copy_file ( tempFilename, file );
 
   return image;
 }
@@ -24,6 +24,8 @@
 
 #include "XmlTree/XercesLife.h"
 #include "XmlTree/Document.h"
+#include "XmlTree/Loader.h"
+#include "XmlTree/StreamHandler.h"
 
 #include "Usul/Adaptors/MemberFunction.h"
 #include "Usul/Adaptors/Bind.h"
@@ -357,12 +359,10 @@ void KmlLayer::_read ( const std::string &filename, Usul::Interfaces::IUnknown *
     XmlTree::XercesLife life;
     for ( FileContents::const_iterator iter = kmlFiles.begin(); iter != kmlFiles.end(); ++iter )
     {
-      XmlTree::Document::ValidRefPtr document ( new XmlTree::Document );
-      document->loadFromMemory ( *iter );
-  
       USUL_TRY_BLOCK
       {
-        this->_parseKml ( *document, caller, progress );
+        KmlLayer::Stream stream ( *this );
+        XmlTree::Loader().parseFromMemory ( *iter, stream );
       }
       USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "2567846007" );
     }
@@ -386,6 +386,113 @@ void KmlLayer::_read ( const std::string &filename, Usul::Interfaces::IUnknown *
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Builds the layers while the file is read, the same way _parseKml and 
+//  parseFolder do from the whole document. Folders and documents are 
+//  streamed into their layers, and only the other elements, like 
+//  placemarks and styles, are built as nodes, one at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct KmlLayer::Stream : public XmlTree::StreamHandler
+{
+  typedef XmlTree::StreamHandler BaseClass;
+
+  Stream ( KmlLayer &layer ) : BaseClass(), _layer ( layer ), _folders()
+  {
+  }
+
+  virtual bool startElement ( const std::string &name, const Attributes &attributes, unsigned int depth )
+  {
+    // The kml element.
+    if ( 1 == depth )
+      return false;
+
+    const bool folder ( "Folder" == name || "Document" == name );
+
+    // A folder or document at the top level is read into our layer.
+    if ( 2 == depth )
+    {
+      if ( true == folder )
+      {
+        _folders.push_back ( Folder ( &_layer, depth ) );
+        return false;
+      }
+      return true;
+    }
+
+    // A folder inside of a folder gets its own layer.
+    if ( ( true == folder ) && ( false == _folders.empty() ) )
+    {
+      KmlLayer &parent ( *_folders.back().first );
+
+      // Get the filename and directory.
+      const std::string filename ( Usul::Threads::Safe::get ( parent.mutex(), parent._filename ) );
+      const std::string directory ( Usul::Threads::Safe::get ( parent.mutex(), parent._directory ) );
+
+      // Get the current styles map.
+      Styles styles ( Usul::Threads::Safe::get ( parent.mutex(), parent._styles ) );
+
+      _folders.push_back ( Folder ( new KmlLayer ( filename, directory, styles, parent.modelCache() ), depth ) );
+      return false;
+    }
+
+    return true;
+  }
+
+  virtual void endElement ( const std::string &name, unsigned int depth )
+  {
+    if ( ( true == _folders.empty() ) || ( depth != _folders.back().second ) )
+      return;
+
+    KmlLayer::RefPtr layer ( _folders.back().first );
+    _folders.pop_back();
+
+    // Add a finished folder's layer to its parent.
+    if ( ( layer.get() != &_layer ) && ( false == _folders.empty() ) )
+    {
+      KmlLayer &parent ( *_folders.back().first );
+
+      layer->dirtyData ( false );
+      layer->dirtyScene ( true );
+      parent.add ( Usul::Interfaces::IUnknown::QueryPtr ( layer.get() ) );
+      parent.dirtyScene ( true );
+    }
+  }
+
+  virtual void subTree ( XmlTree::Node &node, unsigned int depth )
+  {
+    // At the top level.
+    if ( true == _folders.empty() )
+    {
+      _layer._parseNode ( node );
+      return;
+    }
+
+    KmlLayer &layer ( *_folders.back().first );
+    if ( "name" == node.name() )
+      layer.name ( node.value() );
+    else if ( "visibility" == node.name() )
+    {
+      bool visible ( "0" != node.value() );
+      layer.showLayer ( visible );
+    }
+    else
+      layer._parseNode ( node );
+  }
+
+private:
+
+  // A layer being read, and the depth of its folder's element.
+  typedef std::pair < KmlLayer::RefPtr, unsigned int > Folder;
+  typedef std::vector < Folder > Folders;
+
+  KmlLayer &_layer;
+  Folders _folders;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Load a kml file.
@@ -398,10 +505,9 @@ void KmlLayer::_parseKml ( const std::string& filename, Usul::Interfaces::IUnkno
 
   Usul::Scope::Reset<std::string> reset ( _directory, Usul::File::directory ( filename, true ), _directory );
   
-  XmlTree::Document::ValidRefPtr document ( new XmlTree::Document );
-  document->load ( filename );
-  
-  this->_parseKml ( *document, caller, progress );
+  // Build the layers as the file is read, rather than reading it all first.
+  KmlLayer::Stream stream ( *this );
+  XmlTree::Loader().parse ( filename, stream );
 }
 
 
@@ -132,6 +132,9 @@ private:
     READING     = 0x00000002
   };
   
+  // Builds the layers while the file is read.
+  struct Stream;
+  
   std::string _filename;
   std::string _directory;
   Link::RefPtr _link;
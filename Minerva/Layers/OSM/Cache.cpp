@@ -243,6 +243,17 @@ void Cache::addNodeData ( const std::string& key, const Extents& extents, const
 
 void Cache::_addNodeData ( const std::string& key, const Extents& extents, const Nodes& nodes )
 {
+  typedef CadKit::Database::SQLite::Result Statement;
+
+  // Prepare the statements once and bind each node's values.
+  const std::string sql ( Usul::Strings::format ( 
+    "INSERT INTO ", NODE_TABLE_NAME, 
+    " ( ", KEY_COLUMN, ", ", LOCACTION_COLUMN, ", ", OBJECT_ID_COLUMN, ", ", DATE_COLUMN, " )",
+    " values ( ?, MakePoint ( ?, ?, 4326 ), ?, ? )" ) );
+
+  Statement::RefPtr insert ( _connection->prepare ( sql ) );
+  Statement::RefPtr insertTags ( this->_prepareAddTags ( NODE_TAGS_TABLE_NAME ) );
+
   for ( Nodes::const_iterator iter = nodes.begin(); iter != nodes.end(); ++iter )
   {
     OSMNodePtr node ( *iter );
@@ -250,23 +261,17 @@ void Cache::_addNodeData ( const std::string& key, const Extents& extents, const
     {
       Node::IdType id ( node->id() );
       Node::Date timestamp ( node->timestamp() );
-      Node::Tags tags ( node->tags() );
       Node::Location location ( node->location() );
+      Cache::_translate ( location );
 
-      const std::string sql ( Usul::Strings::format ( 
-        "INSERT INTO ", NODE_TABLE_NAME, 
-        " ( ", KEY_COLUMN, ", ", LOCACTION_COLUMN, ", ", OBJECT_ID_COLUMN, ", ", DATE_COLUMN, " ) values (",
-        " \"", key, "\", ",
-        " ", Cache::_createPointText ( location ), ",", 
-        " \"", id, "\", \"", timestamp.toString(), "\" )" ) );
-      
       USUL_TRY_BLOCK
       {
-        _connection->execute ( sql );
+        insert->bind ( 0, key ).bind ( 1, location[0] ).bind ( 2, location[1] ).bind ( 3, id ).bind ( 4, timestamp.toString() );
+        insert->execute();
       }
       USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "2633836923" );
 
-      this->_addTags ( NODE_TAGS_TABLE_NAME, id, tags );
+      this->_addTags ( *insertTags, id, node->tags() );
     }
   }
 }
@@ -299,10 +304,12 @@ void Cache::getNodeData ( const std::string& key, const Extents& extents, Nodes&
     CadKit::Database::SQLite::Result::RefPtr result ( _connection->execute ( sql ) );
     if ( false == result.valid() )
       return;
+
+    CadKit::Database::SQLite::Result::RefPtr selectTags ( this->_prepareGetTags ( NODE_TAGS_TABLE_NAME ) );
     
     while ( result->prepareNextRow() )
     {
-      nodes.push_back ( Cache::_createNode ( *result ) );
+      nodes.push_back ( Cache::_createNode ( *result, *selectTags ) );
     }
   }
   USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "2175538793" )
@@ -315,22 +322,22 @@ void Cache::getNodeData ( const std::string& key, const Extents& extents, Nodes&
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Node* Cache::_createNode ( CadKit::Database::SQLite::Result& result ) const
+Node* Cache::_createNode ( CadKit::Database::SQLite::Result& result, CadKit::Database::SQLite::Result& selectTags ) const
 {
-  std::string sId, sTimestamp;
+  Node::IdType id ( 0 );
+  std::string sTimestamp;
 
   typedef CadKit::Database::SQLite::Blob Blob;
   Blob geometry;
 
-  result >> geometry >> sId >> sTimestamp;
+  result >> geometry >> id >> sTimestamp;
 
-  Node::IdType id ( Usul::Convert::Type<std::string,Node::IdType>::convert ( sId ) );
   Node::Date timestamp ( sTimestamp );
   Node::Tags tags;
   Node::Location location ( Usul::Convert::Type<Blob,Node::Location>::convert ( geometry ) );
   Cache::_unTranslate ( location );
 
-  this->_getTags ( NODE_TAGS_TABLE_NAME, id, tags );
+  this->_getTags ( selectTags, id, tags );
 
   return Node::create ( id, location, timestamp, tags );
 }
@@ -391,31 +398,36 @@ void Cache::_createTagsTable ( const std::string& tableName )
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Add the tags for the id.
+//  Prepare the statement that adds a tag.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Cache::_addTags ( const std::string& tableName, OSMObject::IdType id, const OSMObject::Tags& tags )
+CadKit::Database::SQLite::Result::RefPtr Cache::_prepareAddTags ( const std::string& tableName )
 {
-  if ( false == _connection.valid() )
-    return;
+  const std::string sql ( Usul::Strings::format ( 
+    "INSERT INTO ", tableName, 
+    " ( ", OBJECT_ID_COLUMN, ", ", KEY_COLUMN, ", ", VALUE_COLUMN, " ) values ( ?, ?, ? )" ) );
+
+  return _connection->prepare ( sql );
+}
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the tags for the id.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Cache::_addTags ( CadKit::Database::SQLite::Result& insert, OSMObject::IdType id, const OSMObject::Tags& tags )
+{
   // No transaction here!  Nested transactions cause a crash.
 
   for ( Node::Tags::const_iterator iter = tags.begin(); iter != tags.end(); ++iter )
   {
-    const std::string key ( iter->first );
-    const std::string value ( iter->second );
-    const std::string sql ( Usul::Strings::format ( 
-      "INSERT INTO ", tableName, 
-      " ( ", OBJECT_ID_COLUMN, ", ", KEY_COLUMN, ", ", VALUE_COLUMN, " ) values (",
-      " \"", id, "\", ",
-      " \"", key, "\",",
-      " \"", value, "\" )" ) );
-
     USUL_TRY_BLOCK
     {
-      _connection->execute ( sql );
+      insert.bind ( 0, id ).bind ( 1, iter->first ).bind ( 2, iter->second );
+      insert.execute();
     }
     USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "3992404744" );
   }
@@ -424,82 +436,64 @@ void Cache::_addTags ( const std::string& tableName, OSMObject::IdType id, const
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Get the tags for the id.
+//  Prepare the statement that gets the tags for an id.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Cache::_getTags ( const std::string& tableName, OSMObject::IdType id, OSMObject::Tags& tags ) const
+CadKit::Database::SQLite::Result::RefPtr Cache::_prepareGetTags ( const std::string& tableName ) const
 {
-  if ( false == _connection.valid() )
-    return;
-
   const std::string sql ( 
     Usul::Strings::format ( 
     "SELECT ", KEY_COLUMN, ", ", VALUE_COLUMN, 
     " FROM ", tableName, 
-    " WHERE \"", OBJECT_ID_COLUMN, "\"=\"", id, "\"" ) );
-
-  USUL_TRY_BLOCK
-  {
-    CadKit::Database::SQLite::Result::RefPtr result ( _connection->execute ( sql ) );
-    if ( false == result.valid() )
-      return;
-    
-    while ( result->prepareNextRow() )
-    {
-      std::string key, value;
+    " WHERE \"", OBJECT_ID_COLUMN, "\"=?" ) );
 
-      *result >> key >> value;
-      tags.insert ( std::make_pair ( key, value ) );
-    }
-  }
-  USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "2033756500" )
+  return _connection->prepare ( sql );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Create sql for creating a line.
+//  Get the tags for the id.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-std::string Cache::_createLineText ( const LineString::Vertices& vertices )
+void Cache::_getTags ( CadKit::Database::SQLite::Result& select, OSMObject::IdType id, OSMObject::Tags& tags ) const
 {
-  typedef Usul::Convert::Type<double,std::string> ToString;
-
-  std::string sql ( "GeomFromText ( 'LINESTRING ( " );
-
-  if ( vertices.size() > 0 )
+  USUL_TRY_BLOCK
   {
-    for ( LineString::Vertices::const_iterator iter = vertices.begin(); iter != vertices.end() - 1; ++iter )
+    select.reset();
+    select.bind ( 0, id );
+    
+    while ( select.prepareNextRow() )
     {
-      Node::Location translated ( *iter );
-      Cache::_translate ( translated );
-      sql = Usul::Strings::format ( sql, ToString::convert ( translated[0] ), " ", ToString::convert ( translated[1] ), ", " );
+      std::string key, value;
+
+      select >> key >> value;
+      tags.insert ( std::make_pair ( key, value ) );
     }
 
-    Node::Location translated ( vertices.back() );
-    Cache::_translate ( translated );
-    sql = Usul::Strings::format ( sql, ToString::convert ( translated[0] ), " ", ToString::convert ( translated[1] ) );
+    select.reset();
   }
-  
-  sql = Usul::Strings::format ( sql, " )', 4326 )" );
-  return sql;
+  USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "2033756500" )
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Create sql for creating a point.
+//  Make the well-known binary for the line. The vertices are translated.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-std::string Cache::_createPointText ( const Node::Location& location )
+void Cache::_createLineBlob ( const LineString::Vertices& vertices, CadKit::Database::SQLite::Blob& blob )
 {
-  typedef Usul::Convert::Type<double,std::string> ToString;
-  Node::Location translated ( location );
-  Cache::_translate ( translated );
-  return Usul::Strings::format ( "GeomFromText ( 'POINT ( ", ToString::convert ( translated[0] ), ' ', ToString::convert ( translated[1] ), " )', 4326 )" );
+  LineString::Vertices translated ( vertices );
+  for ( LineString::Vertices::iterator iter = translated.begin(); iter != translated.end(); ++iter )
+  {
+    Cache::_translate ( *iter );
+  }
+
+  Usul::Convert::Type<LineString::Vertices,CadKit::Database::SQLite::Blob>::convert ( translated, blob );
 }
 
 
@@ -563,10 +557,31 @@ void Cache::addLineData ( const std::string& key, const Extents& extents, const
   if ( false == _connection.valid() )
     return;
 
+  typedef CadKit::Database::SQLite::Result Statement;
+
+  CadKit::Database::SQLite::Transaction<CadKit::Database::SQLite::Connection::RefPtr> transaction ( _connection );
+
   // Cache that we have these extents.
   const int entryId ( this->_addLineEntry ( key, extents ) );
 
-  CadKit::Database::SQLite::Transaction<CadKit::Database::SQLite::Connection::RefPtr> transaction ( _connection );
+  // Prepare the statements once and bind each line's values.
+  const std::string columns ( Usul::Strings::format ( 
+      KEY_COLUMN, ", ", 
+      ENTRY_ID, ", ",
+      OBJECT_ID_COLUMN, ", ", 
+      DATE_COLUMN, ", ", 
+      NUM_NODES_COLUMN, ", ", 
+      NODE_IDS_COLUMN, ", ", 
+      GEOMETRY_COLUMN ) );
+
+  const std::string sql ( Usul::Strings::format ( 
+    "INSERT INTO ", LINE_STRING_TABLE_NAME, " ( ", columns, " ) values ( ?, ?, ?, ?, ?, ?, GeomFromWKB ( ?, 4326 ) )" ) );
+
+  Statement::RefPtr insert ( _connection->prepare ( sql ) );
+  Statement::RefPtr insertTags ( this->_prepareAddTags ( LINE_STRING_TAGS_TABLE_NAME ) );
+
+  CadKit::Database::SQLite::Blob geometry;
+
   for ( Lines::const_iterator iter = lines.begin(); iter != lines.end(); ++iter )
   {
     LineString::RefPtr line ( *iter );
@@ -574,43 +589,22 @@ void Cache::addLineData ( const std::string& key, const Extents& extents, const
     {
       LineString::IdType id ( line->id() );
       LineString::Date timestamp ( line->timestamp() );
-      LineString::Tags tags ( line->tags() );
-      
-      const std::string geometry ( Cache::_createLineText ( line->vertices() ) );
-
       LineString::NodeIds ids ( line->ids() );
-      unsigned int numNodes ( ids.size() );
+      const unsigned int numNodes ( ids.size() );
 
       if ( numNodes >= 2 )
       {
-        const std::string columns ( Usul::Strings::format ( 
-            KEY_COLUMN, ", ", 
-            ENTRY_ID, ", ",
-            OBJECT_ID_COLUMN, ", ", 
-            DATE_COLUMN, ", ", 
-            NUM_NODES_COLUMN, ", ", 
-            NODE_IDS_COLUMN, ", ", 
-            GEOMETRY_COLUMN ) );
-
-        const std::string values ( Usul::Strings::format ( 
-            "\"", key, "\", ", 
-            entryId, ", ",
-            id, ", ", 
-            "\"", timestamp.toString(), "\", ", 
-            numNodes, ", ", 
-            "?", ", ", 
-            "", geometry, "" ) );
-
-        const std::string sql ( Usul::Strings::format ( 
-          "INSERT INTO ", LINE_STRING_TABLE_NAME, " ( ", columns, " ) values (", values, " )" ) );
-        
+        Cache::_createLineBlob ( line->vertices(), geometry );
+
         USUL_TRY_BLOCK
         {
-          _connection->execute ( sql, ids );
+          insert->bind ( 0, key ).bind ( 1, entryId ).bind ( 2, id ).bind ( 3, timestamp.toString() );
+          insert->bind ( 4, static_cast<int> ( numNodes ) ).bindData ( 5, ids ).bind ( 6, geometry );
+          insert->execute();
         }
         USUL_DEFINE_SAFE_CALL_CATCH_BLOCKS ( "6077392060" );
 
-        this->_addTags ( LINE_STRING_TAGS_TABLE_NAME, id, tags ); 
+        this->_addTags ( *insertTags, id, line->tags() ); 
       }
     } 
   }
@@ -649,20 +643,20 @@ void Cache::getLineData ( const std::string& key, const Extents& extents, Lines&
     
     while ( result->prepareNextRow() )
     {
-      std::string sId, sTimestamp, sNumNodes;
+      LineString::IdType id ( 0 );
+      unsigned int numNodes ( 0 );
+      std::string sTimestamp;
 
       typedef CadKit::Database::SQLite::Blob Blob;
       Blob geometry;
       Blob bNodeIds;
 
-      *result >> geometry >> sId >> sTimestamp >> sNumNodes >> bNodeIds;
+      *result >> geometry >> id >> sTimestamp >> numNodes >> bNodeIds;
 
-      LineString::IdType id ( Usul::Convert::Type<std::string,Node::IdType>::convert ( sId ) );
       LineString::Date timestamp ( sTimestamp );
       LineString::Tags tags;
       LineString::Vertices vertices ( Usul::Convert::Type<Blob,LineString::Vertices>::convert ( geometry ) );
 
-      unsigned int numNodes ( Usul::Convert::Type<std::string,unsigned int>::convert ( sNumNodes ) );
       LineString::NodeIds nodeIds;
 
       if ( bNodeIds.size() == ( numNodes * sizeof ( OSMObject::IdType ) ) )
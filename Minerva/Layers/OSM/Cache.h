@@ -58,16 +58,17 @@ protected:
   void _addSpatialIndex ( const std::string& table, const std::string& column );
 
   void _addNodeData ( const std::string& key, const Extents& extents, const Nodes& nodes );
-  Node* _createNode ( CadKit::Database::SQLite::Result& result ) const;
+  Node* _createNode ( CadKit::Database::SQLite::Result& result, CadKit::Database::SQLite::Result& selectTags ) const;
 
   int _addLineEntry ( const std::string& key, const Extents& extents );
 
   void _createTagsTable ( const std::string& tableName );
-  void _addTags ( const std::string& tableName, OSMObject::IdType id, const OSMObject::Tags& tags );
-  void _getTags ( const std::string& tableName, OSMObject::IdType id, OSMObject::Tags& tags ) const;
+  CadKit::Database::SQLite::Result::RefPtr _prepareAddTags ( const std::string& tableName );
+  CadKit::Database::SQLite::Result::RefPtr _prepareGetTags ( const std::string& tableName ) const;
+  void _addTags ( CadKit::Database::SQLite::Result& insert, OSMObject::IdType id, const OSMObject::Tags& tags );
+  void _getTags ( CadKit::Database::SQLite::Result& select, OSMObject::IdType id, OSMObject::Tags& tags ) const;
 
-  static std::string _createLineText ( const LineString::Vertices& vertices );
-  static std::string _createPointText ( const Node::Location& location );
+  static void _createLineBlob ( const LineString::Vertices& vertices, CadKit::Database::SQLite::Blob& blob );
   static std::string _createIndexQuery ( const std::string& tableName, const std::string& columnName, const Extents& extents );
 
   static void _translate ( Node::Location& location );
@@ -109,21 +109,14 @@ void OpenStreetMapFile::read ( const std::string &filename, Usul::Interfaces::IU
 
 void OpenStreetMapFile::_read ( const std::string &filename, Usul::Interfaces::IUnknown *caller, Usul::Interfaces::IUnknown *progress )
 {
-  XmlTree::XercesLife life;
-  XmlTree::Document::RefPtr doc ( new XmlTree::Document );
-  doc->load ( filename );
-  
-  // Get the bounds of the data set.
-  XmlTree::Node::RefPtr bounds ( doc->child ( "bounds" ) );
-  if ( bounds.valid() )
-    this->_setBounds ( *bounds );
-  
   // Nodes and ways.
   Nodes nodes;
   Ways ways;
 
-  // Parse.
-  Parser::parseNodesAndWays ( *doc, nodes, ways );
+  // Parse as the file is read, and get the bounds of the data set.
+  Extents bounds ( 0.0, 0.0, 0.0, 0.0 );
+  if ( true == Parser::parseNodesAndWays ( filename, nodes, ways, bounds ) )
+    this->extents ( bounds );
 
   Usul::Interfaces::IUnknown::QueryPtr allNodes ( Minerva::Layers::OSM::createForAllNodes ( nodes ) );
   this->add ( allNodes );
@@ -181,16 +174,3 @@ void OpenStreetMapFile::serialize ( XmlTree::Node &parent ) const
   // Serialize.
   dataMemberMap.serialize ( parent );
 }
-
-
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Set the bounds.
-//
-///////////////////////////////////////////////////////////////////////////////
-
-void OpenStreetMapFile::_setBounds ( const XmlTree::Node& node )
-{
-  Extents extents ( Parser::parseExtents ( node ) );
-  this->extents ( extents );
-}
@@ -55,9 +55,6 @@ protected:
   // Read.
   void                        _read ( const std::string &filename, Usul::Interfaces::IUnknown *caller, Usul::Interfaces::IUnknown *progress );
 
-  // Set the bounds.
-  void                        _setBounds ( const XmlTree::Node& node );
-
 private:
   
   std::string _filename;
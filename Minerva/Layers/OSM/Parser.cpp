@@ -19,6 +19,8 @@
 #include "Minerva/Core/Data/TimeStamp.h"
 
 #include "XmlTree/Document.h"
+#include "XmlTree/Loader.h"
+#include "XmlTree/StreamHandler.h"
 #include "XmlTree/XercesLife.h"
 
 #include "Usul/Convert/Convert.h"
@@ -43,7 +45,6 @@ typedef OSMObject::IdType IdType;
 typedef OSMObject::Date DateType;
 typedef OSMObject::Tags Tags;
 typedef Node::Location LocationType;
-typedef std::map<IdType,Node::RefPtr> NodeMap;
 typedef XmlTree::Node::Children Children;
 typedef XmlTree::Node::Attributes Attributes;
 
@@ -89,64 +90,127 @@ void Parser::parseNodesAndWays ( const XmlTree::Node& xmlNode, Nodes& nodes, Way
   // Add each node.
   BOOST_FOREACH ( XmlTree::Node::ValidRefPtr xmlNode, children )
   {
-    // Get the attributes.
-    Attributes attributes ( xmlNode->attributes() );
-    
-    // Get the id.
-    IdType id ( Usul::Convert::Type<std::string,IdType>::convert ( attributes["id"] ) );
+    Parser::_parseElement ( *xmlNode, map, nodes, ways );
+  }
+}
 
-    // Get the date.
-    DateType date ( DateType::createFromKml ( attributes["timestamp"] ) );
 
-    // Tags for the node.
-    Tags tags;
-    Parser::_parseTags ( *xmlNode, tags );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse a node or a way.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    // Is the xml element a node?
-    if ( "node" == xmlNode->name() )
-    {
-      // Lat/Lon position.
-      const double lat ( Usul::Convert::Type<std::string,double>::convert ( attributes["lat"] ) );
-      const double lon ( Usul::Convert::Type<std::string,double>::convert ( attributes["lon"] ) );
-
-      // Create the node.
-      Node::RefPtr osmNode ( Node::create ( id, LocationType ( lon, lat ), date, tags ) );
-      nodes.push_back ( osmNode );
-      map.insert ( std::make_pair ( id, osmNode ) );
-    }
+void Parser::_parseElement ( const XmlTree::Node& xmlNode, NodeMap& map, Nodes& nodes, Ways& ways )
+{
+  // Get the attributes.
+  Attributes attributes ( xmlNode.attributes() );
+  
+  // Get the id.
+  IdType id ( Usul::Convert::Type<std::string,IdType>::convert ( attributes["id"] ) );
 
-    // Is the xml element a way?
-    else if ( "way" == xmlNode->name() )
-    {
-      // Nodes for this way.
-      Nodes nodes;
+  // Get the date.
+  DateType date ( DateType::createFromKml ( attributes["timestamp"] ) );
+
+  // Tags for the node.
+  Tags tags;
+  Parser::_parseTags ( xmlNode, tags );
+
+  // Is the xml element a node?
+  if ( "node" == xmlNode.name() )
+  {
+    // Lat/Lon position.
+    const double lat ( Usul::Convert::Type<std::string,double>::convert ( attributes["lat"] ) );
+    const double lon ( Usul::Convert::Type<std::string,double>::convert ( attributes["lon"] ) );
+
+    // Create the node.
+    Node::RefPtr osmNode ( Node::create ( id, LocationType ( lon, lat ), date, tags ) );
+    nodes.push_back ( osmNode );
+    map.insert ( std::make_pair ( id, osmNode ) );
+  }
+
+  // Is the xml element a way?
+  else if ( "way" == xmlNode.name() )
+  {
+    // Nodes for this way.
+    Nodes nodes;
 
-      // Parse the nodes.
-      BOOST_FOREACH ( XmlTree::Node::ValidRefPtr child, xmlNode->children() )
+    // Parse the nodes.
+    BOOST_FOREACH ( XmlTree::Node::ValidRefPtr child, xmlNode.children() )
+    {
+      if ( "nd" == child->name() )
       {
-        if ( "nd" == child->name() )
-        {
-          // Get the attributes.
-          Attributes a ( child->attributes() );
+        // Get the attributes.
+        Attributes a ( child->attributes() );
 
-          // Get the node id.
-          const IdType nodeId ( Usul::Convert::Type<std::string,IdType>::convert ( a["ref"] ) );
+        // Get the node id.
+        const IdType nodeId ( Usul::Convert::Type<std::string,IdType>::convert ( a["ref"] ) );
 
-          // Get the node.
-          Node::RefPtr osmNode ( map[nodeId] );
+        // Get the node.
+        NodeMap::const_iterator iter ( map.find ( nodeId ) );
 
-          // Add the node.
-          if ( true == osmNode.valid() )
-            nodes.push_back ( osmNode );
-        }
+        // Add the node.
+        if ( ( map.end() != iter ) && ( true == iter->second.valid() ) )
+          nodes.push_back ( iter->second );
       }
-
-      ways.push_back ( Way::create ( id, date, tags, nodes ) );
     }
+
+    ways.push_back ( Way::create ( id, date, tags, nodes ) );
   }
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Builds the nodes and ways as the file is read. Only one element of the 
+//  file is built as xml nodes at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct Parser::Stream : public XmlTree::StreamHandler
+{
+  Stream ( Nodes& nodes, Ways& ways, Extents& bounds ) : 
+    _nodes ( nodes ), 
+    _ways ( ways ), 
+    _bounds ( bounds ),
+    _hasBounds ( false ),
+    _map()
+  {
+  }
+
+  virtual bool startElement ( const std::string &name, const Attributes &attributes, unsigned int depth )
+  {
+    return ( 2 == depth && ( "node" == name || "way" == name || "bounds" == name ) );
+  }
+
+  virtual void subTree ( XmlTree::Node &node, unsigned int depth )
+  {
+    if ( "bounds" == node.name() )
+    {
+      _bounds = Parser::parseExtents ( node );
+      _hasBounds = true;
+    }
+    else
+    {
+      Parser::_parseElement ( node, _map, _nodes, _ways );
+    }
+  }
+
+  bool hasBounds() const
+  {
+    return _hasBounds;
+  }
+
+private:
+
+  Nodes &_nodes;
+  Ways &_ways;
+  Extents &_bounds;
+  bool _hasBounds;
+  NodeMap _map;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Parse the xml into ways and nodes.
@@ -154,13 +218,26 @@ void Parser::parseNodesAndWays ( const XmlTree::Node& xmlNode, Nodes& nodes, Way
 ///////////////////////////////////////////////////////////////////////////////
 
 void Parser::parseNodesAndWays ( const std::string& filename, Nodes& nodes, Ways& ways )
+{
+  Extents bounds ( 0.0, 0.0, 0.0, 0.0 );
+  Parser::parseNodesAndWays ( filename, nodes, ways, bounds );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse the xml into ways and nodes as the file is read.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Parser::parseNodesAndWays ( const std::string& filename, Nodes& nodes, Ways& ways, Extents& bounds )
 {
   XmlTree::XercesLife life;
-  XmlTree::Document::RefPtr doc ( new XmlTree::Document );
-  doc->load ( filename );
 
-  // Redirect
-  parseNodesAndWays ( *doc, nodes, ways );
+  Parser::Stream stream ( nodes, ways, bounds );
+  XmlTree::Loader().parse ( filename, stream );
+
+  return stream.hasBounds();
 }
 
 
@@ -19,6 +19,7 @@
 #include "Minerva/Layers/OSM/Common.h"
 #include "Minerva/Layers/OSM/LineString.h"
 
+#include <map>
 #include <string>
 
 namespace XmlTree { class Node; }
@@ -36,6 +37,9 @@ public:
   // Parse the xml into ways and nodes.
   static void    parseNodesAndWays ( const std::string& filename, Nodes& nodes, Ways& ways );
   static void    parseNodesAndWays ( const XmlTree::Node& node, Nodes& nodes, Ways& ways );
+
+  // Parse the file as it is read. Returns true if the file has bounds.
+  static bool    parseNodesAndWays ( const std::string& filename, Nodes& nodes, Ways& ways, Extents& bounds );
   
   static void parseLines ( const std::string& filename, Lines& lines );
 
@@ -45,7 +49,11 @@ private:
 
   typedef Minerva::Layers::OSM::Object OSMObject;
   typedef OSMObject::Tags Tags;
+  typedef std::map<OSMObject::IdType,OSMNodePtr> NodeMap;
+
+  struct Stream;
 
+  static void _parseElement ( const XmlTree::Node& node, NodeMap& map, Nodes& nodes, Ways& ways );
   static void _parseTags ( const XmlTree::Node& node, Tags& tags );
 };
 
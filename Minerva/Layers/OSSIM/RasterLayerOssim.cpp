@@ -351,11 +351,16 @@ RasterLayerOssim::ImagePtr RasterLayerOssim::texture ( const Extents& extents, u
     // Convert to osg::Image.
     result = this->_convert ( *data );
 
-    // Get the cache filename.
-    const std::string cacheFile ( this->_cacheFileName ( extents, width, height, level ) );
-    
     // Save the image to the cache.
-    RasterLayerOssim::_writeImageFile ( cacheFile, data.get() );
+    if ( true == this->cachePacked() )
+    {
+      this->_writeImageToCache ( extents, width, height, level, result );
+    }
+    else
+    {
+      const std::string cacheFile ( this->_cacheFileName ( extents, width, height, level ) );
+      RasterLayerOssim::_writeImageFile ( cacheFile, data.get() );
+    }
   }
 
   return result;
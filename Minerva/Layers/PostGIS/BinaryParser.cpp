@@ -17,8 +17,8 @@
 
 #include "Usul/Endian/Endian.h"
 
-#include <algorithm>
-#include <functional>
+#include <cstring>
+#include <stdexcept>
 
 using namespace Minerva::Layers::PostGIS;
 
@@ -43,7 +43,11 @@ namespace Detail
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-BinaryParser::BinaryParser()
+BinaryParser::BinaryParser ( const std::string& wkt ) :
+  _transform ( new Transform ( wkt, Transform::wgs84AsWellKnownText() ) ),
+  _x(),
+  _y(),
+  _z()
 {
 }
 
@@ -56,27 +60,24 @@ BinaryParser::BinaryParser()
 
 BinaryParser::~BinaryParser()
 {
+  delete _transform;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Predicate for comparing vertices.  Should probably use CloseFloat for robustness.
+//  Make sure there are enough bytes left.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace Detail
 {
-  struct VectorCompare : std::binary_function< Usul::Math::Vec2d,
-                                               Usul::Math::Vec2d,
-                                               bool >
+  inline void checkSize ( const unsigned char *buffer, const unsigned char *end, unsigned int count, unsigned int size )
   {
-    template < class T >
-    bool operator() ( const T& lhs, const T& rhs ) const
-    {
-      return lhs.equal( rhs );
-    }
-  };
+    const unsigned int remaining ( static_cast < unsigned int > ( end - buffer ) );
+    if ( buffer > end || count > remaining / size )
+      throw std::runtime_error ( "Error 2491687093: Geometry ends before all of its data." );
+  }
 }
 
 
@@ -89,119 +90,141 @@ namespace Detail
 namespace Detail
 {
   template < typename Type, class Convert >
-  Type convert ( const unsigned char *& buffer )
+  Type convert ( const unsigned char *& buffer, const unsigned char *end )
   {
     Type t;
     const unsigned int size ( sizeof ( t ) );
+    Detail::checkSize ( buffer, end, 1, size );
     ::memcpy( &t, buffer, size );
     buffer += size;
 
-		Convert::convert( t );
+    Convert::convert( t );
     return t;
   }
 }
 
+
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Create vertices from binary string.
+//  Read the vertices and append them. The coordinates are split into the
+//  reused arrays, converted, and transformed all at once.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-namespace Detail
+template < class Convert >
+void BinaryParser::_readVertices ( const unsigned char*& buffer, const unsigned char* end, Vertices& vertices )
 {
+  typedef Usul::Types::Float64 Float64;
+  const unsigned int VERTEX_SIZE ( 2 * sizeof ( Float64 ) );
 
-  template < class Convert, class Vertices >
-  void createVertices ( const unsigned char*& buffer, Vertices& vertices, const Transform& transform )
-  {
-    typedef typename Vertices::value_type Vertex;
-
-    Usul::Types::Uint32 numPoints ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
-    vertices.reserve ( numPoints );
+  const Usul::Types::Uint32 numPoints ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
+  if ( 0 == numPoints )
+    return;
 
-	  for ( Usul::Types::Uint32 i = 0; i < numPoints; ++i )
-	  {
-      Usul::Types::Float64 x ( convert < Usul::Types::Float64, Convert > ( buffer ) );
-      Usul::Types::Float64 y ( convert < Usul::Types::Float64, Convert > ( buffer ) );
-      
-      vertices.push_back ( transform ( Vertex ( x, y, 0.0 ) ) );
-	  }
+  Detail::checkSize ( buffer, end, numPoints, VERTEX_SIZE );
 
-    // Remove any duplicate vertices.
-    vertices.erase ( std::unique ( vertices.begin(), vertices.end(), Detail::VectorCompare() ), vertices.end() );
+  // The buffers only grow.
+  if ( _x.size() < numPoints )
+  {
+    _x.resize ( numPoints );
+    _y.resize ( numPoints );
+    _z.resize ( numPoints );
   }
 
-}
+  Float64 *x ( &_x[0] );
+  Float64 *y ( &_y[0] );
+  Float64 *z ( &_z[0] );
 
+  // The loop has no branches, so the compiler can vectorize it.
+  for ( Usul::Types::Uint32 i = 0; i < numPoints; ++i )
+  {
+    const unsigned char *vertex ( buffer + i * VERTEX_SIZE );
+    ::memcpy ( x + i, vertex, sizeof ( Float64 ) );
+    ::memcpy ( y + i, vertex + sizeof ( Float64 ), sizeof ( Float64 ) );
+    Convert::convert ( x[i] );
+    Convert::convert ( y[i] );
+    z[i] = 0.0;
+  }
+  buffer += numPoints * VERTEX_SIZE;
 
-namespace Detail
-{
-  ///////////////////////////////////////////////////////////////////////////////
-  //
-  //  Create a point.
-  //
-  ///////////////////////////////////////////////////////////////////////////////
-
-  template < class Convert >
-  Point* createPoint ( const unsigned char *& buffer, const Transform& transform )
+  ( *_transform ) ( numPoints, x, y, z );
+
+  // Append, skipping repeated vertices.
+  vertices.reserve ( vertices.size() + numPoints );
+  for ( Usul::Types::Uint32 i = 0; i < numPoints; ++i )
   {
-    Point::RefPtr point ( new Point );
+    const Usul::Math::Vec3d v ( x[i], y[i], z[i] );
+    if ( true == vertices.empty() || false == vertices.back().equal ( v ) )
+    {
+      vertices.push_back ( v );
+    }
+  }
+}
 
-    Usul::Types::Float64 x ( convert < Usul::Types::Float64, Convert > ( buffer ) );
-    Usul::Types::Float64 y ( convert < Usul::Types::Float64, Convert > ( buffer ) );
 
-    point->point ( transform ( Usul::Math::Vec3d ( x, y, 0.0 ) ) );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create a point.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    return point.release();
-  }
+template < class Convert >
+BinaryParser::Geometry* BinaryParser::_createPoint ( const unsigned char *& buffer, const unsigned char* end )
+{
+  Detail::Point::RefPtr point ( new Detail::Point );
 
+  Usul::Types::Float64 x ( Detail::convert < Usul::Types::Float64, Convert > ( buffer, end ) );
+  Usul::Types::Float64 y ( Detail::convert < Usul::Types::Float64, Convert > ( buffer, end ) );
 
-  ///////////////////////////////////////////////////////////////////////////////
-  //
-  //  Create a line.
-  //
-  ///////////////////////////////////////////////////////////////////////////////
+  point->point ( ( *_transform ) ( Usul::Math::Vec3d ( x, y, 0.0 ) ) );
 
-  template < class Convert >
-  Line* createLine ( const unsigned char *& buffer, const Transform& transform )
-  {
-    Line::RefPtr line ( new Line );
+  return point.release();
+}
 
-    typedef Line::Vertices Vertices;
 
-    Vertices vertices;
-	  Detail::createVertices < Convert, Vertices > ( buffer, vertices, transform );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create a line.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    line->line( vertices );
+template < class Convert >
+BinaryParser::Geometry* BinaryParser::_createLine ( const unsigned char *& buffer, const unsigned char* end )
+{
+  Detail::Line::RefPtr line ( new Detail::Line );
 
-    return line.release();
-  }
+  Vertices vertices;
+  this->_readVertices < Convert > ( buffer, end, vertices );
 
+  line->line( vertices );
 
-  ///////////////////////////////////////////////////////////////////////////////
-  //
-  //  Create a polygon.
-  //
-  ///////////////////////////////////////////////////////////////////////////////
+  return line.release();
+}
 
-  template < class Convert >
-  Polygon* createPolygon ( const unsigned char *& buffer, const Transform& transform )
-  {
-    Polygon::RefPtr polygon ( new Polygon );
 
-    Usul::Types::Uint32 numRings ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create a polygon.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    typedef Line::Vertices Vertices;
-    Vertices vertices;
+template < class Convert >
+BinaryParser::Geometry* BinaryParser::_createPolygon ( const unsigned char *& buffer, const unsigned char* end )
+{
+  Detail::Polygon::RefPtr polygon ( new Detail::Polygon );
 
-    for ( Usul::Types::Uint32 i = 0; i < numRings; ++i )
-    {
-      Detail::createVertices < Convert, Vertices > ( buffer, vertices, transform );
-    }
+  Usul::Types::Uint32 numRings ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
 
-    polygon->line ( vertices );
+  Vertices vertices;
 
-    return polygon.release();
+  for ( Usul::Types::Uint32 i = 0; i < numRings; ++i )
+  {
+    this->_readVertices < Convert > ( buffer, end, vertices );
   }
+
+  polygon->line ( vertices );
+
+  return polygon.release();
 }
 
 
@@ -212,57 +235,57 @@ namespace Detail
 ///////////////////////////////////////////////////////////////////////////////
 
 template < class Convert >
-void BinaryParser::_createGeometryEndian ( const unsigned char*& buffer, Geometries &geometries, const Transform& transform )
+void BinaryParser::_createGeometryEndian ( const unsigned char*& buffer, const unsigned char* end, Geometries &geometries )
 {
-  Usul::Types::Uint32 polygonType ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
-
-	switch ( polygonType )
-	{
-	case wkbPoint:       geometries.push_back ( Detail::createPoint   < Convert > ( buffer, transform ) ); break;
-  case wkbLineString:  geometries.push_back ( Detail::createLine    < Convert > ( buffer, transform ) ); break;
-  case wkbPolygon:     geometries.push_back ( Detail::createPolygon < Convert > ( buffer, transform ) ); break;
-	case wkbMultiPoint:
-		{
+  Usul::Types::Uint32 polygonType ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
+
+  switch ( polygonType )
+  {
+  case wkbPoint:       geometries.push_back ( this->_createPoint   < Convert > ( buffer, end ) ); break;
+  case wkbLineString:  geometries.push_back ( this->_createLine    < Convert > ( buffer, end ) ); break;
+  case wkbPolygon:     geometries.push_back ( this->_createPolygon < Convert > ( buffer, end ) ); break;
+  case wkbMultiPoint:
+    {
       // How many points will we have?
-      Usul::Types::Uint32 numPoints ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
+      Usul::Types::Uint32 numPoints ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
 
       // Loop through and add the points.
       for( Usul::Types::Uint32 i = 0; i < numPoints; ++i )
-			{
-        this->_createGeometry( buffer, geometries, transform );
+      {
+        this->_createGeometry( buffer, end, geometries );
       }
-		}
-		break;
-	case wkbMultiLineString:
-		{
+    }
+    break;
+  case wkbMultiLineString:
+    {
       // Get the number of lines to expect.
-      Usul::Types::Uint32 numLines ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
+      Usul::Types::Uint32 numLines ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
 
-			for( Usul::Types::Uint32 i = 0; i < numLines; ++i )
-			{
-        this->_createGeometry ( buffer, geometries, transform );
+      for( Usul::Types::Uint32 i = 0; i < numLines; ++i )
+      {
+        this->_createGeometry ( buffer, end, geometries );
       }
-		}
-		break;
-	case wkbMultiPolygon:
-		{
+    }
+    break;
+  case wkbMultiPolygon:
+    {
       // Get the number of polygons to expect.
-      Usul::Types::Uint32 numPolygons ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer ) );
-
-			for( Usul::Types::Uint32 i = 0; i < numPolygons; ++i )
-			{
-        this->_createGeometry ( buffer, geometries, transform );
-			}
-		}
-		break;
-	case wkbGeometryCollection:
-		{
-      this->_createGeometry ( buffer, geometries, transform );
-		}
-		break;
+      Usul::Types::Uint32 numPolygons ( Detail::convert < Usul::Types::Uint32, Convert > ( buffer, end ) );
+
+      for( Usul::Types::Uint32 i = 0; i < numPolygons; ++i )
+      {
+        this->_createGeometry ( buffer, end, geometries );
+      }
+    }
+    break;
+  case wkbGeometryCollection:
+    {
+      this->_createGeometry ( buffer, end, geometries );
+    }
+    break;
   default:
     throw std::runtime_error ("Error 4919319700: Unknown geometry type." );
-	}
+  }
 }
 
 
@@ -272,37 +295,48 @@ void BinaryParser::_createGeometryEndian ( const unsigned char*& buffer, Geometr
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void BinaryParser::_createGeometry ( const unsigned char*& buffer, Geometries &geometries, const Transform& transform )
+void BinaryParser::_createGeometry ( const unsigned char*& buffer, const unsigned char* end, Geometries &geometries )
 {
-  Usul::Types::Uint8 endian ( 0 );
-	::memcpy( &endian, buffer, sizeof( endian ) );
-  buffer += sizeof(endian);
+  const Usul::Types::Uint8 endian ( Detail::convert < Usul::Types::Uint8, Usul::Endian::FromSystemToSystem > ( buffer, end ) );
 
   switch ( endian )
   {
-	// Big endian.
+  // Big endian.
   case wkbBigEndian:
-		return this->_createGeometryEndian < Usul::Endian::FromBigToSystem > ( buffer, geometries, transform );
-	// Little endian.
+    return this->_createGeometryEndian < Usul::Endian::FromBigToSystem > ( buffer, end, geometries );
+  // Little endian.
   case wkbLittleEndian:
-		return this->_createGeometryEndian < Usul::Endian::FromLittleToSystem > ( buffer, geometries, transform );
-	}
+    return this->_createGeometryEndian < Usul::Endian::FromLittleToSystem > ( buffer, end, geometries );
+  }
 
   throw std::runtime_error ( "Error 1713426630: Unknown endian type." );
 }
 
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Parse and create geomtry.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-BinaryParser::Geometries BinaryParser::operator() ( const unsigned char* buffer, const std::string& wkt )
+BinaryParser::Geometries BinaryParser::operator() ( const unsigned char* buffer, unsigned int size )
 {
-  // Transform to wgs 84.
-  Transform transform ( wkt, Transform::wgs84AsWellKnownText() );
-  
   Geometries geometries;
-  this->_createGeometry ( buffer, geometries, transform );
+  if ( 0x0 != buffer && size > 0 )
+  {
+    this->_createGeometry ( buffer, buffer + size, geometries );
+  }
   return geometries;
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse and create geomtry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+BinaryParser::Geometries BinaryParser::operator() ( const Bytes& bytes )
+{
+  return ( false == bytes.empty() ) ? ( *this ) ( &bytes[0], static_cast < unsigned int > ( bytes.size() ) ) : Geometries();
+}
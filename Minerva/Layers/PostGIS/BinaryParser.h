@@ -12,6 +12,10 @@
 //
 //  Use this parser when using the asBinary postGIS function.
 //
+//  Make one parser for all the rows of a query. The coordinate transform 
+//  and the buffers for the coordinates are made once and reused, so rows 
+//  only allocate the geometry they return.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef __MINERVA_POSTGIS_BINARY_PARSER_H__
@@ -22,10 +26,12 @@
 #include "Minerva/Core/Data/Geometry.h"
 
 #include "Usul/Math/Vector2.h"
+#include "Usul/Math/Vector3.h"
 #include "Usul/Types/Types.h"
 #include "Usul/Base/Referenced.h"
 #include "Usul/Pointers/Pointers.h"
 
+#include <string>
 #include <vector>
 
 namespace Minerva { namespace Core { namespace Data { class Transform; } } }
@@ -37,12 +43,16 @@ namespace PostGIS {
 class MINERVA_POSTGIS_EXPORT BinaryParser
 {
 public:
-  BinaryParser();
-  ~BinaryParser();
-
   typedef Minerva::Core::Data::Geometry Geometry;
   typedef std::vector < Geometry::RefPtr > Geometries;
   typedef Minerva::Core::Data::Transform Transform;
+  typedef std::vector < Usul::Math::Vec3d > Vertices;
+  typedef std::vector < Usul::Types::Float64 > Coordinates;
+  typedef std::vector < unsigned char > Bytes;
+
+  // Construct with the well known text of the data's projection.
+  BinaryParser ( const std::string& wkt );
+  ~BinaryParser();
 
   enum wkbGeometryType 
   {
@@ -61,14 +71,36 @@ public:
     wkbLittleEndian = 1
   };
 
-  Geometries              operator() ( const unsigned char* buffer, const std::string& wkt );
+  // Parse the geometry and transform it to wgs 84.
+  Geometries              operator() ( const unsigned char* buffer, unsigned int size );
+  Geometries              operator() ( const Bytes& bytes );
 
 protected:
 
   template < class Convert >
-	void _createGeometryEndian ( const unsigned char*& buffer, Geometries&, const Transform& );
-  void _createGeometry       ( const unsigned char*& buffer, Geometries&, const Transform& );
+  void                    _createGeometryEndian ( const unsigned char*& buffer, const unsigned char* end, Geometries& );
+  void                    _createGeometry       ( const unsigned char*& buffer, const unsigned char* end, Geometries& );
+
+  template < class Convert >
+  Geometry*               _createPoint   ( const unsigned char*& buffer, const unsigned char* end );
+  template < class Convert >
+  Geometry*               _createLine    ( const unsigned char*& buffer, const unsigned char* end );
+  template < class Convert >
+  Geometry*               _createPolygon ( const unsigned char*& buffer, const unsigned char* end );
+
+  template < class Convert >
+  void                    _readVertices ( const unsigned char*& buffer, const unsigned char* end, Vertices& );
+
+private:
+
+  // Do not copy.
+  BinaryParser ( const BinaryParser& );
+  BinaryParser& operator= ( const BinaryParser& );
 
+  Transform *_transform;
+  Coordinates _x;
+  Coordinates _y;
+  Coordinates _z;
 };
 
 }
@@ -11,7 +11,6 @@
 #include "Minerva/Layers/PostGIS/Layer.h"
 #include "Minerva/Layers/PostGIS/BinaryParser.h"
 
-#include "Minerva/DataSources/BinaryString.h"
 
 #include "Minerva/Core/Data/Transform.h"
 #include "Minerva/Core/Data/TimeSpan.h"
@@ -1388,6 +1387,10 @@ void Layer::_buildDataObjects ( Usul::Interfaces::IUnknown *caller, Usul::Interf
   
   // Get the Well Known Text for the projection.
   const std::string wkt ( this->projectionWKT() );
+
+  // One parser and buffer for all the rows.
+  BinaryParser parser ( wkt );
+  Minerva::DataSources::Result::Bytes buffer;
   
   // Loop through the results.
   unsigned int num ( 0 );
@@ -1426,10 +1429,9 @@ void Layer::_buildDataObjects ( Usul::Interfaces::IUnknown *caller, Usul::Interf
         data->timePrimitive ( span.get() );
       }
       
-      // Make the parser.
-      Minerva::DataSources::BinaryString::RefPtr buffer ( geometryResult->asBlob ( "geom" ) );
-      BinaryParser parser;
-      BinaryParser::Geometries geometries ( parser ( &buffer->byteBuffer()[0], wkt ) );
+      // Parse the geometry.
+      geometryResult->asBytes ( "geom", buffer );
+      BinaryParser::Geometries geometries ( parser ( buffer ) );
       
       for ( BinaryParser::Geometries::iterator geom = geometries.begin(); geom != geometries.end(); ++geom )
       {
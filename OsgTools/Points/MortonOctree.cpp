@@ -0,0 +1,419 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Builds an octree from all of the points at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Points/MortonOctree.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/Algorithms/Parallel.h"
+#include "Usul/Algorithms/RadixSort.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Trace/Trace.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace OsgTools::Points;
+
+const MortonOctree::Uint32 MortonOctree::INVALID ( std::numeric_limits < MortonOctree::Uint32 >::max() );
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 Uint64;
+
+  // The most levels that fit three bits each in a 64 bit key.
+  const Uint32 MAX_LEVELS ( 21 );
+
+  // Put two zero bits after each of the lower 21 bits.
+  inline Uint64 spread ( Uint64 x )
+  {
+    x &= 0x1fffff;
+    x = ( x | ( x << 32 ) ) & 0x001f00000000ffffULL;
+    x = ( x | ( x << 16 ) ) & 0x001f0000ff0000ffULL;
+    x = ( x | ( x <<  8 ) ) & 0x100f00f00f00f00fULL;
+    x = ( x | ( x <<  4 ) ) & 0x10c30c30c30c30c3ULL;
+    x = ( x | ( x <<  2 ) ) & 0x1249249249249249ULL;
+    return x;
+  }
+
+  // The cell of the value along one axis.
+  inline Uint64 cell ( float value, float min, float scale, Uint64 maxCell )
+  {
+    const float c ( ( value - min ) * scale );
+    if ( false == ( c > 0.0f ) )
+      return 0;
+    return std::min ( static_cast < Uint64 > ( c ), maxCell );
+  }
+
+  // The bounds of the child, split the same way as OctTreeNode.
+  inline osg::BoundingBox child ( const osg::BoundingBox &bb, Uint32 i )
+  {
+    const osg::Vec3 min ( bb._min );
+    const osg::Vec3 max ( bb._max );
+    const osg::Vec3 mid ( min + ( ( max - min ) / 2 ) );
+    return osg::BoundingBox ( ( ( i & 1 ) ? mid.x() : min.x() ), ( ( i & 2 ) ? mid.y() : min.y() ), ( ( i & 4 ) ? mid.z() : min.z() ),
+                              ( ( i & 1 ) ? max.x() : mid.x() ), ( ( i & 2 ) ? max.y() : mid.y() ), ( ( i & 4 ) ? max.z() : mid.z() ) );
+  }
+
+  // Compares the child digit of a key with a child index.
+  struct DigitLess
+  {
+    DigitLess ( Uint32 shift ) : _shift ( shift ){}
+    bool operator () ( Uint64 key, Uint32 digit ) const
+    {
+      return static_cast < Uint32 > ( ( key >> _shift ) & 7 ) < digit;
+    }
+  private:
+    Uint32 _shift;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Makes the key of each point.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct MortonOctree::Encode
+{
+  Encode ( const Point *points, Keys &keys, const osg::BoundingBox &bb, Uint32 levels, Uint32 indexBits ) :
+    _points ( points ), _keys ( &keys ), _min ( bb._min ), _scale(), _maxCell ( ( Uint64 ( 1 ) << levels ) - 1 ), _indexBits ( indexBits )
+  {
+    const osg::Vec3 size ( bb._max - bb._min );
+    const float cells ( static_cast < float > ( Uint64 ( 1 ) << levels ) );
+    for ( unsigned int i = 0; i < 3; ++i )
+      _scale[i] = ( ( size[i] > 0.0f ) ? ( cells / size[i] ) : 0.0f );
+  }
+
+  void operator () ( Uint64 first, Uint64 last ) const
+  {
+    for ( Uint64 i = first; i < last; ++i )
+    {
+      const Point &p ( _points[i] );
+      const Uint64 code ( Helper::spread ( Helper::cell ( p[0], _min[0], _scale[0], _maxCell ) ) |
+                        ( Helper::spread ( Helper::cell ( p[1], _min[1], _scale[1], _maxCell ) ) << 1 ) |
+                        ( Helper::spread ( Helper::cell ( p[2], _min[2], _scale[2], _maxCell ) ) << 2 ) );
+      (*_keys)[static_cast < std::size_t > ( i )] = ( code << _indexBits ) | i;
+    }
+  }
+
+private:
+
+  const Point *_points;
+  Keys *_keys;
+  osg::Vec3 _min;
+  osg::Vec3 _scale;
+  Uint64 _maxCell;
+  Uint32 _indexBits;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Fills the nodes of one level.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct MortonOctree::Fill
+{
+  Fill ( MortonOctree &tree, const std::vector < Uint32 > &nodes, const Point *points ) :
+    _tree ( &tree ), _nodes ( &nodes ), _points ( points )
+  {
+  }
+
+  void operator () ( std::size_t first, std::size_t last ) const
+  {
+    for ( std::size_t i = first; i < last; ++i )
+      _tree->_fill ( (*_nodes)[i], _points );
+  }
+
+private:
+
+  MortonOctree *_tree;
+  const std::vector < Uint32 > *_nodes;
+  const Point *_points;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Node constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::Node::Node() :
+  bounds(),
+  depth ( 0 ),
+  first ( 0 ),
+  numPoints ( 0 ),
+  points ( 0x0 )
+{
+  std::fill ( children, children + 8, MortonOctree::INVALID );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the node a leaf?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool MortonOctree::Node::leaf() const
+{
+  return ( MortonOctree::INVALID == children[0] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::MortonOctree ( const osg::BoundingBox &bounds, Uint32 capacity ) : BaseClass(),
+  _bounds ( bounds ),
+  _capacity ( std::max < Uint32 > ( 1, capacity ) ),
+  _maxDepth ( 0 ),
+  _levels ( 0 ),
+  _indexBits ( 0 ),
+  _nodes(),
+  _keys()
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::~MortonOctree()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &MortonOctree::_destroy ), "1180386429" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MortonOctree::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  _nodes.clear();
+  Keys().swap ( _keys );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build the tree.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool MortonOctree::build ( const Point *points, Uint64 numPoints, Usul::Jobs::Job::RefPtr job, Usul::Jobs::Manager &manager )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this->mutex() );
+
+  _nodes.clear();
+  _maxDepth = 0;
+
+  if ( ( 0x0 == points ) || ( 0 == numPoints ) )
+    return true;
+
+  // Use the points' bounds when none were given.
+  if ( false == _bounds.valid() )
+  {
+    for ( Uint64 i = 0; i < numPoints; ++i )
+      _bounds.expandBy ( points[i] );
+  }
+
+  // The lower bits of each key hold the point's index, which leaves room
+  // for this many levels of cells above them.
+  _indexBits = 1;
+  while ( ( _indexBits < 64 ) && ( ( numPoints - 1 ) >> _indexBits ) > 0 )
+    ++_indexBits;
+  _levels = std::min ( Helper::MAX_LEVELS, ( 64 - _indexBits ) / 3 );
+
+  // Make the keys and sort them by cell.
+  _keys.resize ( static_cast < std::size_t > ( numPoints ) );
+  if ( false == Usul::Algorithms::parallelFor ( Uint64 ( 0 ), numPoints, Uint64 ( 64 * 1024 ), Encode ( points, _keys, _bounds, _levels, _indexBits ), job, manager ) )
+    return false;
+  if ( false == Usul::Algorithms::radixSort ( _keys, _indexBits, _indexBits + 3 * _levels, job, manager ) )
+    return false;
+
+  // Make the nodes.
+  this->_create ( 0, numPoints, _bounds, 0 );
+
+  // Fill them from the deepest level up, so children are done first.
+  std::vector < std::vector < Uint32 > > levels ( _maxDepth + 1 );
+  for ( Uint32 i = 0; i < _nodes.size(); ++i )
+    levels[_nodes[i].depth].push_back ( i );
+
+  bool finished ( true );
+  for ( Uint32 depth = _maxDepth + 1; ( depth > 0 ) && ( true == finished ); --depth )
+  {
+    const std::vector < Uint32 > &level ( levels[depth - 1] );
+    finished = Usul::Algorithms::parallelFor ( std::size_t ( 0 ), level.size(), std::size_t ( 16 ), Fill ( *this, level, points ), job, manager );
+  }
+
+  Keys().swap ( _keys );
+  return finished;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the node of the sorted keys in [first,last) and its children.
+//  Returns the node's index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::Uint32 MortonOctree::_create ( Uint64 first, Uint64 last, const osg::BoundingBox &bb, Uint32 depth )
+{
+  const Uint32 index ( static_cast < Uint32 > ( _nodes.size() ) );
+  _nodes.push_back ( Node() );
+  _nodes.back().bounds = bb;
+  _nodes.back().depth = depth;
+  _nodes.back().first = first;
+  _nodes.back().numPoints = last - first;
+  _maxDepth = std::max ( _maxDepth, depth );
+
+  // Leaves can have more than the capacity when there are no more levels.
+  if ( ( last - first <= _capacity ) || ( depth >= _levels ) )
+    return index;
+
+  // The keys of each child are together, in order of the child's digit.
+  const Helper::DigitLess less ( _indexBits + 3 * ( _levels - 1 - depth ) );
+  const Keys::const_iterator begin ( _keys.begin() + static_cast < std::size_t > ( first ) );
+  const Keys::const_iterator end ( _keys.begin() + static_cast < std::size_t > ( last ) );
+
+  Keys::const_iterator childBegin ( begin );
+  for ( Uint32 i = 0; i < 8; ++i )
+  {
+    const Keys::const_iterator childEnd ( ( 7 == i ) ? end : std::lower_bound ( childBegin, end, i + 1, less ) );
+    const Uint32 child ( this->_create ( first + ( childBegin - begin ), first + ( childEnd - begin ), Helper::child ( bb, i ), depth + 1 ) );
+
+    // The nodes may have moved, so look this one up again.
+    _nodes[index].children[i] = child;
+    childBegin = childEnd;
+  }
+
+  return index;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Fill the node. Leaves get their points in Morton order. Other nodes get
+//  up to the capacity, taken evenly from each child in proportion to how
+//  many points the child has. Called from many threads at once, one node
+//  each, after the node's children are filled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MortonOctree::_fill ( Uint32 index, const Point *points )
+{
+  Node &node ( _nodes[index] );
+  node.points = new osg::Vec3Array;
+
+  if ( true == node.leaf() )
+  {
+    const Uint64 mask ( ( Uint64 ( 1 ) << _indexBits ) - 1 );
+    node.points->resize ( static_cast < unsigned int > ( node.numPoints ) );
+    for ( Uint64 i = 0; i < node.numPoints; ++i )
+      (*node.points)[static_cast < unsigned int > ( i )] = points[_keys[static_cast < std::size_t > ( node.first + i )] & mask];
+    return;
+  }
+
+  node.points->reserve ( _capacity );
+  for ( Uint32 i = 0; i < 8; ++i )
+  {
+    const Node &child ( _nodes[node.children[i]] );
+    if ( ( false == child.points.valid() ) || ( true == child.points->empty() ) )
+      continue;
+
+    const Uint64 size ( child.points->size() );
+    const Uint64 take ( std::min ( size, ( Uint64 ( _capacity ) * child.numPoints ) / node.numPoints ) );
+    for ( Uint64 j = 0; j < take; ++j )
+      node.points->push_back ( (*child.points)[static_cast < unsigned int > ( ( j * size ) / take )] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the bounds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+osg::BoundingBox MortonOctree::bounds() const
+{
+  Guard guard ( this->mutex() );
+  return _bounds;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the capacity.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::Uint32 MortonOctree::capacity() const
+{
+  Guard guard ( this->mutex() );
+  return _capacity;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the depth of the deepest node.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MortonOctree::Uint32 MortonOctree::maxDepth() const
+{
+  Guard guard ( this->mutex() );
+  return _maxDepth;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the nodes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const MortonOctree::Nodes &MortonOctree::nodes() const
+{
+  return _nodes;
+}
@@ -0,0 +1,137 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Builds an octree from all of the points at once.
+//
+//  Each point gets a Morton code, which interleaves the bits of its cell in
+//  the finest grid. Sorting the codes puts the points of every octree node
+//  next to each other, so the nodes are found by searching the sorted codes
+//  instead of streaming the points to a file per node. The nodes are then
+//  filled from the deepest up: leaves copy their points, and every other
+//  node takes an even sample of its children's points for drawing from far
+//  away. The codes, the sort and each level of the fill run in parallel.
+//
+//  Children are in the same order as OctTreeNode's, where bit 0 of the
+//  child index is the upper half in x, bit 1 in y and bit 2 in z.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OSGTOOLS_POINTS_MORTON_OCTREE_H_
+#define _OSGTOOLS_POINTS_MORTON_OCTREE_H_
+
+#include "OsgTools/Export.h"
+
+#include "Usul/Base/Object.h"
+#include "Usul/Jobs/Job.h"
+#include "Usul/Jobs/Manager.h"
+#include "Usul/Pointers/Pointers.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Array"
+#include "osg/BoundingBox"
+#include "osg/Vec3"
+
+#include <vector>
+
+
+namespace OsgTools {
+namespace Points {
+
+
+class OSG_TOOLS_EXPORT MortonOctree : public Usul::Base::Object
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 Uint64;
+  typedef osg::Vec3f Point;
+  typedef osg::ref_ptr < osg::Vec3Array > Points;
+  typedef std::vector < Uint64 > Keys;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( MortonOctree );
+
+  // The child of a node that has none.
+  static const Uint32 INVALID;
+
+  // One node of the tree.
+  struct Node
+  {
+    Node();
+
+    osg::BoundingBox bounds;
+    Uint32 depth;
+    Uint32 children[8];
+    Uint64 first;
+    Uint64 numPoints;
+    Points points;
+
+    bool                    leaf() const;
+  };
+  typedef std::vector < Node > Nodes;
+
+  // Construction. Nodes with more points than the capacity are split.
+  MortonOctree ( const osg::BoundingBox &bounds, Uint32 capacity );
+
+  // Build the tree. Points outside the bounds go in the nearest node.
+  // Returns false if the job was canceled.
+  bool                      build ( const Point *points, Uint64 numPoints,
+                                    Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ),
+                                    Usul::Jobs::Manager &manager = Usul::Jobs::Manager::instance() );
+
+  // Get the bounds and capacity.
+  osg::BoundingBox          bounds() const;
+  Uint32                    capacity() const;
+
+  // Get the depth of the deepest node.
+  Uint32                    maxDepth() const;
+
+  // Get the nodes. The root is first and parents come before their
+  // children. Do not call while building.
+  const Nodes &             nodes() const;
+
+protected:
+
+  // Use reference counting.
+  virtual ~MortonOctree();
+
+private:
+
+  // No copying or assignment.
+  MortonOctree ( const MortonOctree & );
+  MortonOctree &operator = ( const MortonOctree & );
+
+  struct Encode;
+  struct Fill;
+
+  Uint32                    _create ( Uint64 first, Uint64 last, const osg::BoundingBox &, Uint32 depth );
+
+  void                      _destroy();
+
+  void                      _fill ( Uint32 node, const Point *points );
+
+  osg::BoundingBox _bounds;
+  Uint32 _capacity;
+  Uint32 _maxDepth;
+  Uint32 _levels;
+  Uint32 _indexBits;
+  Nodes _nodes;
+  Keys _keys;
+};
+
+
+} // namespace Points
+} // namespace OsgTools
+
+
+#endif // _OSGTOOLS_POINTS_MORTON_OCTREE_H_
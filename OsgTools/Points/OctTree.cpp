@@ -192,6 +192,25 @@ void OctTree::split(  Usul::Documents::Document* document, Unknown *caller, Unkn
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Create the octree from all of the points at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTree::build( const Point *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller, Unknown *progress )
+{
+  Guard guard ( this );
+  document->setStatusBar( "Step 2/2: Building Spatial Parameters...", progress );
+
+  MortonOctree::RefPtr tree ( new MortonOctree ( _tree->boundingBox(), _tree->capacity() ) );
+  if( false == tree->build( points, numPoints ) )
+    return;
+
+  _tree->build( *tree, 0 );
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
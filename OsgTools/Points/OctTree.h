@@ -71,6 +71,7 @@ public:
   unsigned int                  capacity();
 
   void                          split( Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
+  void                          build( const Point *points, Usul::Types::Uint64 numPoints, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
 
   void                          write( std::ofstream* ofs, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 ) const;
   void                          read ( std::ifstream* ifs, Usul::Documents::Document* document, Unknown *caller = 0x0, Unknown *progress = 0x0 );
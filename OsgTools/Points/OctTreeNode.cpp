@@ -30,6 +30,27 @@
 using namespace OsgTools::Points;
 USUL_IMPLEMENT_TYPE_ID ( OctTreeNode );
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make indices of every step'th point.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  template < class ElementsType > osg::PrimitiveSet *makeIndices ( unsigned int numPoints, unsigned int step )
+  {
+    osg::ref_ptr< ElementsType > indices ( new ElementsType ( osg::PrimitiveSet::POINTS ) );
+    indices->reserve( numPoints / step );
+    for( unsigned int i = 0; i < numPoints; i += step )
+    {
+      indices->push_back( i );
+    }
+    return indices.release();
+  }
+}
+
 //USUL_IMPLEMENT_IUNKNOWN_MEMBERS ( OctTreeNode, OctTreeNode::BaseClass );
 
  long                OctTreeNode::_streamCount  ( 0 );
@@ -198,6 +219,44 @@ bool OctTreeNode::add ( OctTreeNode::Point p )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Take the bounds, points and children of the node of a built tree.
+//  Leaves keep all their points and other nodes keep the sample for
+//  drawing from far away.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void OctTreeNode::build( const MortonOctree &tree, Usul::Types::Uint32 index )
+{
+  Guard guard ( this->mutex() );
+
+  const MortonOctree::Node &node ( tree.nodes().at( index ) );
+  _bb = node.bounds;
+  _points = ( ( true == node.points.valid() && false == node.points->empty() ) ? node.points.get() : 0x0 );
+  _children.clear();
+
+  if( true == node.leaf() )
+  {
+    this->type( POINT_HOLDER );
+    _numPoints = node.numPoints;
+    return;
+  }
+
+  this->type( NODE_HOLDER );
+  _numPoints = 0;
+  _children.resize( 8 );
+
+  for( unsigned int i = 0; i < 8; ++i )
+  {
+    _children.at( i ) = new OctTreeNode ( _streamBuffer, _tempPath );
+    _children.at( i )->distance( _distance );
+    _children.at( i )->capacity( _capacity );
+    _children.at( i )->build( tree, node.children[i] );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //
@@ -296,20 +355,17 @@ osg::Node* OctTreeNode::buildScene( Unknown *caller, Unknown *progress )
       {
         for( unsigned int lodLevel = 0; lodLevel < numLODs; ++lodLevel )
         {
-          //Points vertices ( new osg::Vec3Array );
-          ElementsPtr indices ( new osg::DrawElementsUShort ( osg::PrimitiveSet::POINTS ) );
-
 #if 0
           double lm ( static_cast< double >( _capacity - 1 ) / static_cast< double > ( _numLODs ) );
           unsigned short lodMultiplier = static_cast< unsigned short > ( lm * lodLevel ) + 1;
 #else
           unsigned int lodMultiplier ( _lodDefinitions.at( lodLevel ) );
 #endif
-          indices->reserve( static_cast< unsigned int > ( ( _points->size() / lodMultiplier ) ) );
-          for( unsigned int i = 0; i < _points->size(); i += lodMultiplier )
-          {
-            indices->push_back( i );
-          }
+          // Leaves of a built tree can be too big for short indices.
+          PrimitiveSetPtr indices ( ( _points->size() > std::numeric_limits< Elements::value_type >::max() ) ?
+            Helper::makeIndices< osg::DrawElementsUInt > ( _points->size(), lodMultiplier ) :
+            Helper::makeIndices< Elements > ( _points->size(), lodMultiplier ) );
+
           GeometryPtr geometry ( new osg::Geometry ); 
           geometry->setVertexArray( _points.get() );
           geometry->addPrimitiveSet( indices.get() );
@@ -347,6 +403,25 @@ osg::Node* OctTreeNode::buildScene( Unknown *caller, Unknown *progress )
         group->addChild( _children.at( i )->buildScene() );
       }
     } 
+
+    // Nodes of a built tree have a sample of their children's points to
+    // draw instead of the children when far away.
+    if( true == _points.valid() && false == _points->empty() )
+    {
+      GeometryPtr geometry ( new osg::Geometry );
+      geometry->setVertexArray( _points.get() );
+      geometry->addPrimitiveSet( new osg::DrawArrays ( osg::PrimitiveSet::POINTS, 0, _points->size() ) );
+
+      GeodePtr geode ( new osg::Geode );
+      geode->addDrawable( geometry.get() );
+
+      const float distance ( static_cast< float > ( 2.0 * this->getBoundingRadius() ) );
+      lod->addChild( group.get(), 0.0f, distance );
+      lod->addChild( geode.get(), distance, std::numeric_limits< float >::max() );
+
+      group = new osg::Group;
+      group->addChild( lod.get() );
+    }
   } 
 
   return group.release();
@@ -426,26 +501,29 @@ void OctTreeNode::buildVectors()
 #else
   if( POINT_HOLDER == this->type() && _numPoints > 0 )
   {
-    
-    //this->_openTempFileForRead();
-    std::ifstream &infile ( this->_getInputStream() );
-
-    if( false == _points.valid() )
+    // Nodes of a built tree already have their points.
+    if( false == _points.valid() || _points->size() != _numPoints )
     {
-      _points = new osg::Vec3Array;
-      _points->resize ( _numPoints, OctTreeNode::Point ( 0.0, 0.0, 0.0 ) );
-    }
+      //this->_openTempFileForRead();
+      std::ifstream &infile ( this->_getInputStream() );
 
-    unsigned int size = _points->size() * sizeof( OctTreeNode::Point );
+      if( false == _points.valid() )
+      {
+        _points = new osg::Vec3Array;
+        _points->resize ( _numPoints, OctTreeNode::Point ( 0.0, 0.0, 0.0 ) );
+      }
 
-    // Sanity check.
-    USUL_ASSERT ( size == Usul::File::size ( _tempFilename ) );
+      unsigned int size = _points->size() * sizeof( OctTreeNode::Point );
 
-    infile.read( reinterpret_cast<char *> ( &((*_points)[0]) ), size );
+      // Sanity check.
+      USUL_ASSERT ( size == Usul::File::size ( _tempFilename ) );
 
-    // Close the streams
-    this->_closeInputStream();
-    this->_closeOutputStream();
+      infile.read( reinterpret_cast<char *> ( &((*_points)[0]) ), size );
+
+      // Close the streams
+      this->_closeInputStream();
+      this->_closeOutputStream();
+    }
 
     // Increment the leaf node count
     ++_numLeafNodes;
@@ -18,6 +18,7 @@
 #define __EXPERIMENTAL_OCTTREENODE_H__
 
 #include "OsgTools/Export.h"
+#include "OsgTools/Points/MortonOctree.h"
 #include "OsgTools/Points/PointSetRecords.h"
 
 #include "Usul/Base/Object.h"
@@ -89,6 +90,9 @@ public:
   void                              capacity( unsigned int level );
   bool                              add( Point p );
 
+  // Take the bounds, points and children of the node of a built tree.
+  void                              build( const MortonOctree &tree, Usul::Types::Uint32 node );
+
   void                              buildVectors();
 
   osg::Node*                        buildScene( Unknown *caller = 0x0, Unknown *progress = 0x0 );
@@ -0,0 +1,383 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Times nested scopes and keeps the last few frames.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Render/FrameProfiler.h"
+
+#include "Usul/Adaptors/MemberFunction.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Trace/Recorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+using namespace OsgTools::Render;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+FrameProfiler::FrameProfiler ( unsigned int maxFrames ) : BaseClass(),
+  _paths      (),
+  _pathMap    (),
+  _eventNames (),
+  _stack      (),
+  _current    (),
+  _frameStart ( 0 ),
+  _frames     ( std::max ( 1u, maxFrames ) ),
+  _next       ( 0 ),
+  _count      ( 0 ),
+  _number     ( 0 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+FrameProfiler::~FrameProfiler()
+{
+  Usul::Functions::safeCall ( Usul::Adaptors::memberFunction ( this, &FrameProfiler::_destroy ), "3560212474" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::_destroy()
+{
+  _frames.clear();
+  _stack.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget all frames. Scopes that have started are kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::clear()
+{
+  Guard guard ( this );
+  _frames.assign ( _frames.size(), Frame() );
+  _next = 0;
+  _count = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the number of frames kept. This forgets the frames.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::maxFrames ( unsigned int num )
+{
+  Guard guard ( this );
+  _frames.assign ( std::max ( 1u, num ), Frame() );
+  _next = 0;
+  _count = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of frames kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int FrameProfiler::maxFrames() const
+{
+  Guard guard ( this );
+  return static_cast < unsigned int > ( _frames.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of frames kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int FrameProfiler::numFrames() const
+{
+  Guard guard ( this );
+  return _count;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the paths of all scopes that were timed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+FrameProfiler::Names FrameProfiler::names() const
+{
+  Guard guard ( this );
+  return _paths;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the i'th kept frame, oldest first. Caller has to lock the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const FrameProfiler::Frame &FrameProfiler::_frame ( unsigned int i ) const
+{
+  const unsigned int size ( static_cast < unsigned int > ( _frames.size() ) );
+  return _frames[( _next + size - _count + i ) % size];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number for the path, adding it if needed. Caller has to lock
+//  the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int FrameProfiler::_path ( const std::string &path )
+{
+  PathMap::const_iterator i ( _pathMap.find ( path ) );
+  if ( _pathMap.end() != i )
+  {
+    return i->second;
+  }
+
+  const unsigned int id ( static_cast < unsigned int > ( _paths.size() ) );
+  _paths.push_back ( path );
+  _pathMap.insert ( PathMap::value_type ( path, id ) );
+  _eventNames.push_back ( Usul::Trace::Recorder::intern ( path ) );
+  return id;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start a scope inside the current one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::start ( const std::string &name )
+{
+  const Uint64 now ( Usul::Trace::Recorder::now() );
+
+  Guard guard ( this );
+
+  if ( true == _stack.empty() )
+  {
+    _frameStart = now;
+    _current.samples.clear();
+  }
+
+  const std::string path ( ( true == _stack.empty() ) ? name : ( _paths[_stack.back().path] + "/" + name ) );
+
+  Open open;
+  open.name = name;
+  open.path = this->_path ( path );
+  open.start = now;
+  _stack.push_back ( open );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Stop the scope. When the outermost scope stops the frame is kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::stop ( const std::string &name )
+{
+  const Uint64 now ( Usul::Trace::Recorder::now() );
+  const bool recording ( Usul::Trace::Recorder::enabled() );
+
+  Guard guard ( this );
+
+  // Find the scope. Ignore names that were not started.
+  Stack::size_type found ( _stack.size() );
+  while ( found > 0 )
+  {
+    if ( name == _stack[found - 1].name )
+      break;
+    --found;
+  }
+  if ( 0 == found )
+    return;
+
+  // Stop it and any scope inside it.
+  while ( _stack.size() >= found )
+  {
+    const Open &open ( _stack.back() );
+
+    Sample sample;
+    sample.path = open.path;
+    sample.depth = static_cast < unsigned int > ( _stack.size() - 1 );
+    sample.start = open.start - _frameStart;
+    sample.duration = now - open.start;
+    _current.samples.push_back ( sample );
+
+    if ( true == recording )
+    {
+      Usul::Trace::Recorder::record ( _eventNames[open.path], open.start, now );
+    }
+
+    _stack.pop_back();
+  }
+
+  // Keep the frame when the outermost scope stops.
+  if ( true == _stack.empty() )
+  {
+    _current.number = _number++;
+    std::swap ( _frames[_next], _current );
+    _current.samples.clear();
+    _next = ( _next + 1 ) % _frames.size();
+    _count = std::min ( _count + 1, static_cast < unsigned int > ( _frames.size() ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the time that the given percent of frames stayed under. Uses the
+//  nearest rank, so the answer is always one of the frame's times.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+double FrameProfiler::percentile ( const std::string &name, double percent ) const
+{
+  Guard guard ( this );
+
+  // Which paths match?
+  std::vector < bool > matches ( _paths.size(), false );
+  bool any ( false );
+  const std::string ending ( "/" + name );
+  for ( unsigned int i = 0; i < _paths.size(); ++i )
+  {
+    const std::string &path ( _paths[i] );
+    matches[i] = ( ( path == name ) || ( ( path.size() > ending.size() ) && ( 0 == path.compare ( path.size() - ending.size(), ending.size(), ending ) ) ) );
+    any = any || matches[i];
+  }
+  if ( false == any )
+    return 0.0;
+
+  // The time of the matching scopes in each frame that has them.
+  std::vector < Uint64 > times;
+  times.reserve ( _count );
+  for ( unsigned int i = 0; i < _count; ++i )
+  {
+    const Frame &frame ( this->_frame ( i ) );
+    Uint64 sum ( 0 );
+    bool found ( false );
+    for ( Samples::const_iterator j = frame.samples.begin(); j != frame.samples.end(); ++j )
+    {
+      if ( true == matches[j->path] )
+      {
+        sum += j->duration;
+        found = true;
+      }
+    }
+    if ( true == found )
+    {
+      times.push_back ( sum );
+    }
+  }
+
+  if ( true == times.empty() )
+    return 0.0;
+
+  const double fraction ( std::min ( 100.0, std::max ( 0.0, percent ) ) / 100.0 );
+  const unsigned int rank ( static_cast < unsigned int > ( std::ceil ( fraction * times.size() ) ) );
+  const unsigned int index ( ( rank > 0 ) ? ( rank - 1 ) : 0 );
+
+  std::nth_element ( times.begin(), times.begin() + index, times.end() );
+  return static_cast < double > ( times[index] ) / 1000.0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the kept frames as comma-separated values. Times are milliseconds
+//  from the start of the frame.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::write ( std::ostream &out ) const
+{
+  Guard guard ( this );
+
+  out << "frame,path,depth,start_ms,duration_ms\n";
+  for ( unsigned int i = 0; i < _count; ++i )
+  {
+    const Frame &frame ( this->_frame ( i ) );
+
+    // Samples are kept in the order they stopped. Write them in the order
+    // they started, so a scope comes before the ones inside it.
+    Samples samples ( frame.samples );
+    std::stable_sort ( samples.begin(), samples.end(), FrameProfiler::_startsBefore );
+
+    for ( Samples::const_iterator j = samples.begin(); j != samples.end(); ++j )
+    {
+      out << frame.number << ',' << _paths[j->path] << ',' << j->depth << ','
+          << static_cast < double > ( j->start ) / 1000.0 << ','
+          << static_cast < double > ( j->duration ) / 1000.0 << '\n';
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the kept frames to the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameProfiler::write ( const std::string &file ) const
+{
+  std::ofstream out ( file.c_str() );
+  if ( false == out.is_open() )
+  {
+    throw std::runtime_error ( "Error 2881706213: Failed to open file for writing frame times: " + file );
+  }
+
+  this->write ( out );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  For sorting samples by start time, and outer scopes first.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool FrameProfiler::_startsBefore ( const Sample &a, const Sample &b )
+{
+  return ( ( a.start < b.start ) || ( ( a.start == b.start ) && ( a.depth < b.depth ) ) );
+}
@@ -0,0 +1,147 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Times nested scopes and keeps the last few frames.
+//
+//  Scopes are named, and a scope started inside another one is recorded
+//  under the path of both, like "frame/draw". A frame is everything inside
+//  one outermost scope. The last frames are kept in a ring, so that the
+//  percentiles show the spikes that an average hides.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OSG_TOOLS_RENDER_FRAME_PROFILER_H_
+#define _OSG_TOOLS_RENDER_FRAME_PROFILER_H_
+
+#include "OsgTools/Export.h"
+
+#include "Usul/Base/Object.h"
+#include "Usul/Types/Types.h"
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace OsgTools {
+namespace Render {
+
+
+class OSG_TOOLS_EXPORT FrameProfiler : public Usul::Base::Object
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Object BaseClass;
+  typedef Usul::Types::Uint64 Uint64;
+  typedef std::vector < std::string > Names;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( FrameProfiler );
+
+  // Constructor.
+  FrameProfiler ( unsigned int maxFrames = 300 );
+
+  // Forget all frames.
+  void                  clear();
+
+  // Set/get the number of frames kept.
+  void                  maxFrames ( unsigned int );
+  unsigned int          maxFrames() const;
+
+  // Get the paths of all scopes that were timed.
+  Names                 names() const;
+
+  // Get the number of frames kept.
+  unsigned int          numFrames() const;
+
+  // Return the time in milliseconds that the given percent of the kept
+  // frames stayed under, or zero if the scope wasn't timed. The name is a
+  // whole path like "frame/draw", or the end of one like "draw". Times of
+  // all matching scopes in one frame are added.
+  double                percentile ( const std::string &name, double percent ) const;
+
+  // Start and stop a scope. Stopping a scope also stops the ones inside it.
+  void                  start ( const std::string &name );
+  void                  stop ( const std::string &name );
+
+  // Write the kept frames as comma-separated values, one row per scope.
+  void                  write ( std::ostream & ) const;
+  void                  write ( const std::string &file ) const;
+
+protected:
+
+  // Use reference counting.
+  virtual ~FrameProfiler();
+
+private:
+
+  // No copying or assignment.
+  FrameProfiler ( const FrameProfiler & );
+  FrameProfiler &operator = ( const FrameProfiler & );
+
+  // One timed scope. Times are in microseconds from the start of the frame.
+  struct Sample
+  {
+    unsigned int path;
+    unsigned int depth;
+    Uint64 start;
+    Uint64 duration;
+  };
+  typedef std::vector < Sample > Samples;
+
+  struct Frame
+  {
+    Frame() : number ( 0 ), samples(){}
+    unsigned int number;
+    Samples samples;
+  };
+  typedef std::vector < Frame > Frames;
+
+  // A scope that has started.
+  struct Open
+  {
+    std::string name;
+    unsigned int path;
+    Uint64 start;
+  };
+  typedef std::vector < Open > Stack;
+
+  typedef std::map < std::string, unsigned int > PathMap;
+  typedef std::vector < unsigned int > EventNames;
+
+  void                  _destroy();
+
+  const Frame &         _frame ( unsigned int ) const;
+
+  unsigned int          _path ( const std::string & );
+
+  static bool           _startsBefore ( const Sample &, const Sample & );
+
+  Names _paths;
+  PathMap _pathMap;
+  EventNames _eventNames;
+  Stack _stack;
+  Frame _current;
+  Uint64 _frameStart;
+  Frames _frames;
+  unsigned int _next;
+  unsigned int _count;
+  unsigned int _number;
+};
+
+
+} // namespace Render
+} // namespace OsgTools
+
+
+#endif // _OSG_TOOLS_RENDER_FRAME_PROFILER_H_
@@ -61,6 +61,7 @@ Renderer::Renderer() : BaseClass(),
   _timer              ( ),
   _start_tick         ( 0 ),
   _times              ( ),
+  _profiler           ( new FrameProfiler ),
   _numPasses          ( 1 ),
   _contextId          ( 0 ),
   _hasAccumBuffer     ( false ),
@@ -559,6 +560,9 @@ void Renderer::timeStart( const std::string& name )
   // Record the time.
   TimePair now ( (double) Usul::System::Clock::milliseconds() / (double) CLOCKS_PER_SEC, 0 );
   _times[name].push_back ( now );
+
+  // Nest it in the frame.
+  _profiler->start ( name );
 }
 
 
@@ -578,6 +582,9 @@ void Renderer::timeStop( const std::string &name )
   // Trim to a reasonable size.
   while ( h.size() > 100 )
     h.pop_front();
+
+  // Stop it in the frame.
+  _profiler->stop ( name );
 }
 
 
@@ -632,6 +639,43 @@ double Renderer::timeAverage ( const std::string &name ) const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the time in seconds that the given percent of recent frames stayed 
+//  under. See FrameProfiler::percentile() for the names.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+double Renderer::timePercentile ( const std::string &name, double percent ) const
+{
+  return _profiler->percentile ( name, percent ) / 1000.0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the frame profiler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Renderer::FrameProfiler *Renderer::frameProfiler()
+{
+  return _profiler.get();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the frame profiler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Renderer::FrameProfiler *Renderer::frameProfiler() const
+{
+  return _profiler.get();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Set the number of rendering passes. Unavailable numbers have no effect.
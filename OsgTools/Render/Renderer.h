@@ -25,6 +25,7 @@
 #include "Usul/Interfaces/IRenderInfoOSG.h"
 
 #include "OsgTools/Builders/GradientBackground.h"
+#include "OsgTools/Render/FrameProfiler.h"
 
 #include "osgUtil/SceneView"
 
@@ -59,6 +60,7 @@ public:
   typedef OsgTools::Builders::GradientBackground GradientBackground;
   typedef GradientBackground::Corners            Corners;
   typedef osg::RenderInfo RenderInfo;
+  typedef OsgTools::Render::FrameProfiler FrameProfiler;
 
   // Constructor
   Renderer();
@@ -85,6 +87,10 @@ public:
   void                  setFrustum ( double left, double right, double bottom, double top, double near, double far );
   bool                  getFrustum ( double &left, double &right, double &bottom, double &top, double &near, double& far ) const;
 
+  // Get the profiler that keeps the last frames' times.
+  FrameProfiler *       frameProfiler();
+  const FrameProfiler * frameProfiler() const;
+
   // Get the frame stamp.
   osg::FrameStamp*       framestamp();
   const osg::FrameStamp* framestamp() const;
@@ -134,6 +140,10 @@ public:
   // Get the time.
   double                timeAverage ( const std::string &name ) const;
   double                timeLast    ( const std::string &name ) const;
+  double                timePercentile ( const std::string &name, double percent ) const;
+
+  // Start and stop the timer. Timers started inside another are nested in
+  // the frame profiler.
   void                  timeStart   ( const std::string &name );
   void                  timeStop    ( const std::string &name );
 
@@ -179,6 +189,7 @@ private:
   osg::Timer _timer;
   osg::Timer_t _start_tick;
   TimeHistories _times;
+  FrameProfiler::RefPtr _profiler;
   unsigned int _numPasses;  
   unsigned int _contextId;
   bool _hasAccumBuffer;
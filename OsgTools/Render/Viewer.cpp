@@ -37,6 +37,7 @@
 #include "OsgTools/Render/Constants.h"
 #include "OsgTools/Render/ClampProjection.h"
 #include "OsgTools/Render/FBOScreenCapture.h"
+#include "OsgTools/Render/RecordTime.h"
 #include "OsgTools/Callbacks/SortBackToFront.h"
 #include "OsgTools/Utilities/DirtyBounds.h"
 #include "OsgTools/Utilities/ReferenceFrame.h"
@@ -390,8 +391,15 @@ void Viewer::render()
   if ( _context.valid() )
     _context->makeCurrent();
 
+  // Time the whole frame. The renderer's times are inside it.
+  typedef OsgTools::Render::RecordTime < Renderer > RecordTime;
+  RecordTime ft ( *_renderer, "frame" );
+
   // Update display lists.
-  this->updateDisplayListUse();
+  {
+    RecordTime dt ( *_renderer, "display lists" );
+    this->updateDisplayListUse();
+  }
 
   // Initialize the error.
   ::glGetError();
@@ -450,13 +458,19 @@ void Viewer::render()
 
   // Swap the buffers.
   if ( _context.valid() )
+  {
+    RecordTime st ( *_renderer, "swap" );
     _context->swapBuffers();
+  }
 
   // Flush deleted GL objects.
-  this->viewer()->flushAllDeletedGLObjects();
+  {
+    RecordTime gt ( *_renderer, "flush" );
+    this->viewer()->flushAllDeletedGLObjects();
   
-  double maxtime ( std::numeric_limits<double>::max() );
-  osg::Texture::flushDeletedTextureObjects ( _contextId, Usul::System::Clock::milliseconds(), maxtime );
+    double maxtime ( std::numeric_limits<double>::max() );
+    osg::Texture::flushDeletedTextureObjects ( _contextId, Usul::System::Clock::milliseconds(), maxtime );
+  }
 
   // Check for errors.
   Detail::checkForErrors ( 896118310 );
@@ -1403,6 +1417,42 @@ double Viewer::timeAverage ( const std::string &name ) const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the time that the given percent of recent frames stayed under.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+double Viewer::timePercentile ( const std::string &name, double percent ) const
+{
+  return _renderer->timePercentile ( name, percent );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the frame profiler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Viewer::FrameProfiler *Viewer::frameProfiler()
+{
+  return _renderer->frameProfiler();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the frame profiler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Viewer::FrameProfiler *Viewer::frameProfiler() const
+{
+  return _renderer->frameProfiler();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Invalidate the various scene shortcuts.
@@ -4578,6 +4628,10 @@ void Viewer::_preRenderNotify()
 {
   USUL_TRACE_SCOPE;
   Guard guard ( this->mutex() );
+
+  // Listeners apply finished jobs here, so it gets its own time.
+  OsgTools::Render::RecordTime < Renderer > rt ( *_renderer, "pre render" );
+
   Usul::Interfaces::IUnknown::QueryPtr me ( this->queryInterface ( Usul::Interfaces::IUnknown::IID ) );
   std::for_each ( _renderListeners.begin(), _renderListeners.end(), std::bind2nd ( std::mem_fun ( &IRenderListener::preRenderNotify ), me.get() ) );
 }
@@ -4593,6 +4647,10 @@ void Viewer::_postRenderNotify()
 {
   USUL_TRACE_SCOPE;
   Guard guard ( this->mutex() );
+
+  // Listeners apply finished jobs here, so it gets its own time.
+  OsgTools::Render::RecordTime < Renderer > rt ( *_renderer, "post render" );
+
   Usul::Interfaces::IUnknown::QueryPtr me ( this->queryInterface ( Usul::Interfaces::IUnknown::IID ) );
   std::for_each ( _renderListeners.begin(), _renderListeners.end(), std::bind2nd ( std::mem_fun ( &IRenderListener::postRenderNotify ), me.get() ) );
 }
@@ -180,6 +180,7 @@ public:
   typedef std::vector<IMouseEventListener::RefPtr> MouseEventListeners;
   typedef Renderer::GradientBackground GradientBackground;
   typedef Renderer::Corners            Corners;
+  typedef Renderer::FrameProfiler      FrameProfiler;
   typedef Usul::Interfaces::IViewMode IViewMode;
   typedef IViewMode::ViewMode ViewMode;
   typedef osg::RenderInfo RenderInfo;
@@ -415,6 +416,11 @@ public:
   // Get the time.
   double                timeAverage ( const std::string &name ) const;
   double                timeLast    ( const std::string &name ) const;
+  double                timePercentile ( const std::string &name, double percent ) const;
+
+  // Get the profiler with the last frames' times, for percentiles and CSV.
+  FrameProfiler *       frameProfiler();
+  const FrameProfiler * frameProfiler() const;
 
   // Spin
   void                  timeoutSpin ();
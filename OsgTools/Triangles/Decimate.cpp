@@ -0,0 +1,953 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Quadric error edge-collapse decimation.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Triangles/Decimate.h"
+#include "OsgTools/Triangles/TriangleSet.h"
+
+#include "Usul/Interfaces/ICanceledStateGet.h"
+#include "Usul/Interfaces/IProgressBar.h"
+#include "Usul/Interfaces/IStatusBar.h"
+#include "Usul/Trace/Trace.h"
+
+#include "osg/Vec3d"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace OsgTools::Triangles;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constants.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  // How much more a border plane counts than a triangle's plane.
+  const double BORDER_WEIGHT ( 1000.0 );
+
+  // A collapse may not turn a triangle's normal more than this (cosine).
+  const double MIN_NORMAL_COSINE ( 0.2 );
+
+  // Steps between checking for cancel and showing progress.
+  const unsigned int CHECK_INTERVAL ( 512 );
+
+  const OsgTools::Triangles::Mesh::Index INVALID ( std::numeric_limits < OsgTools::Triangles::Mesh::Index >::max() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Symmetric 4x4 error quadric. Only the upper triangle is kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  struct Quadric
+  {
+    Quadric()
+    {
+      std::fill ( _a, _a + 10, 0.0 );
+    }
+
+    // The quadric of the plane n.p + d = 0, where n is unit length.
+    Quadric ( const osg::Vec3d &n, double d, double weight )
+    {
+      _a[0] = weight * n[0] * n[0];
+      _a[1] = weight * n[0] * n[1];
+      _a[2] = weight * n[0] * n[2];
+      _a[3] = weight * n[0] * d;
+      _a[4] = weight * n[1] * n[1];
+      _a[5] = weight * n[1] * n[2];
+      _a[6] = weight * n[1] * d;
+      _a[7] = weight * n[2] * n[2];
+      _a[8] = weight * n[2] * d;
+      _a[9] = weight * d * d;
+    }
+
+    Quadric &operator += ( const Quadric &q )
+    {
+      for ( unsigned int i = 0; i < 10; ++i )
+        _a[i] += q._a[i];
+      return *this;
+    }
+
+    Quadric operator + ( const Quadric &q ) const
+    {
+      Quadric answer ( *this );
+      answer += q;
+      return answer;
+    }
+
+    // The weighted sum of squared distances from the point to the planes.
+    double error ( const osg::Vec3d &p ) const
+    {
+      const double x ( p[0] ), y ( p[1] ), z ( p[2] );
+      const double e ( _a[0] * x * x + 2.0 * _a[1] * x * y + 2.0 * _a[2] * x * z + 2.0 * _a[3] * x
+                                     +       _a[4] * y * y + 2.0 * _a[5] * y * z + 2.0 * _a[6] * y
+                                                           +       _a[7] * z * z + 2.0 * _a[8] * z
+                                                                                 +       _a[9] );
+      return ( ( e > 0.0 ) ? e : 0.0 );
+    }
+
+    // The point with the least error. Returns false if there is no single
+    // one, like when all the planes are parallel.
+    bool optimal ( osg::Vec3d &p ) const
+    {
+      const double a ( _a[0] ), b ( _a[1] ), c ( _a[2] );
+      const double e ( _a[4] ), f ( _a[5] ), i ( _a[7] );
+
+      // Cofactors of the symmetric matrix [ a b c ; b e f ; c f i ].
+      const double A (   e * i - f * f );
+      const double B ( -( b * i - f * c ) );
+      const double C (   b * f - e * c );
+      const double det ( a * A + b * B + c * C );
+
+      const double trace ( a + e + i );
+      if ( std::fabs ( det ) <= 1e-12 * trace * trace * trace )
+        return false;
+
+      const double E (   a * i - c * c );
+      const double F ( -( a * f - b * c ) );
+      const double I (   a * e - b * b );
+
+      // Solve M p = -( _a[3], _a[6], _a[8] ) with the inverse of M.
+      const double u ( -_a[3] ), v ( -_a[6] ), w ( -_a[8] );
+      p[0] = ( A * u + B * v + C * w ) / det;
+      p[1] = ( B * u + E * v + F * w ) / det;
+      p[2] = ( C * u + F * v + I * w ) / det;
+      return true;
+    }
+
+  private:
+
+    double _a[10];
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  An edge waiting to be collapsed. The stamp is the sum of the vertices'
+//  stamps when it was made; it no longer matches once either one changes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  struct Edge
+  {
+    float error;
+    float length;
+    OsgTools::Triangles::Mesh::Index v0;
+    OsgTools::Triangles::Mesh::Index v1;
+    OsgTools::Triangles::Mesh::Index stamp;
+  };
+
+  // Puts the smallest error on top of the heap. Flat areas have no error,
+  // so there the shortest edge goes first; otherwise one vertex could take
+  // in all its neighbors and make a big fan.
+  struct GreaterError
+  {
+    bool operator () ( const Edge &a, const Edge &b ) const
+    {
+      return ( ( a.error == b.error ) ? ( a.length > b.length ) : ( a.error > b.error ) );
+    }
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Asks the caller if it canceled and shows the progress. A step is a vertex
+//  while building or an edge taken from the heap, so the caller is asked
+//  often enough on big meshes without asking for every edge.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  class Feedback
+  {
+  public:
+
+    Feedback ( Usul::Interfaces::IUnknown *caller ) : _canceled ( caller ), _progress ( caller ), _count ( 0 )
+    {
+    }
+
+    // Returns true if the caller canceled. Only asks every CHECK_INTERVAL steps.
+    bool step()
+    {
+      if ( 0 != ( ++_count % Detail::CHECK_INTERVAL ) )
+        return false;
+      return ( true == _canceled.valid() && true == _canceled->canceled() );
+    }
+
+    // Show the progress. Only shown every CHECK_INTERVAL steps.
+    void progress ( double fraction )
+    {
+      if ( true == _progress.valid() && 0 == ( _count % Detail::CHECK_INTERVAL ) )
+        _progress->updateProgressBar ( static_cast < unsigned int > ( 100.0 * fraction ) );
+    }
+
+    void done()
+    {
+      if ( true == _progress.valid() )
+        _progress->updateProgressBar ( 100 );
+    }
+
+  private:
+
+    Usul::Interfaces::ICanceledStateGet::QueryPtr _canceled;
+    Usul::Interfaces::IProgressBar::QueryPtr _progress;
+    unsigned int _count;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Does the work of decimating.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  class Collapser
+  {
+  public:
+
+    typedef OsgTools::Triangles::Mesh::Index Index;
+    typedef OsgTools::Triangles::Mesh::Indices Indices;
+    typedef std::vector < osg::Vec3d > Positions;
+    typedef std::vector < Quadric > Quadrics;
+    typedef std::vector < unsigned char > Flags;
+    typedef std::vector < Edge > Heap;
+    typedef std::pair < Index, Index > Neighbor;
+    typedef std::vector < Neighbor > Neighbors;
+
+    Collapser ( const osg::Vec3Array &vertices, const Indices &indices );
+
+    // Make the quadrics and the heap. Returns false if canceled.
+    bool                    build ( Feedback & );
+
+    // Collapse until there are this many triangles left. Returns false if canceled.
+    bool                    run ( Index target, double maxError, Feedback & );
+
+    // Get the remaining triangles and the vertices they use.
+    void                    results ( osg::Vec3Array &vertices, Indices &indices ) const;
+
+  private:
+
+    void                    _addBorders ( Index v );
+    void                    _addTriangleQuadrics();
+    bool                    _canCollapse ( Index v0, Index v1, const osg::Vec3d &p );
+    void                    _collapse ( Index v0, Index v1, const osg::Vec3d &p );
+    void                    _compactReferences();
+    double                  _evaluate ( Index v0, Index v1, osg::Vec3d &p ) const;
+    bool                    _hasVertex ( Index t, Index v ) const;
+    void                    _makeReferences();
+    void                    _neighbors ( Index v, Neighbors &answer ) const;
+    osg::Vec3d              _normal ( Index t ) const;
+    void                    _push ( Index v0, Index v1 );
+    void                    _pushEdges ( Index v );
+    void                    _unmark ( const Neighbors & ) const;
+
+    Positions _positions;
+    Indices _triangles;
+    Quadrics _quadrics;
+    Flags _deadTriangles;
+    Flags _deadVertices;
+    Indices _stamps;
+    Indices _references;
+    Indices _start;
+    Indices _count;
+    Heap _heap;
+    Index _numAlive;
+    Neighbors _neighbors0;
+    Neighbors _neighbors1;
+    mutable Indices _marks;
+  };
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructor. Degenerate triangles are dropped.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  Collapser::Collapser ( const osg::Vec3Array &vertices, const Indices &indices ) :
+    _positions ( vertices.size() ),
+    _triangles ( indices ),
+    _quadrics ( vertices.size() ),
+    _deadTriangles ( indices.size() / 3, 0 ),
+    _deadVertices ( vertices.size(), 0 ),
+    _stamps ( vertices.size(), 0 ),
+    _references(),
+    _start(),
+    _count(),
+    _heap(),
+    _numAlive ( 0 ),
+    _neighbors0(),
+    _neighbors1(),
+    _marks ( vertices.size(), Detail::INVALID )
+  {
+    for ( Index v = 0; v < _positions.size(); ++v )
+      _positions[v] = osg::Vec3d ( vertices[v] );
+
+    const Index numTriangles ( static_cast < Index > ( _deadTriangles.size() ) );
+    for ( Index t = 0; t < numTriangles; ++t )
+    {
+      const Index *i ( &_triangles[t * 3] );
+      const bool degenerate ( i[0] == i[1] || i[1] == i[2] || i[2] == i[0] );
+      _deadTriangles[t] = ( ( true == degenerate ) ? 1 : 0 );
+      _numAlive += ( ( true == degenerate ) ? 0 : 1 );
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Make the quadrics and put every edge in the heap.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Collapser::build ( Feedback &feedback )
+  {
+    this->_makeReferences();
+    this->_addTriangleQuadrics();
+
+    // Borders need all the triangles' references, so do them after.
+    for ( Index v = 0; v < _positions.size(); ++v )
+    {
+      if ( true == feedback.step() )
+        return false;
+      this->_addBorders ( v );
+    }
+
+    // Put every edge in the heap once.
+    _heap.reserve ( _positions.size() * 3 );
+    for ( Index v = 0; v < _positions.size(); ++v )
+    {
+      if ( true == feedback.step() )
+        return false;
+
+      this->_neighbors ( v, _neighbors0 );
+      for ( Neighbors::const_iterator i = _neighbors0.begin(); i != _neighbors0.end(); ++i )
+      {
+        if ( i->first > v )
+          this->_push ( v, i->first );
+      }
+    }
+
+    return true;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  List the live triangles of each vertex in one array.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_makeReferences()
+  {
+    const Index numVertices ( static_cast < Index > ( _positions.size() ) );
+    const Index numTriangles ( static_cast < Index > ( _deadTriangles.size() ) );
+
+    _count.assign ( numVertices, 0 );
+    for ( Index t = 0; t < numTriangles; ++t )
+    {
+      if ( 0 == _deadTriangles[t] )
+      {
+        ++_count[_triangles[t * 3 + 0]];
+        ++_count[_triangles[t * 3 + 1]];
+        ++_count[_triangles[t * 3 + 2]];
+      }
+    }
+
+    _start.resize ( numVertices );
+    Index total ( 0 );
+    for ( Index v = 0; v < numVertices; ++v )
+    {
+      _start[v] = total;
+      total += _count[v];
+    }
+
+    // Room for the lists that collapses append.
+    _references.clear();
+    _references.reserve ( total * 2 );
+    _references.resize ( total );
+
+    _count.assign ( numVertices, 0 );
+    for ( Index t = 0; t < numTriangles; ++t )
+    {
+      if ( 0 == _deadTriangles[t] )
+      {
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+          const Index v ( _triangles[t * 3 + c] );
+          _references[_start[v] + _count[v]++] = t;
+        }
+      }
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Remake the lists without the old ones and the dead triangles.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_compactReferences()
+  {
+    const Index numVertices ( static_cast < Index > ( _positions.size() ) );
+    Indices references;
+    references.reserve ( _references.capacity() );
+
+    for ( Index v = 0; v < numVertices; ++v )
+    {
+      const Index start ( _start[v] ), count ( _count[v] );
+      _start[v] = static_cast < Index > ( references.size() );
+      _count[v] = 0;
+
+      if ( 0 != _deadVertices[v] )
+        continue;
+
+      for ( Index i = start; i < start + count; ++i )
+      {
+        if ( 0 == _deadTriangles[_references[i]] )
+        {
+          references.push_back ( _references[i] );
+          ++_count[v];
+        }
+      }
+    }
+
+    _references.swap ( references );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Is the vertex a corner of the triangle?
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Collapser::_hasVertex ( Index t, Index v ) const
+  {
+    const Index *i ( &_triangles[t * 3] );
+    return ( v == i[0] || v == i[1] || v == i[2] );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  The triangle's normal. The length is twice the area.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  osg::Vec3d Collapser::_normal ( Index t ) const
+  {
+    const Index *i ( &_triangles[t * 3] );
+    const osg::Vec3d &p0 ( _positions[i[0]] );
+    return ( _positions[i[1]] - p0 ) ^ ( _positions[i[2]] - p0 );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Every vertex gets the planes of its triangles, weighted by area.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_addTriangleQuadrics()
+  {
+    const Index numTriangles ( static_cast < Index > ( _deadTriangles.size() ) );
+    for ( Index t = 0; t < numTriangles; ++t )
+    {
+      if ( 0 != _deadTriangles[t] )
+        continue;
+
+      osg::Vec3d n ( this->_normal ( t ) );
+      const double length ( n.length() );
+      if ( length <= 0.0 )
+        continue;
+
+      n /= length;
+      const Index *i ( &_triangles[t * 3] );
+      const Quadric q ( n, -( n * _positions[i[0]] ), length * 0.5 );
+      _quadrics[i[0]] += q;
+      _quadrics[i[1]] += q;
+      _quadrics[i[2]] += q;
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get the vertices that share a live triangle with this one, and how many
+  //  triangles each shares. The second of each pair is that count. Marks
+  //  hold each neighbor's place in the answer while it is made.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_neighbors ( Index v, Neighbors &answer ) const
+  {
+    answer.clear();
+
+    const Index start ( _start[v] ), count ( _count[v] );
+    for ( Index r = start; r < start + count; ++r )
+    {
+      const Index t ( _references[r] );
+      if ( 0 != _deadTriangles[t] )
+        continue;
+
+      for ( unsigned int c = 0; c < 3; ++c )
+      {
+        const Index w ( _triangles[t * 3 + c] );
+        if ( w == v )
+          continue;
+
+        if ( Detail::INVALID == _marks[w] )
+        {
+          _marks[w] = static_cast < Index > ( answer.size() );
+          answer.push_back ( Neighbor ( w, 1 ) );
+        }
+        else
+        {
+          ++answer[_marks[w]].second;
+        }
+      }
+    }
+
+    this->_unmark ( answer );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Clear the marks of the neighbors.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_unmark ( const Neighbors &neighbors ) const
+  {
+    for ( Neighbors::const_iterator i = neighbors.begin(); i != neighbors.end(); ++i )
+      _marks[i->first] = Detail::INVALID;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Edges with only one triangle are on the border. Both ends get a plane
+  //  through the edge that is perpendicular to the triangle.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_addBorders ( Index v )
+  {
+    this->_neighbors ( v, _neighbors0 );
+    for ( Neighbors::const_iterator i = _neighbors0.begin(); i != _neighbors0.end(); ++i )
+    {
+      const Index w ( i->first );
+      if ( 1 != i->second || w < v )
+        continue;
+
+      // Find the triangle.
+      Index triangle ( Detail::INVALID );
+      for ( Index r = _start[v]; r < _start[v] + _count[v]; ++r )
+      {
+        if ( 0 == _deadTriangles[_references[r]] && true == this->_hasVertex ( _references[r], w ) )
+        {
+          triangle = _references[r];
+          break;
+        }
+      }
+      if ( Detail::INVALID == triangle )
+        continue;
+
+      const osg::Vec3d edge ( _positions[w] - _positions[v] );
+      osg::Vec3d n ( edge ^ this->_normal ( triangle ) );
+      const double length ( n.length() );
+      if ( length <= 0.0 )
+        continue;
+
+      n /= length;
+      const Quadric q ( n, -( n * _positions[v] ), Detail::BORDER_WEIGHT * edge.length2() );
+      _quadrics[v] += q;
+      _quadrics[w] += q;
+    }
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Find where the edge would collapse to and the error there.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  double Collapser::_evaluate ( Index v0, Index v1, osg::Vec3d &p ) const
+  {
+    const Quadric q ( _quadrics[v0] + _quadrics[v1] );
+    if ( true == q.optimal ( p ) )
+      return q.error ( p );
+
+    // Use the best of the ends and the middle.
+    const osg::Vec3d candidates[] = { _positions[v0], _positions[v1], ( _positions[v0] + _positions[v1] ) * 0.5 };
+    double best ( std::numeric_limits < double >::max() );
+    for ( unsigned int i = 0; i < 3; ++i )
+    {
+      const double e ( q.error ( candidates[i] ) );
+      if ( e < best )
+      {
+        best = e;
+        p = candidates[i];
+      }
+    }
+    return best;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Put the edge in the heap.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_push ( Index v0, Index v1 )
+  {
+    osg::Vec3d p;
+    Edge edge;
+    edge.error = static_cast < float > ( this->_evaluate ( v0, v1, p ) );
+    edge.length = static_cast < float > ( ( _positions[v1] - _positions[v0] ).length2() );
+    edge.v0 = v0;
+    edge.v1 = v1;
+    edge.stamp = _stamps[v0] + _stamps[v1];
+    _heap.push_back ( edge );
+    std::push_heap ( _heap.begin(), _heap.end(), Detail::GreaterError() );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Put all the edges of the vertex in the heap.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_pushEdges ( Index v )
+  {
+    this->_neighbors ( v, _neighbors0 );
+    for ( Neighbors::const_iterator i = _neighbors0.begin(); i != _neighbors0.end(); ++i )
+      this->_push ( v, i->first );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Can the edge collapse to the point without harming the mesh?
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Collapser::_canCollapse ( Index v0, Index v1, const osg::Vec3d &p )
+  {
+    // The ends may only share the neighbors across the triangles that the
+    // edge is in. Otherwise the surface would be pinched.
+    this->_neighbors ( v0, _neighbors0 );
+    this->_neighbors ( v1, _neighbors1 );
+
+    for ( Neighbors::const_iterator j = _neighbors1.begin(); j != _neighbors1.end(); ++j )
+      _marks[j->first] = 0;
+
+    Index shared ( 0 ), common ( 0 );
+    for ( Neighbors::const_iterator i = _neighbors0.begin(); i != _neighbors0.end(); ++i )
+    {
+      if ( v1 == i->first )
+        shared = i->second;
+      else if ( Detail::INVALID != _marks[i->first] )
+        ++common;
+    }
+
+    this->_unmark ( _neighbors1 );
+    if ( common > shared )
+      return false;
+
+    // No triangle that stays may turn over or become a sliver.
+    const Index ends[] = { v0, v1 };
+    for ( unsigned int e = 0; e < 2; ++e )
+    {
+      const Index v ( ends[e] );
+      for ( Index r = _start[v]; r < _start[v] + _count[v]; ++r )
+      {
+        const Index t ( _references[r] );
+        if ( 0 != _deadTriangles[t] || ( true == this->_hasVertex ( t, v0 ) && true == this->_hasVertex ( t, v1 ) ) )
+          continue;
+
+        osg::Vec3d corners[3];
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+          const Index w ( _triangles[t * 3 + c] );
+          corners[c] = ( ( w == v ) ? p : _positions[w] );
+        }
+
+        const osg::Vec3d before ( this->_normal ( t ) );
+        const osg::Vec3d after ( ( corners[1] - corners[0] ) ^ ( corners[2] - corners[0] ) );
+        const double lengths ( before.length() * after.length() );
+        if ( lengths <= 0.0 || ( before * after ) < Detail::MIN_NORMAL_COSINE * lengths )
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Move v0 to the point and remove v1.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::_collapse ( Index v0, Index v1, const osg::Vec3d &p )
+  {
+    // Make sure there is room to append the new list.
+    if ( _references.size() + _count[v0] + _count[v1] > _references.capacity() )
+      this->_compactReferences();
+
+    _positions[v0] = p;
+    _quadrics[v0] += _quadrics[v1];
+    _deadVertices[v1] = 1;
+    ++_stamps[v0];
+    ++_stamps[v1];
+
+    // The triangles on the edge go away and the rest of v1's move to v0.
+    const Index start ( static_cast < Index > ( _references.size() ) );
+    const Index ends[] = { v0, v1 };
+    for ( unsigned int e = 0; e < 2; ++e )
+    {
+      const Index v ( ends[e] );
+      for ( Index r = _start[v]; r < _start[v] + _count[v]; ++r )
+      {
+        const Index t ( _references[r] );
+        if ( 0 != _deadTriangles[t] )
+          continue;
+
+        Index *i ( &_triangles[t * 3] );
+        if ( true == this->_hasVertex ( t, v0 ) && true == this->_hasVertex ( t, v1 ) )
+        {
+          _deadTriangles[t] = 1;
+          --_numAlive;
+          continue;
+        }
+
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+          if ( v1 == i[c] )
+            i[c] = v0;
+        }
+        _references.push_back ( t );
+      }
+    }
+
+    _start[v0] = start;
+    _count[v0] = static_cast < Index > ( _references.size() ) - start;
+    _count[v1] = 0;
+
+    this->_pushEdges ( v0 );
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Collapse until there are this many triangles left.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool Collapser::run ( Index target, double maxError, Feedback &feedback )
+  {
+    const Index numStart ( _numAlive );
+    const double toRemove ( ( numStart > target ) ? static_cast < double > ( numStart - target ) : 1.0 );
+
+    while ( _numAlive > target && false == _heap.empty() )
+    {
+      if ( true == feedback.step() )
+        return false;
+      feedback.progress ( ( numStart - _numAlive ) / toRemove );
+
+      std::pop_heap ( _heap.begin(), _heap.end(), Detail::GreaterError() );
+      const Edge edge ( _heap.back() );
+      _heap.pop_back();
+
+      // Skip edges that changed since they were put in the heap.
+      if ( 0 != _deadVertices[edge.v0] || 0 != _deadVertices[edge.v1] )
+        continue;
+      if ( edge.stamp != _stamps[edge.v0] + _stamps[edge.v1] )
+        continue;
+
+      // Everything left costs more.
+      if ( maxError >= 0.0 && edge.error > maxError )
+        break;
+
+      osg::Vec3d p;
+      this->_evaluate ( edge.v0, edge.v1, p );
+      if ( false == this->_canCollapse ( edge.v0, edge.v1, p ) )
+        continue;
+
+      this->_collapse ( edge.v0, edge.v1, p );
+    }
+
+    feedback.done();
+    return true;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get the remaining triangles and the vertices they use.
+  //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  void Collapser::results ( osg::Vec3Array &vertices, Indices &indices ) const
+  {
+    const Index numTriangles ( static_cast < Index > ( _deadTriangles.size() ) );
+    Indices remap ( _positions.size(), Detail::INVALID );
+
+    vertices.clear();
+    indices.clear();
+    indices.reserve ( _numAlive * 3 );
+
+    for ( Index t = 0; t < numTriangles; ++t )
+    {
+      if ( 0 != _deadTriangles[t] )
+        continue;
+
+      for ( unsigned int c = 0; c < 3; ++c )
+      {
+        const Index v ( _triangles[t * 3 + c] );
+        if ( Detail::INVALID == remap[v] )
+        {
+          remap[v] = static_cast < Index > ( vertices.size() );
+          const osg::Vec3d &p ( _positions[v] );
+          vertices.push_back ( osg::Vec3f ( p[0], p[1], p[2] ) );
+        }
+        indices.push_back ( remap[v] );
+      }
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Decimate::Decimate ( float r, double maxError ) :
+  _ratio ( 0.5f ),
+  _maxError ( maxError )
+{
+  this->ratio ( r );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the fraction of the triangles to keep.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Decimate::ratio ( float r )
+{
+  _ratio = std::max ( 0.0f, std::min ( 1.0f, r ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Decimate the triangles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Decimate::operator () ( const osg::Vec3Array &vertices, const Indices &indices,
+                             osg::Vec3Array &outVertices, Indices &outIndices,
+                             Unknown *caller ) const
+{
+  USUL_TRACE_SCOPE;
+
+  const Index numTriangles ( static_cast < Index > ( indices.size() / 3 ) );
+  const Index target ( static_cast < Index > ( _ratio * numTriangles ) );
+
+  Detail::Feedback feedback ( caller );
+  Detail::Collapser collapser ( vertices, indices );
+  if ( false == collapser.build ( feedback ) )
+    return false;
+  if ( false == collapser.run ( target, _maxError, feedback ) )
+    return false;
+
+  collapser.results ( outVertices, outIndices );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Decimate the triangle set.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Decimate::operator () ( TriangleSet &triangles, Unknown *caller ) const
+{
+  USUL_TRACE_SCOPE;
+
+  Usul::Interfaces::IStatusBar::QueryPtr status ( caller );
+  if ( true == status.valid() )
+    status->setStatusBarText ( "Decimating triangles...", true );
+
+  // Decimate the set's index buffer.
+  osg::ref_ptr < osg::Vec3Array > vertices ( new osg::Vec3Array );
+  Indices indices;
+  {
+    Mesh::RefPtr mesh ( triangles.mesh() );
+    if ( false == (*this) ( *triangles.vertices(), mesh->indices(), *vertices, indices, caller ) )
+      return false;
+  }
+
+  // Replace the triangles.
+  const Index numTriangles ( static_cast < Index > ( indices.size() / 3 ) );
+  triangles.clear ( caller );
+  triangles.reserve ( numTriangles );
+
+  std::vector < SharedVertex * > shared ( vertices->size(), 0x0 );
+  for ( Index v = 0; v < vertices->size(); ++v )
+    shared[v] = triangles.addSharedVertex ( vertices->at ( v ), false );
+
+  for ( Index t = 0; t < numTriangles; ++t )
+  {
+    const Index *i ( &indices[t * 3] );
+    const osg::Vec3f &p0 ( vertices->at ( i[0] ) );
+    osg::Vec3f n ( ( vertices->at ( i[1] ) - p0 ) ^ ( vertices->at ( i[2] ) - p0 ) );
+    n.normalize();
+    triangles.addTriangle ( shared[i[0]], shared[i[1]], shared[i[2]], n, false );
+  }
+
+  return true;
+}
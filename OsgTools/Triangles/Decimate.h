@@ -0,0 +1,91 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Quadric error edge-collapse decimation.
+//
+//  Each vertex gets the sum of the squared distances to the planes of its
+//  triangles (Garland and Heckbert). Every edge is put in a heap ordered by
+//  the error of collapsing it to the point that its two quadrics agree on
+//  best. The cheapest edge is collapsed, the edges around the kept vertex
+//  are put back with their new errors, and edges that were in the heap
+//  before are skipped when they come out. Collapses that would fold a
+//  triangle over, or join the mesh at a single vertex, are not made.
+//  Border edges get extra planes so the border keeps its shape.
+//
+//  This works on an index buffer, so a triangle set is decimated without
+//  converting it to another library's mesh. The caller is asked for
+//  Usul::Interfaces::ICanceledStateGet and IProgressBar.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_DECIMATE_H_
+#define _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_DECIMATE_H_
+
+#include "OsgTools/Export.h"
+#include "OsgTools/Configure/OSG.h"
+#include "OsgTools/Triangles/Mesh.h"
+
+#include "Usul/Interfaces/IUnknown.h"
+
+#include "osg/Array"
+
+
+namespace OsgTools {
+namespace Triangles {
+
+
+class TriangleSet;
+
+
+class OSG_TOOLS_EXPORT Decimate
+{
+public:
+
+  // Useful typedefs.
+  typedef Mesh::Index Index;
+  typedef Mesh::Indices Indices;
+  typedef Usul::Interfaces::IUnknown Unknown;
+
+  // Construction. See ratio() and maxError().
+  Decimate ( float ratio = 0.5f, double maxError = -1.0 );
+
+  // Set/get the fraction of the triangles to keep.
+  void                    ratio ( float );
+  float                   ratio() const { return _ratio; }
+
+  // Set/get the largest error of a collapse, which is a squared distance.
+  // Decimation stops before this is passed. Negative means no limit.
+  void                    maxError ( double e ) { _maxError = e; }
+  double                  maxError() const { return _maxError; }
+
+  // Decimate the triangles, three indices each. Vertices that are no longer
+  // used are removed. Returns false if canceled, in which case the output
+  // is not touched.
+  bool                    operator () ( const osg::Vec3Array &vertices, const Indices &indices,
+                                        osg::Vec3Array &outVertices, Indices &outIndices,
+                                        Unknown *caller = 0x0 ) const;
+
+  // Decimate the triangle set. Returns false if canceled, in which case the
+  // set is not changed.
+  bool                    operator () ( TriangleSet &triangles, Unknown *caller = 0x0 ) const;
+
+private:
+
+  float _ratio;
+  double _maxError;
+};
+
+
+} // namespace Triangles
+} // namespace OsgTools
+
+
+#endif // _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_DECIMATE_H_
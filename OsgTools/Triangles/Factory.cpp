@@ -51,9 +51,9 @@ namespace Helper
     {
     }
 
-    SharedVertex *operator () ( SharedVertex *raw ) const
+    SharedVertex *operator () ( SharedVertex *raw, unsigned short flags = SharedVertex::MEMORY_POOL ) const
     {
-      return ( new ( raw ) SharedVertex ( _index, _reserve, SharedVertex::MEMORY_POOL ) );
+      return ( new ( raw ) SharedVertex ( _index, _reserve, flags ) );
     }
 
     SharedVertex * operator()() const
@@ -89,9 +89,9 @@ namespace Helper
     {
     }
 
-    Triangle *operator () ( Triangle *raw ) const
+    Triangle *operator () ( Triangle *raw, unsigned short flags = Triangle::MEMORY_POOL ) const
     {
-      return ( new ( raw ) Triangle ( _v0, _v1, _v2, _index, Triangle::MEMORY_POOL ) );
+      return ( new ( raw ) Triangle ( _v0, _v1, _v2, _index, flags ) );
     }
 
     Triangle *operator()() const
@@ -174,6 +174,36 @@ namespace Helper
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Generic arena allocator.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  template < class ObjectType > struct ArenaAllocator
+  {
+    template < class NewFunctor > static ObjectType *newObject ( const NewFunctor &nf, Usul::Memory::Arena &arena )
+    {
+      // This throws if it fails. There is no point in trying the heap next.
+      ObjectType *raw ( static_cast < ObjectType * > ( arena.malloc ( sizeof ( ObjectType ) ) ) );
+
+      // The constructor can throw too.
+      try
+      {
+        return nf ( raw, ObjectType::ARENA );
+      }
+      catch ( ... )
+      {
+        Usul::Memory::Arena::free ( raw );
+        throw;
+      }
+    }
+  };
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Generic heap allocator.
@@ -246,6 +276,8 @@ namespace OsgTools
       typedef Helper::PoolAllocator < Triangle >     PoolAllocatorT;
       typedef Helper::HeapAllocator < SharedVertex > HeapAllocatorSV;
       typedef Helper::HeapAllocator < Triangle >     HeapAllocatorT;
+      typedef Helper::ArenaAllocator < SharedVertex > ArenaAllocatorSV;
+      typedef Helper::ArenaAllocator < Triangle >     ArenaAllocatorT;
       typedef Usul::Memory::Pool < SharedVertex > MemoryPoolSV;
       typedef Usul::Memory::Pool < Triangle >     MemoryPoolT;
 
@@ -253,7 +285,8 @@ namespace OsgTools
         _memorySV  ( firstNum, maxNum, growthFactor ),
         _memoryT   ( firstNum, maxNum, growthFactor ),
         _usePoolSV ( true ),
-        _usePoolT  ( true )
+        _usePoolT  ( true ),
+        _arena     ( 0x0 )
       {
       }
 
@@ -275,6 +308,23 @@ namespace OsgTools
       }
 
 
+      /////////////////////////////////////////////////////////////////////////
+      //
+      //  Set/get the arena.
+      //
+      /////////////////////////////////////////////////////////////////////////
+
+      void useArena ( Usul::Memory::Arena *arena )
+      {
+        _arena = arena;
+      }
+
+      Usul::Memory::Arena *arena()
+      {
+        return _arena.get();
+      }
+
+
       /////////////////////////////////////////////////////////////////////////
       //
       //  Return new shared-vertex.
@@ -283,6 +333,12 @@ namespace OsgTools
 
       SharedVertex *newSharedVertex ( unsigned int index, unsigned int reserve )
       {
+        // Allocate from the arena if there is one.
+        if ( true == _arena.valid() )
+        {
+          return ArenaAllocatorSV::newObject ( Helper::NewSharedVertex ( index, reserve ), *_arena );
+        }
+
         // Initialize.
         SharedVertex *sv ( 0x0 );
 
@@ -316,8 +372,14 @@ namespace OsgTools
         // Initialize.
         Triangle *t ( 0x0 );
 
+        // Allocate from the arena if there is one. This throws if it fails.
+        if ( true == _arena.valid() )
+        {
+          t = ArenaAllocatorT::newObject ( Helper::NewTriangle ( v0, v1, v2, index ), *_arena );
+        }
+
         // Allocate from the pool if we should. This should return null if it fails.
-        if ( _usePoolT )
+        else if ( _usePoolT )
         {
           t = PoolAllocatorT::newObject ( Helper::NewTriangle ( v0, v1, v2, index ), "triangle", _memoryT );
         }
@@ -419,6 +481,7 @@ namespace OsgTools
       MemoryPoolT _memoryT;
       bool _usePoolSV;
       bool _usePoolT;
+      Usul::Memory::Arena::RefPtr _arena;
     };
   }
 }
@@ -554,3 +617,27 @@ void Factory::usePool ( bool use )
 {
   _factory->usePool ( use );
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Allocate from the given arena, or from the pool if it is null.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Factory::useArena ( Usul::Memory::Arena *arena )
+{
+  _factory->useArena ( arena );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the arena, which may be null.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Memory::Arena *Factory::arena()
+{
+  return _factory->arena();
+}
@@ -19,6 +19,7 @@
 #include "OsgTools/Export.h"
 
 #include "Usul/Base/Referenced.h"
+#include "Usul/Memory/Arena.h"
 #include "Usul/Pointers/Pointers.h"
 
 #include <climits>
@@ -56,6 +57,13 @@ public:
 
   void                    usePool ( bool );
 
+  // Allocate from the given arena instead of the pool. The arena is thread
+  // safe, so several factories may share one, and objects go back to it as
+  // soon as their reference count reaches zero. The arena must outlive the
+  // objects. Pass null to go back to the pool.
+  void                    useArena ( Usul::Memory::Arena * );
+  Usul::Memory::Arena *   arena();
+
 protected:
 
   virtual ~Factory();
@@ -475,6 +475,40 @@ inline void capPolygons ( Polygons& polygons, Loops& loops, const AdjacencyTest&
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Make the loops that need to be capped from the mesh's open edges. Each
+//  vertex's shared vertex is found through a triangle around it, so the
+//  flags of the polygons and shared vertices are not used.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Mesh, class Polygons, class Loops >
+inline void boundaryLoops ( Mesh &mesh, const Polygons &polygons, Loops &loops )
+{
+    typedef typename Mesh::Index Index;
+    typedef typename Loops::value_type Loop;
+    typedef typename Polygons::value_type::element_type Polygon;
+    typedef typename Polygon::SharedVertex SharedVertex;
+
+    typename Mesh::Loops indices;
+    mesh.boundaryLoops ( indices );
+
+    for ( typename Mesh::Loops::const_iterator i = indices.begin(); i != indices.end(); ++i )
+    {
+        Loop loop;
+        for ( typename Mesh::Indices::const_iterator j = i->begin(); j != i->end(); ++j )
+        {
+            const Index v ( *j );
+            Polygon *p ( polygons.at ( *mesh.trianglesBegin ( v ) ).get() );
+            SharedVertex *sv ( ( p->vertex0()->index() == v ) ? p->vertex0() : ( ( p->vertex1()->index() == v ) ? p->vertex1() : p->vertex2() ) );
+            loop.append ( sv );
+        }
+        loops.push_back ( loop );
+    }
+}
+
+
 }
 }
 
@@ -0,0 +1,908 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Index-based triangle mesh.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Triangles/Mesh.h"
+
+#include "Usul/Algorithms/Parallel.h"
+#include "Usul/Errors/Assert.h"
+#include "Usul/Exceptions/Thrower.h"
+
+#include "boost/atomic.hpp"
+#include "boost/scoped_array.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace OsgTools::Triangles;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh::Mesh() : BaseClass(),
+  _indices(),
+  _offsets(),
+  _adjacent(),
+  _numVertices ( 0 ),
+  _dirtyAdjacency ( true ),
+  _labels(),
+  _componentOffsets(),
+  _componentTriangles(),
+  _dirtyComponents ( true ),
+  _boundary(),
+  _dirtyBoundary ( true ),
+  _vertices ( 0x0 ),
+  _normalsV ( 0x0 ),
+  _colorsV ( 0x0 ),
+  _normalsT ( 0x0 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh::~Mesh()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the arrays.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::arrays ( osg::Vec3Array *vertices, osg::Vec3Array *normalsV, osg::Vec4Array *colorsV, osg::Vec3Array *normalsT )
+{
+  _vertices = vertices;
+  _normalsV = normalsV;
+  _colorsV  = colorsV;
+  _normalsT = normalsT;
+
+  if ( _vertices.valid() && ( _vertices->size() != _numVertices ) )
+  {
+    _numVertices = std::max < Index > ( _numVertices, static_cast < Index > ( _vertices->size() ) );
+    _dirtyAdjacency = true;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove everything.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::clear()
+{
+  Indices().swap ( _indices );
+  Indices().swap ( _offsets );
+  Indices().swap ( _adjacent );
+  Indices().swap ( _labels );
+  Indices().swap ( _componentOffsets );
+  Indices().swap ( _componentTriangles );
+  Edges().swap ( _boundary );
+  _numVertices = 0;
+  this->_dirty();
+  _vertices = 0x0;
+  _normalsV = 0x0;
+  _colorsV  = 0x0;
+  _normalsT = 0x0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The triangles changed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::_dirty()
+{
+  _dirtyAdjacency = true;
+  _dirtyComponents = true;
+  _dirtyBoundary = true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make space.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::reserve ( Index numTriangles )
+{
+  _indices.reserve ( static_cast < Indices::size_type > ( numTriangles ) * 3 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a triangle.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::addTriangle ( Index v0, Index v1, Index v2 )
+{
+  _indices.push_back ( v0 );
+  _indices.push_back ( v1 );
+  _indices.push_back ( v2 );
+
+  _numVertices = std::max ( _numVertices, std::max ( v0, std::max ( v1, v2 ) ) + 1 );
+  this->_dirty();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make room for the triangles.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::resize ( Index numTriangles )
+{
+  _indices.resize ( static_cast < Indices::size_type > ( numTriangles ) * 3, 0 );
+  this->_dirty();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the triangle. Does not touch anything shared with other triangles,
+//  so that threads can fill different triangles. The number of vertices is
+//  found again when the adjacency is built.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::setTriangle ( Index t, Index v0, Index v1, Index v2 )
+{
+  Index *i ( &_indices[ t * 3 ] );
+  i[0] = v0;
+  i[1] = v1;
+  i[2] = v2;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build the table of triangles around each vertex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::updateAdjacency()
+{
+  if ( false == _dirtyAdjacency )
+    return;
+
+  // Triangles may have been set directly.
+  for ( Indices::const_iterator i = _indices.begin(); i != _indices.end(); ++i )
+  {
+    _numVertices = std::max ( _numVertices, *i + 1 );
+  }
+
+  // Count the triangles at each vertex.
+  Indices offsets ( static_cast < Indices::size_type > ( _numVertices ) + 1, 0 );
+  for ( Indices::const_iterator i = _indices.begin(); i != _indices.end(); ++i )
+  {
+    ++offsets[ *i + 1 ];
+  }
+
+  // Turn the counts into where each vertex starts.
+  for ( Index v = 0; v < _numVertices; ++v )
+  {
+    offsets[ v + 1 ] += offsets[v];
+  }
+
+  // Fill in the triangles. Use a copy of the starts as the insertion points.
+  Indices adjacent ( _indices.size() );
+  Indices next ( offsets.begin(), offsets.end() - 1 );
+  const Index numTriangles ( this->numTriangles() );
+  for ( Index t = 0; t < numTriangles; ++t )
+  {
+    for ( unsigned int c = 0; c < 3; ++c )
+    {
+      adjacent[ next[ _indices[ t * 3 + c ] ]++ ] = t;
+    }
+  }
+
+  _offsets.swap ( offsets );
+  _adjacent.swap ( adjacent );
+  _dirtyAdjacency = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The triangles around the vertex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Mesh::Index *Mesh::trianglesBegin ( Index v )
+{
+  this->updateAdjacency();
+  return ( _adjacent.empty() ) ? 0x0 : &_adjacent[0] + _offsets.at ( v );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The end of the triangles around the vertex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Mesh::Index *Mesh::trianglesEnd ( Index v )
+{
+  this->updateAdjacency();
+  return ( _adjacent.empty() ) ? 0x0 : &_adjacent[0] + _offsets.at ( v + 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The number of triangles around the vertex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh::Index Mesh::numTriangles ( Index v )
+{
+  this->updateAdjacency();
+  return ( _offsets.at ( v + 1 ) - _offsets.at ( v ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Find the triangles connected to the seed. The visited state lives in two
+//  bit vectors here, not in the triangles, so nothing has to be reset first.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::findConnected ( Index seed, Indices &answer )
+{
+  const Index numTriangles ( this->numTriangles() );
+  if ( seed >= numTriangles )
+  {
+    Usul::Exceptions::Thrower < std::runtime_error >
+      ( "Error 1303470875: seed triangle is ", seed, " but there are only ", numTriangles, " triangles" );
+  }
+
+  this->updateAdjacency();
+
+  std::vector < bool > visitedT ( numTriangles, false );
+  std::vector < bool > visitedV ( _numVertices, false );
+
+  // The answer doubles as the queue.
+  const Indices::size_type start ( answer.size() );
+  answer.push_back ( seed );
+  visitedT[seed] = true;
+
+  for ( Indices::size_type i = start; i < answer.size(); ++i )
+  {
+    const Index t ( answer[i] );
+    for ( unsigned int c = 0; c < 3; ++c )
+    {
+      const Index v ( _indices[ t * 3 + c ] );
+      if ( true == visitedV[v] )
+        continue;
+      visitedV[v] = true;
+
+      const Index *end ( &_adjacent[0] + _offsets[ v + 1 ] );
+      for ( const Index *n = &_adjacent[0] + _offsets[v]; n != end; ++n )
+      {
+        if ( false == visitedT[*n] )
+        {
+          visitedT[*n] = true;
+          answer.push_back ( *n );
+        }
+      }
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Approximate number of bytes used.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long Mesh::memoryUsed() const
+{
+  const Indices::size_type num ( _indices.capacity() + _offsets.capacity() + _adjacent.capacity() +
+                                 _labels.capacity() + _componentOffsets.capacity() + _componentTriangles.capacity() );
+  return static_cast < unsigned long > ( num * sizeof ( Index ) + _boundary.capacity() * sizeof ( Edge ) + sizeof ( Mesh ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lock-free union-find over the vertices. A root only ever gets linked to
+//  a smaller root, and only while it is still a root, so there are no
+//  cycles no matter how the threads interleave.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef Mesh::Index Index;
+  typedef boost::atomic < Index > Parent;
+
+  inline Index findRoot ( Parent *parents, Index v )
+  {
+    while ( true )
+    {
+      Index p ( parents[v].load ( boost::memory_order_relaxed ) );
+      if ( p == v )
+        return v;
+
+      // Path halving. Losing the race is harmless.
+      const Index g ( parents[p].load ( boost::memory_order_relaxed ) );
+      if ( g != p )
+        parents[v].compare_exchange_weak ( p, g, boost::memory_order_relaxed );
+      v = g;
+    }
+  }
+
+  inline void unite ( Parent *parents, Index a, Index b )
+  {
+    while ( true )
+    {
+      a = Detail::findRoot ( parents, a );
+      b = Detail::findRoot ( parents, b );
+      if ( a == b )
+        return;
+      if ( a < b )
+        std::swap ( a, b );
+
+      Index expected ( a );
+      if ( true == parents[a].compare_exchange_strong ( expected, b ) )
+        return;
+    }
+  }
+
+  struct UniteTriangles
+  {
+    UniteTriangles ( const Mesh::Indices &indices, Parent *parents ) : _indices ( &indices ), _parents ( parents ){}
+    void operator () ( Index first, Index last ) const
+    {
+      const Index *i ( &(*_indices)[0] );
+      for ( Index t = first; t < last; ++t )
+      {
+        Detail::unite ( _parents, i[ t * 3 ], i[ t * 3 + 1 ] );
+        Detail::unite ( _parents, i[ t * 3 ], i[ t * 3 + 2 ] );
+      }
+    }
+  private:
+    const Mesh::Indices *_indices;
+    Parent *_parents;
+  };
+
+  struct TriangleRoots
+  {
+    TriangleRoots ( const Mesh::Indices &indices, Parent *parents, Mesh::Indices &roots ) : _indices ( &indices ), _parents ( parents ), _roots ( &roots ){}
+    void operator () ( Index first, Index last ) const
+    {
+      for ( Index t = first; t < last; ++t )
+      {
+        (*_roots)[t] = Detail::findRoot ( _parents, (*_indices)[ t * 3 ] );
+      }
+    }
+  private:
+    const Mesh::Indices *_indices;
+    Parent *_parents;
+    Mesh::Indices *_roots;
+  };
+
+  const Index _grain ( 16384 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Label the connected components.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Mesh::labelComponents ( Usul::Jobs::Job *job )
+{
+  const Index numTriangles ( this->numTriangles() );
+
+  // This also makes sure the number of vertices is right.
+  this->updateAdjacency();
+
+  // Every vertex starts as its own root.
+  boost::scoped_array < Detail::Parent > parents ( new Detail::Parent[ std::max < Index > ( _numVertices, 1 ) ] );
+  for ( Index v = 0; v < _numVertices; ++v )
+  {
+    parents[v].store ( v, boost::memory_order_relaxed );
+  }
+
+  Usul::Jobs::Job::RefPtr owner ( job );
+  if ( false == Usul::Algorithms::parallelFor ( Index ( 0 ), numTriangles, Detail::_grain, Detail::UniteTriangles ( _indices, parents.get() ), owner ) )
+    return false;
+
+  Indices roots ( numTriangles );
+  if ( false == Usul::Algorithms::parallelFor ( Index ( 0 ), numTriangles, Detail::_grain, Detail::TriangleRoots ( _indices, parents.get(), roots ), owner ) )
+    return false;
+
+  this->_setComponents ( roots, _numVertices );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Use these labels.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::components ( const Indices &labels )
+{
+  if ( labels.size() != this->numTriangles() )
+  {
+    Usul::Exceptions::Thrower < std::invalid_argument >
+      ( "Error 2978315270: there are ", labels.size(), " labels for ", this->numTriangles(), " triangles" );
+  }
+
+  const Index numLabels ( ( labels.empty() ) ? 0 : ( *std::max_element ( labels.begin(), labels.end() ) + 1 ) );
+  this->_setComponents ( labels, numLabels );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Number the components in the order they first appear and list their
+//  triangles. Every root is less than numRoots.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::_setComponents ( const Indices &roots, Index numRoots )
+{
+  const Index none ( 0xFFFFFFFF );
+  const Index numTriangles ( static_cast < Index > ( roots.size() ) );
+
+  // Renumber and count.
+  Indices labels ( numTriangles );
+  Indices renumbered ( numRoots, none );
+  Indices offsets ( 1, 0 );
+  for ( Index t = 0; t < numTriangles; ++t )
+  {
+    Index &label ( renumbered[ roots[t] ] );
+    if ( none == label )
+    {
+      label = static_cast < Index > ( offsets.size() - 1 );
+      offsets.push_back ( 0 );
+    }
+    labels[t] = label;
+    ++offsets[ label + 1 ];
+  }
+
+  // Turn the counts into where each component starts.
+  for ( Indices::size_type c = 1; c < offsets.size(); ++c )
+  {
+    offsets[c] += offsets[ c - 1 ];
+  }
+
+  // List the triangles. They stay in increasing order.
+  Indices triangles ( numTriangles );
+  Indices next ( offsets.begin(), offsets.end() - 1 );
+  for ( Index t = 0; t < numTriangles; ++t )
+  {
+    triangles[ next[ labels[t] ]++ ] = t;
+  }
+
+  _labels.swap ( labels );
+  _componentOffsets.swap ( offsets );
+  _componentTriangles.swap ( triangles );
+  _dirtyComponents = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of components.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh::Index Mesh::numComponents()
+{
+  if ( true == _dirtyComponents )
+    this->labelComponents();
+  return ( _componentOffsets.empty() ) ? 0 : static_cast < Index > ( _componentOffsets.size() - 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the component of the triangle.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh::Index Mesh::component ( Index t )
+{
+  if ( true == _dirtyComponents )
+    this->labelComponents();
+  return _labels.at ( t );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The triangles in the component.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Mesh::Index *Mesh::componentBegin ( Index c )
+{
+  if ( true == _dirtyComponents )
+    this->labelComponents();
+  return ( _componentTriangles.empty() ) ? 0x0 : &_componentTriangles[0] + _componentOffsets.at ( c );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The end of the triangles in the component.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Mesh::Index *Mesh::componentEnd ( Index c )
+{
+  if ( true == _dirtyComponents )
+    this->labelComponents();
+  return ( _componentTriangles.empty() ) ? 0x0 : &_componentTriangles[0] + _componentOffsets.at ( c + 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lock-free table of edge counts. A slot holds an undirected edge, the
+//  smaller vertex first, and how often it is used in each direction: from
+//  the smaller vertex in the low 16 bits, from the larger in the high 16
+//  bits. Slots are claimed by swapping in the key, and never given back.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef Mesh::Edge Edge;
+
+  // Key and counts together, so that an edge costs one cache miss.
+  struct EdgeSlot
+  {
+    boost::atomic < Edge > key;
+    boost::atomic < Usul::Types::Uint32 > counts;
+  };
+
+  const Edge _emptySlot ( 0xFFFFFFFFFFFFFFFFull );
+  const Index _numHarvests ( 64 );
+
+  struct EdgeTable
+  {
+    EdgeTable ( Index numTriangles, Index numVertices ) : _slots(), _mask ( 15 ), _stride ( 1 )
+    {
+      // Room for every edge used once, with the table no more than 80% full.
+      const Edge wanted ( static_cast < Edge > ( numTriangles ) * 15 / 4 + 1 );
+      while ( _mask + 1 < wanted )
+        _mask = _mask * 2 + 1;
+
+      // Each vertex gets a run of slots for the edges it is the smaller end
+      // of. Triangles near each other in the buffer usually have vertices
+      // near each other too, so their edges land near each other.
+      const Edge size ( _mask + 1 );
+      while ( _stride * 2 * std::max < Edge > ( numVertices, 1 ) <= size )
+        _stride *= 2;
+
+      _slots.reset ( new EdgeSlot[ static_cast < std::size_t > ( size ) ] );
+      for ( Edge i = 0; i < size; ++i )
+      {
+        _slots[i].key.store ( _emptySlot, boost::memory_order_relaxed );
+        _slots[i].counts.store ( 0, boost::memory_order_relaxed );
+      }
+    }
+
+    void add ( Index from, Index to )
+    {
+      if ( from == to )
+        return;
+
+      const Edge key ( ( from < to ) ? Mesh::edge ( from, to ) : Mesh::edge ( to, from ) );
+      const Usul::Types::Uint32 count ( ( from < to ) ? 0x00000001 : 0x00010000 );
+
+      Edge slot ( static_cast < Edge > ( std::min ( from, to ) ) * _stride + ( std::max ( from, to ) & ( _stride - 1 ) ) );
+      while ( true )
+      {
+        slot &= _mask;
+        EdgeSlot &s ( _slots[slot] );
+        Edge current ( s.key.load ( boost::memory_order_relaxed ) );
+        if ( _emptySlot == current )
+        {
+          if ( true == s.key.compare_exchange_strong ( current, key, boost::memory_order_relaxed ) )
+            current = key;
+        }
+        if ( key == current )
+        {
+          s.counts.fetch_add ( count, boost::memory_order_relaxed );
+          return;
+        }
+        ++slot;
+      }
+    }
+
+    // Append the open edges of slots [first,last).
+    void harvest ( Edge first, Edge last, Mesh::Edges &edges ) const
+    {
+      for ( Edge i = first; i < last; ++i )
+      {
+        const Edge key ( _slots[i].key.load ( boost::memory_order_relaxed ) );
+        if ( _emptySlot == key )
+          continue;
+
+        const Usul::Types::Uint32 counts ( _slots[i].counts.load ( boost::memory_order_relaxed ) );
+        const Index forward ( counts & 0xFFFF ), backward ( counts >> 16 );
+        const Index low ( Mesh::edgeFrom ( key ) ), high ( Mesh::edgeTo ( key ) );
+        for ( Index n = backward; n < forward; ++n )
+          edges.push_back ( key );
+        for ( Index n = forward; n < backward; ++n )
+          edges.push_back ( Mesh::edge ( high, low ) );
+      }
+    }
+
+    Edge size() const { return _mask + 1; }
+
+  private:
+
+    boost::scoped_array < EdgeSlot > _slots;
+    Edge _mask;
+    Edge _stride;
+  };
+
+  struct CountEdges
+  {
+    CountEdges ( const Mesh::Indices &indices, EdgeTable &table ) : _indices ( &indices ), _table ( &table ){}
+    void operator () ( Index first, Index last ) const
+    {
+      const Index *i ( &(*_indices)[0] );
+      for ( Index t = first; t < last; ++t )
+      {
+        const Index *v ( i + t * 3 );
+        _table->add ( v[0], v[1] );
+        _table->add ( v[1], v[2] );
+        _table->add ( v[2], v[0] );
+      }
+    }
+  private:
+    const Mesh::Indices *_indices;
+    EdgeTable *_table;
+  };
+
+  struct HarvestEdges
+  {
+    HarvestEdges ( const EdgeTable &table, std::vector < Mesh::Edges > &edges ) : _table ( &table ), _edges ( &edges ){}
+    void operator () ( Index first, Index last ) const
+    {
+      const Edge size ( _table->size() );
+      for ( Index h = first; h < last; ++h )
+      {
+        _table->harvest ( size * h / _numHarvests, size * ( h + 1 ) / _numHarvests, (*_edges)[h] );
+      }
+    }
+  private:
+    const EdgeTable *_table;
+    std::vector < Mesh::Edges > *_edges;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Find the open edges.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Mesh::findBoundary ( Usul::Jobs::Job *job )
+{
+  const Index numTriangles ( this->numTriangles() );
+
+  // This also makes sure the number of vertices is right.
+  this->updateAdjacency();
+
+  Detail::EdgeTable table ( numTriangles, _numVertices );
+  Usul::Jobs::Job::RefPtr owner ( job );
+  if ( false == Usul::Algorithms::parallelFor ( Index ( 0 ), numTriangles, Detail::_grain, Detail::CountEdges ( _indices, table ), owner ) )
+    return false;
+
+  // Each part of the table has its own answer, so nothing is shared.
+  std::vector < Edges > parts ( Detail::_numHarvests );
+  if ( false == Usul::Algorithms::parallelFor ( Index ( 0 ), Detail::_numHarvests, Index ( 1 ), Detail::HarvestEdges ( table, parts ), owner ) )
+    return false;
+
+  Edges edges;
+  for ( std::vector < Edges >::const_iterator i = parts.begin(); i != parts.end(); ++i )
+  {
+    edges.insert ( edges.end(), i->begin(), i->end() );
+  }
+
+  this->boundary ( edges );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Use these open edges.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::boundary ( const Edges &edges )
+{
+  Edges sorted ( edges );
+  std::sort ( sorted.begin(), sorted.end() );
+  _boundary.swap ( sorted );
+  _dirtyBoundary = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the open edges.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Mesh::Edges &Mesh::boundary()
+{
+  if ( true == _dirtyBoundary )
+    this->findBoundary();
+  return _boundary;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The open edges after only the keepers are left. An edge can only change
+//  if a triangle that goes uses it, so those edges are counted again from
+//  the kept triangles around their first vertex, and the rest are copied.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::keptBoundary ( const Indices &keepers, Edges &edges )
+{
+  const Index numTriangles ( this->numTriangles() );
+
+  std::vector < bool > kept ( numTriangles, false );
+  for ( Indices::const_iterator i = keepers.begin(); i != keepers.end(); ++i )
+  {
+    kept.at ( *i ) = true;
+  }
+
+  // The undirected edges of the triangles that go.
+  Edges changed;
+  for ( Index t = 0; t < numTriangles; ++t )
+  {
+    if ( true == kept[t] )
+      continue;
+
+    const Index *v ( &_indices[ t * 3 ] );
+    for ( unsigned int c = 0; c < 3; ++c )
+    {
+      const Index a ( v[c] ), b ( v[ ( c + 1 ) % 3 ] );
+      if ( a != b )
+        changed.push_back ( Mesh::edge ( std::min ( a, b ), std::max ( a, b ) ) );
+    }
+  }
+  std::sort ( changed.begin(), changed.end() );
+  changed.erase ( std::unique ( changed.begin(), changed.end() ), changed.end() );
+
+  // Keep the open edges that do not change.
+  const Edges &current ( this->boundary() );
+  edges.clear();
+  for ( Edges::const_iterator i = current.begin(); i != current.end(); ++i )
+  {
+    const Index a ( Mesh::edgeFrom ( *i ) ), b ( Mesh::edgeTo ( *i ) );
+    if ( false == std::binary_search ( changed.begin(), changed.end(), Mesh::edge ( std::min ( a, b ), std::max ( a, b ) ) ) )
+      edges.push_back ( *i );
+  }
+
+  // Count the changed ones again.
+  this->updateAdjacency();
+  for ( Edges::const_iterator i = changed.begin(); i != changed.end(); ++i )
+  {
+    const Index a ( Mesh::edgeFrom ( *i ) ), b ( Mesh::edgeTo ( *i ) );
+    Index forward ( 0 ), backward ( 0 );
+    const Index *end ( &_adjacent[0] + _offsets[ a + 1 ] );
+    for ( const Index *t = &_adjacent[0] + _offsets[a]; t != end; ++t )
+    {
+      if ( false == kept[*t] )
+        continue;
+
+      const Index *v ( &_indices[ *t * 3 ] );
+      for ( unsigned int c = 0; c < 3; ++c )
+      {
+        const Index from ( v[c] ), to ( v[ ( c + 1 ) % 3 ] );
+        if ( a == from && b == to )
+          ++forward;
+        else if ( b == from && a == to )
+          ++backward;
+      }
+    }
+
+    for ( Index n = backward; n < forward; ++n )
+      edges.push_back ( Mesh::edge ( a, b ) );
+    for ( Index n = forward; n < backward; ++n )
+      edges.push_back ( Mesh::edge ( b, a ) );
+  }
+
+  std::sort ( edges.begin(), edges.end() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Join the open edges into loops. Where a vertex has more than one open
+//  edge leaving it, as where two holes touch, the first unused one is
+//  taken, and a loop ends when it gets back to where it started.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::boundaryLoops ( Loops &loops )
+{
+  const Edges &edges ( this->boundary() );
+  const Edges::size_type numEdges ( edges.size() );
+  std::vector < bool > used ( numEdges, false );
+
+  for ( Edges::size_type start = 0; start < numEdges; ++start )
+  {
+    if ( true == used[start] )
+      continue;
+
+    Indices loop;
+    const Index first ( Mesh::edgeFrom ( edges[start] ) );
+    Edges::size_type e ( start );
+    while ( true )
+    {
+      used[e] = true;
+      loop.push_back ( Mesh::edgeFrom ( edges[e] ) );
+
+      const Index next ( Mesh::edgeTo ( edges[e] ) );
+      if ( first == next )
+        break;
+
+      // The open edges leaving the next vertex are together.
+      Edges::const_iterator i ( std::lower_bound ( edges.begin(), edges.end(), Mesh::edge ( next, 0 ) ) );
+      while ( ( edges.end() != i ) && ( next == Mesh::edgeFrom ( *i ) ) && ( true == used[ i - edges.begin() ] ) )
+        ++i;
+
+      // A chain that does not close.
+      if ( ( edges.end() == i ) || ( next != Mesh::edgeFrom ( *i ) ) )
+        break;
+
+      e = i - edges.begin();
+    }
+
+    if ( loop.size() >= 3 )
+    {
+      loops.push_back ( Indices() );
+      loops.back().swap ( loop );
+    }
+  }
+}
@@ -0,0 +1,210 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Index-based triangle mesh.
+//
+//  Positions, per-vertex normals and colors, and per-triangle normals are
+//  flat arrays. They are shared with the triangle set (and therefore the
+//  scene), not copied. Triangles are three 32-bit vertex indices each, in
+//  one buffer. The triangles around each vertex are stored in compressed
+//  sparse row form: the ones around vertex v are
+//  adjacent[ offsets[v] ] ... adjacent[ offsets[v+1] - 1 ].
+//
+//  That is about 28 bytes per triangle for the topology. The triangle and
+//  shared-vertex objects are still the primary storage, so the mesh adds
+//  to the memory used. What it buys is that connectivity queries walk flat
+//  arrays instead of following pointers between those objects. The triangle
+//  set rebuilds it after any call that may have changed the triangles.
+//
+//  Connected components are labelled for the whole mesh in one parallel
+//  union-find pass over the vertices. The labels are kept, along with the
+//  triangles of each component in the same sparse row form, until the
+//  triangles change.
+//
+//  The boundary is found in one parallel pass over the triangles that
+//  counts how often each edge is used in each direction, in a hash table
+//  with one slot per undirected edge. An edge used more often one way than
+//  the other is open. The open edges are kept, sorted, until the triangles
+//  change, and can be carried over when only some triangles are kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_MESH_H_
+#define _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_MESH_H_
+
+#include "OsgTools/Export.h"
+#include "OsgTools/Configure/OSG.h"
+
+#include "Usul/Base/Referenced.h"
+#include "Usul/Jobs/Job.h"
+#include "Usul/Pointers/Pointers.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Array"
+#include "osg/ref_ptr"
+
+#include <vector>
+
+
+namespace OsgTools {
+namespace Triangles {
+
+
+class OSG_TOOLS_EXPORT Mesh : public Usul::Base::Referenced
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Referenced BaseClass;
+  typedef Usul::Types::Uint32 Index;
+  typedef std::vector < Index > Indices;
+  typedef osg::ref_ptr < osg::Vec3Array > VerticesPtr;
+  typedef osg::ref_ptr < osg::Vec3Array > NormalsPtr;
+  typedef osg::ref_ptr < osg::Vec4Array > ColorsPtr;
+  typedef Usul::Types::Uint64 Edge;
+  typedef std::vector < Edge > Edges;
+  typedef std::vector < Indices > Loops;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( Mesh );
+
+  // Construction.
+  Mesh();
+
+  // Add a triangle.
+  void                    addTriangle ( Index v0, Index v1, Index v2 );
+
+  // Set the arrays. They are shared, not copied. Any of them may be null.
+  void                    arrays ( osg::Vec3Array *vertices, osg::Vec3Array *normalsV, osg::Vec4Array *colorsV, osg::Vec3Array *normalsT );
+
+  // Get the open edges, sorted. They are found first if needed.
+  const Edges &           boundary();
+
+  // Use these open edges instead of finding them.
+  void                    boundary ( const Edges &edges );
+
+  // Join the open edges into loops of vertices. Each loop follows its edges
+  // in the direction the triangles use them. Loops with fewer than three
+  // vertices are left out.
+  void                    boundaryLoops ( Loops &loops );
+
+  // Remove all triangles and arrays.
+  void                    clear();
+
+  // Get the component of the triangle, and the triangles in the component
+  // in increasing order. Components are labelled first if needed.
+  Index                   component ( Index t );
+  const Index *           componentBegin ( Index c );
+  const Index *           componentEnd ( Index c );
+
+  // Use these labels, one per triangle, instead of finding them. They can be
+  // any numbers; they are renumbered in the order they first appear.
+  void                    components ( const Indices &labels );
+
+  // Are the component labels or the open edges out of date?
+  bool                    dirtyBoundary() const { return _dirtyBoundary; }
+  bool                    dirtyComponents() const { return _dirtyComponents; }
+
+  // A directed edge, with the first vertex in the high bits.
+  static Edge             edge ( Index from, Index to ) { return ( ( static_cast < Edge > ( from ) << 32 ) | to ); }
+  static Index            edgeFrom ( Edge e ) { return static_cast < Index > ( e >> 32 ); }
+  static Index            edgeTo ( Edge e ) { return static_cast < Index > ( e & 0xFFFFFFFF ); }
+
+  // Find the open edges. If the job is canceled then false is returned and
+  // the open edges stay dirty.
+  bool                    findBoundary ( Usul::Jobs::Job *job = 0x0 );
+
+  // Get the arrays.
+  const osg::Vec4Array *  colorsV() const { return _colorsV.get(); }
+  const osg::Vec3Array *  normalsT() const { return _normalsT.get(); }
+  const osg::Vec3Array *  normalsV() const { return _normalsV.get(); }
+  const osg::Vec3Array *  vertices() const { return _vertices.get(); }
+
+  // Put every triangle that shares a vertex, directly or through others,
+  // with the seed into the answer. The seed comes first.
+  void                    findConnected ( Index seed, Indices &answer );
+
+  // The index buffer. Three per triangle.
+  const Indices &         indices() const { return _indices; }
+
+  // Get the open edges there will be when only the keepers are left, in
+  // the current vertex numbers. Only the edges of the other triangles are
+  // looked at.
+  void                    keptBoundary ( const Indices &keepers, Edges &edges );
+
+  // Label the connected components. If the job is canceled then false is
+  // returned and the labels stay dirty.
+  bool                    labelComponents ( Usul::Jobs::Job *job = 0x0 );
+
+  // Approximate number of bytes used by the topology. The shared arrays are not counted.
+  unsigned long           memoryUsed() const;
+
+  // Get the numbers.
+  Index                   numComponents();
+  Index                   numTriangles() const { return static_cast < Index > ( _indices.size() / 3 ); }
+  Index                   numVertices() const { return _numVertices; }
+
+  // Make space.
+  void                    reserve ( Index numTriangles );
+
+  // Make room for this many triangles, then fill them in with setTriangle().
+  // Different threads may set different triangles.
+  void                    resize ( Index numTriangles );
+  void                    setTriangle ( Index t, Index v0, Index v1, Index v2 );
+
+  // The triangles around the vertex.
+  const Index *           trianglesBegin ( Index v );
+  const Index *           trianglesEnd ( Index v );
+  Index                   numTriangles ( Index v );
+
+  // Return the vertex index at the corner (0, 1 or 2) of the triangle.
+  Index                   vertex ( Index t, unsigned int corner ) const { return _indices[ t * 3 + corner ]; }
+
+  // Build the vertex-to-triangle table now. It is otherwise built when first needed.
+  void                    updateAdjacency();
+
+protected:
+
+  // Use reference counting.
+  virtual ~Mesh();
+
+private:
+
+  // No copying or assigning.
+  Mesh ( const Mesh & );
+  Mesh &operator = ( const Mesh & );
+
+  void                    _dirty();
+  void                    _setComponents ( const Indices &roots, Index numRoots );
+
+  Indices _indices;
+  Indices _offsets;
+  Indices _adjacent;
+  Index _numVertices;
+  bool _dirtyAdjacency;
+  Indices _labels;
+  Indices _componentOffsets;
+  Indices _componentTriangles;
+  bool _dirtyComponents;
+  Edges _boundary;
+  bool _dirtyBoundary;
+  VerticesPtr _vertices;
+  NormalsPtr _normalsV;
+  ColorsPtr _colorsV;
+  NormalsPtr _normalsT;
+};
+
+
+} // namespace Triangles
+} // namespace OsgTools
+
+
+#endif // _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_MESH_H_
@@ -21,6 +21,7 @@
 #include "Usul/Pointers/Pointers.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/Bits/Bits.h"
+#include "Usul/Memory/Arena.h"
 
 #include <algorithm>
 #include <limits>
@@ -34,7 +35,7 @@ using namespace OsgTools::Triangles;
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-SharedVertex::SharedVertex ( unsigned int index, unsigned int numTrianglesToReserve, unsigned char flags ) : 
+SharedVertex::SharedVertex ( unsigned int index, unsigned int numTrianglesToReserve, unsigned short flags ) : 
   _index     ( index ),
   _triangles (),
   _flags     ( flags ),
@@ -116,8 +117,12 @@ void SharedVertex::unref ( bool allowDeletion )
   {
     if ( allowDeletion )
     {
-      const unsigned int bit ( SharedVertex::MEMORY_POOL );
-      if ( Usul::Bits::has ( _flags, bit ) )
+      if ( Usul::Bits::has ( _flags, static_cast < unsigned int > ( SharedVertex::ARENA ) ) )
+      {
+        this->~SharedVertex();
+        Usul::Memory::Arena::free ( this );
+      }
+      else if ( Usul::Bits::has ( _flags, static_cast < unsigned int > ( SharedVertex::MEMORY_POOL ) ) )
       {
         _triangles.clear();
       }
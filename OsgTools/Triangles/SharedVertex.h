@@ -52,10 +52,11 @@ public:
     DIRTY_NORMAL = 0x10,
     DIRTY_COLOR  = 0x20,
     PROBLEM      = 0x40,
+    ARENA        = 0x100,
   };
 
   // Construction
-  SharedVertex ( unsigned int index, unsigned int numTrianglesToReserve = 0, unsigned char flags = 0 );
+  SharedVertex ( unsigned int index, unsigned int numTrianglesToReserve = 0, unsigned short flags = 0 );
 
   // Add the given triangle to the list.
   void                  addTriangle ( Triangle *t );
@@ -139,7 +140,7 @@ private:
 
   IndexType _index;
   TriangleSequence _triangles;
-  unsigned char _flags;
+  unsigned short _flags;
   ReferenceCount _ref;
 };
 
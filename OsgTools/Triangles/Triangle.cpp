@@ -20,6 +20,7 @@
 #include "Usul/MPL/StaticAssert.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/Bits/Bits.h"
+#include "Usul/Memory/Arena.h"
 #include "Usul/Pointers/Functions.h"
 
 #include <limits>
@@ -34,7 +35,7 @@ using namespace OsgTools::Triangles;
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Triangle::Triangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, IndexType index, unsigned char flags ) : 
+Triangle::Triangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, IndexType index, unsigned short flags ) : 
   _v0    ( v0 ),
   _v1    ( v1 ),
   _v2    ( v2 ),
@@ -156,9 +157,15 @@ void Triangle::unref ( bool allowDeletion )
     // If we are allowed to delete...
     if ( allowDeletion )
     {
+      // If we were allocated on an arena then give the memory back.
+      if ( Usul::Bits::has ( _flags, static_cast < unsigned int > ( Triangle::ARENA ) ) )
+      {
+        this->~Triangle();
+        Usul::Memory::Arena::free ( this );
+      }
+
       // If we were allocated on a memory-pool...
-      const unsigned int bit ( Triangle::MEMORY_POOL );
-      if ( Usul::Bits::has ( _flags, bit ) )
+      else if ( Usul::Bits::has ( _flags, static_cast < unsigned int > ( Triangle::MEMORY_POOL ) ) )
       {
         this->clear();
       }
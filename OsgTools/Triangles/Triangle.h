@@ -54,10 +54,11 @@ public:
     DIRTY_COLOR  = 0x20,
     PROBLEM      = 0x40,
     ORIGINAL     = 0x80,
+    ARENA        = 0x100,
   };
 
   // Construction
-  Triangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, IndexType index, unsigned char flags = 0 );
+  Triangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, IndexType index, unsigned short flags = 0 );
 
   // Sets all vertices to null.
   void                        clear();
@@ -130,7 +131,7 @@ private:
   SharedVertex *_v1;
   SharedVertex *_v2;
   IndexType _index;
-  unsigned char _flags;
+  unsigned short _flags;
   ReferenceCount _ref;
 };
 
@@ -23,6 +23,7 @@
 #include "OsgTools/State/StateSet.h"
 #include "OsgTools/State/PolygonMode.h"
 
+#include "Usul/Algorithms/Parallel.h"
 #include "Usul/MPL/StaticAssert.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/Policies/Update.h"
@@ -31,6 +32,7 @@
 #include "Usul/Bits/Bits.h"
 #include "Usul/Functors/General/Increment.h"
 #include "Usul/Errors/Checker.h"
+#include "Usul/Exceptions/Thrower.h"
 #include "Usul/Types/Types.h"
 #include "Usul/Adaptors/Random.h"
 #include "Usul/Shared/Preferences.h"
@@ -65,6 +67,7 @@
 #include <numeric>
 #include <functional>
 #include <limits>
+#include <stdexcept>
 
 using namespace OsgTools::Triangles;
 using namespace Usul::Types;
@@ -93,20 +96,23 @@ namespace Detail
 ///////////////////////////////////////////////////////////////////////////////
 
 TriangleSet::TriangleSet ( unsigned int unitsInLastPlace ) : BaseClass(),
-  _shared    ( LessVector ( CloseFloat ( unitsInLastPlace ) ) ),
+  _shared    (),
+  _weld      ( unitsInLastPlace ),
   _triangles (),
   _vertices  ( new osg::Vec3Array ),
   _normalsV  ( new osg::Vec3Array ),
   _normalsT  ( new osg::Vec3Array ),
   _colorsV   ( 0x0 ),
-  _flags     ( Dirty::NORMALS_V | Dirty::COLORS_V | Dirty::BLOCKS ),
+  _flags     ( Dirty::NORMALS_V | Dirty::COLORS_V | Dirty::BLOCKS | Dirty::MESH ),
   _bbox      (),
   _factory   ( new Factory ),
   _blocks    ( ),
   _progress  ( 0, 1 ),
   _color     ( new ColorFunctor ),
   _root      ( new osg::Group ),
-  _useMaterial ( false )
+  _useMaterial ( false ),
+  _mesh      ( 0x0 ),
+  _useMesh   ( false )
 {
 #ifdef _MSC_VER
   // Keeping tabs on memory consumption...
@@ -146,8 +152,14 @@ void TriangleSet::clear ( Usul::Interfaces::IUnknown *caller )
   _blocks.clear();
   this->dirtyBlocks ( true );
 
-  // Clear the map of shared vertices.
+  // Clear the shared vertices.
   _shared.clear();
+  _weld.clear();
+
+  // The mesh shares the arrays that are replaced below.
+  if ( _mesh.valid() )
+    _mesh->clear();
+  _flags = Usul::Bits::add ( _flags, Dirty::MESH );
 
   // Used for progress feedback.
   const unsigned int numTriangles ( _triangles.size() );
@@ -223,8 +235,13 @@ void TriangleSet::reserve ( unsigned int num )
   if ( _colorsV.valid() )
     _colorsV->reserve ( num );
 
+  _shared.reserve ( num );
+
   _factory->reserveTriangles ( num );
   _factory->reserveSharedVertices ( num );
+
+  // Closed meshes have about half as many vertices as triangles.
+  _weld.reserve ( num / 2 );
 }
 
 
@@ -393,6 +410,10 @@ OsgTools::Triangles::Triangle *TriangleSet::addTriangle ( SharedVertex *sv0, Sha
   // Set triangle's flag if appropriate.
   t->problem ( sv0->problem() || sv1->problem() || sv2->problem() );
 
+  // Keep the mesh current if it is, since appending is cheap.
+  if ( ( _mesh.valid() ) && ( false == Usul::Bits::has ( _flags, Dirty::MESH ) ) )
+    _mesh->addTriangle ( sv0->index(), sv1->index(), sv2->index() );
+
   // If we are supposed to update everything now...
   if ( update )
     this->_updateDependencies ( t );
@@ -413,6 +434,134 @@ OsgTools::Triangles::Triangle *TriangleSet::addTriangle ( SharedVertex *sv0, Sha
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Welds the vertices of one chunk of triangles. Each chunk has its own list
+//  of unique vertices, and every input vertex gets the index into that list.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef std::vector < osg::Vec3f > UniqueVertices;
+  typedef std::vector < UniqueVertices > ChunkVertices;
+  typedef std::vector < unsigned int > LocalIndices;
+
+  struct WeldChunk
+  {
+    WeldChunk ( const osg::Vec3Array &vertices, unsigned int grain, unsigned int ulps, ChunkVertices &unique, LocalIndices &local ) :
+      _vertices ( &vertices ),
+      _grain    ( grain ),
+      _ulps     ( ulps ),
+      _unique   ( &unique ),
+      _local    ( &local )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      OsgTools::Triangles::WeldGrid < unsigned int > grid ( _ulps );
+      grid.reserve ( ( last - first ) * 3 );
+
+      UniqueVertices &unique ( _unique->at ( first / _grain ) );
+      unique.reserve ( ( last - first ) * 3 );
+
+      for ( unsigned int i = first * 3; i < last * 3; ++i )
+      {
+        const osg::Vec3f &v ( _vertices->at ( i ) );
+        unsigned int index ( 0 );
+        if ( false == grid.find ( v, index ) )
+        {
+          index = static_cast < unsigned int > ( unique.size() );
+          unique.push_back ( v );
+          grid.insert ( v, index );
+        }
+        _local->at ( i ) = index;
+      }
+    }
+
+  private:
+
+    const osg::Vec3Array *_vertices;
+    unsigned int _grain;
+    unsigned int _ulps;
+    ChunkVertices *_unique;
+    LocalIndices *_local;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add many triangles at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int TriangleSet::addTriangles ( const osg::Vec3Array &vertices, const osg::Vec3Array &normals, bool update, Unknown *caller )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( vertices.size() != normals.size() * 3 )
+    throw std::invalid_argument ( "Error 1720448360: Need three vertices and one normal per triangle" );
+
+  const unsigned int numTriangles ( normals.size() );
+  if ( 0 == numTriangles )
+    return 0;
+
+  // Triangles per chunk.
+  const unsigned int grain ( 65536 );
+  const unsigned int numChunks ( ( numTriangles + grain - 1 ) / grain );
+
+  // Weld each chunk on its own. This is the part that runs in parallel.
+  this->_setStatusBar ( "Welding vertices...", caller );
+  Detail::ChunkVertices unique ( numChunks );
+  Detail::LocalIndices local ( vertices.size() );
+  Usul::Algorithms::parallelFor ( 0u, numTriangles, grain, Detail::WeldChunk ( vertices, grain, _weld.ulps(), unique, local ) );
+
+  // Make space. Appending grows by at least half so that adding the
+  // triangles in pieces does not copy everything each time.
+  const unsigned int needed ( static_cast < unsigned int > ( _triangles.size() ) + numTriangles );
+  const unsigned int capacity ( static_cast < unsigned int > ( _triangles.capacity() ) );
+  if ( needed > capacity )
+    this->reserve ( std::max ( needed, capacity + capacity / 2 ) );
+
+  // For progress.
+  Usul::Policies::TimeBased elapsed ( Detail::_milliseconds );
+  this->_setStatusBar ( "Adding triangles...", caller );
+
+  // Merge the chunks in order so that the result does not depend on the
+  // number of threads. Each chunk only has to look up its unique vertices.
+  std::vector < SharedVertex * > shared;
+  for ( unsigned int chunk = 0; chunk < numChunks; ++chunk )
+  {
+    const Detail::UniqueVertices &u ( unique.at ( chunk ) );
+    shared.resize ( u.size() );
+    for ( unsigned int i = 0; i < u.size(); ++i )
+    {
+      shared[i] = this->addSharedVertex ( u[i], true );
+    }
+
+    const unsigned int first ( chunk * grain );
+    const unsigned int last ( std::min ( first + grain, numTriangles ) );
+    // Triangles that collapsed are added too, like addTriangle() does.
+    for ( unsigned int t = first; t < last; ++t )
+    {
+      SharedVertex *sv0 ( shared.at ( local[ t * 3     ] ) );
+      SharedVertex *sv1 ( shared.at ( local[ t * 3 + 1 ] ) );
+      SharedVertex *sv2 ( shared.at ( local[ t * 3 + 2 ] ) );
+      this->addTriangle ( sv0, sv1, sv2, normals[t], update );
+    }
+
+    // Free it now.
+    Detail::UniqueVertices().swap ( unique.at ( chunk ) );
+
+    this->_setProgressBar ( elapsed(), last, numTriangles, caller );
+  }
+
+  return numTriangles;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Remove the specified triangle.
@@ -440,6 +589,9 @@ void TriangleSet::removeTriangle ( const osg::Geode* g, const osg::Drawable *d,
   // Remove the triangle from the block.
   block->removeTriangle ( i );
 
+  // The mesh's triangle indices are now wrong.
+  _flags = Usul::Bits::add ( _flags, Dirty::MESH );
+
   // Tell shared-vertices to remove this triangle.
   t->vertex0()->removeTriangle ( t );
   t->vertex1()->removeTriangle ( t );
@@ -562,85 +714,80 @@ SharedVertex* TriangleSet::addSharedVertex ( const osg::Vec3f &v, bool look )
   // Should always be true.
   USUL_ASSERT ( _shared.size() == _vertices->size() );
   USUL_ASSERT ( _shared.size() == _normalsV->size() );
+  USUL_ASSERT ( _shared.size() == _weld.size() );
 
   // Look for an existing shared vertex if we are supposed to.
   if ( look )
   {
-    SharedVertices::iterator i = _shared.find ( v );
-    if ( _shared.end() != i )
-      return i->second.get();
+    SharedVertex *found ( 0x0 );
+    if ( true == _weld.find ( v, found ) )
+      return found;
   }
 
-  // Should always be true.
-  USUL_ASSERT ( _shared.size() == _vertices->size() );
-  USUL_ASSERT ( _shared.size() == _normalsV->size() );
-
   // If we get to here then make shared vertex with proper index.
   SharedVertex::ValidRefPtr sv ( this->newSharedVertex ( _vertices->size() ) );
 
-  // Insert the new shared-vertex into the map.
-  const InsertResult result ( this->_insertSharedVertex ( v, sv.get() ) );
+  // Append to sequence.
+  _shared.push_back ( sv.get() );
+  _vertices->push_back ( v );
 
-  // If insertion worked (and it should have).
-  if ( true == result.second )
-  {
-    // Append to sequence.
-    _vertices->push_back ( v );
+  // So that the next search finds it.
+  _weld.insert ( v, sv.get() );
 
-    // Add dummy normal value because this keeps the vector sizes consistant, 
-    // and prevents accessing values off the end. We don't want to add the 
-    // real value because this requires averaging the normals from all the 
-    // triangles that contain this vector, which is expensive.
-    _normalsV->push_back ( OsgTools::Triangles::DEFAULT_NORMAL );
+  // Add dummy normal value because this keeps the vector sizes consistant, 
+  // and prevents accessing values off the end. We don't want to add the 
+  // real value because this requires averaging the normals from all the 
+  // triangles that contain this vector, which is expensive.
+  _normalsV->push_back ( OsgTools::Triangles::DEFAULT_NORMAL );
 
-    // For similar reasons as above, add default color.
-    if ( _colorsV.valid() )
-      _colorsV->push_back ( OsgTools::Triangles::DEFAULT_COLOR );
+  // For similar reasons as above, add default color.
+  if ( _colorsV.valid() )
+    _colorsV->push_back ( OsgTools::Triangles::DEFAULT_COLOR );
 
-    // Set appropriate dirty-flags.
-    sv->dirtyColor  ( true );
-    sv->dirtyNormal ( true );
-  }
+  // Set appropriate dirty-flags.
+  sv->dirtyColor  ( true );
+  sv->dirtyNormal ( true );
 
-  // In rare cases, insertion fails even though the "find" above was 
-  // executed. I've seen this using the CloseFloat and LessVector combination, 
-  // but not with the default std::less comparison predicate.
-  else
-  {
-    std::cout << Usul::Strings::format 
-      ( "Warning 1435177723: Failed to find existing shared-vertex for (", 
-        v[0], ',', v[1], ',', v[2], 
-        "), however, when attempting to insert a new shared-vertex, an existing one was returned" ) << std::endl;
+  // Return the new shared vertex.
+  return sv.get();
+}
 
-    // Re-assign the shared-vertex to the one returned.
-    sv = result.first->second;
 
-    // Should be true.
-    USUL_ASSERT ( sv->index() < _vertices->size() );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the shared vertices for the vertex pool.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    // Flag it.
-    sv->problem ( true );
-  }
+void TriangleSet::sharedVertices ( const SharedVertices &shared )
+{
+  USUL_TRACE_SCOPE;
 
-  // Should always be true.
-  USUL_ASSERT ( _shared.size() == _vertices->size() );
-  USUL_ASSERT ( _shared.size() == _normalsV->size() );
+  if ( shared.size() != _vertices->size() )
+    throw std::invalid_argument ( "Error 2874310956: Need one shared vertex per vertex" );
 
-  // Return the new shared vertex.
-  return sv.get();
+  _shared = shared;
+  this->_rebuildWeldIndex();
+  _flags = Usul::Bits::add ( _flags, Dirty::MESH );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Insert the given shared-vertex into the correct map.
+//  Fill the weld index from the shared vertices.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-TriangleSet::InsertResult TriangleSet::_insertSharedVertex ( const osg::Vec3f &v, SharedVertex *sv )
+void TriangleSet::_rebuildWeldIndex()
 {
-  // Using default heap-allocator for now...
-  return _shared.insert ( SharedVertices::value_type ( v, sv ) );
+  _weld.clear();
+  _weld.reserve ( _shared.size() );
+
+  const unsigned int numVertices ( _shared.size() );
+  for ( unsigned int i = 0; i < numVertices; ++i )
+  {
+    _weld.insert ( _vertices->at ( i ), _shared[i].get() );
+  }
 }
 
 
@@ -845,21 +992,20 @@ void TriangleSet::checkStatus() const
       USUL_ERROR_CHECKER ( i1 < numVertices );
       USUL_ERROR_CHECKER ( i2 < numVertices );
 
-      // Make sure it is in the map.
-      USUL_ERROR_CHECKER ( _shared.end() != _shared.find ( _vertices->at ( i0 ) ) );
-      USUL_ERROR_CHECKER ( _shared.end() != _shared.find ( _vertices->at ( i1 ) ) );
-      USUL_ERROR_CHECKER ( _shared.end() != _shared.find ( _vertices->at ( i2 ) ) );
+      // Make sure it is the one at that index.
+      USUL_ERROR_CHECKER ( sv0 == _shared.at ( i0 ).get() );
+      USUL_ERROR_CHECKER ( sv1 == _shared.at ( i1 ).get() );
+      USUL_ERROR_CHECKER ( sv2 == _shared.at ( i2 ).get() );
     }
   }
 
   // Check every shared-vertex.
   {
     const unsigned int numVertices  ( _vertices->size() );
-    for ( SharedVertices::const_iterator i = _shared.begin(); i != _shared.end(); ++i )
+    for ( unsigned int i = 0; i < numVertices; ++i )
     {
-      const SharedVertex *sv ( i->second );
-      const unsigned int index ( sv->index() );
-      USUL_ERROR_CHECKER ( index < numVertices );
+      const SharedVertex *sv ( _shared[i] );
+      USUL_ERROR_CHECKER ( i == sv->index() );
       USUL_ERROR_CHECKER ( sv->numTriangles() > 0 );
       USUL_ERROR_CHECKER ( sv->numTriangles() + 1 == sv->refCount() );
     }
@@ -883,6 +1029,15 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
   if ( keepers.size() == _triangles.size() )
     return;
 
+  // When whole components are kept, their labels are still right afterwards.
+  Mesh::Indices labels;
+  this->_keptComponents ( keepers, labels );
+
+  // The open edges can be carried over too, if they are current.
+  Mesh::Edges boundary;
+  const bool keepBoundary ( this->_keptBoundary ( keepers, boundary ) );
+  Mesh::Indices renumbered ( ( true == keepBoundary ) ? _vertices->size() : 0 );
+
   // For progress.
   _progress.first = 0;
   _progress.second = 3 * _shared.size() + keepers.size();
@@ -898,7 +1053,7 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
     for ( SharedVertices::iterator i = _shared.begin(); i != _shared.end(); ++i )
     {
       // Save the current number of triangles and reserve them again.
-      SharedVertex *sv ( i->second );
+      SharedVertex *sv ( *i );
       const unsigned int num ( sv->numTriangles() );
       sv->removeAllTriangles();
       sv->reserve ( num );
@@ -935,6 +1090,7 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
     }
     _triangles.swap ( triangles ); // Important!
     _normalsT = normalsT.get();
+    _flags = Usul::Bits::add ( _flags, Dirty::MESH );
     USUL_ASSERT ( keepers.size() == _triangles.size() );
     USUL_ASSERT ( keepers.size() == this->normalsT()->size() );
   }
@@ -942,13 +1098,12 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
   // Purge all shared-vertices that do not have any triangles.
   {
     this->_setStatusBar ( "Purging Shared Vertices...", caller );
-    CloseFloat closeFloatPred;
-    LessVector lessVectorPred ( closeFloatPred );
-    SharedVertices shared ( lessVectorPred );
+    SharedVertices shared;
+    shared.reserve ( _shared.size() );
     for ( SharedVertices::iterator i = _shared.begin(); i != _shared.end(); ++i )
     {
-      if ( i->second->numTriangles() > 0 )
-        shared.insert ( shared.end(), SharedVertices::value_type ( i->first, i->second ) );
+      if ( (*i)->numTriangles() > 0 )
+        shared.push_back ( *i );
       this->_incrementProgress ( update(), caller );
     }
     _shared.swap ( shared ); // Important!
@@ -960,6 +1115,7 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
   // indices, and the bounding box.
   {
     this->_setStatusBar ( "Updating Vertex Pool and Per-Vertex Normal Vectors...", caller );
+    const VerticesPtr positions ( new osg::Vec3Array ( _vertices->begin(), _vertices->end() ) );
     _vertices->clear();
     _vertices->reserve ( _shared.size() );
     ColorsPtr colors ( new osg::Vec4Array );
@@ -970,8 +1126,8 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
     for ( SharedVertices::iterator i = _shared.begin(); i != _shared.end(); ++i )
     {
       // Order is important here... 
-      const osg::Vec3f &v ( i->first );
-      SharedVertex *sv ( i->second );
+      SharedVertex *sv ( *i );
+      const osg::Vec3f &v ( positions->at ( sv->index() ) );
 
       // Add normal vector and color using original index.
       normalsV->push_back ( this->normalsV()->at ( sv->index() ) );
@@ -980,9 +1136,11 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
         colors->push_back ( _colorsV->at ( sv->index() ) );
 
       // Update the shared-vertex's index.
-      i->second->index ( _vertices->size() );
+      if ( true == keepBoundary )
+        renumbered.at ( sv->index() ) = _vertices->size();
+      sv->index ( _vertices->size() );
 
-      // Add the shared-vertex's key (the 3D vector) to the vertex pool.
+      // Add the shared-vertex's position to the vertex pool.
       _vertices->push_back ( v );
 
       // Expand the bounding box and display progress.
@@ -998,15 +1156,99 @@ void TriangleSet::keepTriangles ( const Indices &keepers, Usul::Interfaces::IUnk
     this->dirtyColorsV ( false );
   }
 
+  // The positions are the same but the indices changed.
+  this->_rebuildWeldIndex();
+
 #ifdef _DEBUG
   this->checkStatus();
 #endif
 
+  // Rebuild the mesh with the labels we saved.
+  if ( ( true == _useMesh ) && ( false == labels.empty() ) )
+  {
+    this->mesh()->components ( labels );
+  }
+
+  // Give the open edges the new vertex numbers.
+  if ( true == keepBoundary )
+  {
+    for ( Mesh::Edges::iterator i = boundary.begin(); i != boundary.end(); ++i )
+    {
+      *i = Mesh::edge ( renumbered[ Mesh::edgeFrom ( *i ) ], renumbered[ Mesh::edgeTo ( *i ) ] );
+    }
+    this->mesh()->boundary ( boundary );
+  }
+
   // These things are now dirty.
   this->dirtyBlocks ( true );
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  If the mesh's component labels are current and the keepers are made of
+//  whole components, return the labels of the keepers. Otherwise the labels
+//  are left empty.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleSet::_keptComponents ( const Indices &keepers, Mesh::Indices &labels )
+{
+  USUL_TRACE_SCOPE;
+
+  labels.clear();
+
+  if ( ( false == _useMesh ) || ( false == _mesh.valid() ) || ( true == keepers.empty() ) )
+    return;
+  if ( ( true == Usul::Bits::has ( _flags, Dirty::MESH ) ) || ( true == _mesh->dirtyComponents() ) )
+    return;
+
+  // Count the keepers in each component.
+  Mesh::Indices counts ( _mesh->numComponents(), 0 );
+  labels.reserve ( keepers.size() );
+  for ( Indices::const_iterator i = keepers.begin(); i != keepers.end(); ++i )
+  {
+    const Mesh::Index c ( _mesh->component ( *i ) );
+    labels.push_back ( c );
+    ++counts[c];
+  }
+
+  // Every component has to be kept whole or not at all.
+  for ( Mesh::Index c = 0; c < counts.size(); ++c )
+  {
+    const Mesh::Index size ( static_cast < Mesh::Index > ( _mesh->componentEnd ( c ) - _mesh->componentBegin ( c ) ) );
+    if ( ( 0 != counts[c] ) && ( size != counts[c] ) )
+    {
+      labels.clear();
+      return;
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  If the mesh's open edges are current, get the ones there will be when
+//  only the keepers are left. The vertices are not renumbered yet.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool TriangleSet::_keptBoundary ( const Indices &keepers, Mesh::Edges &edges )
+{
+  USUL_TRACE_SCOPE;
+
+  edges.clear();
+
+  if ( ( false == _useMesh ) || ( false == _mesh.valid() ) )
+    return false;
+  if ( ( true == Usul::Bits::has ( _flags, Dirty::MESH ) ) || ( true == _mesh->dirtyBoundary() ) )
+    return false;
+
+  _mesh->keptBoundary ( keepers, edges );
+  return true;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Remove these triangles.
@@ -1299,6 +1541,31 @@ bool TriangleSet::dirtyBlocks() const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the dirty flag.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool TriangleSet::dirtyMesh() const
+{
+  return Usul::Bits::has ( _flags, Dirty::MESH );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the triangles. The caller may change them, so the mesh is dirty.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TriangleSet::TriangleVector &TriangleSet::triangles()
+{
+  _flags = Usul::Bits::add ( _flags, Dirty::MESH );
+  return _triangles;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Update the blocks if needed. 
@@ -1371,7 +1638,7 @@ void TriangleSet::_updateNormalsV()
   for ( SharedVertices::iterator i = _shared.begin(); i != _shared.end(); ++i )
   {
     // This only updates the individual normals that are dirty.
-    this->_updateNormalV ( i->second );
+    this->_updateNormalV ( *i );
 
     // Progress.
     this->_incrementProgress ( update() );
@@ -1432,7 +1699,7 @@ void TriangleSet::_updateColorsV()
   for ( SharedVertices::iterator i = _shared.begin(); i != _shared.end(); ++i )
   {
     // This only updates the individual normals that are dirty.
-    this->_updateColorV ( i->second );
+    this->_updateColorV ( *i );
 
     // Progress.
     this->_incrementProgress ( update() );
@@ -1734,6 +2001,13 @@ void TriangleSet::purge()
     _triangles.swap ( temp );
   }
 
+  // Purge shared vertices.
+  if ( false == _shared.empty() )
+  {
+    SharedVertices temp ( _shared );
+    _shared.swap ( temp );
+  }
+
   // Purge vertices.
   if ( _vertices.valid() && false == _vertices->empty() )
   {
@@ -1765,6 +2039,10 @@ void TriangleSet::purge()
   // Purge the blocks.
   for( BlocksVector::iterator iter = _blocks.begin(); iter != _blocks.end(); ++iter )
     (*iter)->purge();
+
+  // Do not let the mesh hold on to the old arrays.
+  if ( _mesh.valid() )
+    _mesh->arrays ( _vertices.get(), _normalsV.get(), _colorsV.get(), _normalsT.get() );
 }
 
 
@@ -2057,6 +2335,32 @@ void TriangleSet::findAllConnected ( Usul::Interfaces::IUnknown* caller, Connect
 {
   typedef Usul::Polygons::TriangleFunctor< Connected, Triangle > Functor;
 
+  // The mesh labels every component in one pass and keeps the labels until
+  // the triangles change, so there are no flags to clear. A connected group
+  // is never partly visited, so the answer is the same.
+  if ( true == _useMesh )
+  {
+    Mesh::RefPtr mesh ( this->mesh() );
+    if ( seed >= mesh->numTriangles() )
+    {
+      Usul::Exceptions::Thrower < std::runtime_error >
+        ( "Error 1482663012: seed triangle is ", seed, " but there are only ", mesh->numTriangles(), " triangles" );
+    }
+
+    const Mesh::Index component ( mesh->component ( seed ) );
+    const Mesh::Index *begin ( mesh->componentBegin ( component ) );
+    const Mesh::Index *end ( mesh->componentEnd ( component ) );
+
+    // Callers like groupTriangles() look at the triangles' flags for the next seed.
+    connected.reserve ( connected.size() + ( end - begin ) );
+    for ( const Mesh::Index *i = begin; i != end; ++i )
+    {
+      _triangles[*i]->visited ( true );
+      connected.push_back ( *i );
+    }
+    return;
+  }
+
   // If we should...
   if ( clearVisitedFlag )
   {
@@ -2087,6 +2391,101 @@ void TriangleSet::findAllConnected ( Usul::Interfaces::IUnknown* caller, Connect
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copies the shared-vertex indices of the triangles into the mesh.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  struct FillMesh
+  {
+    FillMesh ( const TriangleSet::TriangleVector &triangles, Mesh &mesh ) : _triangles ( &triangles ), _mesh ( &mesh )
+    {
+    }
+
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      for ( unsigned int i = first; i < last; ++i )
+      {
+        const Triangle *t ( (*_triangles)[i].get() );
+        _mesh->setTriangle ( i, t->vertex0()->index(), t->vertex1()->index(), t->vertex2()->index() );
+      }
+    }
+
+  private:
+
+    const TriangleSet::TriangleVector *_triangles;
+    Mesh *_mesh;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the index-based mesh.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Mesh *TriangleSet::mesh()
+{
+  USUL_TRACE_SCOPE;
+
+  if ( false == _mesh.valid() )
+  {
+    _mesh = new Mesh;
+    _flags = Usul::Bits::add ( _flags, Dirty::MESH );
+  }
+
+  if ( ( Usul::Bits::has ( _flags, Dirty::MESH ) ) || ( _mesh->numTriangles() != _triangles.size() ) )
+  {
+    const unsigned int numTriangles ( _triangles.size() );
+    _mesh->clear();
+    _mesh->resize ( numTriangles );
+    Usul::Algorithms::parallelFor ( 0u, numTriangles, 65536u, Detail::FillMesh ( _triangles, *_mesh ) );
+    _flags = Usul::Bits::remove ( _flags, Dirty::MESH );
+  }
+
+  // The arrays are replaced, not just changed, by several members.
+  _mesh->arrays ( _vertices.get(), _normalsV.get(), _colorsV.get(), _normalsT.get() );
+  return _mesh.get();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the flag that routes connectivity queries through the mesh.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void TriangleSet::useMesh ( bool state )
+{
+  USUL_TRACE_SCOPE;
+  _useMesh = state;
+
+  // Free the memory if nobody wants it.
+  if ( ( false == state ) && ( _mesh.valid() ) )
+  {
+    _mesh = 0x0;
+    _flags = Usul::Bits::add ( _flags, Dirty::MESH );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the flag that routes connectivity queries through the mesh.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool TriangleSet::useMesh() const
+{
+  USUL_TRACE_SCOPE;
+  return _useMesh;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Group the Primitive Drawables by their connectivity
@@ -2111,6 +2510,24 @@ void TriangleSet::groupTriangles ( Usul::Interfaces::IUnknown *caller )
   
   // Start actual Code....
   Subsets islands;
+
+  // The mesh already has every island.
+  if ( true == _useMesh )
+  {
+    Mesh::RefPtr mesh ( this->mesh() );
+    const Mesh::Index numComponents ( mesh->numComponents() );
+    islands.resize ( numComponents );
+    for ( Mesh::Index c = 0; c < numComponents; ++c )
+    {
+      islands[c].assign ( mesh->componentBegin ( c ), mesh->componentEnd ( c ) );
+    }
+
+    this->createSubsets ( islands, caller );
+    this->setDirtyDisplayList();
+    std::cout << "Number of Islands Found: " << islands.size() << std::endl;
+    status ( "Grouping of Triangles Complete", true );
+    return;
+  }
   
   // Clear the Visited Flag for the triangles
   this->setAllUnvisited();
@@ -26,14 +26,15 @@
 #include "OsgTools/Triangles/SharedVertex.h"
 #include "OsgTools/Triangles/Triangle.h"
 #include "OsgTools/Triangles/Factory.h"
+#include "OsgTools/Triangles/Mesh.h"
 #include "OsgTools/Triangles/Blocks.h"
 #include "OsgTools/Triangles/ColorFunctor.h"
+#include "OsgTools/Triangles/WeldGrid.h"
 
 #include "Usul/Base/Referenced.h"
 #include "Usul/Pointers/Pointers.h"
 #include "Usul/Interfaces/IUnknown.h"
 #include "Usul/Predicates/CloseFloat.h"
-#include "Usul/Predicates/LessVector.h"
 #include "Usul/Types/Types.h"
 
 #include "osg/Geometry"
@@ -63,14 +64,9 @@ public:
 
   // Useful typedefs.
   typedef Usul::Base::Referenced BaseClass;
-  typedef std::pair < osg::Vec3f, SharedVertex::ValidAccessRefPtr > KeyValuePair;
-
-  // The comparison predicate.
-  typedef Usul::Predicates::CloseFloat < float > CloseFloat;
-  typedef Usul::Predicates::LessVector < CloseFloat, 3 > LessVector;
 
   // Remaining typedefs.
-  typedef std::map < KeyValuePair::first_type, KeyValuePair::second_type, LessVector > SharedVertices;
+  typedef std::vector < SharedVertex::ValidAccessRefPtr > SharedVertices;
   typedef std::vector < Triangle::ValidAccessRefPtr > TriangleVector;
   typedef Usul::Interfaces::IUnknown Unknown;
   typedef std::map < std::string,std::string > Options;
@@ -83,12 +79,12 @@ public:
   typedef BlocksVector::const_iterator    BlocksConstIterator;
   typedef std::vector < unsigned int > Indices;
   typedef std::pair < unsigned int, unsigned int > Progress;
-  typedef std::pair < SharedVertices::iterator, bool > InsertResult;
   typedef Factory::ValidRefPtr FactoryPtr;
   typedef std::vector< unsigned int > Connected;
   typedef std::vector < Connected > Subsets;
   typedef osg::ref_ptr< osg::Group > GroupPtr;
   typedef std::vector< float > HeaderInfo;
+  typedef WeldGrid < SharedVertex * > WeldIndex;
 
   // Type information.
   USUL_DECLARE_TYPE_ID ( TriangleSet );
@@ -106,6 +102,13 @@ public:
   Triangle *              addTriangle ( const osg::Vec3f &v0, const osg::Vec3f &v1, const osg::Vec3f &v2, const osg::Vec3f &n, bool update, bool look );
   Triangle *              addTriangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, const osg::Vec3f &n, bool update );
 
+  // Add many triangles at once. There are three vertices and one normal per triangle.
+  // The vertices are welded in parallel, then merged with the existing ones.
+  // Triangles whose vertices weld together are kept, the same as with
+  // addTriangle(). The new triangles are appended in order. Returns the
+  // number added, which is one per normal.
+  unsigned int            addTriangles ( const osg::Vec3Array &vertices, const osg::Vec3Array &normals, bool update, Unknown *caller = 0x0 );
+
   // Get the averaged normal for the shared vertex.
   osg::Vec3f              averageNormal ( const SharedVertex *sv ) const;
 
@@ -158,6 +161,7 @@ public:
   bool                    dirtyColorsV() const;
   void                    dirtyNormalsV ( bool );
   bool                    dirtyNormalsV() const;
+  bool                    dirtyMesh() const;
 
   // Get/Set the display list flag.
   bool                    displayList () const;
@@ -202,6 +206,13 @@ public:
   SharedVertex *          newSharedVertex ( unsigned int index, unsigned int numTrianglesToReserve = 0 );
   Triangle *              newTriangle ( SharedVertex *v0, SharedVertex *v1, SharedVertex *v2, unsigned int index );
 
+  // Get the index-based mesh. It is rebuilt from the triangles when they change.
+  Mesh *                  mesh();
+
+  // Set/get the flag that routes connectivity queries through the mesh.
+  void                    useMesh ( bool );
+  bool                    useMesh() const;
+
   // Get the number of subdivisions.
   unsigned int            numberSubDivisions( unsigned int numberTriangles );
 
@@ -246,9 +257,12 @@ public:
   // Returns the index of the first triangle flagged as visited=FALSE
   Usul::Types::Int32      firstUnvisited();
 
-  // Get the shared vertices. Be real careful when using this.
+  // Get the shared vertices. The i'th one has index i.
   const SharedVertices &  sharedVertices() const { return _shared; }
-  SharedVertices &        sharedVertices()       { return _shared; }
+
+  // Set the shared vertices for the vertex pool, in the same order. Use
+  // this after filling the vertex pool directly.
+  void                    sharedVertices ( const SharedVertices & );
 
   // Get the shared-vertices of the i'th triangle.
   const SharedVertex *    sharedVertex0 ( const osg::Geode* g, const osg::Drawable* d, unsigned int i ) const;
@@ -261,9 +275,11 @@ public:
   /// Get a node that shows the new triangles.
   osg::Node*              showNewTriangles();
 
-  // Get the triangles. Use with caution.
+  // Get the triangles. Use with caution. The non-const version marks the
+  // mesh as dirty because the caller may add or remove triangles, so use
+  // the const one to only look at them.
   const TriangleVector &  triangles() const { return _triangles; }
-  TriangleVector &        triangles()       { return _triangles; }
+  TriangleVector &        triangles();
 
   // Update the bounding box.
   void                    updateBounds ( Triangle *t );
@@ -306,7 +322,10 @@ protected:
   void                    _buildDecorations ( const Options &options, osg::Group * ) const;
 
   void                    _incrementProgress ( bool state, Usul::Interfaces::IUnknown *caller = 0x0 );
-  InsertResult            _insertSharedVertex ( const osg::Vec3f &v, SharedVertex *sv );
+  bool                    _keptBoundary ( const Indices &keepers, Mesh::Edges &edges );
+  void                    _keptComponents ( const Indices &keepers, Mesh::Indices &labels );
+
+  void                    _rebuildWeldIndex();
 
   void                    _setProgressBar ( bool state, unsigned int numerator, unsigned int denominator, Usul::Interfaces::IUnknown *caller = 0x0  );
   void                    _setStatusBar ( const std::string &text, Usul::Interfaces::IUnknown *caller = 0x0 );
@@ -328,11 +347,13 @@ private:
     {
       NORMALS_V = 0x00000001,
       COLORS_V  = 0x00000002,
-      BLOCKS    = 0x00000004
+      BLOCKS    = 0x00000004,
+      MESH      = 0x00000010
     };
   };
 
   SharedVertices _shared;
+  WeldIndex _weld;
   TriangleVector _triangles;
   VerticesPtr _vertices;
   NormalsPtr _normalsV;
@@ -346,6 +367,8 @@ private:
   ColorFunctor::RefPtr _color;
   GroupPtr _root;
   bool _useMaterial;
+  Mesh::RefPtr _mesh;
+  bool _useMesh;
 };
 
 
@@ -0,0 +1,293 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Spatial hash used to weld vertices.
+//
+//  Two vertices are the same when every component is within the given
+//  number of units in the last place, exactly like the CloseFloat
+//  predicate. TriangleSet uses it to find its shared vertices.
+//
+//  Each float is turned into the same lexicographically ordered integer
+//  that CloseFloat compares. Dropping the low bits of that integer gives
+//  the cell along one axis, so a cell is a fixed number of ULPs wide and
+//  grows with the magnitude of the coordinate. Only the cells that the
+//  tolerance reaches are searched, which is one cell unless the vertex is
+//  right on a cell boundary.
+//
+//  Entries are kept in one flat vector and chained per cell. The cells are
+//  an open-addressing table of ( key, first entry ) pairs, so a search
+//  usually touches one slot of the table and one entry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_WELD_GRID_H_
+#define _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_WELD_GRID_H_
+
+#include "Usul/Predicates/CloseFloat.h"
+#include "Usul/Types/Types.h"
+
+#include "osg/Vec3f"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+
+namespace OsgTools {
+namespace Triangles {
+
+
+template < class ValueType_ > class WeldGrid
+{
+public:
+
+  // Useful typedefs.
+  typedef ValueType_ ValueType;
+  typedef Usul::Types::Int32 Int32;
+  typedef Usul::Types::Int64 Int64;
+  typedef Usul::Types::Uint64 Key;
+
+  // Cells are 2^SHIFT ULPs wide by default.
+  enum { SHIFT = 12 };
+
+  // Constructor.
+  WeldGrid ( unsigned int unitsInLastPlace = 1, unsigned int shift = SHIFT ) :
+    _ulps    ( unitsInLastPlace ),
+    _shift   ( ( shift < 11 ) ? 11 : ( ( shift > 31 ) ? 31 : shift ) ),
+    _numCells ( 0 ),
+    _cells   (),
+    _entries ()
+  {
+  }
+
+  // Remove all the entries.
+  void clear()
+  {
+    Cells().swap ( _cells );
+    Entries().swap ( _entries );
+    _numCells = 0;
+  }
+
+  // Is it empty?
+  bool empty() const
+  {
+    return _entries.empty();
+  }
+
+  // Return the value of a vertex that is close to v. Returns false if there is none.
+  bool find ( const osg::Vec3f &v, ValueType &value ) const
+  {
+    const Int64 ordered[3] = { WeldGrid::_ordered ( v[0] ), WeldGrid::_ordered ( v[1] ), WeldGrid::_ordered ( v[2] ) };
+
+    Int64 lo[3], hi[3];
+    this->_range ( ordered, lo, hi );
+
+    for ( Int64 x = lo[0]; x <= hi[0]; ++x )
+    {
+      for ( Int64 y = lo[1]; y <= hi[1]; ++y )
+      {
+        for ( Int64 z = lo[2]; z <= hi[2]; ++z )
+        {
+          const Cell *cell ( this->_findCell ( WeldGrid::_key ( x, y, z ) ) );
+          if ( 0x0 == cell )
+            continue;
+
+          for ( unsigned int e = cell->first; e != NONE; e = _entries[e].next )
+          {
+            const Entry &entry ( _entries[e] );
+            if ( ( true == this->_close ( ordered[0], entry.v[0] ) ) &&
+                 ( true == this->_close ( ordered[1], entry.v[1] ) ) &&
+                 ( true == this->_close ( ordered[2], entry.v[2] ) ) )
+            {
+              value = entry.value;
+              return true;
+            }
+          }
+        }
+      }
+    }
+
+    return false;
+  }
+
+  // Add the vertex. Does not look for an existing one.
+  void insert ( const osg::Vec3f &v, ValueType value )
+  {
+    const Key key ( WeldGrid::_key ( this->_cell ( v[0] ), this->_cell ( v[1] ), this->_cell ( v[2] ) ) );
+    const unsigned int index ( static_cast < unsigned int > ( _entries.size() ) );
+
+    // Keep the table at most half full.
+    if ( 2 * ( _numCells + 1 ) > _cells.size() )
+      this->_grow ( 2 * ( _numCells + 1 ) );
+
+    Cell &cell ( this->_slot ( key ) );
+    if ( NONE == cell.first )
+    {
+      cell.key = key;
+      ++_numCells;
+    }
+
+    // The new entry goes to the front of the cell's chain.
+    _entries.push_back ( Entry ( v, value, cell.first ) );
+    cell.first = index;
+  }
+
+  // Make space.
+  void reserve ( unsigned int num )
+  {
+    _entries.reserve ( num );
+    if ( 2 * num > _cells.size() )
+      this->_grow ( 2 * num );
+  }
+
+  // Return the tolerance in units in the last place.
+  unsigned int ulps() const
+  {
+    return _ulps;
+  }
+
+  // Return the number of entries.
+  unsigned int size() const
+  {
+    return static_cast < unsigned int > ( _entries.size() );
+  }
+
+private:
+
+  enum { NONE = 0xFFFFFFFF };
+
+  struct Entry
+  {
+    Entry ( const osg::Vec3f &v_, ValueType value_, unsigned int next_ ) : v ( v_ ), value ( value_ ), next ( next_ ){}
+    osg::Vec3f v;
+    ValueType value;
+    unsigned int next;
+  };
+
+  struct Cell
+  {
+    Cell() : key ( 0 ), first ( NONE ){}
+    Key key;
+    unsigned int first;
+  };
+
+  typedef std::vector < Cell > Cells;
+  typedef std::vector < Entry > Entries;
+
+  static std::size_t _hash ( Key key )
+  {
+    key ^= ( key >> 29 );
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= ( key >> 32 );
+    return static_cast < std::size_t > ( key );
+  }
+
+  // The cell with the key, or null.
+  const Cell *_findCell ( Key key ) const
+  {
+    if ( true == _cells.empty() )
+      return 0x0;
+
+    const std::size_t mask ( _cells.size() - 1 );
+    for ( std::size_t i = ( WeldGrid::_hash ( key ) & mask ); ; i = ( ( i + 1 ) & mask ) )
+    {
+      const Cell &cell ( _cells[i] );
+      if ( NONE == cell.first )
+        return 0x0;
+      if ( key == cell.key )
+        return &cell;
+    }
+  }
+
+  // The cell with the key, or the empty one where it goes.
+  Cell &_slot ( Key key )
+  {
+    const std::size_t mask ( _cells.size() - 1 );
+    for ( std::size_t i = ( WeldGrid::_hash ( key ) & mask ); ; i = ( ( i + 1 ) & mask ) )
+    {
+      Cell &cell ( _cells[i] );
+      if ( ( NONE == cell.first ) || ( key == cell.key ) )
+        return cell;
+    }
+  }
+
+  // Make the table a power of two that is at least this big.
+  void _grow ( std::size_t num )
+  {
+    std::size_t size ( 16 );
+    while ( size < num )
+      size *= 2;
+
+    if ( size <= _cells.size() )
+      return;
+
+    Cells old ( size );
+    old.swap ( _cells );
+    for ( typename Cells::const_iterator i = old.begin(); i != old.end(); ++i )
+    {
+      if ( NONE != i->first )
+        this->_slot ( i->key ) = *i;
+    }
+  }
+
+  // Same ordering that CloseFloat uses.
+  static Int64 _ordered ( float f )
+  {
+    Int32 i ( 0 );
+    std::memcpy ( &i, &f, sizeof ( Int32 ) );
+    Usul::Predicates::Detail::handleTwosCompliment ( i );
+    return static_cast < Int64 > ( i );
+  }
+
+  Int64 _cell ( float f ) const
+  {
+    return ( WeldGrid::_ordered ( f ) >> _shift );
+  }
+
+  // Same answer as CloseFloat::compare for finite numbers.
+  bool _close ( Int64 a, float b ) const
+  {
+    const Int64 diff ( a - WeldGrid::_ordered ( b ) );
+    return ( ( ( diff < 0 ) ? -diff : diff ) <= static_cast < Int64 > ( _ulps ) );
+  }
+
+  // Cells that a vertex within tolerance of v could be in.
+  void _range ( const Int64 *ordered, Int64 *lo, Int64 *hi ) const
+  {
+    for ( unsigned int i = 0; i < 3; ++i )
+    {
+      lo[i] = ( ordered[i] - static_cast < Int64 > ( _ulps ) ) >> _shift;
+      hi[i] = ( ordered[i] + static_cast < Int64 > ( _ulps ) ) >> _shift;
+    }
+  }
+
+  // 21 bits per axis. Cells that share a key are told apart by the compare.
+  static Key _key ( Int64 x, Int64 y, Int64 z )
+  {
+    const Key mask ( 0x1FFFFF );
+    return ( ( static_cast < Key > ( x ) & mask ) << 42 ) |
+           ( ( static_cast < Key > ( y ) & mask ) << 21 ) |
+           ( ( static_cast < Key > ( z ) & mask ) );
+  }
+
+  unsigned int _ulps;
+  unsigned int _shift;
+  unsigned int _numCells;
+  Cells _cells;
+  Entries _entries;
+};
+
+
+} // namespace Triangles
+} // namespace OsgTools
+
+
+#endif // _OPEN_SCENE_GRAPH_TOOLS_TRIANGLES_WELD_GRID_H_
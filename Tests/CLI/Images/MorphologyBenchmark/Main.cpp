@@ -0,0 +1,222 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Adam Kubach
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Compares the morphology and convolution kernels with looking at every
+//  value of the window for every pixel, which is what the old templates
+//  did for their 3x3 windows.
+//
+//  Usage: MorphologyBenchmark [size] [repeats]
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Images/Algorithms/Morphology.h"
+
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/date_time/posix_time/posix_time_types.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Channels, the window scans, and timing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef boost::posix_time::ptime Time;
+  typedef boost::posix_time::microsec_clock Clock;
+
+  double seconds ( const Time &start )
+  {
+    return static_cast < double > ( ( Clock::universal_time() - start ).total_microseconds() ) * 1e-6;
+  }
+
+  // Blobs with speckle, like a segmentation mask.
+  template < class T > std::vector < T > channel ( unsigned int size, T high )
+  {
+    std::vector < T > values ( size * size );
+    unsigned int seed ( size );
+    for ( unsigned int y = 0; y < size; ++y )
+    {
+      for ( unsigned int x = 0; x < size; ++x )
+      {
+        seed = seed * 1103515245u + 12345u;
+        const bool blob ( ( ( x / 37 ) + ( y / 23 ) ) % 3 == 0 );
+        const bool speck ( 0 == ( ( seed >> 16 ) % 50 ) );
+        values[y * size + x] = ( ( blob != speck ) ? high : T ( 0 ) );
+      }
+    }
+    return values;
+  }
+
+  template < class T > void minimum ( std::vector < T > &channel, unsigned int size, unsigned int k )
+  {
+    const std::vector < T > copy ( channel );
+    const int a ( static_cast < int > ( k / 2 ) ), n ( static_cast < int > ( size ) );
+    for ( int y = 0; y < n; ++y )
+    {
+      for ( int x = 0; x < n; ++x )
+      {
+        T answer ( copy[y * n + x] );
+        for ( int r = std::max ( 0, y - a ); r < std::min ( n, y - a + static_cast < int > ( k ) ); ++r )
+          for ( int c = std::max ( 0, x - a ); c < std::min ( n, x - a + static_cast < int > ( k ) ); ++c )
+            answer = std::min ( answer, copy[r * n + c] );
+        channel[y * n + x] = answer;
+      }
+    }
+  }
+
+  template < class T > void convolve ( std::vector < T > &channel, unsigned int size, const Images::Algorithms::Mask &mask )
+  {
+    const std::vector < T > copy ( channel );
+    const int kr ( mask.rows() ), kc ( mask.columns() ), n ( static_cast < int > ( size ) );
+    for ( int y = 0; y < n; ++y )
+    {
+      for ( int x = 0; x < n; ++x )
+      {
+        float sum ( 0 );
+        for ( int i = 0; i < kr; ++i )
+        {
+          const int r ( std::min ( std::max ( y + i - kr / 2, 0 ), n - 1 ) );
+          for ( int j = 0; j < kc; ++j )
+            sum += mask ( i, j ) * copy[r * n + std::min ( std::max ( x + j - kc / 2, 0 ), n - 1 )];
+        }
+        channel[y * n + x] = static_cast < T > ( std::min ( 255.0f, std::max ( 0.0f, sum + 0.5f ) ) );
+      }
+    }
+  }
+
+  void print ( const std::string &name, unsigned int k, unsigned int size, unsigned int repeats, double seconds )
+  {
+    const double pixels ( static_cast < double > ( size ) * size * repeats );
+    std::cout << std::setw ( 20 ) << name
+              << std::setw ( 8 ) << k
+              << std::setw ( 12 ) << std::fixed << std::setprecision ( 2 ) << ( seconds * 1e3 / repeats )
+              << std::setw ( 15 ) << std::setprecision ( 1 ) << ( ( seconds > 0 ) ? ( pixels / seconds * 1e-6 ) : 0 )
+              << std::endl;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run the benchmark.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _test ( int argc, char **argv )
+{
+  namespace Algorithms = Images::Algorithms;
+  typedef Usul::Types::Uint8 Byte;
+  typedef Usul::Types::Uint16 Short;
+
+  const unsigned int size ( ( argc > 1 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[1] ) ) ) : 1024 );
+  const unsigned int repeats ( std::max ( 1, ( argc > 2 ) ? std::abs ( ::atoi ( argv[2] ) ) : 5 ) );
+
+  const std::vector < Byte > bytes ( Detail::channel < Byte > ( size, 255 ) );
+  const std::vector < Short > shorts ( Detail::channel < Short > ( size, 4095 ) );
+  const std::vector < float > floats ( Detail::channel < float > ( size, 1.0f ) );
+
+  std::cout << "Size: " << size << " x " << size << ", repeats: " << repeats << '\n';
+  std::cout << std::setw ( 20 ) << "Kernel"
+            << std::setw ( 8 ) << "Window"
+            << std::setw ( 12 ) << "msec"
+            << std::setw ( 15 ) << "Mpixels/sec"
+            << std::endl;
+
+  const unsigned int windows[] = { 3, 7, 15, 31 };
+  for ( unsigned int w = 0; w < 4; ++w )
+  {
+    const unsigned int k ( windows[w] );
+
+    // The window scan gets slow with big windows, so only time it once.
+    {
+      std::vector < Byte > v ( bytes );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      Detail::minimum ( v, size, k );
+      Detail::print ( "erode u8 scan", k, size, 1, Detail::seconds ( start ) );
+    }
+
+    {
+      std::vector < Byte > v ( bytes );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      for ( unsigned int i = 0; i < repeats; ++i )
+        Algorithms::erode ( v, size, size, k, k );
+      Detail::print ( "erode u8", k, size, repeats, Detail::seconds ( start ) );
+    }
+
+    {
+      std::vector < Short > v ( shorts );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      for ( unsigned int i = 0; i < repeats; ++i )
+        Algorithms::dilate ( v, size, size, k, k );
+      Detail::print ( "dilate u16", k, size, repeats, Detail::seconds ( start ) );
+    }
+
+    {
+      std::vector < float > v ( floats );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      for ( unsigned int i = 0; i < repeats; ++i )
+        Algorithms::open ( v, size, size, k, k );
+      Detail::print ( "open float", k, size, repeats, Detail::seconds ( start ) );
+    }
+
+    Algorithms::Mask box ( k, k, 1.0f / ( k * k ) );
+
+    {
+      std::vector < Byte > v ( bytes );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      Detail::convolve ( v, size, box );
+      Detail::print ( "box u8 scan", k, size, 1, Detail::seconds ( start ) );
+    }
+
+    {
+      std::vector < Byte > v ( bytes );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      for ( unsigned int i = 0; i < repeats; ++i )
+        Algorithms::convolve ( v, size, size, box );
+      Detail::print ( "box u8", k, size, repeats, Detail::seconds ( start ) );
+    }
+
+    // Not separable, so it takes the one pass path.
+    box ( 0, 0 ) = 0.0f;
+
+    {
+      std::vector < Byte > v ( bytes );
+      const Detail::Time start ( Detail::Clock::universal_time() );
+      for ( unsigned int i = 0; i < repeats; ++i )
+        Algorithms::convolve ( v, size, size, box );
+      Detail::print ( "mask u8", k, size, repeats, Detail::seconds ( start ) );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Main function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+int main ( int argc, char **argv )
+{
+  Usul::Functions::safeCallV1V2 ( _test, argc, argv, "3071849526" );
+  return 0;
+}
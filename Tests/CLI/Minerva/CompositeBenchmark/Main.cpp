@@ -0,0 +1,221 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2008, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Compares the raster compositing kernels on typical tile sizes.
+//
+//  "blend" times only the kernel that blends a row into the result. The
+//  other rows time all of Composite::raster, which also finds the color and
+//  weight of each pixel. Which vector kernels there are depends on how this
+//  was compiled (e.g., -mavx2). The vector kernels have to give the same
+//  bytes as the scalar one, or it stops with an error.
+//
+//  Usage: CompositeBenchmark [num tiles]
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/Algorithms/Composite.h"
+
+#include "Usul/Functions/Color.h"
+#include "Usul/Functions/SafeCall.h"
+
+#include "osg/Image"
+
+#include "boost/date_time/posix_time/posix_time_types.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <stdexcept>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef osg::ref_ptr < osg::Image > ImagePtr;
+typedef std::map < Usul::Types::Uint32, unsigned short > Alphas;
+typedef Minerva::Core::Algorithms::Composite::Detail::Weight Weight;
+typedef void ( *Kernel ) ( unsigned char *, const unsigned char *, const Weight *, unsigned int );
+typedef std::vector < unsigned char > Pixels;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Images and timing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef boost::posix_time::ptime Time;
+  typedef boost::posix_time::microsec_clock Clock;
+
+  double seconds ( const Time &start )
+  {
+    return static_cast < double > ( ( Clock::universal_time() - start ).total_microseconds() ) * 1e-6;
+  }
+
+  // Smooth gradient with some noise and a partly transparent band.
+  ImagePtr image ( unsigned int size, GLenum format )
+  {
+    const unsigned int channels ( ( GL_RGBA == format ) ? 4 : 3 );
+    ImagePtr image ( new osg::Image );
+    image->allocateImage ( size, size, 1, format, GL_UNSIGNED_BYTE );
+    unsigned char *p ( image->data() );
+    unsigned int seed ( size );
+    for ( unsigned int y = 0; y < size; ++y )
+    {
+      for ( unsigned int x = 0; x < size; ++x, p += channels )
+      {
+        seed = seed * 1103515245u + 12345u;
+        p[0] = static_cast < unsigned char > ( x + ( ( seed >> 16 ) & 7 ) );
+        p[1] = static_cast < unsigned char > ( y );
+        p[2] = static_cast < unsigned char > ( ( x < size / 8 ) ? 0 : x + y );
+        if ( 4 == channels )
+          p[3] = static_cast < unsigned char > ( ( y < size / 2 ) ? 255 : x );
+      }
+    }
+    return image;
+  }
+
+  void print ( const std::string &name, unsigned int size, unsigned int numTiles, double seconds )
+  {
+    const double pixels ( static_cast < double > ( size ) * size * numTiles );
+    std::cout << std::setw ( 24 ) << name
+              << std::setw ( 6 ) << size
+              << std::setw ( 15 ) << std::fixed << std::setprecision ( 1 ) << ( ( numTiles > 0 ) ? ( seconds * 1e6 / numTiles ) : 0 )
+              << std::setw ( 15 ) << std::setprecision ( 0 ) << ( ( seconds > 0 ) ? ( pixels / seconds * 1e-6 ) : 0 )
+              << std::endl;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Time one blending kernel. Returns what it made.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Pixels _runKernel ( const std::string &name, Kernel kernel, unsigned int numTiles, unsigned int size )
+{
+  namespace Composite = Minerva::Core::Algorithms::Composite;
+
+  Pixels dst ( size * size * 4, 64 ), colors ( size * 4 );
+  std::vector < Weight > weights ( size );
+  for ( unsigned int i = 0; i < size; ++i )
+  {
+    colors[i * 4 + 0] = static_cast < unsigned char > ( i );
+    colors[i * 4 + 1] = static_cast < unsigned char > ( i * 3 );
+    colors[i * 4 + 2] = static_cast < unsigned char > ( i * 7 );
+    weights[i] = static_cast < Weight > ( i % ( Composite::Detail::ONE + 1 ) );
+  }
+
+  const Detail::Time start ( Detail::Clock::universal_time() );
+  for ( unsigned int tile = 0; tile < numTiles; ++tile )
+  {
+    for ( unsigned int row = 0; row < size; ++row )
+      kernel ( &dst[row * size * 4], &colors[0], &weights[0], size );
+  }
+  Detail::print ( name, size, numTiles, Detail::seconds ( start ) );
+
+  return dst;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Time a vector kernel and make sure it made the same bytes as the scalar.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _checkKernel ( const std::string &name, Kernel kernel, unsigned int numTiles, unsigned int size, const Pixels &expected )
+{
+  if ( expected != _runKernel ( name, kernel, numTiles, size ) )
+    throw std::runtime_error ( "Error 2560419873: Kernel '" + name + "' does not match the scalar kernel" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Time all of the compositing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _runRaster ( const std::string &name, const osg::Image &image, const Alphas &alphas, float alpha, unsigned int numTiles, unsigned int size )
+{
+  ImagePtr result ( new osg::Image );
+  result->allocateImage ( size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE );
+
+  const Detail::Time start ( Detail::Clock::universal_time() );
+  for ( unsigned int tile = 0; tile < numTiles; ++tile )
+    Minerva::Core::Algorithms::Composite::raster ( *result, image, alphas, alpha, 1.0f, 0x0 );
+  Detail::print ( name, size, numTiles, Detail::seconds ( start ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run the benchmark.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _test ( int argc, char **argv )
+{
+  namespace Composite = Minerva::Core::Algorithms::Composite;
+
+  const unsigned int numTiles ( ( argc > 1 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[1] ) ) ) : 1000 );
+
+  // A few colors made transparent, like the layers' no-data colors.
+  Alphas alphas;
+  alphas[Usul::Functions::Color::pack ( 0, 0, 0, 0 )] = 0;
+  alphas[Usul::Functions::Color::pack ( 255, 255, 255, 0 )] = 0;
+  alphas[Usul::Functions::Color::pack ( 10, 20, 30, 0 )] = 128;
+
+  std::cout << "Tiles: " << numTiles << '\n';
+  std::cout << std::setw ( 24 ) << "Kernel"
+            << std::setw ( 6 ) << "Size"
+            << std::setw ( 15 ) << "usec/tile"
+            << std::setw ( 15 ) << "Mpixels/sec"
+            << std::endl;
+
+  const unsigned int sizes[] = { 256, 512 };
+  for ( unsigned int i = 0; i < 2; ++i )
+  {
+    const unsigned int size ( sizes[i] );
+
+    const Pixels expected ( _runKernel ( "blend scalar", &Composite::Detail::blendScalar, numTiles, size ) );
+#ifdef MINERVA_COMPOSITE_SSE2
+    _checkKernel ( "blend sse2", &Composite::Detail::blendSSE2, numTiles, size, expected );
+#endif
+#ifdef MINERVA_COMPOSITE_AVX2
+    _checkKernel ( "blend avx2", &Composite::Detail::blendAVX2, numTiles, size, expected );
+#endif
+
+    ImagePtr rgb ( Detail::image ( size, GL_RGB ) );
+    ImagePtr rgba ( Detail::image ( size, GL_RGBA ) );
+    _runRaster ( "raster rgb", *rgb, Alphas(), 1.0f, numTiles, size );
+    _runRaster ( "raster rgb alphas", *rgb, alphas, 1.0f, numTiles, size );
+    _runRaster ( "raster rgba", *rgba, Alphas(), 1.0f, numTiles, size );
+    _runRaster ( "raster rgba alphas 0.5", *rgba, alphas, 0.5f, numTiles, size );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Main function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+int main ( int argc, char **argv )
+{
+  Usul::Functions::safeCallV1V2 ( _test, argc, argv, "1364705829" );
+  return 0;
+}
@@ -0,0 +1,223 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Compares looking up tiles in one PNG file per tile, the way RasterLayer
+//  caches them, with the packed cache, raw and compressed.
+//
+//  "Cold" is the first pass after opening the cache again, including the
+//  time to read the index. Drop the system's file cache before running for
+//  numbers from the disk. "Warm" is a second pass over the same tiles.
+//
+//  Usage: TileCacheBenchmark [num tiles] [tile size] [directory]
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/Utilities/PackedTileCache.h"
+
+#include "Usul/File/Make.h"
+#include "Usul/File/Temp.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Strings/Format.h"
+
+#include "osgDB/ReadFile"
+#include "osgDB/WriteFile"
+
+#include "boost/date_time/posix_time/posix_time_types.hpp"
+#include "boost/filesystem/operations.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+typedef Minerva::Core::Utilities::PackedTileCache PackedTileCache;
+typedef PackedTileCache::Extents Extents;
+typedef PackedTileCache::ImagePtr ImagePtr;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Tiles and timing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef boost::posix_time::ptime Time;
+  typedef boost::posix_time::microsec_clock Clock;
+
+  const unsigned int LEVEL ( 12 );
+
+  double seconds ( const Time &start )
+  {
+    return static_cast < double > ( ( Clock::universal_time() - start ).total_microseconds() ) * 1e-6;
+  }
+
+  Extents extents ( unsigned int i )
+  {
+    const double size ( 180.0 / ( 1u << LEVEL ) );
+    const unsigned int row ( i / 1024 ), column ( i % 1024 );
+    return Extents ( -180.0 + column * size, -90.0 + row * size, -180.0 + ( column + 1 ) * size, -90.0 + ( row + 1 ) * size );
+  }
+
+  // Smooth gradient with some noise, so that it compresses a little.
+  ImagePtr image ( unsigned int size, unsigned int seed )
+  {
+    ImagePtr image ( new osg::Image );
+    image->allocateImage ( size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE );
+    unsigned char *p ( image->data() );
+    for ( unsigned int y = 0; y < size; ++y )
+    {
+      for ( unsigned int x = 0; x < size; ++x, p += 4 )
+      {
+        seed = seed * 1103515245u + 12345u;
+        p[0] = static_cast < unsigned char > ( x + ( ( seed >> 16 ) & 7 ) );
+        p[1] = static_cast < unsigned char > ( y );
+        p[2] = static_cast < unsigned char > ( x + y );
+        p[3] = 255;
+      }
+    }
+    return image;
+  }
+
+  std::string pngFile ( const std::string &dir, unsigned int i )
+  {
+    return Usul::Strings::format ( dir, "/", LEVEL, "/", i / 1024, "/", i % 1024, ".png" );
+  }
+
+  // What RasterLayer does for each lookup: see if it's there, check the size, and decode it.
+  ImagePtr readPng ( const std::string &file )
+  {
+    if ( ( false == boost::filesystem::exists ( file ) ) || ( 0 == boost::filesystem::file_size ( file ) ) )
+      return ImagePtr ( 0x0 );
+    return osgDB::readImageFile ( file );
+  }
+
+  void print ( const std::string &name, const std::string &pass, unsigned int numTiles, double seconds, unsigned int found )
+  {
+    std::cout << std::setw ( 12 ) << name
+              << std::setw ( 8 ) << pass
+              << std::setw ( 15 ) << std::fixed << std::setprecision ( 0 ) << ( ( seconds > 0 ) ? ( numTiles / seconds ) : 0 )
+              << std::setw ( 15 ) << std::setprecision ( 1 ) << ( ( numTiles > 0 ) ? ( seconds * 1e6 / numTiles ) : 0 )
+              << std::setw ( 10 ) << found
+              << std::endl;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  One file per tile.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _runFiles ( const std::string &dir, unsigned int numTiles, unsigned int size )
+{
+  for ( unsigned int i = 0; i < numTiles; ++i )
+  {
+    const std::string file ( Detail::pngFile ( dir, i ) );
+    Usul::File::make ( boost::filesystem::path ( file ).parent_path().string() + "/" );
+    osgDB::writeImageFile ( *Detail::image ( size, i ), file );
+  }
+
+  const char *passes[] = { "cold", "warm" };
+  for ( unsigned int pass = 0; pass < 2; ++pass )
+  {
+    unsigned int found ( 0 );
+    const Detail::Time start ( Detail::Clock::universal_time() );
+    for ( unsigned int i = 0; i < numTiles; ++i )
+      found += ( ( true == Detail::readPng ( Detail::pngFile ( dir, i ) ).valid() ) ? 1 : 0 );
+    Detail::print ( "png files", passes[pass], numTiles, Detail::seconds ( start ), found );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The packed cache.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _runPacked ( const std::string &name, const std::string &file, PackedTileCache::Compression compression, unsigned int numTiles, unsigned int size )
+{
+  const PackedTileCache::SizeType maxBytes ( static_cast < PackedTileCache::SizeType > ( 64 ) * 1024 * 1024 * 1024 );
+  {
+    PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, maxBytes, compression ) );
+    for ( unsigned int i = 0; i < numTiles; ++i )
+      cache->insert ( Detail::extents ( i ), size, size, Detail::LEVEL, *Detail::image ( size, i ) );
+    PackedTileCache::close ( file );
+  }
+
+  // Opening again reads the index.
+  Detail::Time start ( Detail::Clock::universal_time() );
+  PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, maxBytes, compression ) );
+
+  const char *passes[] = { "cold", "warm" };
+  for ( unsigned int pass = 0; pass < 2; ++pass )
+  {
+    if ( pass > 0 )
+      start = Detail::Clock::universal_time();
+
+    unsigned int found ( 0 );
+    for ( unsigned int i = 0; i < numTiles; ++i )
+      found += ( ( true == cache->find ( Detail::extents ( i ), size, size, Detail::LEVEL ).valid() ) ? 1 : 0 );
+    Detail::print ( name, passes[pass], numTiles, Detail::seconds ( start ), found );
+  }
+
+  std::cout << std::setw ( 12 ) << "" << "  file size: " << cache->fileBytes() / ( 1024 * 1024 ) << " MB" << std::endl;
+  PackedTileCache::close ( file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run the benchmark.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _test ( int argc, char **argv )
+{
+  const unsigned int numTiles ( ( argc > 1 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[1] ) ) ) : 10000 );
+  const unsigned int size ( ( argc > 2 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[2] ) ) ) : 256 );
+  const std::string dir ( ( argc > 3 ) ? std::string ( argv[3] ) : Usul::Strings::format ( Usul::File::Temp::directory ( false ), "/TileCacheBenchmark" ) );
+
+  boost::filesystem::remove_all ( dir );
+  Usul::File::make ( dir + "/" );
+
+  std::cout << "Tiles: " << numTiles << ", size: " << size << ", directory: " << dir << '\n';
+  std::cout << std::setw ( 12 ) << "Cache"
+            << std::setw ( 8 ) << "Pass"
+            << std::setw ( 15 ) << "Tiles/sec"
+            << std::setw ( 15 ) << "usec/tile"
+            << std::setw ( 10 ) << "Found"
+            << std::endl;
+
+  _runFiles ( dir + "/files", numTiles, size );
+  _runPacked ( "pack raw", dir + "/raw.pack", PackedTileCache::RAW, numTiles, size );
+  _runPacked ( "pack fast", dir + "/fast.pack", PackedTileCache::FAST, numTiles, size );
+
+  boost::filesystem::remove_all ( dir );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Main function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+int main ( int argc, char **argv )
+{
+  Usul::Functions::safeCallV1V2 ( _test, argc, argv, "2417693044" );
+  return 0;
+}
@@ -0,0 +1,214 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Adam Kubach
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Images/Algorithms/Morphology.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+
+namespace
+{
+  const unsigned int ROWS ( 37 );
+  const unsigned int COLUMNS ( 53 );
+
+  // Kernel sizes, including even ones and ones bigger than the image.
+  const unsigned int SIZES[][2] = { { 1, 1 }, { 3, 3 }, { 1, 7 }, { 6, 1 }, { 5, 4 }, { 9, 17 }, { 41, 60 } };
+  const unsigned int NUM_SIZES ( sizeof ( SIZES ) / sizeof ( SIZES[0] ) );
+
+  template < class T > std::vector<T> random ( unsigned int seed, T high )
+  {
+    std::srand ( seed );
+    std::vector<T> v ( ROWS * COLUMNS );
+    for ( unsigned int i = 0; i < v.size(); ++i )
+      v[i] = static_cast < T > ( ( static_cast < double > ( std::rand() ) / RAND_MAX ) * high );
+    return v;
+  }
+
+  // The smallest or largest in the window, looking at every value.
+  template < class T > std::vector<T> bruteForce ( const std::vector<T> &in, unsigned int kr, unsigned int kc, bool minimum )
+  {
+    std::vector<T> out ( in.size() );
+    for ( int y = 0; y < static_cast < int > ( ROWS ); ++y )
+    {
+      for ( int x = 0; x < static_cast < int > ( COLUMNS ); ++x )
+      {
+        T answer ( in[y * COLUMNS + x] );
+        for ( int i = 0; i < static_cast < int > ( kr ); ++i )
+        {
+          for ( int j = 0; j < static_cast < int > ( kc ); ++j )
+          {
+            const int r ( y + i - static_cast < int > ( kr / 2 ) ), c ( x + j - static_cast < int > ( kc / 2 ) );
+            if ( r < 0 || c < 0 || r >= static_cast < int > ( ROWS ) || c >= static_cast < int > ( COLUMNS ) )
+              continue;
+            const T v ( in[r * COLUMNS + c] );
+            answer = ( ( true == minimum ) ? std::min ( answer, v ) : std::max ( answer, v ) );
+          }
+        }
+        out[y * COLUMNS + x] = answer;
+      }
+    }
+    return out;
+  }
+
+  // Sums of the mask times the values, with the edges repeated.
+  template < class T > std::vector<double> bruteForce ( const std::vector<T> &in, const Images::Algorithms::Mask &mask )
+  {
+    std::vector<double> out ( in.size() );
+    const int kr ( mask.rows() ), kc ( mask.columns() );
+    for ( int y = 0; y < static_cast < int > ( ROWS ); ++y )
+    {
+      for ( int x = 0; x < static_cast < int > ( COLUMNS ); ++x )
+      {
+        double sum ( 0 );
+        for ( int i = 0; i < kr; ++i )
+        {
+          for ( int j = 0; j < kc; ++j )
+          {
+            const int r ( std::min ( std::max ( y + i - kr / 2, 0 ), static_cast < int > ( ROWS ) - 1 ) );
+            const int c ( std::min ( std::max ( x + j - kc / 2, 0 ), static_cast < int > ( COLUMNS ) - 1 ) );
+            sum += mask ( i, j ) * in[r * COLUMNS + c];
+          }
+        }
+        out[y * COLUMNS + x] = sum;
+      }
+    }
+    return out;
+  }
+
+  template < class T > void testMinMax ( T high )
+  {
+    const std::vector<T> original ( random<T> ( 17, high ) );
+
+    for ( unsigned int s = 0; s < NUM_SIZES; ++s )
+    {
+      const unsigned int kr ( SIZES[s][0] ), kc ( SIZES[s][1] );
+
+      std::vector<T> eroded ( original );
+      ASSERT_TRUE ( Images::Algorithms::erode ( eroded, ROWS, COLUMNS, kr, kc ) );
+      ASSERT_TRUE ( bruteForce ( original, kr, kc, true ) == eroded );
+
+      std::vector<T> dilated ( original );
+      ASSERT_TRUE ( Images::Algorithms::dilate ( dilated, ROWS, COLUMNS, kr, kc ) );
+      ASSERT_TRUE ( bruteForce ( original, kr, kc, false ) == dilated );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Erode and dilate give what looking at the whole window gives.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Morphology,MinMaxUint8)
+{
+  testMinMax < unsigned char > ( 255 );
+}
+
+TEST(Morphology,MinMaxUint16)
+{
+  testMinMax < unsigned short > ( 65535 );
+}
+
+TEST(Morphology,MinMaxFloat)
+{
+  testMinMax < float > ( 1000.0f );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Opening removes a speck smaller than the rectangle and keeps a bigger
+//  block.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Morphology,Open)
+{
+  std::vector<unsigned char> v ( ROWS * COLUMNS, 0 );
+  v[10 * COLUMNS + 10] = 255;
+  for ( unsigned int y = 20; y < 30; ++y )
+    for ( unsigned int x = 20; x < 30; ++x )
+      v[y * COLUMNS + x] = 255;
+
+  const std::vector<unsigned char> before ( v );
+  ASSERT_TRUE ( Images::Algorithms::open ( v, ROWS, COLUMNS, 3, 3 ) );
+
+  ASSERT_EQ ( 0, v[10 * COLUMNS + 10] );
+  for ( unsigned int i = 20 * COLUMNS; i < v.size(); ++i )
+    ASSERT_EQ ( before[i], v[i] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Convolution with separable and other masks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Morphology,Convolve)
+{
+  const std::vector<float> original ( random<float> ( 5, 100.0f ) );
+
+  // Separable.
+  Images::Algorithms::Mask gaussian ( 3, 5 );
+  const float column[] = { 1, 2, 1 };
+  const float row[] = { 1, 4, 6, 4, 1 };
+  for ( unsigned int i = 0; i < 3; ++i )
+    for ( unsigned int j = 0; j < 5; ++j )
+      gaussian ( i, j ) = column[i] * row[j] / 64.0f;
+
+  // Not separable.
+  Images::Algorithms::Mask laplacian ( 3, 3, 0.0f );
+  laplacian ( 0, 1 ) = laplacian ( 1, 0 ) = laplacian ( 1, 2 ) = laplacian ( 2, 1 ) = 1.0f;
+  laplacian ( 1, 1 ) = -4.0f;
+
+  Images::Algorithms::Mask::Weights c, r;
+  ASSERT_TRUE ( gaussian.separable ( c, r ) );
+  ASSERT_FALSE ( laplacian.separable ( c, r ) );
+
+  const Images::Algorithms::Mask *masks[] = { &gaussian, &laplacian };
+  for ( unsigned int m = 0; m < 2; ++m )
+  {
+    std::vector<float> v ( original );
+    ASSERT_TRUE ( Images::Algorithms::convolve ( v, ROWS, COLUMNS, *masks[m] ) );
+    const std::vector<double> expected ( bruteForce ( original, *masks[m] ) );
+    for ( unsigned int i = 0; i < v.size(); ++i )
+      ASSERT_NEAR ( expected[i], v[i], 1e-3 );
+  }
+
+  // Integers are rounded and clamped.
+  std::vector<unsigned char> bytes ( random<unsigned char> ( 9, 255 ) );
+  const std::vector<unsigned char> copy ( bytes );
+  ASSERT_TRUE ( Images::Algorithms::convolve ( bytes, ROWS, COLUMNS, laplacian ) );
+  const std::vector<double> expected ( bruteForce ( copy, laplacian ) );
+  for ( unsigned int i = 0; i < bytes.size(); ++i )
+    ASSERT_EQ ( static_cast < int > ( std::min ( 255.0, std::max ( 0.0, std::floor ( expected[i] + 0.5 ) ) ) ), bytes[i] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Smoothing a constant changes nothing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Morphology,Smooth)
+{
+  std::vector<unsigned short> v ( ROWS * COLUMNS, 1234 );
+  ASSERT_TRUE ( Images::Algorithms::smooth ( v, ROWS, COLUMNS, 5, 7 ) );
+  for ( unsigned int i = 0; i < v.size(); ++i )
+    ASSERT_EQ ( 1234, v[i] );
+}
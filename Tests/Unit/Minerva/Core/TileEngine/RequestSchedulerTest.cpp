@@ -0,0 +1,244 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/TileEngine/RequestScheduler.h"
+
+#include "Usul/Jobs/Manager.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+  typedef Minerva::Core::TileEngine::RequestScheduler Scheduler;
+  typedef Minerva::Core::TileEngine::Tile Tile;
+  typedef Usul::Jobs::Job::RefPtr JobPtr;
+
+  void pause ( unsigned int milliseconds )
+  {
+    boost::this_thread::sleep ( boost::posix_time::milliseconds ( milliseconds ) );
+  }
+
+  // Remembers which jobs ran, and can keep the only thread busy.
+  struct Events
+  {
+    Events() : _mutex(), _ran(), _holding ( false ), _release ( false ){}
+
+    void add ( unsigned int i )
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      _ran.push_back ( i );
+    }
+
+    void hold()
+    {
+      {
+        boost::mutex::scoped_lock lock ( _mutex );
+        _holding = true;
+      }
+      while ( false == this->released() )
+        pause ( 1 );
+    }
+
+    bool holding()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _holding;
+    }
+
+    bool released()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _release;
+    }
+
+    void release()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      _release = true;
+    }
+
+    std::vector<unsigned int> ran()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _ran;
+    }
+
+    boost::mutex _mutex;
+    std::vector<unsigned int> _ran;
+    bool _holding;
+    bool _release;
+  };
+
+  JobPtr add ( Events &events, unsigned int i )
+  {
+    return JobPtr ( Usul::Jobs::create ( boost::bind ( &Events::add, &events, i ), 0x0, false ) );
+  }
+
+  // The scheduler only compares the tiles, so any address will do.
+  const Tile *tile ( unsigned int i )
+  {
+    static char tiles[8];
+    return reinterpret_cast < const Tile * > ( &tiles[i] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Only the requests seen in the frame go to the manager, best first, no
+//  more than the maximum, and not before the update.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RequestScheduler,BestFirst)
+{
+  Usul::Jobs::Manager manager ( "RequestSchedulerTest", 1 );
+  Events events;
+
+  JobPtr holder ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events ), 0x0, false ) );
+  manager.addJob ( holder );
+  while ( false == events.holding() )
+    pause ( 1 );
+
+  Scheduler::RefPtr scheduler ( new Scheduler ( 2 ) );
+  JobPtr a ( add ( events, 1 ) );
+  JobPtr b ( add ( events, 2 ) );
+  JobPtr c ( add ( events, 3 ) );
+  JobPtr d ( add ( events, 4 ) );
+  scheduler->add ( a, tile ( 1 ), Scheduler::TEXTURE );
+  scheduler->add ( b, tile ( 2 ), Scheduler::TEXTURE );
+  scheduler->add ( c, tile ( 3 ), Scheduler::TEXTURE );
+  scheduler->add ( d, tile ( 4 ), Scheduler::TEXTURE );
+
+  // Tile 4 is not seen.
+  scheduler->visible ( tile ( 1 ), 1 );
+  scheduler->visible ( tile ( 2 ), 3 );
+  scheduler->visible ( tile ( 3 ), 2 );
+  ASSERT_EQ ( 0u, scheduler->numInFlight() );
+  ASSERT_EQ ( 4u, scheduler->numPending() );
+
+  // The update after the cull hands out the two best.
+  scheduler->update ( 1, &manager );
+  ASSERT_EQ ( 2u, scheduler->numInFlight() );
+  ASSERT_EQ ( 2u, scheduler->numPending() );
+
+  events.release();
+  manager.wait();
+
+  std::vector<unsigned int> ran ( events.ran() );
+  std::sort ( ran.begin(), ran.end() );
+  ASSERT_EQ ( 2u, ran.size() );
+  ASSERT_EQ ( 2u, ran[0] );
+  ASSERT_EQ ( 3u, ran[1] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Jobs for tiles that are no longer seen come out of the queue, are done,
+//  and make room for the ones that are.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RequestScheduler,StaleJobsLeaveQueue)
+{
+  Usul::Jobs::Manager manager ( "RequestSchedulerTest", 1 );
+  Events events;
+
+  JobPtr holder ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events ), 0x0, false ) );
+  manager.addJob ( holder );
+  while ( false == events.holding() )
+    pause ( 1 );
+
+  Scheduler::RefPtr scheduler ( new Scheduler ( 2 ) );
+  JobPtr a ( add ( events, 1 ) );
+  JobPtr b ( add ( events, 2 ) );
+  JobPtr c ( add ( events, 3 ) );
+  scheduler->add ( a, tile ( 1 ), Scheduler::TEXTURE );
+  scheduler->add ( b, tile ( 2 ), Scheduler::TEXTURE );
+  scheduler->add ( c, tile ( 3 ), Scheduler::TEXTURE );
+
+  scheduler->visible ( tile ( 1 ), 3 );
+  scheduler->visible ( tile ( 2 ), 2 );
+  scheduler->visible ( tile ( 3 ), 1 );
+  scheduler->update ( 1, &manager );
+  ASSERT_EQ ( 2u, scheduler->numInFlight() );
+  ASSERT_EQ ( 1u, scheduler->numPending() );
+
+  // Only tile 3 is seen in the next frame. The queued jobs for tiles 1 and 2
+  // are taken out, which makes room for 3.
+  scheduler->visible ( tile ( 3 ), 1 );
+  scheduler->update ( 2, &manager );
+  ASSERT_TRUE ( a->canceled() );
+  ASSERT_TRUE ( b->canceled() );
+  ASSERT_TRUE ( a->isDone() );
+  ASSERT_TRUE ( b->isDone() );
+  ASSERT_EQ ( 1u, scheduler->numInFlight() );
+  ASSERT_EQ ( 0u, scheduler->numPending() );
+
+  events.release();
+  manager.wait();
+
+  const std::vector<unsigned int> ran ( events.ran() );
+  ASSERT_EQ ( 1u, ran.size() );
+  ASSERT_EQ ( 3u, ran[0] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  When two views cull in the same frame, the tiles seen by either count.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RequestScheduler,TwoViews)
+{
+  Usul::Jobs::Manager manager ( "RequestSchedulerTest", 1 );
+  Events events;
+
+  JobPtr holder ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events ), 0x0, false ) );
+  manager.addJob ( holder );
+  while ( false == events.holding() )
+    pause ( 1 );
+
+  Scheduler::RefPtr scheduler ( new Scheduler ( 2 ) );
+  JobPtr a ( add ( events, 1 ) );
+  JobPtr b ( add ( events, 2 ) );
+  scheduler->add ( a, tile ( 1 ), Scheduler::TEXTURE );
+  scheduler->add ( b, tile ( 2 ), Scheduler::TEXTURE );
+
+  scheduler->visible ( tile ( 1 ), 1 );
+  scheduler->update ( 1, &manager );
+  scheduler->visible ( tile ( 2 ), 1 );
+  scheduler->update ( 1, &manager );
+  ASSERT_EQ ( 2u, scheduler->numInFlight() );
+
+  // Only tile 1 is seen in the next frame.
+  scheduler->visible ( tile ( 1 ), 1 );
+  scheduler->update ( 2, &manager );
+  ASSERT_FALSE ( a->canceled() );
+  ASSERT_TRUE ( b->canceled() );
+  ASSERT_EQ ( 1u, scheduler->numInFlight() );
+
+  events.release();
+  manager.wait();
+
+  const std::vector<unsigned int> ran ( events.ran() );
+  ASSERT_EQ ( 1u, ran.size() );
+  ASSERT_EQ ( 1u, ran[0] );
+}
@@ -0,0 +1,226 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Core/Utilities/PackedTileCache.h"
+
+#include "Usul/File/Temp.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/filesystem/operations.hpp"
+
+#include <cstring>
+
+typedef Minerva::Core::Utilities::PackedTileCache PackedTileCache;
+typedef PackedTileCache::Extents Extents;
+typedef PackedTileCache::ImagePtr ImagePtr;
+
+
+namespace
+{
+  // Half blank, half noise, like a tile at the edge of the data.
+  ImagePtr makeImage ( unsigned int size, unsigned int seed )
+  {
+    ImagePtr image ( new osg::Image );
+    image->allocateImage ( size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE );
+    const unsigned int bytes ( image->getImageSizeInBytes() );
+    std::memset ( image->data(), 0, bytes );
+    for ( unsigned int i = bytes / 2; i < bytes; ++i )
+    {
+      seed = seed * 1103515245u + 12345u;
+      image->data()[i] = static_cast < unsigned char > ( seed >> 16 );
+    }
+    return image;
+  }
+
+  Extents tileExtents ( unsigned int level, unsigned int row, unsigned int column )
+  {
+    const double size ( 180.0 / ( 1u << level ) );
+    return Extents ( -180.0 + column * size, -90.0 + row * size, -180.0 + ( column + 1 ) * size, -90.0 + ( row + 1 ) * size );
+  }
+
+  bool same ( const osg::Image &a, const osg::Image &b )
+  {
+    return ( ( a.getImageSizeInBytes() == b.getImageSizeInBytes() ) &&
+             ( 0 == std::memcmp ( a.data(), b.data(), a.getImageSizeInBytes() ) ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Tiles come back the same, raw or compressed, and after opening again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(PackedTileCache,RoundTrip)
+{
+  const PackedTileCache::Compression compressions[] = { PackedTileCache::RAW, PackedTileCache::FAST };
+  for ( unsigned int c = 0; c < 2; ++c )
+  {
+    const std::string file ( Usul::File::Temp::file() );
+    std::vector < ImagePtr > images;
+    {
+      PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, compressions[c] ) );
+      for ( unsigned int i = 0; i < 16; ++i )
+      {
+        images.push_back ( makeImage ( 64, i ) );
+        cache->insert ( tileExtents ( 4, i / 4, i % 4 ), 64, 64, 4, *images.back() );
+      }
+
+      for ( unsigned int i = 0; i < 16; ++i )
+      {
+        ImagePtr image ( cache->find ( tileExtents ( 4, i / 4, i % 4 ), 64, 64, 4 ) );
+        ASSERT_TRUE ( image.valid() );
+        ASSERT_TRUE ( same ( *images[i], *image ) );
+      }
+
+      // Not there.
+      ASSERT_FALSE ( cache->find ( tileExtents ( 5, 0, 0 ), 64, 64, 5 ).valid() );
+      ASSERT_FALSE ( cache->find ( tileExtents ( 4, 0, 0 ), 32, 32, 4 ).valid() );
+
+      PackedTileCache::close ( file );
+    }
+
+    // The index is read back from the file.
+    PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, compressions[c] ) );
+    ASSERT_EQ ( 16u, cache->numTiles() );
+    for ( unsigned int i = 0; i < 16; ++i )
+    {
+      ImagePtr image ( cache->find ( tileExtents ( 4, i / 4, i % 4 ), 64, 64, 4 ) );
+      ASSERT_TRUE ( image.valid() );
+      ASSERT_TRUE ( same ( *images[i], *image ) );
+    }
+
+    PackedTileCache::close ( file );
+    cache = 0x0;
+    Usul::File::Temp::remove ( file );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The least recently used tiles go first, and compacting keeps the rest.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(PackedTileCache,LeastRecentlyUsed)
+{
+  const std::string file ( Usul::File::Temp::file() );
+  PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, PackedTileCache::RAW ) );
+
+  ImagePtr image ( makeImage ( 32, 1 ) );
+  for ( unsigned int i = 0; i < 8; ++i )
+    cache->insert ( tileExtents ( 3, 0, i ), 32, 32, 3, *image );
+  const PackedTileCache::SizeType tileBytes ( cache->liveBytes() / 8 );
+
+  // Use the first one so that the second is the oldest.
+  ASSERT_TRUE ( cache->find ( tileExtents ( 3, 0, 0 ), 32, 32, 3 ).valid() );
+
+  cache->maxBytes ( tileBytes * 6 );
+  ASSERT_EQ ( 6u, cache->numTiles() );
+  ASSERT_TRUE  ( cache->find ( tileExtents ( 3, 0, 0 ), 32, 32, 3 ).valid() );
+  ASSERT_FALSE ( cache->find ( tileExtents ( 3, 0, 1 ), 32, 32, 3 ).valid() );
+  ASSERT_FALSE ( cache->find ( tileExtents ( 3, 0, 2 ), 32, 32, 3 ).valid() );
+  ASSERT_TRUE  ( cache->find ( tileExtents ( 3, 0, 3 ), 32, 32, 3 ).valid() );
+
+  cache->compact();
+  ASSERT_EQ ( cache->fileBytes(), cache->liveBytes() + 16 );
+  ASSERT_EQ ( 6u, cache->numTiles() );
+  for ( unsigned int i = 3; i < 8; ++i )
+  {
+    ImagePtr found ( cache->find ( tileExtents ( 3, 0, i ), 32, 32, 3 ) );
+    ASSERT_TRUE ( found.valid() );
+    ASSERT_TRUE ( same ( *image, *found ) );
+  }
+
+  PackedTileCache::close ( file );
+  cache = 0x0;
+  Usul::File::Temp::remove ( file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Dropped tiles stay dropped when the file is opened again, unless they
+//  were added again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(PackedTileCache,DroppedStayDropped)
+{
+  const std::string file ( Usul::File::Temp::file() );
+  ImagePtr image ( makeImage ( 32, 1 ) );
+  {
+    PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, PackedTileCache::RAW ) );
+    for ( unsigned int i = 0; i < 8; ++i )
+      cache->insert ( tileExtents ( 3, 0, i ), 32, 32, 3, *image );
+    const PackedTileCache::SizeType tileBytes ( cache->liveBytes() / 8 );
+
+    // Drops the first four.
+    cache->maxBytes ( tileBytes * 4 );
+    ASSERT_EQ ( 4u, cache->numTiles() );
+
+    // Adding the first one again drops the fifth.
+    cache->insert ( tileExtents ( 3, 0, 0 ), 32, 32, 3, *image );
+    ASSERT_EQ ( 4u, cache->numTiles() );
+
+    PackedTileCache::close ( file );
+  }
+
+  PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, PackedTileCache::RAW ) );
+  ASSERT_EQ ( 4u, cache->numTiles() );
+  ASSERT_TRUE ( cache->find ( tileExtents ( 3, 0, 0 ), 32, 32, 3 ).valid() );
+  for ( unsigned int i = 1; i < 5; ++i )
+  {
+    ASSERT_FALSE ( cache->find ( tileExtents ( 3, 0, i ), 32, 32, 3 ).valid() );
+  }
+  for ( unsigned int i = 5; i < 8; ++i )
+  {
+    ASSERT_TRUE ( cache->find ( tileExtents ( 3, 0, i ), 32, 32, 3 ).valid() );
+  }
+
+  PackedTileCache::close ( file );
+  cache = 0x0;
+  Usul::File::Temp::remove ( file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A tile that was not all written is dropped when the file is opened.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(PackedTileCache,Truncated)
+{
+  const std::string file ( Usul::File::Temp::file() );
+  {
+    PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, PackedTileCache::FAST ) );
+    cache->insert ( tileExtents ( 2, 0, 0 ), 16, 16, 2, *makeImage ( 16, 1 ) );
+    cache->insert ( tileExtents ( 2, 0, 1 ), 16, 16, 2, *makeImage ( 16, 2 ) );
+    PackedTileCache::close ( file );
+  }
+
+  boost::filesystem::resize_file ( file, boost::filesystem::file_size ( file ) - 10 );
+
+  PackedTileCache::RefPtr cache ( PackedTileCache::open ( file, 1024 * 1024 * 1024, PackedTileCache::FAST ) );
+  ASSERT_EQ ( 1u, cache->numTiles() );
+  ASSERT_TRUE ( cache->find ( tileExtents ( 2, 0, 0 ), 16, 16, 2 ).valid() );
+
+  // Appending after the dropped tile works.
+  cache->insert ( tileExtents ( 2, 0, 1 ), 16, 16, 2, *makeImage ( 16, 2 ) );
+  ASSERT_TRUE ( cache->find ( tileExtents ( 2, 0, 1 ), 16, 16, 2 ).valid() );
+
+  PackedTileCache::close ( file );
+  cache = 0x0;
+  Usul::File::Temp::remove ( file );
+}
@@ -0,0 +1,130 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Layers/Kml/KmlLayer.h"
+
+#include "Usul/File/Remove.h"
+#include "Usul/File/Temp.h"
+#include "Usul/Interfaces/ITreeNode.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+
+namespace
+{
+  typedef Minerva::Layers::Kml::KmlLayer KmlLayer;
+  typedef Minerva::Core::Data::Container Container;
+  typedef Usul::Interfaces::ITreeNode ITreeNode;
+
+  // The file has to end in .kml for the layer to read it.
+  struct KmlFile
+  {
+    KmlFile ( const std::string &contents ) : name ( Usul::File::Temp::file() + ".kml" )
+    {
+      std::ofstream out ( name.c_str() );
+      out << contents;
+    }
+
+    ~KmlFile()
+    {
+      Usul::File::remove ( name, false );
+    }
+
+    const std::string name;
+  };
+
+  Container *child ( Container &parent, unsigned int which )
+  {
+    ITreeNode::RefPtr node ( parent.getChildNode ( which ) );
+    return dynamic_cast < Container * > ( node.get() );
+  }
+
+  std::string placemark ( const std::string &name )
+  {
+    return "<Placemark><name>" + name + "</name><Point><coordinates>-111.9,33.4,0</coordinates></Point></Placemark>";
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The top-level document is read into the layer, and nested folders get
+//  their own layers, in order, with their names and visibility.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(KmlStreamTest,Folders)
+{
+  const KmlFile file ( "<?xml version='1.0' encoding='UTF-8'?>\n"
+                       "<kml xmlns='http://www.opengis.net/kml/2.2'>\n"
+                       "<Document>\n"
+                       "  <name>top</name>\n" +
+                       placemark ( "a" ) +
+                       "  <Folder>\n"
+                       "    <name>first</name>\n"
+                       "    <visibility>0</visibility>\n" +
+                       placemark ( "b" ) + placemark ( "c" ) +
+                       "    <Folder>\n"
+                       "      <name>inner</name>\n" +
+                       placemark ( "d" ) +
+                       "    </Folder>\n"
+                       "  </Folder>\n"
+                       "  <Folder>\n"
+                       "    <name>second</name>\n"
+                       "  </Folder>\n"
+                       "</Document>\n"
+                       "</kml>\n" );
+
+  KmlLayer::RefPtr layer ( new KmlLayer );
+  layer->read ( file.name );
+
+  // The placemark and the two folders.
+  EXPECT_EQ ( "top", layer->name() );
+  ASSERT_EQ ( 3u, layer->size() );
+
+  Container *first ( child ( *layer, 1 ) );
+  ASSERT_TRUE ( 0x0 != first );
+  EXPECT_EQ ( "first", first->name() );
+  EXPECT_FALSE ( first->showLayer() );
+  ASSERT_EQ ( 3u, first->size() );
+
+  Container *inner ( child ( *first, 2 ) );
+  ASSERT_TRUE ( 0x0 != inner );
+  EXPECT_EQ ( "inner", inner->name() );
+  EXPECT_TRUE ( inner->showLayer() );
+  EXPECT_EQ ( 1u, inner->size() );
+
+  Container *second ( child ( *layer, 2 ) );
+  ASSERT_TRUE ( 0x0 != second );
+  EXPECT_EQ ( "second", second->name() );
+  EXPECT_EQ ( 0u, second->size() );
+
+  // Placemarks are not layers.
+  EXPECT_TRUE ( 0x0 == child ( *layer, 0 ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Placemarks at the top level, without a document, are read too.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(KmlStreamTest,NoDocument)
+{
+  const KmlFile file ( "<kml>" + placemark ( "a" ) + placemark ( "b" ) + "</kml>" );
+
+  KmlLayer::RefPtr layer ( new KmlLayer );
+  layer->read ( file.name );
+
+  EXPECT_EQ ( 2u, layer->size() );
+}
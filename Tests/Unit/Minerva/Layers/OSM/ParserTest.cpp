@@ -0,0 +1,172 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Adam Kubach
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Minerva/Layers/OSM/Parser.h"
+#include "Minerva/Layers/OSM/Node.h"
+#include "Minerva/Layers/OSM/Way.h"
+
+#include "XmlTree/Document.h"
+#include "XmlTree/XercesLife.h"
+
+#include "Usul/File/Temp.h"
+
+#include "gtest/gtest.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Typedefs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+typedef Minerva::Layers::OSM::Parser Parser;
+typedef Minerva::Layers::OSM::Extents Extents;
+typedef Minerva::Layers::OSM::Nodes Nodes;
+typedef Minerva::Layers::OSM::Ways Ways;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A small file with bounds, three nodes and two ways. The second way
+//  refers to a node that is not in the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  const char *OSM_FILE =
+    "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<osm version='0.6'>\n"
+    "  <bounds minlat='33.0' minlon='-112.0' maxlat='34.0' maxlon='-111.0'/>\n"
+    "  <node id='1' lat='33.25' lon='-111.75' timestamp='2009-01-01T00:00:00Z'>\n"
+    "    <tag k='name' v='first'/>\n"
+    "    <tag k='ele' v='350'/>\n"
+    "  </node>\n"
+    "  <node id='2' lat='33.5' lon='-111.5' timestamp='2009-01-01T00:00:00Z'/>\n"
+    "  <node id='3' lat='33.75' lon='-111.25' timestamp='2009-01-01T00:00:00Z'/>\n"
+    "  <way id='10' timestamp='2009-01-01T00:00:00Z'>\n"
+    "    <nd ref='1'/>\n"
+    "    <nd ref='2'/>\n"
+    "    <nd ref='3'/>\n"
+    "    <tag k='highway' v='residential'/>\n"
+    "  </way>\n"
+    "  <way id='11' timestamp='2009-01-01T00:00:00Z'>\n"
+    "    <nd ref='3'/>\n"
+    "    <nd ref='99'/>\n"
+    "  </way>\n"
+    "</osm>\n";
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The streaming parser builds the nodes, ways and bounds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(OSMParserTest,Stream)
+{
+  Usul::File::Temp file;
+  file.stream() << OSM_FILE;
+  file.close();
+
+  Nodes nodes;
+  Ways ways;
+  Extents bounds ( 0.0, 0.0, 0.0, 0.0 );
+  ASSERT_TRUE ( Parser::parseNodesAndWays ( file.name(), nodes, ways, bounds ) );
+
+  EXPECT_DOUBLE_EQ ( -112.0, bounds.minLon() );
+  EXPECT_DOUBLE_EQ (   33.0, bounds.minLat() );
+  EXPECT_DOUBLE_EQ ( -111.0, bounds.maxLon() );
+  EXPECT_DOUBLE_EQ (   34.0, bounds.maxLat() );
+
+  ASSERT_EQ ( 3u, nodes.size() );
+  EXPECT_EQ ( 1u, nodes[0]->id() );
+  EXPECT_DOUBLE_EQ ( -111.75, nodes[0]->location()[0] );
+  EXPECT_DOUBLE_EQ (   33.25, nodes[0]->location()[1] );
+  EXPECT_EQ ( 2u, nodes[0]->tags().size() );
+  EXPECT_EQ ( "first", nodes[0]->tag<std::string> ( "name" ) );
+  EXPECT_EQ ( 350, nodes[0]->tag<int> ( "ele" ) );
+  EXPECT_TRUE ( nodes[1]->tags().empty() );
+  EXPECT_EQ ( 3u, nodes[2]->id() );
+
+  // The way refers to the same nodes, and the missing node is skipped.
+  ASSERT_EQ ( 2u, ways.size() );
+  EXPECT_EQ ( 10u, ways[0]->id() );
+  ASSERT_EQ ( 3u, ways[0]->numNodes() );
+  EXPECT_TRUE ( nodes[0].get() == ways[0]->nodes()[0].get() );
+  EXPECT_TRUE ( nodes[2].get() == ways[0]->nodes()[2].get() );
+  EXPECT_EQ ( "residential", ways[0]->tag<std::string> ( "highway" ) );
+  EXPECT_EQ ( 1u, ways[1]->numNodes() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The streaming parser gives the same answer as parsing the whole document.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(OSMParserTest,StreamMatchesDocument)
+{
+  Usul::File::Temp file;
+  file.stream() << OSM_FILE;
+  file.close();
+
+  Nodes streamNodes;
+  Ways streamWays;
+  Extents bounds ( 0.0, 0.0, 0.0, 0.0 );
+  Parser::parseNodesAndWays ( file.name(), streamNodes, streamWays, bounds );
+
+  Nodes treeNodes;
+  Ways treeWays;
+  {
+    XmlTree::XercesLife life;
+    XmlTree::Document::RefPtr document ( new XmlTree::Document );
+    document->load ( file.name() );
+    Parser::parseNodesAndWays ( *document, treeNodes, treeWays );
+  }
+
+  ASSERT_EQ ( treeNodes.size(), streamNodes.size() );
+  for ( unsigned int i = 0; i < treeNodes.size(); ++i )
+  {
+    EXPECT_EQ ( treeNodes[i]->id(), streamNodes[i]->id() );
+    EXPECT_TRUE ( treeNodes[i]->location() == streamNodes[i]->location() );
+    EXPECT_TRUE ( treeNodes[i]->tags() == streamNodes[i]->tags() );
+  }
+
+  ASSERT_EQ ( treeWays.size(), streamWays.size() );
+  for ( unsigned int i = 0; i < treeWays.size(); ++i )
+  {
+    EXPECT_EQ ( treeWays[i]->id(), streamWays[i]->id() );
+    EXPECT_EQ ( treeWays[i]->numNodes(), streamWays[i]->numNodes() );
+    EXPECT_TRUE ( treeWays[i]->tags() == streamWays[i]->tags() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A file without bounds says so.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(OSMParserTest,NoBounds)
+{
+  Usul::File::Temp file;
+  file.stream() << "<osm version='0.6'><node id='1' lat='1' lon='2'/></osm>";
+  file.close();
+
+  Nodes nodes;
+  Ways ways;
+  Extents bounds ( 0.0, 0.0, 0.0, 0.0 );
+  ASSERT_FALSE ( Parser::parseNodesAndWays ( file.name(), nodes, ways, bounds ) );
+  ASSERT_EQ ( 1u, nodes.size() );
+  ASSERT_TRUE ( ways.empty() );
+}
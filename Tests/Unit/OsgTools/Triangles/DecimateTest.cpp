@@ -0,0 +1,205 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Triangles/Decimate.h"
+
+#include "Usul/Base/Referenced.h"
+#include "Usul/Interfaces/ICanceledStateGet.h"
+
+#include "gtest/gtest.h"
+
+#include "osg/ref_ptr"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+  typedef OsgTools::Triangles::Decimate Decimate;
+  typedef Decimate::Index Index;
+  typedef Decimate::Indices Indices;
+  typedef osg::ref_ptr < osg::Vec3Array > Vec3ArrayPtr;
+
+  // A closed torus with two triangles per grid cell.
+  void torus ( unsigned int numU, unsigned int numV, osg::Vec3Array &vertices, Indices &indices )
+  {
+    const double pi ( 3.14159265358979323846 );
+    for ( unsigned int j = 0; j < numV; ++j )
+    {
+      for ( unsigned int i = 0; i < numU; ++i )
+      {
+        const double u ( 2.0 * pi * i / numU ), v ( 2.0 * pi * j / numV );
+        const double r ( 3.0 + std::cos ( v ) );
+        vertices.push_back ( osg::Vec3f ( r * std::cos ( u ), r * std::sin ( u ), std::sin ( v ) ) );
+      }
+    }
+
+    for ( unsigned int j = 0; j < numV; ++j )
+    {
+      for ( unsigned int i = 0; i < numU; ++i )
+      {
+        const Index a ( j * numU + i );
+        const Index b ( j * numU + ( i + 1 ) % numU );
+        const Index c ( ( ( j + 1 ) % numV ) * numU + ( i + 1 ) % numU );
+        const Index d ( ( ( j + 1 ) % numV ) * numU + i );
+        indices.push_back ( a ); indices.push_back ( b ); indices.push_back ( c );
+        indices.push_back ( a ); indices.push_back ( c ); indices.push_back ( d );
+      }
+    }
+  }
+
+  // Every edge is used once in each direction, and every vertex is used.
+  bool closed ( const osg::Vec3Array &vertices, const Indices &indices )
+  {
+    typedef std::map < std::pair < Index, Index >, unsigned int > Edges;
+    Edges edges;
+    std::vector < bool > used ( vertices.size(), false );
+
+    for ( unsigned int t = 0; t < indices.size(); t += 3 )
+    {
+      for ( unsigned int c = 0; c < 3; ++c )
+      {
+        const Index v0 ( indices[t + c] ), v1 ( indices[t + ( c + 1 ) % 3] );
+        if ( v0 >= vertices.size() || v0 == v1 )
+          return false;
+        used[v0] = true;
+        ++edges[std::make_pair ( v0, v1 )];
+      }
+    }
+
+    for ( Edges::const_iterator i = edges.begin(); i != edges.end(); ++i )
+    {
+      Edges::const_iterator j ( edges.find ( std::make_pair ( i->first.second, i->first.first ) ) );
+      if ( 1 != i->second || edges.end() == j || 1 != j->second )
+        return false;
+    }
+
+    return ( used.end() == std::find ( used.begin(), used.end(), false ) );
+  }
+
+  // Says it was canceled.
+  class Canceler : public Usul::Base::Referenced,
+                   public Usul::Interfaces::ICanceledStateGet
+  {
+  public:
+
+    USUL_DECLARE_REF_POINTERS ( Canceler );
+    USUL_DECLARE_IUNKNOWN_MEMBERS;
+
+    Canceler() : asked ( 0 )
+    {
+    }
+
+    virtual bool canceled() const
+    {
+      ++asked;
+      return true;
+    }
+
+    mutable unsigned int asked;
+
+  protected:
+
+    virtual ~Canceler()
+    {
+    }
+  };
+
+  Usul::Interfaces::IUnknown *Canceler::queryInterface ( unsigned long iid )
+  {
+    switch ( iid )
+    {
+    case Usul::Interfaces::IUnknown::IID:
+    case Usul::Interfaces::ICanceledStateGet::IID:
+      return static_cast < Usul::Interfaces::ICanceledStateGet * > ( this );
+    default:
+      return 0x0;
+    }
+  }
+
+  USUL_IMPLEMENT_IUNKNOWN_MEMBERS ( Canceler, Usul::Base::Referenced );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A closed mesh is still closed after decimating, and has the number of
+//  triangles asked for.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Decimate,ClosedToTarget)
+{
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Indices indices;
+  torus ( 64, 32, *vertices, indices );
+  ASSERT_TRUE ( closed ( *vertices, indices ) );
+  ASSERT_EQ ( 4096u, indices.size() / 3 );
+
+  Vec3ArrayPtr outVertices ( new osg::Vec3Array );
+  Indices outIndices;
+  ASSERT_TRUE ( Decimate ( 0.25f ) ( *vertices, indices, *outVertices, outIndices ) );
+
+  // Each collapse takes away two triangles.
+  const unsigned int numTriangles ( outIndices.size() / 3 );
+  ASSERT_LE ( numTriangles, 1024u );
+  ASSERT_GE ( numTriangles, 1022u );
+  ASSERT_TRUE ( closed ( *outVertices, outIndices ) );
+
+  // A closed mesh of genus one has as many vertices as half its triangles.
+  ASSERT_EQ ( numTriangles / 2, outVertices->size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A ratio of one changes nothing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Decimate,KeepAll)
+{
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Indices indices;
+  torus ( 16, 8, *vertices, indices );
+
+  Vec3ArrayPtr outVertices ( new osg::Vec3Array );
+  Indices outIndices;
+  ASSERT_TRUE ( Decimate ( 1.0f ) ( *vertices, indices, *outVertices, outIndices ) );
+  ASSERT_EQ ( indices.size(), outIndices.size() );
+  ASSERT_EQ ( vertices->size(), outVertices->size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Canceling leaves the output alone.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Decimate,Cancel)
+{
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Indices indices;
+  torus ( 64, 32, *vertices, indices );
+
+  Vec3ArrayPtr outVertices ( new osg::Vec3Array );
+  outVertices->push_back ( osg::Vec3f ( 1, 2, 3 ) );
+  Indices outIndices ( 3, 0 );
+
+  Canceler::RefPtr canceler ( new Canceler );
+  ASSERT_FALSE ( Decimate ( 0.25f ) ( *vertices, indices, *outVertices, outIndices, canceler.get() ) );
+  ASSERT_EQ ( 1u, canceler->asked );
+  ASSERT_EQ ( 1u, outVertices->size() );
+  ASSERT_EQ ( 3u, outIndices.size() );
+}
@@ -0,0 +1,170 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Triangles/TriangleSet.h"
+
+#include "gtest/gtest.h"
+
+#include "osg/ref_ptr"
+
+#include <cstring>
+
+
+namespace
+{
+  typedef OsgTools::Triangles::SharedVertex SharedVertex;
+  typedef OsgTools::Triangles::Triangle Triangle;
+  typedef OsgTools::Triangles::TriangleSet TriangleSet;
+  typedef osg::ref_ptr < osg::Vec3Array > Vec3ArrayPtr;
+
+  // The float that is the given number of units in the last place from f.
+  float step ( float f, int ulps )
+  {
+    Usul::Types::Int32 i ( 0 );
+    std::memcpy ( &i, &f, sizeof ( float ) );
+    i += ulps;
+    std::memcpy ( &f, &i, sizeof ( float ) );
+    return f;
+  }
+
+  // Three vertices per triangle of a unit cube, none of them shared.
+  void cube ( osg::Vec3Array &vertices, osg::Vec3Array &normals )
+  {
+    const unsigned int faces[12][3] =
+    {
+      { 0, 2, 1 }, { 0, 3, 2 }, { 4, 5, 6 }, { 4, 6, 7 },
+      { 0, 1, 5 }, { 0, 5, 4 }, { 1, 2, 6 }, { 1, 6, 5 },
+      { 2, 3, 7 }, { 2, 7, 6 }, { 3, 0, 4 }, { 3, 4, 7 }
+    };
+    const osg::Vec3f corners[8] =
+    {
+      osg::Vec3f ( 0, 0, 0 ), osg::Vec3f ( 1, 0, 0 ), osg::Vec3f ( 1, 1, 0 ), osg::Vec3f ( 0, 1, 0 ),
+      osg::Vec3f ( 0, 0, 1 ), osg::Vec3f ( 1, 0, 1 ), osg::Vec3f ( 1, 1, 1 ), osg::Vec3f ( 0, 1, 1 )
+    };
+
+    for ( unsigned int i = 0; i < 12; ++i )
+    {
+      const osg::Vec3f &a ( corners[faces[i][0]] );
+      const osg::Vec3f &b ( corners[faces[i][1]] );
+      const osg::Vec3f &c ( corners[faces[i][2]] );
+      vertices.push_back ( a );
+      vertices.push_back ( b );
+      vertices.push_back ( c );
+
+      osg::Vec3f n ( ( b - a ) ^ ( c - a ) );
+      n.normalize();
+      normals.push_back ( n );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The corners of a cube are welded into eight shared vertices.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TriangleSet,WeldCube)
+{
+  TriangleSet::RefPtr ts ( new TriangleSet );
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Vec3ArrayPtr normals ( new osg::Vec3Array );
+  cube ( *vertices, *normals );
+
+  ASSERT_EQ ( 12u, ts->addTriangles ( *vertices, *normals, false ) );
+
+  const TriangleSet &cts ( *ts );
+  ASSERT_EQ ( 8u, cts.sharedVertices().size() );
+  ASSERT_EQ ( 8u, cts.vertices()->size() );
+  ASSERT_EQ ( 12u, cts.triangles().size() );
+
+  // The i'th shared vertex has index i.
+  for ( unsigned int i = 0; i < 8; ++i )
+  {
+    ASSERT_EQ ( i, cts.sharedVertices()[i]->index() );
+  }
+
+  // Adding it again in a second batch finds the existing vertices.
+  ASSERT_EQ ( 12u, ts->addTriangles ( *vertices, *normals, false ) );
+  ASSERT_EQ ( 8u, cts.sharedVertices().size() );
+  ASSERT_EQ ( 24u, cts.triangles().size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Vertices within the tolerance weld, and triangles that collapse are
+//  kept the same way addTriangle() keeps them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TriangleSet,WeldTolerance)
+{
+  TriangleSet::RefPtr ts ( new TriangleSet ( 1 ) );
+
+  SharedVertex *a ( ts->addSharedVertex ( osg::Vec3f ( 1, 2, 3 ), true ) );
+  ASSERT_TRUE ( a == ts->addSharedVertex ( osg::Vec3f ( step ( 1, 1 ), 2, step ( 3, -1 ) ), true ) );
+  ASSERT_TRUE ( a != ts->addSharedVertex ( osg::Vec3f ( step ( 1, 2 ), 2, 3 ), true ) );
+
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Vec3ArrayPtr normals ( new osg::Vec3Array );
+  vertices->push_back ( osg::Vec3f ( 5, 5, 5 ) );
+  vertices->push_back ( osg::Vec3f ( step ( 5, 1 ), 5, 5 ) );
+  vertices->push_back ( osg::Vec3f ( 6, 5, 5 ) );
+  normals->push_back ( osg::Vec3f ( 0, 0, 1 ) );
+
+  ASSERT_EQ ( 1u, ts->addTriangles ( *vertices, *normals, false ) );
+
+  const TriangleSet &cts ( *ts );
+  ASSERT_EQ ( 1u, cts.triangles().size() );
+  const Triangle *batch ( cts.triangles().front().get() );
+  ASSERT_TRUE ( batch->vertex0() == batch->vertex1() );
+  ASSERT_TRUE ( batch->vertex0() != batch->vertex2() );
+
+  const Triangle *single ( ts->addTriangle ( vertices->at ( 0 ), vertices->at ( 1 ), vertices->at ( 2 ), normals->at ( 0 ), false, true ) );
+  ASSERT_EQ ( 2u, cts.triangles().size() );
+  ASSERT_TRUE ( single->vertex0() == batch->vertex0() );
+  ASSERT_TRUE ( single->vertex1() == batch->vertex1() );
+  ASSERT_TRUE ( single->vertex2() == batch->vertex2() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  After keeping some triangles the remaining vertices are still found.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TriangleSet,WeldAfterKeep)
+{
+  TriangleSet::RefPtr ts ( new TriangleSet );
+  Vec3ArrayPtr vertices ( new osg::Vec3Array );
+  Vec3ArrayPtr normals ( new osg::Vec3Array );
+  cube ( *vertices, *normals );
+  ts->addTriangles ( *vertices, *normals, false );
+
+  // The top face only.
+  TriangleSet::Indices keepers;
+  keepers.push_back ( 2 );
+  keepers.push_back ( 3 );
+  ts->keepTriangles ( keepers, 0x0 );
+
+  const TriangleSet &cts ( *ts );
+  ASSERT_EQ ( 4u, cts.sharedVertices().size() );
+  ASSERT_EQ ( 4u, cts.vertices()->size() );
+
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    const SharedVertex *sv ( cts.sharedVertices()[i] );
+    ASSERT_EQ ( i, sv->index() );
+    ASSERT_TRUE ( sv == ts->addSharedVertex ( cts.vertices()->at ( i ), true ) );
+  }
+  ASSERT_EQ ( 4u, cts.sharedVertices().size() );
+}
@@ -0,0 +1,135 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OsgTools/Triangles/WeldGrid.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+  typedef OsgTools::Triangles::WeldGrid < unsigned int > Grid;
+
+  // The float that is the given number of units in the last place from f.
+  float step ( float f, int ulps )
+  {
+    Usul::Types::Int32 i ( 0 );
+    std::memcpy ( &i, &f, sizeof ( float ) );
+    i += ulps;
+    std::memcpy ( &f, &i, sizeof ( float ) );
+    return f;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Vertices within the tolerance are found, the others are not.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(WeldGrid,Tolerance)
+{
+  Grid grid ( 2 );
+  grid.insert ( osg::Vec3f ( 1.0f, 2.0f, 3.0f ), 7 );
+
+  unsigned int found ( 0 );
+  ASSERT_TRUE ( grid.find ( osg::Vec3f ( 1.0f, 2.0f, 3.0f ), found ) );
+  ASSERT_EQ ( 7u, found );
+
+  ASSERT_TRUE ( grid.find ( osg::Vec3f ( step ( 1.0f, 2 ), 2.0f, step ( 3.0f, -2 ) ), found ) );
+  ASSERT_FALSE ( grid.find ( osg::Vec3f ( step ( 1.0f, 3 ), 2.0f, 3.0f ), found ) );
+  ASSERT_FALSE ( grid.find ( osg::Vec3f ( 1.0f, 2.0f, step ( 3.0f, -3 ) ), found ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A vertex right on a cell boundary finds its neighbor in the next cell.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(WeldGrid,CellBoundary)
+{
+  Grid grid ( 1 );
+
+  // With the default shift, this is the last float in its cell.
+  Usul::Types::Int32 i ( 0 );
+  const float one ( 1.0f );
+  std::memcpy ( &i, &one, sizeof ( float ) );
+  i |= ( ( 1 << Grid::SHIFT ) - 1 );
+  float last ( 0.0f );
+  std::memcpy ( &last, &i, sizeof ( float ) );
+
+  grid.insert ( osg::Vec3f ( last, last, last ), 1 );
+
+  unsigned int found ( 0 );
+  const float next ( step ( last, 1 ) );
+  ASSERT_TRUE ( grid.find ( osg::Vec3f ( next, next, next ), found ) );
+  ASSERT_EQ ( 1u, found );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Zero welds across the sign, like CloseFloat.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(WeldGrid,Zero)
+{
+  Grid grid ( 1 );
+  grid.insert ( osg::Vec3f ( 0.0f, 0.0f, 0.0f ), 1 );
+
+  unsigned int found ( 0 );
+  ASSERT_TRUE ( grid.find ( osg::Vec3f ( -0.0f, 0.0f, -0.0f ), found ) );
+  ASSERT_EQ ( 1u, found );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Many vertices that are all different are all found again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(WeldGrid,Many)
+{
+  Grid grid ( 1 );
+
+  const unsigned int num ( 40 );
+  for ( unsigned int x = 0; x < num; ++x )
+    for ( unsigned int y = 0; y < num; ++y )
+      for ( unsigned int z = 0; z < num; ++z )
+        grid.insert ( osg::Vec3f ( x * 0.1f - 2.0f, y * 1000.0f, std::sqrt ( float ( z ) ) ), ( x * num + y ) * num + z );
+
+  ASSERT_EQ ( num * num * num, grid.size() );
+
+  for ( unsigned int x = 0; x < num; ++x )
+  {
+    for ( unsigned int y = 0; y < num; ++y )
+    {
+      for ( unsigned int z = 0; z < num; ++z )
+      {
+        unsigned int found ( 0 );
+        ASSERT_TRUE ( grid.find ( osg::Vec3f ( x * 0.1f - 2.0f, y * 1000.0f, std::sqrt ( float ( z ) ) ), found ) );
+        ASSERT_EQ ( ( x * num + y ) * num + z, found );
+      }
+    }
+  }
+
+  grid.clear();
+  ASSERT_TRUE ( grid.empty() );
+
+  unsigned int found ( 0 );
+  ASSERT_FALSE ( grid.find ( osg::Vec3f ( 0.0f, 0.0f, 0.0f ), found ) );
+}
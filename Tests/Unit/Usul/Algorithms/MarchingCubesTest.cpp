@@ -0,0 +1,171 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Algorithms/MarchingCubes.h"
+#include "Usul/Containers/Array2D.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+  typedef Usul::Algorithms::MarchingCubes < unsigned char > MarchingCubes;
+  typedef MarchingCubes::Mesh Mesh;
+  typedef MarchingCubes::Index Index;
+
+  const unsigned int SIZE ( 40 );
+
+  // Distance from the middle of the volume.
+  double distance ( unsigned int x, unsigned int y, unsigned int z )
+  {
+    const double m ( 0.5 * ( SIZE - 1 ) );
+    return std::sqrt ( ( x - m ) * ( x - m ) + ( y - m ) * ( y - m ) + ( z - m ) * ( z - m ) );
+  }
+
+  // A ball, or with noise, a lot of small pieces away from the sides.
+  struct Ball
+  {
+    Ball ( bool noise ) : _noise ( noise ){}
+    void operator () ( unsigned int z, std::vector<unsigned char> &slice ) const
+    {
+      for ( unsigned int y = 0; y < SIZE; ++y )
+      {
+        for ( unsigned int x = 0; x < SIZE; ++x )
+        {
+          const unsigned int hash ( ( x * 73856093u ) ^ ( y * 19349663u ) ^ ( z * 83492791u ) );
+          const bool border ( 0 == x || 0 == y || 0 == z || SIZE - 1 == x || SIZE - 1 == y || SIZE - 1 == z );
+          const bool inside ( ( true == _noise ) ? ( false == border && 0 == ( hash % 3 ) ) : ( distance ( x, y, z ) < 15.0 ) );
+          slice[y * SIZE + x] = ( ( true == inside ) ? 255 : 0 );
+        }
+      }
+    }
+    bool _noise;
+  };
+
+  void extract ( bool noise, unsigned int blockSize, Usul::Jobs::Manager &manager, Mesh &mesh )
+  {
+    MarchingCubes mc ( SIZE, SIZE, SIZE, 127.5 );
+    mc.blockSize ( blockSize );
+    ASSERT_TRUE ( mc ( Ball ( noise ), mesh, Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+  }
+
+  // Every edge is used once each way.
+  bool closed ( const Mesh &mesh )
+  {
+    typedef std::map < std::pair < Index, Index >, int > Edges;
+    Edges edges;
+    for ( unsigned int t = 0; t < mesh.indices.size(); t += 3 )
+    {
+      for ( unsigned int c = 0; c < 3; ++c )
+      {
+        const Index a ( mesh.indices[t + c] ), b ( mesh.indices[t + ( c + 1 ) % 3] );
+        if ( a == b )
+          return false;
+        ++edges[std::make_pair ( a, b )];
+      }
+    }
+    for ( Edges::const_iterator i = edges.begin(); i != edges.end(); ++i )
+    {
+      Edges::const_iterator j ( edges.find ( std::make_pair ( i->first.second, i->first.first ) ) );
+      if ( 1 != i->second || edges.end() == j || 1 != j->second )
+        return false;
+    }
+    return true;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The surface of a ball is closed, faces out, and is near the ball.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(MarchingCubes,Ball)
+{
+  Usul::Jobs::Manager manager ( "MarchingCubesTest", 4 );
+  Mesh mesh;
+  extract ( false, 7, manager, mesh );
+
+  ASSERT_FALSE ( mesh.indices.empty() );
+  ASSERT_TRUE ( closed ( mesh ) );
+
+  const double m ( 0.5 * ( SIZE - 1 ) );
+  for ( unsigned int i = 0; i < mesh.x.size(); ++i )
+  {
+    const double r ( std::sqrt ( ( mesh.x[i] - m ) * ( mesh.x[i] - m ) + ( mesh.y[i] - m ) * ( mesh.y[i] - m ) + ( mesh.z[i] - m ) * ( mesh.z[i] - m ) ) );
+    ASSERT_NEAR ( 15.0, r, 1.0 );
+  }
+
+  for ( unsigned int t = 0; t < mesh.indices.size(); t += 3 )
+  {
+    const Index *i ( &mesh.indices[t] );
+    const double ax ( mesh.x[i[1]] - mesh.x[i[0]] ), ay ( mesh.y[i[1]] - mesh.y[i[0]] ), az ( mesh.z[i[1]] - mesh.z[i[0]] );
+    const double bx ( mesh.x[i[2]] - mesh.x[i[0]] ), by ( mesh.y[i[2]] - mesh.y[i[0]] ), bz ( mesh.z[i[2]] - mesh.z[i[0]] );
+    const double nx ( ay * bz - az * by ), ny ( az * bx - ax * bz ), nz ( ax * by - ay * bx );
+    ASSERT_GT ( nx * ( mesh.x[i[0]] - m ) + ny * ( mesh.y[i[0]] - m ) + nz * ( mesh.z[i[0]] - m ), 0.0 );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Noise has every cube case. The mesh is still closed, and it is the same
+//  for any block size and number of threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(MarchingCubes,Noise)
+{
+  Usul::Jobs::Manager one ( "MarchingCubesTest", 1 );
+  Usul::Jobs::Manager many ( "MarchingCubesTest", 4 );
+
+  Mesh a, b;
+  extract ( true, 1, one, a );
+  extract ( true, 16, many, b );
+
+  ASSERT_TRUE ( closed ( a ) );
+  ASSERT_TRUE ( a.indices == b.indices );
+  ASSERT_TRUE ( a.x == b.x && a.y == b.y && a.z == b.z );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Slices can come from 2D arrays.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(MarchingCubes,Layers)
+{
+  typedef Usul::Containers::Array2D < unsigned char > Layer;
+  std::vector < Layer > layers ( SIZE, Layer ( SIZE, SIZE ) );
+  std::vector < unsigned char > slice ( SIZE * SIZE );
+  for ( unsigned int z = 0; z < SIZE; ++z )
+  {
+    Ball ( false ) ( z, slice );
+    for ( unsigned int y = 0; y < SIZE; ++y )
+      for ( unsigned int x = 0; x < SIZE; ++x )
+        layers[z] ( y, x ) = slice[y * SIZE + x];
+  }
+
+  Usul::Jobs::Manager manager ( "MarchingCubesTest", 4 );
+  Mesh a, b;
+  extract ( false, 16, manager, a );
+
+  MarchingCubes mc ( SIZE, SIZE, SIZE, 127.5 );
+  ASSERT_TRUE ( mc ( Usul::Algorithms::MarchingCubesLayers < std::vector < Layer > > ( layers ), b, Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+  ASSERT_TRUE ( a.indices == b.indices );
+}
@@ -0,0 +1,167 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Algorithms/Parallel.h"
+
+#include "gtest/gtest.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+  struct Double
+  {
+    Double ( std::vector<unsigned int> &v ) : _v ( &v ){}
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      for ( unsigned int i = first; i < last; ++i )
+        (*_v)[i] *= 2;
+    }
+    std::vector<unsigned int> *_v;
+  };
+
+  struct Sum
+  {
+    Sum ( const std::vector<unsigned int> &v ) : _v ( &v ){}
+    unsigned long operator () ( unsigned int first, unsigned int last ) const
+    {
+      unsigned long sum ( 0 );
+      for ( unsigned int i = first; i < last; ++i )
+        sum += (*_v)[i];
+      return sum;
+    }
+    const std::vector<unsigned int> *_v;
+  };
+
+  struct Nested
+  {
+    Nested ( const std::vector<unsigned int> &v, std::vector<unsigned long> &answers, Usul::Jobs::Manager &m ) : _v ( &v ), _answers ( &answers ), _m ( &m ){}
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      for ( unsigned int i = first; i < last; ++i )
+      {
+        Usul::Algorithms::parallelReduce ( 0u, 100u, 7u, 0ul, Sum ( *_v ), std::plus<unsigned long>(), (*_answers)[i], Usul::Jobs::Job::RefPtr ( 0x0 ), *_m );
+      }
+    }
+    const std::vector<unsigned int> *_v;
+    std::vector<unsigned long> *_answers;
+    Usul::Jobs::Manager *_m;
+  };
+
+  struct Throw
+  {
+    void operator () ( unsigned int first, unsigned int last ) const
+    {
+      if ( ( first <= 500 ) && ( 500 < last ) )
+        throw Usul::Exceptions::Canceled ( "Canceled at 500" );
+    }
+  };
+
+  void nothing()
+  {
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Every index is visited exactly once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Parallel,For)
+{
+  Usul::Jobs::Manager manager ( "ParallelTest", 4 );
+  std::vector<unsigned int> v ( 100003, 1 );
+
+  ASSERT_TRUE ( Usul::Algorithms::parallelFor ( 0u, 100003u, 1000u, Double ( v ), Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+
+  for ( unsigned int i = 0; i < v.size(); ++i )
+    ASSERT_EQ ( 2u, v[i] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sum with an uneven last chunk.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Parallel,Reduce)
+{
+  Usul::Jobs::Manager manager ( "ParallelTest", 4 );
+  std::vector<unsigned int> v ( 100003, 3 );
+
+  unsigned long answer ( 0 );
+  ASSERT_TRUE ( Usul::Algorithms::parallelReduce ( 0u, 100003u, 777u, 0ul, Sum ( v ), std::plus<unsigned long>(), answer, Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+  ASSERT_EQ ( 300009ul, answer );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Loops inside loops on the same pool must not deadlock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Parallel,Nested)
+{
+  Usul::Jobs::Manager manager ( "ParallelTest", 2 );
+  std::vector<unsigned int> v ( 100, 1 );
+  std::vector<unsigned long> answers ( 50, 0 );
+
+  ASSERT_TRUE ( Usul::Algorithms::parallelFor ( 0u, 50u, 1u, Nested ( v, answers, manager ), Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+
+  for ( unsigned int i = 0; i < answers.size(); ++i )
+    ASSERT_EQ ( 100ul, answers[i] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A cancelled job stops the loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Parallel,Canceled)
+{
+  Usul::Jobs::Manager manager ( "ParallelTest", 4 );
+  std::vector<unsigned int> v ( 1000, 1 );
+
+  Usul::Jobs::Job::RefPtr job ( Usul::Jobs::create ( &nothing ) );
+  job->cancel();
+
+  ASSERT_FALSE ( Usul::Algorithms::parallelFor ( 0u, 1000u, 10u, Double ( v ), job, manager ) );
+  ASSERT_EQ ( 1u, v[0] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  An exception thrown in a chunk comes out of the loop with its own type.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Parallel,Exception)
+{
+  Usul::Jobs::Manager manager ( "ParallelTest", 4 );
+
+  try
+  {
+    Usul::Algorithms::parallelFor ( 0u, 1000u, 10u, Throw(), Usul::Jobs::Job::RefPtr ( 0x0 ), manager );
+    FAIL();
+  }
+  catch ( const Usul::Exceptions::Canceled &e )
+  {
+    ASSERT_EQ ( std::string ( "Canceled at 500" ), e.what() );
+  }
+}
@@ -0,0 +1,76 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Algorithms/RadixSort.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+  // Compare only the bits in [16,36).
+  struct Middle
+  {
+    bool operator () ( unsigned long long a, unsigned long long b ) const
+    {
+      return ( ( a >> 16 ) & 0xfffff ) < ( ( b >> 16 ) & 0xfffff );
+    }
+  };
+
+  std::vector<unsigned long long> random ( unsigned int n )
+  {
+    std::vector<unsigned long long> v ( n );
+    unsigned long long x ( 88172645463325252ull );
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+      x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+      v[i] = x;
+    }
+    return v;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sorting all the bits gives the same as std::sort.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RadixSort,AllBits)
+{
+  Usul::Jobs::Manager manager ( "RadixSortTest", 4 );
+  std::vector<unsigned long long> v ( random ( 300007 ) );
+  std::vector<unsigned long long> expected ( v );
+  std::sort ( expected.begin(), expected.end() );
+
+  ASSERT_TRUE ( Usul::Algorithms::radixSort ( v, 0, 64, Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+  ASSERT_TRUE ( expected == v );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sorting some of the bits is stable, with a partial last digit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RadixSort,SomeBits)
+{
+  Usul::Jobs::Manager manager ( "RadixSortTest", 4 );
+  std::vector<unsigned long long> v ( random ( 200003 ) );
+  std::vector<unsigned long long> expected ( v );
+  std::stable_sort ( expected.begin(), expected.end(), Middle() );
+
+  ASSERT_TRUE ( Usul::Algorithms::radixSort ( v, 16, 36, Usul::Jobs::Job::RefPtr ( 0x0 ), manager ) );
+  ASSERT_TRUE ( expected == v );
+}
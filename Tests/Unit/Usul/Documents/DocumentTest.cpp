@@ -0,0 +1,305 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L. Miller IV and Adam Kubach
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Documents/Document.h"
+#include "Usul/Interfaces/IScenePublished.h"
+#include "Usul/Jobs/Manager.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+  // Reads a made up file in chunks and publishes each one.
+  class ChunkDocument : public Usul::Documents::Document
+  {
+  public:
+
+    typedef Usul::Documents::Document BaseClass;
+
+    USUL_DECLARE_REF_POINTERS ( ChunkDocument );
+
+    ChunkDocument ( unsigned int numChunks, bool fail = false ) : BaseClass ( "Chunk Document" ),
+      chunks(),
+      events(),
+      fail ( fail ),
+      cancelInBuild ( false ),
+      buildCaller ( 0x0 ),
+      _numChunks ( numChunks )
+    {
+    }
+
+    virtual bool canExport ( const std::string & ) const { return false; }
+    virtual bool canInsert ( const std::string & ) const { return false; }
+    virtual bool canOpen   ( const std::string & ) const { return true; }
+    virtual bool canSave   ( const std::string & ) const { return false; }
+
+    virtual void clear ( Unknown * )
+    {
+      chunks.clear();
+      events.push_back ( "clear" );
+    }
+
+    virtual Filters filtersExport() const { return Filters(); }
+    virtual Filters filtersInsert() const { return Filters(); }
+    virtual Filters filtersOpen()   const { return Filters(); }
+    virtual Filters filtersSave()   const { return Filters(); }
+
+    virtual void read ( const std::string &, Unknown *, Unknown * )
+    {
+      for ( unsigned int i = 0; i < _numChunks; ++i )
+      {
+        this->checkLoadCanceled();
+        if ( ( true == fail ) && ( 2 == i ) )
+          throw std::runtime_error ( "Error 3374096212: Bad chunk" );
+        chunks.push_back ( i );
+        this->publishScene();
+      }
+    }
+
+    virtual void write ( const std::string &, Unknown *, Unknown * ) const
+    {
+    }
+
+    std::vector<unsigned int> chunks;
+    std::vector<std::string> events;
+    bool fail;
+    bool cancelInBuild;
+    Unknown *buildCaller;
+
+  protected:
+
+    virtual ~ChunkDocument()
+    {
+    }
+
+    virtual void _loadBuild ( Unknown *caller )
+    {
+      buildCaller = caller;
+      events.push_back ( "build" );
+      if ( true == cancelInBuild )
+        this->cancelLoad();
+    }
+
+    virtual void _loadFinished ( bool canceled )
+    {
+      events.push_back ( ( true == canceled ) ? "canceled" : "finished" );
+    }
+
+  private:
+
+    unsigned int _numChunks;
+  };
+
+  // Counts what the document publishes. Cancels after the given number.
+  class Listener : public Usul::Base::Referenced,
+                   public Usul::Interfaces::IScenePublished
+  {
+  public:
+
+    USUL_DECLARE_REF_POINTERS ( Listener );
+    USUL_DECLARE_IUNKNOWN_MEMBERS;
+
+    Listener ( unsigned int cancelAfter = 0 ) : published ( 0 ), finished ( 0 ), loading ( true ), _cancelAfter ( cancelAfter )
+    {
+    }
+
+    virtual void scenePublished ( Usul::Documents::Document *document, bool done )
+    {
+      if ( true == done )
+      {
+        ++finished;
+        loading = document->loading();
+        return;
+      }
+
+      ++published;
+      if ( published == _cancelAfter )
+        document->cancelLoad();
+    }
+
+    unsigned int published;
+    unsigned int finished;
+    bool loading;
+
+  protected:
+
+    virtual ~Listener()
+    {
+    }
+
+  private:
+
+    unsigned int _cancelAfter;
+  };
+
+  Usul::Interfaces::IUnknown *Listener::queryInterface ( unsigned long iid )
+  {
+    switch ( iid )
+    {
+    case Usul::Interfaces::IUnknown::IID:
+    case Usul::Interfaces::IScenePublished::IID:
+      return static_cast < Usul::Interfaces::IScenePublished * > ( this );
+    default:
+      return 0x0;
+    }
+  }
+
+  USUL_IMPLEMENT_IUNKNOWN_MEMBERS ( Listener, Usul::Base::Referenced );
+
+  struct SetFlag
+  {
+    SetFlag ( bool &flag ) : _flag ( &flag ){}
+    void operator () () const { *_flag = true; }
+    bool *_flag;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The chunks are published while reading, then it builds and finishes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Document,OpenAsync)
+{
+  Usul::Jobs::Manager manager ( "Document Test", 2 );
+  ChunkDocument::RefPtr document ( new ChunkDocument ( 5 ) );
+  Listener::RefPtr listener ( new Listener );
+
+  bool done ( false );
+  document->openAsync ( "file.chunks", listener->queryInterface ( Usul::Interfaces::IUnknown::IID ),
+                        Usul::Jobs::create ( SetFlag ( done ) ), &manager );
+  manager.wait();
+
+  ASSERT_TRUE ( done );
+  ASSERT_FALSE ( document->loading() );
+  ASSERT_TRUE ( document->fileValid() );
+  ASSERT_EQ ( std::string ( "file.chunks" ), document->fileName() );
+  ASSERT_EQ ( 5u, document->chunks.size() );
+
+  ASSERT_EQ ( 5u, listener->published );
+  ASSERT_EQ ( 1u, listener->finished );
+  ASSERT_FALSE ( listener->loading );
+  ASSERT_TRUE ( listener->queryInterface ( Usul::Interfaces::IUnknown::IID ) == document->buildCaller );
+
+  const char *events[] = { "clear", "build", "finished" };
+  ASSERT_EQ ( 3u, document->events.size() );
+  for ( unsigned int i = 0; i < 3; ++i )
+    ASSERT_EQ ( std::string ( events[i] ), document->events[i] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Canceling stops the reading at the next check and drops what was read.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Document,CancelLoad)
+{
+  Usul::Jobs::Manager manager ( "Document Test", 2 );
+  ChunkDocument::RefPtr document ( new ChunkDocument ( 100 ) );
+  Listener::RefPtr listener ( new Listener ( 3 ) );
+
+  bool done ( false );
+  Usul::Jobs::Job::RefPtr read ( document->openAsync ( "file.chunks", listener->queryInterface ( Usul::Interfaces::IUnknown::IID ),
+                                                       Usul::Jobs::create ( SetFlag ( done ) ), &manager ) );
+  manager.wait();
+
+  ASSERT_TRUE ( read->canceled() );
+  ASSERT_FALSE ( done );
+  ASSERT_FALSE ( document->loading() );
+  ASSERT_FALSE ( document->fileValid() );
+  ASSERT_TRUE ( document->chunks.empty() );
+
+  ASSERT_EQ ( 3u, listener->published );
+  ASSERT_EQ ( 1u, listener->finished );
+
+  ASSERT_EQ ( std::string ( "canceled" ), document->events.back() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Canceling while building ends the load and does not keep the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Document,CancelWhileBuilding)
+{
+  Usul::Jobs::Manager manager ( "Document Test", 2 );
+  ChunkDocument::RefPtr document ( new ChunkDocument ( 5 ) );
+  document->cancelInBuild = true;
+  Listener::RefPtr listener ( new Listener );
+
+  bool done ( false );
+  Usul::Jobs::Job::RefPtr read ( document->openAsync ( "file.chunks", listener->queryInterface ( Usul::Interfaces::IUnknown::IID ),
+                                                       Usul::Jobs::create ( SetFlag ( done ) ), &manager ) );
+  manager.wait();
+
+  ASSERT_FALSE ( done );
+  ASSERT_FALSE ( document->loading() );
+  ASSERT_FALSE ( document->fileValid() );
+  ASSERT_NE ( std::string ( "file.chunks" ), document->fileName() );
+  ASSERT_TRUE ( document->chunks.empty() );
+
+  ASSERT_EQ ( 5u, listener->published );
+  ASSERT_EQ ( 1u, listener->finished );
+
+  ASSERT_EQ ( std::string ( "build" ), document->events[document->events.size() - 3] );
+  ASSERT_EQ ( std::string ( "clear" ), document->events[document->events.size() - 2] );
+  ASSERT_EQ ( std::string ( "canceled" ), document->events.back() );
+
+  // It can be opened again.
+  document->cancelInBuild = false;
+  document->openAsync ( "file.chunks", 0x0, Usul::Jobs::Job::RefPtr ( 0x0 ), &manager );
+  manager.wait();
+  ASSERT_TRUE ( document->fileValid() );
+  ASSERT_EQ ( 5u, document->chunks.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A reading error ends the load without building.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Document,LoadError)
+{
+  Usul::Jobs::Manager manager ( "Document Test", 2 );
+  ChunkDocument::RefPtr document ( new ChunkDocument ( 5, true ) );
+  Listener::RefPtr listener ( new Listener );
+
+  bool done ( false );
+  document->openAsync ( "file.chunks", listener->queryInterface ( Usul::Interfaces::IUnknown::IID ),
+                        Usul::Jobs::create ( SetFlag ( done ) ), &manager );
+  manager.wait();
+
+  ASSERT_FALSE ( done );
+  ASSERT_FALSE ( document->loading() );
+  ASSERT_FALSE ( document->fileValid() );
+  ASSERT_EQ ( 2u, listener->published );
+  ASSERT_EQ ( 1u, listener->finished );
+  ASSERT_TRUE ( document->events.end() == std::find ( document->events.begin(), document->events.end(), std::string ( "build" ) ) );
+
+  // It can be opened again.
+  document->fail = false;
+  document->openAsync ( "file.chunks", 0x0, Usul::Jobs::Job::RefPtr ( 0x0 ), &manager );
+  manager.wait();
+  ASSERT_TRUE ( document->fileValid() );
+  ASSERT_EQ ( 5u, document->chunks.size() );
+}
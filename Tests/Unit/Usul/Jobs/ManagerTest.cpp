@@ -0,0 +1,414 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Jobs/Manager.h"
+#include "Usul/Trace/Recorder.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+  typedef Usul::Jobs::Job::RefPtr JobPtr;
+  typedef Usul::Jobs::Manager::Jobs Jobs;
+
+  void pause ( unsigned int milliseconds )
+  {
+    boost::this_thread::sleep ( boost::posix_time::milliseconds ( milliseconds ) );
+  }
+
+  // Remembers the order the jobs ran in.
+  struct Events
+  {
+    Events() : _mutex(), _order(), _holding ( false ), _release ( false ){}
+
+    void add ( unsigned int i, unsigned int milliseconds )
+    {
+      pause ( milliseconds );
+      boost::mutex::scoped_lock lock ( _mutex );
+      _order.push_back ( i );
+    }
+
+    // Spin until told to go.
+    void hold ( unsigned int i )
+    {
+      {
+        boost::mutex::scoped_lock lock ( _mutex );
+        _holding = true;
+      }
+      while ( false == this->released() )
+        pause ( 1 );
+      this->add ( i, 0 );
+    }
+
+    void fail()
+    {
+      throw std::runtime_error ( "Error 3021658749: Failing on purpose" );
+    }
+
+    bool holding()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _holding;
+    }
+
+    bool released()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _release;
+    }
+
+    void release()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      _release = true;
+    }
+
+    std::vector<unsigned int> order()
+    {
+      boost::mutex::scoped_lock lock ( _mutex );
+      return _order;
+    }
+
+    boost::mutex _mutex;
+    std::vector<unsigned int> _order;
+    bool _holding;
+    bool _release;
+  };
+
+  JobPtr add ( Events &events, unsigned int i, unsigned int milliseconds = 0 )
+  {
+    return JobPtr ( Usul::Jobs::create ( boost::bind ( &Events::add, &events, i, milliseconds ), 0x0, false ) );
+  }
+
+  // Counts how often it ran and was cancelled.
+  class Counted : public Usul::Jobs::Job
+  {
+  public:
+
+    typedef Usul::Jobs::Job BaseClass;
+
+    USUL_DECLARE_REF_POINTERS ( Counted );
+
+    Counted ( bool succeeds = true ) : BaseClass ( 0x0, false ), ran ( 0 ), cancelled ( 0 ), _succeeds ( succeeds )
+    {
+    }
+
+    virtual bool success() const
+    {
+      return _succeeds;
+    }
+
+    unsigned int ran;
+    unsigned int cancelled;
+
+  protected:
+
+    virtual ~Counted()
+    {
+    }
+
+    virtual void _started()
+    {
+      ++ran;
+    }
+
+    virtual void _cancelled()
+    {
+      ++cancelled;
+    }
+
+  private:
+
+    bool _succeeds;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A chain of continuations runs in order, even when the first is slow.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,Order)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 4 );
+  Events events;
+
+  JobPtr a ( add ( events, 1, 50 ) );
+  JobPtr b ( manager.then ( a, add ( events, 2, 10 ) ) );
+  JobPtr c ( manager.then ( b, add ( events, 3 ) ) );
+  manager.addJob ( a );
+  manager.wait();
+
+  const std::vector<unsigned int> order ( events.order() );
+  ASSERT_EQ ( 3u, order.size() );
+  ASSERT_EQ ( 1u, order[0] );
+  ASSERT_EQ ( 2u, order[1] );
+  ASSERT_EQ ( 3u, order[2] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A job with several predecessors waits for all of them, including ones
+//  that are already done when it is added.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,FanIn)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 4 );
+  Events events;
+
+  JobPtr done ( add ( events, 0 ) );
+  manager.addJob ( done );
+  manager.wait();
+
+  Jobs predecessors;
+  predecessors.push_back ( done );
+  predecessors.push_back ( add ( events, 1, 40 ) );
+  predecessors.push_back ( add ( events, 2, 20 ) );
+  predecessors.push_back ( add ( events, 3, 0 ) );
+
+  manager.addJob ( add ( events, 4 ), predecessors );
+  for ( unsigned int i = 1; i < predecessors.size(); ++i )
+    manager.addJob ( predecessors[i] );
+  manager.wait();
+
+  const std::vector<unsigned int> order ( events.order() );
+  ASSERT_EQ ( 5u, order.size() );
+  ASSERT_EQ ( 4u, order.back() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A predecessor that throws cancels everything downstream of it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,ErrorCancelsSuccessors)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 2 );
+  Events events;
+
+  JobPtr a ( Usul::Jobs::create ( boost::bind ( &Events::fail, &events ), 0x0, false ) );
+  JobPtr b ( manager.then ( a, add ( events, 2 ) ) );
+  JobPtr c ( manager.then ( b, add ( events, 3 ) ) );
+  manager.addJob ( a );
+  manager.wait();
+
+  ASSERT_TRUE ( events.order().empty() );
+  ASSERT_TRUE ( b->canceled() );
+  ASSERT_TRUE ( c->canceled() );
+  ASSERT_TRUE ( b->isDone() );
+  ASSERT_TRUE ( c->isDone() );
+
+  // Added after the failure, it is cancelled right away, whether it waits
+  // on the cancelled job or the one that failed.
+  JobPtr d ( manager.then ( b, add ( events, 4 ) ) );
+  JobPtr e ( manager.then ( a, add ( events, 5 ) ) );
+  manager.wait();
+  ASSERT_TRUE ( d->canceled() );
+  ASSERT_TRUE ( d->isDone() );
+  ASSERT_TRUE ( e->canceled() );
+  ASSERT_TRUE ( e->isDone() );
+  ASSERT_TRUE ( events.order().empty() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A predecessor that says it did not succeed cancels its successors, the
+//  ones added before it finished and the ones added after.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,NoSuccessCancelsSuccessors)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 2 );
+
+  Counted::RefPtr a ( new Counted ( false ) );
+  Counted::RefPtr before ( new Counted );
+  manager.then ( a.get(), before.get() );
+  manager.addJob ( a.get() );
+  manager.wait();
+
+  Counted::RefPtr after ( new Counted );
+  manager.then ( a.get(), after.get() );
+  manager.wait();
+
+  ASSERT_EQ ( 1u, a->ran );
+  ASSERT_EQ ( 0u, before->ran );
+  ASSERT_EQ ( 0u, after->ran );
+  ASSERT_EQ ( 1u, before->cancelled );
+  ASSERT_EQ ( 1u, after->cancelled );
+  ASSERT_TRUE ( before->isDone() );
+  ASSERT_TRUE ( after->isDone() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancelling a running predecessor cancels the jobs waiting on it, but
+//  not the other jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,CancelCancelsSuccessors)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 2 );
+  Events events;
+
+  JobPtr a ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events, 1 ), 0x0, false ) );
+  JobPtr b ( manager.then ( a, add ( events, 2 ) ) );
+  JobPtr c ( manager.then ( b, add ( events, 3 ) ) );
+  JobPtr other ( add ( events, 4 ) );
+  manager.addJob ( a );
+
+  // Cancel it while it runs.
+  while ( false == events.holding() )
+    pause ( 1 );
+  manager.cancel ( a );
+  events.release();
+  manager.addJob ( other );
+  manager.wait();
+
+  ASSERT_TRUE ( b->canceled() );
+  ASSERT_TRUE ( c->canceled() );
+  ASSERT_TRUE ( b->isDone() );
+  ASSERT_TRUE ( c->isDone() );
+  ASSERT_FALSE ( other->canceled() );
+
+  const std::vector<unsigned int> order ( events.order() );
+  ASSERT_EQ ( 2u, order.size() );
+  ASSERT_TRUE ( order.end() == std::find ( order.begin(), order.end(), 2u ) );
+  ASSERT_TRUE ( order.end() == std::find ( order.begin(), order.end(), 3u ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A job taken out of the queue never runs, is done, and its successors
+//  are cancelled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,RemoveQueuedJob)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 1 );
+  Events events;
+
+  JobPtr holder ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events, 1 ), 0x0, false ) );
+  manager.addJob ( holder );
+  while ( false == events.holding() )
+    pause ( 1 );
+
+  JobPtr a ( add ( events, 2 ) );
+  JobPtr b ( manager.then ( a, add ( events, 3 ) ) );
+  manager.addJob ( a );
+  manager.removeQueuedJob ( a );
+
+  ASSERT_TRUE ( a->isDone() );
+  ASSERT_TRUE ( b->canceled() );
+
+  events.release();
+  manager.wait();
+
+  const std::vector<unsigned int> order ( events.order() );
+  ASSERT_EQ ( 1u, order.size() );
+  ASSERT_EQ ( 1u, order[0] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Jobs waiting on others are cancelled and done when the queue is cleared,
+//  or when the whole manager is cancelled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,ClearWaitingJobs)
+{
+  Usul::Jobs::Manager manager ( "ManagerTest", 1 );
+  Events events;
+
+  JobPtr holder ( Usul::Jobs::create ( boost::bind ( &Events::hold, &events, 1 ), 0x0, false ) );
+  manager.addJob ( holder );
+  while ( false == events.holding() )
+    pause ( 1 );
+
+  Counted::RefPtr a ( new Counted );
+  Counted::RefPtr b ( new Counted );
+  manager.then ( holder, a.get() );
+  manager.then ( a.get(), b.get() );
+  ASSERT_EQ ( 2u, manager.numJobsQueued() );
+
+  manager.clearQueuedJobs();
+  ASSERT_EQ ( 0u, manager.numJobsQueued() );
+  ASSERT_TRUE ( a->isDone() );
+  ASSERT_TRUE ( b->isDone() );
+  ASSERT_EQ ( 1u, a->cancelled );
+  ASSERT_EQ ( 1u, b->cancelled );
+
+  Counted::RefPtr c ( new Counted );
+  manager.then ( holder, c.get() );
+  manager.cancel();
+  ASSERT_TRUE ( c->isDone() );
+  ASSERT_TRUE ( c->canceled() );
+  ASSERT_EQ ( 1u, c->cancelled );
+
+  events.release();
+  manager.wait();
+  ASSERT_EQ ( 0u, a->ran );
+  ASSERT_EQ ( 0u, b->ran );
+  ASSERT_EQ ( 0u, c->ran );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Jobs are recorded under the readable name of their type.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(JobManager,RecordedName)
+{
+  typedef Usul::Trace::Recorder Recorder;
+  Usul::Jobs::Manager manager ( "ManagerTest", 2 );
+  Events events;
+
+  Recorder::clear();
+  Recorder::enabled ( true );
+  for ( unsigned int i = 0; i < 4; ++i )
+    manager.addJob ( add ( events, i ) );
+  manager.wait();
+  Recorder::enabled ( false );
+
+  Recorder::Events recorded;
+  Recorder::events ( recorded );
+
+  unsigned int found ( 0 );
+  for ( Recorder::Events::const_iterator i = recorded.begin(); i != recorded.end(); ++i )
+  {
+    if ( 0 == Recorder::name ( i->name ).find ( "Usul::Jobs::Detail::GenericJob<" ) )
+      ++found;
+  }
+  ASSERT_EQ ( 4u, found );
+}
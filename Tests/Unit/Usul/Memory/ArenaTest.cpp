@@ -0,0 +1,174 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Memory/Arena.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+  void churn ( Usul::Memory::Arena *arena, unsigned char value )
+  {
+    std::vector<unsigned char *> v;
+    for ( unsigned int round = 0; round < 10; ++round )
+    {
+      for ( unsigned int i = 0; i < 10000; ++i )
+      {
+        const unsigned int size ( 1 + ( i % Usul::Memory::Arena::MAX_SIZE ) );
+        unsigned char *p ( static_cast < unsigned char * > ( arena->malloc ( size ) ) );
+        std::memset ( p, value, size );
+        v.push_back ( p );
+      }
+      for ( unsigned int i = 0; i < v.size(); ++i )
+      {
+        // Nobody else wrote into our memory.
+        ASSERT_EQ ( value, v[i][0] );
+        Usul::Memory::Arena::free ( v[i] );
+      }
+      v.clear();
+    }
+  }
+
+  void allocateAndFree ( Usul::Memory::Arena *arena, void **p )
+  {
+    *p = arena->malloc ( 32 );
+    Usul::Memory::Arena::free ( *p );
+  }
+
+  void allocateAndWait ( Usul::Memory::Arena *arena, boost::mutex *mutex )
+  {
+    Usul::Memory::Arena::free ( arena->malloc ( 32 ) );
+    boost::mutex::scoped_lock lock ( *mutex );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Freed memory is handed out again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Arena,Reuse)
+{
+  Usul::Memory::Arena::RefPtr arena ( new Usul::Memory::Arena );
+
+  void *a ( arena->malloc ( 40 ) );
+  Usul::Memory::Arena::free ( a );
+  void *b ( arena->malloc ( 48 ) );
+  ASSERT_EQ ( a, b );
+  Usul::Memory::Arena::free ( b );
+
+  // Same size class, so no more chunks are needed.
+  const Usul::Memory::Arena::SizeType reserved ( arena->bytesReserved() );
+  for ( unsigned int i = 0; i < 100000; ++i )
+  {
+    Usul::Memory::Arena::free ( arena->malloc ( 33 ) );
+  }
+  ASSERT_EQ ( reserved, arena->bytesReserved() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reset gives everything back.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Arena,Reset)
+{
+  Usul::Memory::Arena::RefPtr arena ( new Usul::Memory::Arena );
+
+  for ( unsigned int i = 0; i < 10000; ++i )
+  {
+    arena->malloc ( 24 );
+  }
+  ASSERT_TRUE ( arena->bytesReserved() > 0 );
+
+  arena->reset();
+  ASSERT_EQ ( 0u, arena->bytesReserved() );
+  ASSERT_TRUE ( 0x0 != arena->malloc ( 24 ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Several threads allocating and freeing at the same time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Arena,Threads)
+{
+  Usul::Memory::Arena::RefPtr arena ( new Usul::Memory::Arena );
+
+  boost::thread_group threads;
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    threads.create_thread ( boost::bind ( &churn, arena.get(), static_cast < unsigned char > ( i + 1 ) ) );
+  }
+  threads.join_all();
+
+  ASSERT_THROW ( arena->malloc ( Usul::Memory::Arena::MAX_SIZE + 1 ), std::invalid_argument );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A thread that ends gives the slots in its cache back.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Arena,ThreadEnded)
+{
+  Usul::Memory::Arena::RefPtr arena ( new Usul::Memory::Arena );
+
+  void *p ( 0x0 );
+  boost::thread thread ( boost::bind ( &allocateAndFree, arena.get(), &p ) );
+  thread.join();
+
+  // Without that, this thread would cut new slots and never see p again.
+  std::vector<void *> v;
+  for ( unsigned int i = 0; i < Usul::Memory::Arena::BATCH_SIZE; ++i )
+  {
+    v.push_back ( arena->malloc ( 32 ) );
+  }
+  ASSERT_TRUE ( v.end() != std::find ( v.begin(), v.end(), p ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A thread that ends after the arena is gone does not touch it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Arena,DeletedBeforeThreadEnded)
+{
+  Usul::Memory::Arena::RefPtr arena ( new Usul::Memory::Arena );
+
+  boost::mutex mutex;
+  boost::mutex::scoped_lock lock ( mutex );
+  boost::thread thread ( boost::bind ( &allocateAndWait, arena.get(), &mutex ) );
+
+  // Wait until the thread has a cache.
+  while ( 0 == arena->bytesReserved() )
+    boost::this_thread::yield();
+
+  arena = 0x0;
+  lock.unlock();
+  thread.join();
+}
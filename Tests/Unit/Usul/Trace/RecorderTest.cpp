@@ -0,0 +1,134 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Trace/Recorder.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <set>
+#include <sstream>
+
+typedef Usul::Trace::Recorder Recorder;
+
+
+namespace
+{
+  void recordEvents ( Recorder::Uint32 name, unsigned int count )
+  {
+    for ( unsigned int i = 0; i < count; ++i )
+    {
+      Recorder::record ( name, 1000 + i, 1010 + i );
+    }
+  }
+
+  void recordScopes ( unsigned int count )
+  {
+    for ( unsigned int i = 0; i < count; ++i )
+    {
+      USUL_TRACE_EVENT ( "recordScopes" );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Every thread's events are kept, under its own thread number.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Recorder,Threads)
+{
+  Recorder::clear();
+  Recorder::enabled ( true );
+
+  boost::thread_group threads;
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    threads.create_thread ( boost::bind ( &recordScopes, 1000 ) );
+  }
+  threads.join_all();
+
+  Recorder::enabled ( false );
+  recordScopes ( 10 );
+
+  Recorder::Events events;
+  Recorder::events ( events );
+  ASSERT_EQ ( 4000u, events.size() );
+
+  std::set < Recorder::Uint32 > numbers;
+  for ( Recorder::Events::const_iterator i = events.begin(); i != events.end(); ++i )
+  {
+    ASSERT_EQ ( "recordScopes", Recorder::name ( i->name ) );
+    numbers.insert ( i->thread );
+  }
+  ASSERT_EQ ( 4u, numbers.size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A full buffer keeps the newest events.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Recorder,Overflow)
+{
+  Recorder::clear();
+  const unsigned int capacity ( Recorder::capacity() );
+  Recorder::capacity ( 5 );
+  ASSERT_EQ ( 8u, Recorder::capacity() );
+
+  boost::thread thread ( boost::bind ( &recordEvents, Recorder::intern ( "overflow" ), 20 ) );
+  thread.join();
+  Recorder::capacity ( capacity );
+
+  Recorder::Events events;
+  Recorder::events ( events );
+  ASSERT_EQ ( 8u, events.size() );
+  for ( unsigned int i = 0; i < events.size(); ++i )
+  {
+    ASSERT_EQ ( 1012u + i, events[i].start );
+    ASSERT_EQ ( 10u, events[i].duration );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The JSON has one complete event per recorded one, with the name escaped.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(Recorder,Json)
+{
+  Recorder::clear();
+
+  boost::thread thread ( boost::bind ( &recordEvents, Recorder::intern ( "say \"hi\"" ), 3 ) );
+  thread.join();
+
+  std::ostringstream out;
+  Recorder::write ( out );
+  const std::string json ( out.str() );
+
+  ASSERT_EQ ( 0u, json.find ( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" ) );
+  ASSERT_NE ( std::string::npos, json.find ( "\"name\":\"say \\\"hi\\\"\"" ) );
+  ASSERT_NE ( std::string::npos, json.find ( "\"ts\":0,\"dur\":10" ) );
+
+  unsigned int count ( 0 );
+  for ( std::string::size_type i = json.find ( "\"ph\":\"X\"" ); std::string::npos != i; i = json.find ( "\"ph\":\"X\"", i + 1 ) )
+  {
+    ++count;
+  }
+  ASSERT_EQ ( 3u, count );
+}
@@ -0,0 +1,105 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "XmlTree/Node.h"
+
+#include "gtest/gtest.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <vector>
+
+
+namespace
+{
+  typedef XmlTree::Node Node;
+
+  // Make nodes with a few names and remember where the names are.
+  void makeNodes ( std::vector<const std::string *> &names )
+  {
+    for ( unsigned int i = 0; i < 1000; ++i )
+    {
+      Node::RefPtr node ( new Node ( ( 0 == i % 2 ) ? "even" : "odd" ) );
+      names.push_back ( &node->name() );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Nodes with the same name share it, also between threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(XmlTreeNodeTest,SharedNames)
+{
+  Node::RefPtr even ( new Node ( "even" ) );
+  Node::RefPtr odd ( new Node ( "odd" ) );
+  ASSERT_TRUE ( &even->name() != &odd->name() );
+
+  std::vector<const std::string *> names[4];
+  boost::thread_group threads;
+  for ( unsigned int i = 0; i < 4; ++i )
+    threads.create_thread ( boost::bind ( &makeNodes, boost::ref ( names[i] ) ) );
+  threads.join_all();
+
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    ASSERT_EQ ( 1000u, names[i].size() );
+    for ( unsigned int j = 0; j < names[i].size(); ++j )
+      ASSERT_TRUE ( names[i][j] == &( ( 0 == j % 2 ) ? even : odd )->name() );
+  }
+
+  // Renaming a node shares the name too.
+  odd->name ( "even" );
+  ASSERT_TRUE ( &even->name() == &odd->name() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The names are freed when the last node is deleted, and nodes made after
+//  that, in this thread and others, get names again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(XmlTreeNodeTest,ReleaseNames)
+{
+  Node::RefPtr node ( new Node ( "kept" ) );
+  Node::RefPtr other ( new Node ( "kept" ) );
+  ASSERT_TRUE ( &node->name() == &other->name() );
+
+  // One node is left, so the name stays.
+  node = 0x0;
+  ASSERT_EQ ( "kept", other->name() );
+  node = new Node ( "kept" );
+  ASSERT_TRUE ( &node->name() == &other->name() );
+
+  // This thread and others look the names up again.
+  node = 0x0;
+  other = 0x0;
+  node = new Node ( "kept" );
+  ASSERT_EQ ( "kept", node->name() );
+
+  std::vector<const std::string *> names;
+  boost::thread thread ( boost::bind ( &makeNodes, boost::ref ( names ) ) );
+  thread.join();
+
+  // Its nodes are gone, but this one kept the names alive.
+  other = new Node ( "even" );
+  ASSERT_TRUE ( names.front() == &other->name() );
+  ASSERT_EQ ( "kept", node->name() );
+  ASSERT_TRUE ( &node->name() != &other->name() );
+
+  // Nodes that live at the same time still share.
+  Node::RefPtr again ( new Node ( "even" ) );
+  ASSERT_TRUE ( &again->name() == &other->name() );
+}
@@ -0,0 +1,162 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "XmlTree/Loader.h"
+#include "XmlTree/Node.h"
+#include "XmlTree/StreamHandler.h"
+#include "XmlTree/XercesLife.h"
+
+#include "Usul/Strings/Format.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+  // Writes each call as a line, and asks for the elements with the given name.
+  struct Recorder : public XmlTree::StreamHandler
+  {
+    Recorder ( const std::string &wanted = std::string() ) : _wanted ( wanted ), calls()
+    {
+    }
+
+    virtual bool startElement ( const std::string &name, const Attributes &attributes, unsigned int depth )
+    {
+      Attributes::const_iterator i ( attributes.find ( "id" ) );
+      const std::string id ( ( attributes.end() == i ) ? std::string() : " id=" + i->second );
+      calls.push_back ( Usul::Strings::format ( "start ", name, id, " ", depth ) );
+      return ( name == _wanted );
+    }
+
+    virtual void text ( const std::string &value, unsigned int depth )
+    {
+      calls.push_back ( Usul::Strings::format ( "text ", value, " ", depth ) );
+    }
+
+    virtual void endElement ( const std::string &name, unsigned int depth )
+    {
+      calls.push_back ( Usul::Strings::format ( "end ", name, " ", depth ) );
+    }
+
+    virtual void subTree ( XmlTree::Node &node, unsigned int depth )
+    {
+      std::string children;
+      for ( XmlTree::Node::Children::const_iterator i = node.children().begin(); i != node.children().end(); ++i )
+        children += " " + (*i)->name() + "=" + (*i)->value();
+      calls.push_back ( Usul::Strings::format ( "subTree ", node.name(), children, " ", depth ) );
+    }
+
+    std::string _wanted;
+    std::vector < std::string > calls;
+  };
+
+  const std::string XML ( "<root>\n"
+                          "  <a id=\"1\">one</a>\n"
+                          "  <b>\n"
+                          "    <c>two</c>\n"
+                          "    <d>three</d>\n"
+                          "  </b>\n"
+                          "  <a id=\"2\"/>\n"
+                          "</root>\n" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Every element is given with its depth, and text that is only white
+//  space is not.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(StreamHandler,Elements)
+{
+  XmlTree::XercesLife life;
+  Recorder recorder;
+  XmlTree::Loader().parseFromMemory ( XML, recorder );
+
+  const char *expected[] =
+  {
+    "start root 1",
+    "start a id=1 2",
+    "text one 2",
+    "end a 2",
+    "start b 2",
+    "start c 3",
+    "text two 3",
+    "end c 3",
+    "start d 3",
+    "text three 3",
+    "end d 3",
+    "end b 2",
+    "start a id=2 2",
+    "end a 2",
+    "end root 1"
+  };
+  const unsigned int num ( sizeof ( expected ) / sizeof ( expected[0] ) );
+
+  ASSERT_EQ ( num, recorder.calls.size() );
+  for ( unsigned int i = 0; i < num; ++i )
+  {
+    EXPECT_EQ ( expected[i], recorder.calls[i] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  An element that is asked for is given whole, and what is inside of it is
+//  not given one element at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(StreamHandler,SubTree)
+{
+  XmlTree::XercesLife life;
+  Recorder recorder ( "b" );
+  XmlTree::Loader().parseFromMemory ( XML, recorder );
+
+  const char *expected[] =
+  {
+    "start root 1",
+    "start a id=1 2",
+    "text one 2",
+    "end a 2",
+    "start b 2",
+    "subTree b c=two d=three 2",
+    "start a id=2 2",
+    "end a 2",
+    "end root 1"
+  };
+  const unsigned int num ( sizeof ( expected ) / sizeof ( expected[0] ) );
+
+  ASSERT_EQ ( num, recorder.calls.size() );
+  for ( unsigned int i = 0; i < num; ++i )
+  {
+    EXPECT_EQ ( expected[i], recorder.calls[i] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Bad XML throws.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(StreamHandler,BadXml)
+{
+  XmlTree::XercesLife life;
+  Recorder recorder;
+  EXPECT_THROW ( XmlTree::Loader().parseFromMemory ( "<root><a></root>", recorder ), std::runtime_error );
+}
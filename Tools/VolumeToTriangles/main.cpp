@@ -1,126 +1,316 @@
 
-#include "vtkDiscreteMarchingCubes.h"
-#include "vtkTriangleFilter.h"
-#include "vtkBMPReader.h"
-#include "vtkTIFFReader.h"
-#include "vtkSTLWriter.h"
-#include "vtkSmartPointer.h"
-#include "vtkImageData.h"
-
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2006, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make a binary STL surface from a stack of TIFF slices.
+//
+//  Slices are read as the extractor needs them, so the stack does not have
+//  to fit in memory. The volume is padded with one empty value on every
+//  side so that the surface is closed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Algorithms/MarchingCubes.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Types/Types.h"
+
+#include <tiffio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
-const unsigned int xSize ( 1024 );
-const unsigned int ySize ( 884 );
-const unsigned int zSize ( 25 );
+typedef Usul::Types::Uint16 Value;
+typedef Usul::Algorithms::MarchingCubes < Value > MarchingCubes;
 
 const unsigned int start ( 1 );
+const unsigned int numSlices ( 25 );
+const double isoValue ( 127.5 );
 
 const std::string filepattern ( "D:\\adam\\models\\Yoonessi\\Claycomposites_April06_2006\\Segmentedimagesclaycomposite_April6th2006\\%03d.tif" );
 const std::string outfile ( "D:\\adam\\models\\Yoonessi\\Claycomposites_April06_2006\\Segmentedimagesclaycomposite_April6th2006\\model1.stl" );
 
-int main ( int argc, char **argv )
-{
-  vtkSmartPointer < vtkTIFFReader > reader ( vtkTIFFReader::New() );
-
-  reader->SetFilePattern ( filepattern.c_str() );
 
-  reader->SetDataExtent ( 0, xSize, 0, ySize, 0, zSize );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Open the slice's file.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-  reader->SetDataScalarTypeToUnsignedShort();
+namespace Detail
+{
+  struct Tiff
+  {
+    Tiff ( const std::string &pattern, unsigned int number ) : _tif ( 0x0 ), _name()
+    {
+      std::vector < char > name ( pattern.size() + 32 );
+      ::sprintf ( &name[0], pattern.c_str(), number );
+      _name = &name[0];
 
-  reader->SetFileNameSliceOffset( start );
+      _tif = ::TIFFOpen ( _name.c_str(), "r" );
+      if ( 0x0 == _tif )
+        throw std::runtime_error ( "Error 1837406625: Failed to open slice: " + _name );
+    }
 
-  reader->Update();
+    ~Tiff()
+    {
+      ::TIFFClose ( _tif );
+    }
 
-  vtkSmartPointer < vtkDiscreteMarchingCubes > surface ( vtkDiscreteMarchingCubes::New() );
-  surface->SetInput( reader->GetOutput() );
-  surface->SetValue ( 0, 255.0 );
-	surface->ComputeScalarsOff();
-	surface->ComputeNormalsOn();
-	surface->ComputeGradientsOff();
+    void size ( unsigned int &width, unsigned int &height ) const
+    {
+      uint32 w ( 0 ), h ( 0 );
+      ::TIFFGetField ( _tif, TIFFTAG_IMAGEWIDTH, &w );
+      ::TIFFGetField ( _tif, TIFFTAG_IMAGELENGTH, &h );
+      width = w;
+      height = h;
+    }
 
-  vtkSmartPointer < vtkTriangleFilter > triangles ( vtkTriangleFilter::New() );
-  triangles->SetInput(surface->GetOutput() );
+    TIFF *_tif;
+    std::string _name;
 
-  vtkSmartPointer < vtkSTLWriter > writer ( vtkSTLWriter::New() );
-  writer->SetInput( triangles->GetOutput() );
-  writer->SetFileTypeToBinary();
-  writer->SetFileName( outfile.c_str() ); 
-  writer->Write();
+  private:
 
-  return 0;
+    Tiff ( const Tiff & );
+    Tiff &operator = ( const Tiff & );
+  };
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reads the slices into the padded volume. Slice z of the volume is file
+//  z - 1; the first and last slices are empty.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-#if 0
-  /// Hack for larry drummy data.
-  vtkSmartPointer < vtkTIFFReader > reader ( vtkTIFFReader::New() );
+namespace Detail
+{
+  struct Reader
+  {
+    Reader ( const std::string &pattern, unsigned int first, unsigned int count, unsigned int width, unsigned int height ) :
+      _pattern ( pattern ), _first ( first ), _count ( count ), _width ( width ), _height ( height )
+    {
+    }
 
-  //reader->SetFilePrefix( "G:\\models\\DrummyTomoStack\\Stack_Close_FillHoles");
-  //reader->SetFileName ( "" );
-  reader->SetFilePattern ( "G:\\models\\DrummyTomoStack\\Stack_Close_FillHoles\\%2dm.tif" );
+    void operator () ( unsigned int z, std::vector < Value > &slice ) const
+    {
+      std::fill ( slice.begin(), slice.end(), Value ( 0 ) );
+      if ( 0 == z || z > _count )
+        return;
 
-  unsigned int xSize ( 834 );
-  unsigned int ySize ( 729 );
-  unsigned int zSize ( 46 );
+      Detail::Tiff tiff ( _pattern, _first + z - 1 );
 
-  reader->SetDataExtent ( 0, xSize, 0, ySize, 0, zSize );
+      unsigned int width ( 0 ), height ( 0 );
+      tiff.size ( width, height );
+      if ( width != _width || height != _height )
+        throw std::runtime_error ( "Error 2960017734: Slice is not the same size as the first: " + tiff._name );
 
-  reader->SetDataScalarTypeToUnsignedShort();
+      uint16 bits ( 8 ), samples ( 1 );
+      ::TIFFGetFieldDefaulted ( tiff._tif, TIFFTAG_BITSPERSAMPLE, &bits );
+      ::TIFFGetFieldDefaulted ( tiff._tif, TIFFTAG_SAMPLESPERPIXEL, &samples );
+      if ( ( 8 != bits && 16 != bits ) || 1 != samples )
+        throw std::runtime_error ( "Error 4119563650: Only 8 and 16 bit gray slices are supported: " + tiff._name );
 
-  reader->SetFileNameSliceOffset( 50 );
+      std::vector < unsigned char > row ( ::TIFFScanlineSize ( tiff._tif ) );
+      const unsigned int padded ( _width + 2 );
 
-  reader->Update();
-  
-  vtkImageData *temp ( reader->GetOutput() );
+      for ( unsigned int y = 0; y < _height; ++y )
+      {
+        if ( ::TIFFReadScanline ( tiff._tif, &row[0], y, 0 ) < 0 )
+          throw std::runtime_error ( "Error 3380527915: Failed to read slice: " + tiff._name );
+
+        Value *values ( &slice[( y + 1 ) * padded + 1] );
+        if ( 8 == bits )
+        {
+          for ( unsigned int x = 0; x < _width; ++x )
+            values[x] = row[x];
+        }
+        else
+        {
+          const uint16 *source ( reinterpret_cast < const uint16 * > ( &row[0] ) );
+          std::copy ( source, source + _width, values );
+        }
+      }
+    }
 
-  xSize += 2;
-  ySize += 2;
-  zSize += 2;
+    std::string _pattern;
+    unsigned int _first;
+    unsigned int _count;
+    unsigned int _width;
+    unsigned int _height;
+  };
+}
 
-  vtkImageData *image ( vtkImageData::New() );
-  image->SetSpacing ( 1.0, 1.0, 1.0 );
-  image->SetOrigin ( 0.0, 0.0, 0.0 );
-  image->SetDimensions ( xSize, ySize, zSize );
-  image->SetNumberOfScalarComponents(1);
-  image->SetScalarTypeToUnsignedChar();
-  image->AllocateScalars();
 
-  // Set the data to all zeros.
-  unsigned char *data = static_cast < unsigned char* > ( image->GetScalarPointer( ) );
-  ::memset ( data, 0,  xSize * ySize * zSize );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Writes the triangles to a binary STL file as they are made.
+//
+//  Only the vertices of the slices that triangles can still use are kept.
+//  The triangles come a layer at a time in slice order, and a layer uses
+//  the vertices of its two slices. So once a layer is written, the slices 
+//  before the one with its smallest index are not used again, and dropped.
+//  Indices are made local by subtracting the index of the first vertex kept.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-  // Create the final image.
-  for ( unsigned int x = 0; x < xSize - 2; ++x )
+namespace Detail
+{
+  struct StlWriter
   {
-    for ( unsigned int y = 0; y < ySize - 2; ++y )
+    StlWriter ( const std::string &file ) : _out ( file.c_str(), std::ios::binary ), _x(), _y(), _z(), _offset ( 0 ), _slices(), _count ( 0 )
     {
-      for ( unsigned int z = 0; z < zSize - 2; ++z )
+      if ( false == _out.is_open() )
+        throw std::runtime_error ( "Error 2291843707: Failed to open file for writing: " + file );
+
+      const std::vector < char > header ( 80, ' ' );
+      _out.write ( &header[0], header.size() );
+      _out.write ( reinterpret_cast < const char * > ( &_count ), sizeof ( _count ) );
+    }
+
+    void appendVertices ( const MarchingCubes::Coordinates &x, const MarchingCubes::Coordinates &y, const MarchingCubes::Coordinates &z )
+    {
+      _slices.push_back ( _offset + static_cast < MarchingCubes::Index > ( _x.size() ) );
+      _x.insert ( _x.end(), x.begin(), x.end() );
+      _y.insert ( _y.end(), y.begin(), y.end() );
+      _z.insert ( _z.end(), z.begin(), z.end() );
+    }
+
+    void appendTriangles ( const MarchingCubes::Indices &indices )
+    {
+      float facet[12];
+      const Usul::Types::Uint16 attributes ( 0 );
+      MarchingCubes::Index lowest ( std::numeric_limits < MarchingCubes::Index >::max() );
+
+      for ( unsigned int t = 0; t + 2 < indices.size(); t += 3 )
       {
-        unsigned char *tempData = static_cast < unsigned char* > ( temp->GetScalarPointer( x, y, z ) );
-        unsigned char *data = static_cast < unsigned char* > ( image->GetScalarPointer( x + 1, y + 1  , z + 1 ) );
-        
-        *data = 255 - *tempData;
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+          const MarchingCubes::Index i ( indices[t + c] - _offset );
+          lowest = std::min ( lowest, indices[t + c] );
+          facet[3 + c * 3 + 0] = _x[i];
+          facet[3 + c * 3 + 1] = _y[i];
+          facet[3 + c * 3 + 2] = _z[i];
+        }
+
+        const float ax ( facet[6] - facet[3] ), ay ( facet[7] - facet[4] ), az ( facet[8] - facet[5] );
+        const float bx ( facet[9] - facet[3] ), by ( facet[10] - facet[4] ), bz ( facet[11] - facet[5] );
+        float nx ( ay * bz - az * by ), ny ( az * bx - ax * bz ), nz ( ax * by - ay * bx );
+        const float length ( std::sqrt ( nx * nx + ny * ny + nz * nz ) );
+        if ( length > 0.0f )
+        {
+          nx /= length;
+          ny /= length;
+          nz /= length;
+        }
+        facet[0] = nx;
+        facet[1] = ny;
+        facet[2] = nz;
+
+        _out.write ( reinterpret_cast < const char * > ( facet ), sizeof ( facet ) );
+        _out.write ( reinterpret_cast < const char * > ( &attributes ), sizeof ( attributes ) );
       }
+
+      _count += static_cast < Usul::Types::Uint32 > ( indices.size() / 3 );
+
+      if ( false == indices.empty() )
+        this->_drop ( lowest );
+    }
+
+    // Write the number of triangles in the header.
+    void finish()
+    {
+      _out.seekp ( 80 );
+      _out.write ( reinterpret_cast < const char * > ( &_count ), sizeof ( _count ) );
+      _out.close();
     }
-  }
 
+    Usul::Types::Uint32 count() const { return _count; }
 
+  private:
 
-  Mesher model;
-  model.setUseDecimation ( false );
-  model.setDecimation ( 0.75 );
-  model.setUsePolygonSmoothing ( false );
-  model.setNumberIterations( 20 );
-  model.createModel( image );
+    // Drop the slices before the one with the vertex.
+    void _drop ( MarchingCubes::Index vertex )
+    {
+      while ( _slices.size() > 1 && _slices[1] <= vertex )
+        _slices.pop_front();
+
+      const MarchingCubes::Index first ( _slices.front() );
+      if ( first <= _offset )
+        return;
+
+      const MarchingCubes::Index num ( first - _offset );
+      _x.erase ( _x.begin(), _x.begin() + num );
+      _y.erase ( _y.begin(), _y.begin() + num );
+      _z.erase ( _z.begin(), _z.begin() + num );
+      _offset = first;
+    }
+
+    std::ofstream _out;
+    MarchingCubes::Coordinates _x;
+    MarchingCubes::Coordinates _y;
+    MarchingCubes::Coordinates _z;
+    MarchingCubes::Index _offset;
+    std::deque < MarchingCubes::Index > _slices;
+    Usul::Types::Uint32 _count;
+  };
+}
 
-  vtkSmartPointer < vtkSTLWriter > stlwriter ( vtkSTLWriter::New() );
-  stlwriter->SetInput( model.getData() );
-  stlwriter->SetFileTypeToBinary();
-  stlwriter->SetFileName( "G:\\models\\DrummyTomoStack\\Stack_Close_FillHoles\\model5.stl" ); 
-  stlwriter->Write();
 
-  system ( "pause" );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the surface. The arguments are the file pattern, the number of the
+//  first slice, the number of slices, the output file and the iso-value.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-#endif
\ No newline at end of file
+void _run ( int argc, char **argv )
+{
+  const std::string pattern ( ( argc > 1 ) ? argv[1] : filepattern );
+  const unsigned int first ( ( argc > 2 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[2] ) ) ) : start );
+  const unsigned int count ( ( argc > 3 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[3] ) ) ) : numSlices );
+  const std::string output ( ( argc > 4 ) ? argv[4] : outfile );
+  const double iso ( ( argc > 5 ) ? ::atof ( argv[5] ) : isoValue );
+
+  unsigned int width ( 0 ), height ( 0 );
+  {
+    Detail::Tiff tiff ( pattern, first );
+    tiff.size ( width, height );
+  }
+
+  MarchingCubes mc ( width + 2, height + 2, count + 2, iso );
+  Detail::StlWriter writer ( output );
+  mc ( Detail::Reader ( pattern, first, count, width, height ), writer );
+  writer.finish();
+
+  std::cout << "Wrote " << writer.count() << " triangles to " << output << std::endl;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Main function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+int main ( int argc, char **argv )
+{
+  Usul::Functions::safeCallV1V2 ( _run, argc, argv, "2473915406" );
+  return 0;
+}
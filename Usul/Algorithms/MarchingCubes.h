@@ -0,0 +1,648 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parallel marching cubes.
+//
+//  The volume is read one slice at a time, in blocks of slices, so only a
+//  block has to fit in memory. For each block the vertices on the grid
+//  edges are found one slice per task, then the triangles of the cells
+//  between slices are made one layer per task. Every edge's vertex is made
+//  once, by the slice that owns it, and the triangles on both sides of a
+//  slice look it up there, so there are no repeated vertices and the mesh
+//  is closed across slices and blocks. Vertices and triangles are given to
+//  the sink in slice order, so the answer does not depend on the number of
+//  threads.
+//
+//  The triangles of each cube case come from walking the cube's faces. An
+//  ambiguous face always keeps its inside corners apart, and both cubes of
+//  a face see it the same way, so there are no holes between cubes.
+//
+//  A slice reader is called as reader ( z, slice ) and fills the slice with
+//  the x-fastest values of slice z. It is called from several threads at
+//  once, with different slices.
+//
+//  A sink has appendVertices ( x, y, z ) and appendTriangles ( indices ).
+//  The triangles have three indices each, counting every vertex given to
+//  the sink before. The triangles face the lower values.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ALGORITHMS_MARCHING_CUBES_H_
+#define _USUL_ALGORITHMS_MARCHING_CUBES_H_
+
+#include "Usul/Algorithms/Parallel.h"
+#include "Usul/Types/Types.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Usul {
+namespace Algorithms {
+
+
+namespace Detail
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  The triangles of every cube case. Corner i is at ( i & 1, ( i >> 1 ) & 1,
+  //  ( i >> 2 ) & 1 ). Edges 0-3 point along x, 4-7 along y and 8-11 along z.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  class MarchingCubesTable
+  {
+  public:
+
+    enum { MAX_EDGES = 16 };
+
+    // The edges of the case's triangles, three per triangle, then -1.
+    const signed char *triangles ( unsigned int cube ) const { return _triangles[cube]; }
+
+    // The corners of the edge.
+    unsigned int corner ( unsigned int edge, unsigned int which ) const { return _corners[edge][which]; }
+
+    static const MarchingCubesTable &instance()
+    {
+      static MarchingCubesTable table;
+      return table;
+    }
+
+  private:
+
+    MarchingCubesTable()
+    {
+      const unsigned int corners[12][2] =
+      {
+        { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+        { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+      };
+
+      int edgeOf[8][8];
+      for ( unsigned int i = 0; i < 8; ++i )
+        std::fill ( edgeOf[i], edgeOf[i] + 8, -1 );
+
+      for ( unsigned int e = 0; e < 12; ++e )
+      {
+        _corners[e][0] = corners[e][0];
+        _corners[e][1] = corners[e][1];
+        edgeOf[corners[e][0]][corners[e][1]] = e;
+        edgeOf[corners[e][1]][corners[e][0]] = e;
+      }
+
+      // The corners of each face, counter-clockwise when seen from outside.
+      unsigned int faces[6][4];
+      for ( unsigned int axis = 0; axis < 3; ++axis )
+      {
+        const unsigned int a ( 1 << axis ), b ( 1 << ( ( axis + 1 ) % 3 ) ), c ( 1 << ( ( axis + 2 ) % 3 ) );
+        for ( unsigned int side = 0; side < 2; ++side )
+        {
+          unsigned int *face ( faces[axis * 2 + side] );
+          const unsigned int base ( ( 1 == side ) ? a : 0 );
+          face[0] = base;
+          face[1] = base + ( ( 1 == side ) ? b : c );
+          face[2] = base + b + c;
+          face[3] = base + ( ( 1 == side ) ? c : b );
+        }
+      }
+
+      // The faces that each edge is on.
+      unsigned int faceMask[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+      for ( unsigned int f = 0; f < 6; ++f )
+      {
+        for ( unsigned int k = 0; k < 4; ++k )
+          faceMask[edgeOf[faces[f][k]][faces[f][( k + 1 ) % 4]]] |= ( 1 << f );
+      }
+
+      for ( unsigned int cube = 0; cube < 256; ++cube )
+      {
+        // On each face, the crossing where the walk goes inside leads to
+        // the next crossing, where it goes out again.
+        int next[12];
+        std::fill ( next, next + 12, -1 );
+        for ( unsigned int f = 0; f < 6; ++f )
+        {
+          int crossings[4];
+          bool entering[4];
+          unsigned int count ( 0 );
+          for ( unsigned int k = 0; k < 4; ++k )
+          {
+            const unsigned int c0 ( faces[f][k] ), c1 ( faces[f][( k + 1 ) % 4] );
+            const bool in0 ( 0 != ( cube & ( 1 << c0 ) ) ), in1 ( 0 != ( cube & ( 1 << c1 ) ) );
+            if ( in0 != in1 )
+            {
+              crossings[count] = edgeOf[c0][c1];
+              entering[count] = in1;
+              ++count;
+            }
+          }
+          for ( unsigned int k = 0; k < count; ++k )
+          {
+            if ( true == entering[k] )
+              next[crossings[k]] = crossings[( k + 1 ) % count];
+          }
+        }
+
+        // Follow the crossings around each loop and make a fan of it.
+        bool used[12] = { false, false, false, false, false, false, false, false, false, false, false, false };
+        unsigned int size ( 0 );
+        for ( unsigned int e = 0; e < 12; ++e )
+        {
+          if ( -1 == next[e] || true == used[e] )
+            continue;
+
+          std::vector < int > loop;
+          for ( int i = e; false == used[i]; i = next[i] )
+          {
+            used[i] = true;
+            loop.push_back ( i );
+          }
+
+          // Start the fan where the fewest of its diagonals lie on a face.
+          // The cube on the other side of the face could have the same
+          // diagonal, and then four triangles would share it.
+          const unsigned int n ( static_cast < unsigned int > ( loop.size() ) );
+          unsigned int apex ( 0 ), fewest ( n );
+          for ( unsigned int a = 0; a < n; ++a )
+          {
+            unsigned int count ( 0 );
+            for ( unsigned int i = 2; i + 1 < n; ++i )
+              count += ( ( 0 != ( faceMask[loop[a]] & faceMask[loop[( a + i ) % n]] ) ) ? 1 : 0 );
+            if ( count < fewest )
+            {
+              fewest = count;
+              apex = a;
+            }
+          }
+
+          for ( unsigned int i = 1; i + 1 < n; ++i )
+          {
+            if ( size + 3 >= MAX_EDGES )
+              throw std::logic_error ( "Error 3061452783: Too many triangles in marching cubes case" );
+            _triangles[cube][size++] = static_cast < signed char > ( loop[apex] );
+            _triangles[cube][size++] = static_cast < signed char > ( loop[( apex + i ) % n] );
+            _triangles[cube][size++] = static_cast < signed char > ( loop[( apex + i + 1 ) % n] );
+          }
+        }
+        std::fill ( _triangles[cube] + size, _triangles[cube] + MAX_EDGES, -1 );
+      }
+    }
+
+    signed char _triangles[256][MAX_EDGES];
+    unsigned int _corners[12][2];
+  };
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  The vertices a slice owns: those on its x and y edges, and on the z
+  //  edges up to the next slice. Each kind is listed in row order by the
+  //  position of the edge's lower end.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  struct MarchingCubesSlice
+  {
+    typedef Usul::Types::Uint32 Index;
+    typedef std::vector < Index > Keys;
+    typedef std::vector < float > Coordinates;
+
+    void clear()
+    {
+      for ( unsigned int i = 0; i < 3; ++i )
+        keys[i].clear();
+      x.clear();
+      y.clear();
+      z.clear();
+    }
+
+    void swap ( MarchingCubesSlice &other )
+    {
+      for ( unsigned int i = 0; i < 3; ++i )
+        keys[i].swap ( other.keys[i] );
+      x.swap ( other.x );
+      y.swap ( other.y );
+      z.swap ( other.z );
+      std::swap ( offset, other.offset );
+    }
+
+    // The number of the edge's vertex, counting all that came before.
+    Index vertex ( unsigned int axis, Index key ) const
+    {
+      const Keys &k ( keys[axis] );
+      const Index local ( static_cast < Index > ( std::lower_bound ( k.begin(), k.end(), key ) - k.begin() ) );
+      Index before ( 0 );
+      for ( unsigned int i = 0; i < axis; ++i )
+        before += static_cast < Index > ( keys[i].size() );
+      return ( offset + before + local );
+    }
+
+    Keys keys[3];
+    Coordinates x;
+    Coordinates y;
+    Coordinates z;
+    Index offset;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Marching cubes over a volume of ValueType.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ValueType > class MarchingCubes
+{
+public:
+
+  typedef Usul::Types::Uint32 Index;
+  typedef std::vector < Index > Indices;
+  typedef std::vector < float > Coordinates;
+  typedef std::vector < ValueType > Slice;
+  typedef Detail::MarchingCubesSlice Vertices;
+  typedef Detail::MarchingCubesTable Table;
+
+  // An indexed mesh with its coordinates in separate arrays. It is a sink.
+  struct Mesh
+  {
+    void appendVertices ( const Coordinates &vx, const Coordinates &vy, const Coordinates &vz )
+    {
+      x.insert ( x.end(), vx.begin(), vx.end() );
+      y.insert ( y.end(), vy.begin(), vy.end() );
+      z.insert ( z.end(), vz.begin(), vz.end() );
+    }
+
+    void appendTriangles ( const Indices &i )
+    {
+      indices.insert ( indices.end(), i.begin(), i.end() );
+    }
+
+    Coordinates x;
+    Coordinates y;
+    Coordinates z;
+    Indices indices;
+  };
+
+  // Construction. The sizes are the number of values along each axis.
+  MarchingCubes ( unsigned int nx, unsigned int ny, unsigned int nz, double isoValue ) :
+    _nx ( nx ),
+    _ny ( ny ),
+    _nz ( nz ),
+    _isoValue ( isoValue ),
+    _blockSize ( 16 ),
+    _table ( Table::instance() )
+  {
+    _spacing[0] = _spacing[1] = _spacing[2] = 1.0f;
+    _origin[0] = _origin[1] = _origin[2] = 0.0f;
+
+    if ( static_cast < double > ( nx ) * static_cast < double > ( ny ) > static_cast < double > ( std::numeric_limits < Index >::max() ) )
+      throw std::invalid_argument ( "Error 1183542964: Slices are too big for marching cubes" );
+  }
+
+  // Set the distance between values, and where the first one is.
+  void spacing ( float x, float y, float z ) { _spacing[0] = x; _spacing[1] = y; _spacing[2] = z; }
+  void origin ( float x, float y, float z ) { _origin[0] = x; _origin[1] = y; _origin[2] = z; }
+
+  // Set/get the number of slices read at a time.
+  void blockSize ( unsigned int s ) { _blockSize = std::max ( 1u, s ); }
+  unsigned int blockSize() const { return _blockSize; }
+
+  // Make the surface. Returns false if the job was canceled.
+  template < class Reader, class Sink > bool operator () ( Reader reader, Sink &sink,
+                                                           Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ),
+                                                           Usul::Jobs::Manager &manager = Usul::Jobs::Manager::instance() ) const;
+
+private:
+
+  template < class Reader > struct ReadSlices;
+  struct MakeVertices;
+  struct MakeTriangles;
+  friend struct MakeVertices;
+  friend struct MakeTriangles;
+
+  void                    _makeVertices ( unsigned int z, const Slice &s0, const Slice *s1, Vertices &vertices ) const;
+  void                    _makeTriangles ( const Slice &s0, const Slice &s1, const Vertices &v0, const Vertices &v1, Indices &triangles ) const;
+
+  unsigned int _nx;
+  unsigned int _ny;
+  unsigned int _nz;
+  double _isoValue;
+  unsigned int _blockSize;
+  float _spacing[3];
+  float _origin[3];
+  const Table &_table;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Task functors. Window slot i holds slice ( first - 1 + i ).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ValueType > template < class Reader > struct MarchingCubes < ValueType >::ReadSlices
+{
+  ReadSlices ( Reader reader, std::vector < Slice > &window, unsigned int first ) :
+    _reader ( reader ), _window ( &window ), _first ( first )
+  {
+  }
+
+  void operator () ( unsigned int begin, unsigned int end )
+  {
+    for ( unsigned int z = begin; z < end; ++z )
+      _reader ( z, (*_window)[z - _first + 1] );
+  }
+
+  Reader _reader;
+  std::vector < Slice > *_window;
+  unsigned int _first;
+};
+
+template < class ValueType > struct MarchingCubes < ValueType >::MakeVertices
+{
+  MakeVertices ( const MarchingCubes &mc, const std::vector < Slice > &window, std::vector < Vertices > &vertices, unsigned int first ) :
+    _mc ( &mc ), _window ( &window ), _vertices ( &vertices ), _first ( first )
+  {
+  }
+
+  void operator () ( unsigned int begin, unsigned int end ) const
+  {
+    for ( unsigned int z = begin; z < end; ++z )
+    {
+      const unsigned int i ( z - _first + 1 );
+      const Slice *above ( ( z + 1 < _mc->_nz ) ? &(*_window)[i + 1] : 0x0 );
+      _mc->_makeVertices ( z, (*_window)[i], above, (*_vertices)[i] );
+    }
+  }
+
+  const MarchingCubes *_mc;
+  const std::vector < Slice > *_window;
+  std::vector < Vertices > *_vertices;
+  unsigned int _first;
+};
+
+template < class ValueType > struct MarchingCubes < ValueType >::MakeTriangles
+{
+  MakeTriangles ( const MarchingCubes &mc, const std::vector < Slice > &window, const std::vector < Vertices > &vertices, std::vector < Indices > &triangles, unsigned int first ) :
+    _mc ( &mc ), _window ( &window ), _vertices ( &vertices ), _triangles ( &triangles ), _first ( first )
+  {
+  }
+
+  void operator () ( unsigned int begin, unsigned int end ) const
+  {
+    for ( unsigned int z = begin; z < end; ++z )
+    {
+      const unsigned int i ( z + 1 - _first );
+      _mc->_makeTriangles ( (*_window)[i], (*_window)[i + 1], (*_vertices)[i], (*_vertices)[i + 1], (*_triangles)[i] );
+    }
+  }
+
+  const MarchingCubes *_mc;
+  const std::vector < Slice > *_window;
+  const std::vector < Vertices > *_vertices;
+  std::vector < Indices > *_triangles;
+  unsigned int _first;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Find the vertices that the slice owns.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ValueType >
+inline void MarchingCubes < ValueType >::_makeVertices ( unsigned int z, const Slice &s0, const Slice *s1, Vertices &vertices ) const
+{
+  vertices.clear();
+
+  // Each kind of edge is listed separately, then put together.
+  Coordinates position[3][3];
+  const double iso ( _isoValue );
+  const float pz ( _origin[2] + _spacing[2] * z );
+
+  for ( unsigned int y = 0; y < _ny; ++y )
+  {
+    const float py ( _origin[1] + _spacing[1] * y );
+    const Index row ( y * _nx );
+
+    for ( unsigned int x = 0; x < _nx; ++x )
+    {
+      const Index key ( row + x );
+      const double v ( static_cast < double > ( s0[key] ) );
+      const bool inside ( v >= iso );
+      const float px ( _origin[0] + _spacing[0] * x );
+
+      // Along x.
+      if ( x + 1 < _nx )
+      {
+        const double w ( static_cast < double > ( s0[key + 1] ) );
+        if ( inside != ( w >= iso ) )
+        {
+          const float t ( static_cast < float > ( ( iso - v ) / ( w - v ) ) );
+          vertices.keys[0].push_back ( key );
+          position[0][0].push_back ( px + t * _spacing[0] );
+          position[0][1].push_back ( py );
+          position[0][2].push_back ( pz );
+        }
+      }
+
+      // Along y.
+      if ( y + 1 < _ny )
+      {
+        const double w ( static_cast < double > ( s0[key + _nx] ) );
+        if ( inside != ( w >= iso ) )
+        {
+          const float t ( static_cast < float > ( ( iso - v ) / ( w - v ) ) );
+          vertices.keys[1].push_back ( key );
+          position[1][0].push_back ( px );
+          position[1][1].push_back ( py + t * _spacing[1] );
+          position[1][2].push_back ( pz );
+        }
+      }
+
+      // Along z, up to the next slice.
+      if ( 0x0 != s1 )
+      {
+        const double w ( static_cast < double > ( (*s1)[key] ) );
+        if ( inside != ( w >= iso ) )
+        {
+          const float t ( static_cast < float > ( ( iso - v ) / ( w - v ) ) );
+          vertices.keys[2].push_back ( key );
+          position[2][0].push_back ( px );
+          position[2][1].push_back ( py );
+          position[2][2].push_back ( pz + t * _spacing[2] );
+        }
+      }
+    }
+  }
+
+  for ( unsigned int axis = 0; axis < 3; ++axis )
+  {
+    vertices.x.insert ( vertices.x.end(), position[axis][0].begin(), position[axis][0].end() );
+    vertices.y.insert ( vertices.y.end(), position[axis][1].begin(), position[axis][1].end() );
+    vertices.z.insert ( vertices.z.end(), position[axis][2].begin(), position[axis][2].end() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the triangles of the cells between the two slices.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ValueType >
+inline void MarchingCubes < ValueType >::_makeTriangles ( const Slice &s0, const Slice &s1, const Vertices &v0, const Vertices &v1, Indices &triangles ) const
+{
+  triangles.clear();
+
+  const double iso ( _isoValue );
+  const Vertices *slices[2] = { &v0, &v1 };
+
+  for ( unsigned int y = 0; y + 1 < _ny; ++y )
+  {
+    for ( unsigned int x = 0; x + 1 < _nx; ++x )
+    {
+      const Index key ( y * _nx + x );
+      const Index keys[4] = { key, key + 1, key + _nx, key + _nx + 1 };
+
+      unsigned int cube ( 0 );
+      for ( unsigned int c = 0; c < 4; ++c )
+      {
+        cube |= ( ( static_cast < double > ( s0[keys[c]] ) >= iso ) ? 1u : 0u ) << c;
+        cube |= ( ( static_cast < double > ( s1[keys[c]] ) >= iso ) ? 1u : 0u ) << ( c + 4 );
+      }
+
+      if ( 0 == cube || 255 == cube )
+        continue;
+
+      for ( const signed char *e = _table.triangles ( cube ); *e >= 0; ++e )
+      {
+        // The edge's vertex belongs to the slice of its lower corner.
+        const unsigned int edge ( static_cast < unsigned int > ( *e ) );
+        const unsigned int corner ( _table.corner ( edge, 0 ) );
+        const Vertices &owner ( *slices[corner >> 2] );
+        triangles.push_back ( owner.vertex ( edge / 4, keys[corner & 3] ) );
+      }
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make the surface.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ValueType >
+template < class Reader, class Sink >
+inline bool MarchingCubes < ValueType >::operator () ( Reader reader, Sink &sink, Usul::Jobs::Job::RefPtr job, Usul::Jobs::Manager &manager ) const
+{
+  if ( _nx < 2 || _ny < 2 || _nz < 2 )
+    return true;
+
+  const Index sliceSize ( _nx * _ny );
+
+  // Slot 0 holds the last slice of the block before, and the vertices that
+  // it owns. The last slot holds the first slice of the next block.
+  std::vector < Slice > window ( _blockSize + 2 );
+  std::vector < Vertices > vertices ( _blockSize + 1 );
+  std::vector < Indices > triangles ( _blockSize + 1 );
+  Index numVertices ( 0 );
+
+  for ( unsigned int first = 0; first < _nz; first += _blockSize )
+  {
+    const unsigned int last ( std::min ( _nz, first + _blockSize ) );
+
+    // Read the slices that are not here yet.
+    const unsigned int firstRead ( ( 0 == first ) ? 0 : first + 1 );
+    const unsigned int lastRead ( std::min ( _nz, last + 1 ) );
+    for ( unsigned int z = firstRead; z < lastRead; ++z )
+      window[z - first + 1].resize ( sliceSize );
+    if ( false == Usul::Algorithms::parallelFor ( firstRead, lastRead, 1u, ReadSlices < Reader > ( reader, window, first ), job, manager ) )
+      return false;
+
+    // Find the vertices of the block's slices.
+    if ( false == Usul::Algorithms::parallelFor ( first, last, 1u, MakeVertices ( *this, window, vertices, first ), job, manager ) )
+      return false;
+
+    for ( unsigned int z = first; z < last; ++z )
+    {
+      Vertices &v ( vertices[z - first + 1] );
+      if ( static_cast < double > ( numVertices ) + v.x.size() > static_cast < double > ( std::numeric_limits < Index >::max() ) )
+        throw std::runtime_error ( "Error 2714368025: Too many vertices for marching cubes" );
+
+      v.offset = numVertices;
+      numVertices += static_cast < Index > ( v.x.size() );
+      sink.appendVertices ( v.x, v.y, v.z );
+    }
+
+    // Make the triangles between the slices that have their vertices.
+    const unsigned int firstLayer ( ( 0 == first ) ? 0 : first - 1 );
+    const unsigned int lastLayer ( last - 1 );
+    if ( false == Usul::Algorithms::parallelFor ( firstLayer, lastLayer, 1u, MakeTriangles ( *this, window, vertices, triangles, first ), job, manager ) )
+      return false;
+
+    for ( unsigned int z = firstLayer; z < lastLayer; ++z )
+      sink.appendTriangles ( triangles[z + 1 - first] );
+
+    // Keep the last slice and the one after it for the next block.
+    const unsigned int kept ( last - first );
+    window[0].swap ( window[kept] );
+    window[1].swap ( window[kept + 1] );
+    vertices[0].swap ( vertices[kept] );
+  }
+
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reads slices from layers of Usul::Containers::Array2D, or anything else
+//  with rows(), columns() and operator () ( row, column ). Rows are y.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Layers > struct MarchingCubesLayers
+{
+  MarchingCubesLayers ( const Layers &layers ) : _layers ( &layers )
+  {
+  }
+
+  template < class Slice > void operator () ( unsigned int z, Slice &slice ) const
+  {
+    const typename Layers::value_type &layer ( (*_layers)[z] );
+    const unsigned int rows ( layer.rows() ), columns ( layer.columns() );
+    for ( unsigned int r = 0; r < rows; ++r )
+    {
+      for ( unsigned int c = 0; c < columns; ++c )
+        slice[r * columns + c] = layer ( r, c );
+    }
+  }
+
+private:
+
+  const Layers *_layers;
+};
+
+
+} // namespace Algorithms
+} // namespace Usul
+
+
+#endif // _USUL_ALGORITHMS_MARCHING_CUBES_H_
@@ -0,0 +1,339 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Data-parallel loops that run on a job manager's thread pool.
+//
+//  The range [begin,end) is cut into chunks of "grain" indices. The calling
+//  thread and up to one helper job per pool thread take chunks until there
+//  are none left. The calling thread always takes part, so the loop finishes
+//  even when every pool thread is busy, including when it is called from
+//  inside a job on the same pool.
+//
+//  If a job is given then its canceled() state is checked once per chunk.
+//  The loops return false when they stopped because of that.
+//
+//  The first exception thrown by f stops the loop and is thrown again, with
+//  its own type, from the calling thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ALGORITHMS_PARALLEL_H_
+#define _USUL_ALGORITHMS_PARALLEL_H_
+
+#include "Usul/Exceptions/Canceled.h"
+#include "Usul/Jobs/Job.h"
+#include "Usul/Jobs/Manager.h"
+
+#include "boost/exception_ptr.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace Usul {
+namespace Algorithms {
+
+
+namespace Detail
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  State shared by the calling thread and the helper jobs. Helpers that
+  //  start after the loop is over only touch this, so it is ref-counted.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class IndexType, class Function > class ParallelForState
+  {
+  public:
+
+    typedef boost::shared_ptr < ParallelForState > Ptr;
+
+    ParallelForState ( IndexType begin, IndexType end, IndexType grain, Function f, Usul::Jobs::Job::RefPtr job ) :
+      _mutex(),
+      _done(),
+      _end ( end ),
+      _grain ( grain ),
+      _next ( begin ),
+      _f ( f ),
+      _job ( job ),
+      _running ( 0 ),
+      _canceled ( false ),
+      _error()
+    {
+    }
+
+    // Take chunks until there are none left.
+    void run()
+    {
+      IndexType first ( 0 ), last ( 0 );
+      while ( true == this->_claim ( first, last ) )
+      {
+        try
+        {
+          _f ( first, last );
+        }
+        catch ( const Usul::Exceptions::Canceled &e )
+        {
+          // Not every compiler can capture any type, so keep this one exactly.
+          this->_fail ( boost::copy_exception ( e ) );
+        }
+        catch ( ... )
+        {
+          this->_fail ( boost::current_exception() );
+        }
+        this->_release();
+      }
+    }
+
+    // Wait for chunks that are still running in other threads.
+    void wait()
+    {
+      boost::unique_lock<boost::mutex> lock ( _mutex );
+      while ( _running > 0 )
+        _done.wait ( lock );
+    }
+
+    bool canceled() const
+    {
+      boost::lock_guard<boost::mutex> lock ( _mutex );
+      return _canceled;
+    }
+
+    boost::exception_ptr error() const
+    {
+      boost::lock_guard<boost::mutex> lock ( _mutex );
+      return _error;
+    }
+
+  private:
+
+    bool _claim ( IndexType &first, IndexType &last )
+    {
+      boost::lock_guard<boost::mutex> lock ( _mutex );
+
+      if ( ( true == _canceled ) || ( boost::exception_ptr() != _error ) || ( _next >= _end ) )
+        return false;
+
+      // Once per chunk.
+      if ( ( true == _job.valid() ) && ( true == _job->canceled() ) )
+      {
+        _canceled = true;
+        return false;
+      }
+
+      first = _next;
+      last = ( ( _end - _next ) > _grain ) ? ( _next + _grain ) : _end;
+      _next = last;
+      ++_running;
+      return true;
+    }
+
+    void _release()
+    {
+      boost::lock_guard<boost::mutex> lock ( _mutex );
+      --_running;
+      if ( 0 == _running )
+        _done.notify_all();
+    }
+
+    void _fail ( const boost::exception_ptr &error )
+    {
+      boost::lock_guard<boost::mutex> lock ( _mutex );
+      if ( boost::exception_ptr() == _error )
+      {
+        _error = error;
+      }
+    }
+
+    mutable boost::mutex _mutex;
+    boost::condition_variable _done;
+    const IndexType _end;
+    const IndexType _grain;
+    IndexType _next;
+    Function _f;
+    Usul::Jobs::Job::RefPtr _job;
+    unsigned int _running;
+    bool _canceled;
+    boost::exception_ptr _error;
+  };
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Helper job that takes chunks from the shared state.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class StateType > class ParallelForJob : public Usul::Jobs::Job
+  {
+  public:
+
+    typedef Usul::Jobs::Job BaseClass;
+    typedef typename StateType::Ptr StatePtr;
+
+    ParallelForJob ( StatePtr state ) : BaseClass ( 0x0, false ), _state ( state )
+    {
+    }
+
+  protected:
+
+    virtual ~ParallelForJob()
+    {
+    }
+
+    virtual void _started()
+    {
+      _state->run();
+    }
+
+  private:
+
+    StatePtr _state;
+  };
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Writes each chunk's partial result into its own slot.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class IndexType, class T, class Function > struct ReduceChunk
+  {
+    ReduceChunk ( IndexType begin, IndexType grain, std::vector<T> &results, Function f ) :
+      _begin ( begin ),
+      _grain ( grain ),
+      _results ( &results ),
+      _f ( f )
+    {
+    }
+
+    void operator () ( IndexType first, IndexType last )
+    {
+      const std::size_t chunk ( static_cast < std::size_t > ( ( first - _begin ) / _grain ) );
+      _results->at ( chunk ) = _f ( first, last );
+    }
+
+  private:
+
+    IndexType _begin;
+    IndexType _grain;
+    std::vector<T> *_results;
+    Function _f;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Call f ( first, last ) for every chunk of [begin,end).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class IndexType, class Function >
+inline bool parallelFor ( IndexType begin, IndexType end, IndexType grain, Function f,
+                          Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ),
+                          Usul::Jobs::Manager &manager = Usul::Jobs::Manager::instance() )
+{
+  typedef Detail::ParallelForState < IndexType, Function > State;
+  typedef Detail::ParallelForJob < State > HelperJob;
+  typedef std::vector < Usul::Jobs::Job::RefPtr > Helpers;
+
+  if ( false == ( begin < end ) )
+    return true;
+
+  if ( grain < 1 )
+    grain = 1;
+
+  typename State::Ptr state ( new State ( begin, end, grain, f, job ) );
+
+  // One helper per pool thread at most. The calling thread does the rest.
+  const IndexType numChunks ( ( ( end - begin ) + ( grain - 1 ) ) / grain );
+  const unsigned int numHelpers ( static_cast < unsigned int > ( std::min < IndexType > ( numChunks - 1, static_cast < IndexType > ( manager.poolSize() ) ) ) );
+
+  Helpers helpers;
+  helpers.reserve ( numHelpers );
+  for ( unsigned int i = 0; i < numHelpers; ++i )
+  {
+    Usul::Jobs::Job::RefPtr helper ( new HelperJob ( state ) );
+    if ( true == job.valid() )
+      helper->priority ( job->priority() );
+    manager.addJob ( helper );
+    helpers.push_back ( helper );
+  }
+
+  // Do our share.
+  state->run();
+
+  // Helpers that have not started would find nothing to do.
+  for ( Helpers::iterator i = helpers.begin(); i != helpers.end(); ++i )
+  {
+    manager.removeQueuedJob ( *i );
+  }
+
+  // Chunks may still be running in the helpers that did start.
+  state->wait();
+
+  const boost::exception_ptr error ( state->error() );
+  if ( boost::exception_ptr() != error )
+    boost::rethrow_exception ( error );
+
+  return ( false == state->canceled() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Call f ( first, last ) for every chunk of [begin,end) and combine the
+//  returned values with combine ( a, b ). Partial results are combined in
+//  chunk order, so the answer does not depend on the number of threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class IndexType, class T, class Function, class Combine >
+inline bool parallelReduce ( IndexType begin, IndexType end, IndexType grain, const T &identity, Function f, Combine combine, T &answer,
+                             Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ),
+                             Usul::Jobs::Manager &manager = Usul::Jobs::Manager::instance() )
+{
+  typedef Detail::ReduceChunk < IndexType, T, Function > Chunk;
+
+  answer = identity;
+
+  if ( false == ( begin < end ) )
+    return true;
+
+  if ( grain < 1 )
+    grain = 1;
+
+  const IndexType numChunks ( ( ( end - begin ) + ( grain - 1 ) ) / grain );
+  std::vector<T> results ( static_cast < std::size_t > ( numChunks ), identity );
+
+  if ( false == Usul::Algorithms::parallelFor ( begin, end, grain, Chunk ( begin, grain, results, f ), job, manager ) )
+    return false;
+
+  for ( typename std::vector<T>::const_iterator i = results.begin(); i != results.end(); ++i )
+  {
+    answer = combine ( answer, *i );
+  }
+
+  return true;
+}
+
+
+} // namespace Algorithms
+} // namespace Usul
+
+
+#endif // _USUL_ALGORITHMS_PARALLEL_H_
@@ -0,0 +1,182 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parallel radix sort of unsigned integer keys.
+//
+//  Keys are sorted by the bits in [firstBit,lastBit), eight bits per pass,
+//  starting with the lowest. Each pass counts the digits of every chunk in
+//  parallel, then moves every chunk's keys in parallel to where the counts
+//  say. Chunks keep their order, so the sort is stable, and keys that have
+//  the same sorted bits stay in the order they were given.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ALGORITHMS_RADIX_SORT_H_
+#define _USUL_ALGORITHMS_RADIX_SORT_H_
+
+#include "Usul/Algorithms/Parallel.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace Usul {
+namespace Algorithms {
+
+
+namespace Detail
+{
+  const unsigned int RADIX_BITS ( 8 );
+  const unsigned int RADIX_SIZE ( 1 << RADIX_BITS );
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Count the digits of each chunk.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class KeyType > struct RadixCount
+  {
+    typedef std::vector < std::size_t > Counts;
+
+    RadixCount ( const std::vector<KeyType> &keys, std::size_t grain, unsigned int shift, KeyType mask, Counts &counts ) :
+      _keys ( &keys ), _grain ( grain ), _shift ( shift ), _mask ( mask ), _counts ( &counts )
+    {
+    }
+
+    void operator () ( std::size_t firstChunk, std::size_t lastChunk ) const
+    {
+      for ( std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk )
+      {
+        std::size_t *counts ( &(*_counts)[chunk * RADIX_SIZE] );
+        const std::size_t end ( std::min ( _keys->size(), ( chunk + 1 ) * _grain ) );
+        for ( std::size_t i = chunk * _grain; i < end; ++i )
+        {
+          ++counts[static_cast < std::size_t > ( ( (*_keys)[i] >> _shift ) & _mask )];
+        }
+      }
+    }
+
+  private:
+
+    const std::vector<KeyType> *_keys;
+    std::size_t _grain;
+    unsigned int _shift;
+    KeyType _mask;
+    Counts *_counts;
+  };
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Move each chunk's keys to where the counts say.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class KeyType > struct RadixScatter
+  {
+    typedef std::vector < std::size_t > Counts;
+
+    RadixScatter ( const std::vector<KeyType> &from, std::vector<KeyType> &to, std::size_t grain, unsigned int shift, KeyType mask, Counts &offsets ) :
+      _from ( &from ), _to ( &to ), _grain ( grain ), _shift ( shift ), _mask ( mask ), _offsets ( &offsets )
+    {
+    }
+
+    void operator () ( std::size_t firstChunk, std::size_t lastChunk ) const
+    {
+      for ( std::size_t chunk = firstChunk; chunk < lastChunk; ++chunk )
+      {
+        std::size_t *offsets ( &(*_offsets)[chunk * RADIX_SIZE] );
+        const std::size_t end ( std::min ( _from->size(), ( chunk + 1 ) * _grain ) );
+        for ( std::size_t i = chunk * _grain; i < end; ++i )
+        {
+          const KeyType key ( (*_from)[i] );
+          (*_to)[offsets[static_cast < std::size_t > ( ( key >> _shift ) & _mask )]++] = key;
+        }
+      }
+    }
+
+  private:
+
+    const std::vector<KeyType> *_from;
+    std::vector<KeyType> *_to;
+    std::size_t _grain;
+    unsigned int _shift;
+    KeyType _mask;
+    Counts *_offsets;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sort the keys by the bits in [firstBit,lastBit). Returns false if the
+//  job was canceled, in which case the keys are in no particular order.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class KeyType >
+inline bool radixSort ( std::vector<KeyType> &keys, unsigned int firstBit, unsigned int lastBit,
+                        Usul::Jobs::Job::RefPtr job = Usul::Jobs::Job::RefPtr ( 0x0 ),
+                        Usul::Jobs::Manager &manager = Usul::Jobs::Manager::instance() )
+{
+  typedef std::vector < std::size_t > Counts;
+
+  lastBit = std::min < unsigned int > ( lastBit, sizeof ( KeyType ) * 8 );
+  if ( ( keys.size() < 2 ) || ( firstBit >= lastBit ) )
+    return true;
+
+  // Enough chunks to keep the pool busy, but big enough that the counts
+  // are small next to the keys.
+  const std::size_t grain ( std::max < std::size_t > ( 64 * 1024, keys.size() / ( 4 * ( manager.poolSize() + 1 ) ) + 1 ) );
+  const std::size_t numChunks ( ( keys.size() + grain - 1 ) / grain );
+
+  std::vector<KeyType> buffer ( keys.size() );
+  Counts counts ( numChunks * Detail::RADIX_SIZE );
+
+  for ( unsigned int shift = firstBit; shift < lastBit; shift += Detail::RADIX_BITS )
+  {
+    const unsigned int bits ( std::min ( Detail::RADIX_BITS, lastBit - shift ) );
+    const KeyType mask ( static_cast < KeyType > ( ( 1u << bits ) - 1 ) );
+
+    std::fill ( counts.begin(), counts.end(), 0 );
+    if ( false == Usul::Algorithms::parallelFor ( std::size_t ( 0 ), numChunks, std::size_t ( 1 ), Detail::RadixCount<KeyType> ( keys, grain, shift, mask, counts ), job, manager ) )
+      return false;
+
+    // Turn the counts into where each chunk writes each digit. All of the
+    // smaller digits come first, then this digit of the earlier chunks.
+    std::size_t offset ( 0 );
+    for ( std::size_t digit = 0; digit < Detail::RADIX_SIZE; ++digit )
+    {
+      for ( std::size_t chunk = 0; chunk < numChunks; ++chunk )
+      {
+        std::size_t &count ( counts[chunk * Detail::RADIX_SIZE + digit] );
+        const std::size_t n ( count );
+        count = offset;
+        offset += n;
+      }
+    }
+
+    if ( false == Usul::Algorithms::parallelFor ( std::size_t ( 0 ), numChunks, std::size_t ( 1 ), Detail::RadixScatter<KeyType> ( keys, buffer, grain, shift, mask, counts ), job, manager ) )
+      return false;
+
+    keys.swap ( buffer );
+  }
+
+  return true;
+}
+
+
+} // namespace Algorithms
+} // namespace Usul
+
+
+#endif // _USUL_ALGORITHMS_RADIX_SORT_H_
@@ -0,0 +1,57 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Conditional compile configurations.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_DLL_CONFIG_H_
+#define _USUL_DLL_CONFIG_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Turn tracing on/off everywhere with this switch.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* #undef USUL_USE_TRACING */
+
+/* #undef USUL_USE_LOG_FILES */
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Have the job manager use the work-stealing thread pool.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/* #undef USUL_USE_WORK_STEALING_POOL */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Definitions to customize plugin file names.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef USUL_PLUGIN_EXTENSION_RELEASE
+#define USUL_PLUGIN_EXTENSION_RELEASE "plug"
+#endif // USUL_PLUGIN_EXTENSION_RELEASE
+
+#ifndef USUL_PLUGIN_EXTENSION_DEBUG
+#define USUL_PLUGIN_EXTENSION_DEBUG "plug"
+#endif // USUL_PLUGIN_EXTENSION_DEBUG
+
+#ifndef USUL_PLUGIN_POSTFIX_DEBUG
+#define USUL_PLUGIN_POSTFIX_DEBUG "d"
+#endif // USUL_PLUGIN_POSTFIX_DEBUG
+
+#endif // _USUL_DLL_CONFIG_H_
@@ -27,6 +27,15 @@
 
 #cmakedefine USUL_USE_LOG_FILES 1
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Have the job manager use the work-stealing thread pool.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#cmakedefine USUL_USE_WORK_STEALING_POOL 1
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Definitions to customize plugin file names.
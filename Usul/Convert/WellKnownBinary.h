@@ -24,6 +24,7 @@
 #include "Usul/MPL/SameType.h"
 #include "Usul/Strings/Format.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 
@@ -205,4 +206,67 @@ namespace Usul
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Conversion from line. Writes little-endian well-known-binary.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Usul
+{ 
+  namespace Convert
+  {
+    template <> struct Type < std::vector<Usul::Math::Vec2d>, std::vector<unsigned char> >
+    {
+      typedef std::vector<unsigned char> Blob;
+      typedef std::vector<Usul::Math::Vec2d> Line;
+      typedef Type < Line, Blob > ThisType;
+
+      enum
+      {
+        HEADER_BYTES = ( sizeof ( unsigned char ) + 2 * sizeof ( Usul::Types::Uint32 ) ),
+        LINE_TYPE = 2
+      };
+
+      static void convert ( const Line &from, Blob &to )
+      {
+        USUL_ASSERT_SAME_TYPE ( Usul::Types::Float64, Usul::Math::Vec2d::value_type );
+
+        const Usul::Types::Uint32 count ( static_cast < Usul::Types::Uint32 > ( from.size() ) );
+        to.resize ( ThisType::HEADER_BYTES + count * 2 * sizeof ( Usul::Types::Float64 ) );
+
+        unsigned char *bytes ( &to[0] );
+        *bytes = 1; ++bytes;
+
+        ThisType::_write ( bytes, static_cast < Usul::Types::Uint32 > ( ThisType::LINE_TYPE ) );
+        ThisType::_write ( bytes, count );
+
+        for ( Line::const_iterator i = from.begin(); i != from.end(); ++i )
+        {
+          ThisType::_write ( bytes, (*i)[0] );
+          ThisType::_write ( bytes, (*i)[1] );
+        }
+      }
+
+      static Blob convert ( const Line &from )
+      {
+        Blob to;
+        ThisType::convert ( from, to );
+        return to;
+      }
+
+    private:
+
+      template < class T > static void _write ( unsigned char *&bytes, T value )
+      {
+        Usul::Endian::FromSystemToLittle::convert ( value );
+        const unsigned char *start ( reinterpret_cast < const unsigned char * > ( &value ) );
+        std::copy ( start, start + sizeof ( T ), bytes );
+        bytes += sizeof ( T );
+      }
+    };
+  }
+}
+
+
 #endif // _USUL_CONVERT_WELL_KNOWN_BINARY_H_
@@ -17,15 +17,19 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Usul/Documents/Document.h"
+#include "Usul/Adaptors/MemberFunction.h"
 #include "Usul/Documents/Manager.h"
 #include "Usul/Exceptions/Canceled.h"
+#include "Usul/Functions/SafeCall.h"
 #include "Usul/Interfaces/ILoadFileDialog.h"
 #include "Usul/Interfaces/ISaveFileDialog.h"
 #include "Usul/Interfaces/IProgressBar.h"
 #include "Usul/Interfaces/IStatusBar.h"
 #include "Usul/Interfaces/IQuestion.h"
+#include "Usul/Interfaces/IScenePublished.h"
 #include "Usul/Interfaces/IUpdateGUI.h"
 #include "Usul/Jobs/Job.h"
+#include "Usul/Jobs/Manager.h"
 #include "Usul/Registry/Database.h"
 #include "Usul/Resources/TextWindow.h"
 #include "Usul/Threads/Safe.h"
@@ -65,7 +69,10 @@ Document::Document ( const std::string &type ) : BaseClass(),
   _delegate  (),
   _options   (),
   _modifiedObservers(),
-  _allowRequestRedraw ( true )
+  _allowRequestRedraw ( true ),
+  _loadJob(),
+  _loadBuildJob(),
+  _loadCaller()
 {
   this->fileValid ( false );
 }
@@ -229,6 +236,8 @@ Usul::Interfaces::IUnknown *Document::queryInterface ( unsigned long iid )
 
 void Document::open ( const std::string &file, Usul::Interfaces::IUnknown *caller, Unknown *progress )
 {
+  Usul::Trace::Recorder::Scope event ( ( true == Usul::Trace::Recorder::enabled() ) ? Usul::Trace::Recorder::intern ( "Open " + this->typeName() ) : 0 );
+
   this->clear();
   this->read ( file, caller, progress );
   this->fileName ( file );
@@ -237,6 +246,368 @@ void Document::open ( const std::string &file, Usul::Interfaces::IUnknown *calle
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The jobs that open the file for openAsync(). When the reading job stops,
+//  for any reason, the manager cancels the jobs after it, which do not get 
+//  a callback, so it also ends the load. A building job that is canceled 
+//  ends the load itself.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class Document::ReadJob : public Usul::Jobs::Job
+{
+public:
+
+  typedef Usul::Jobs::Job BaseClass;
+
+  ReadJob ( Document *document, const std::string &name, Unknown *caller ) : BaseClass ( caller ),
+    _document ( document ),
+    _name ( name ),
+    _caller ( caller )
+  {
+  }
+
+protected:
+
+  virtual ~ReadJob()
+  {
+  }
+
+  virtual void _started()
+  {
+    _document->_loadRead ( _name, _caller.get(), this->progress() );
+  }
+
+  virtual void _finished()
+  {
+    // It was canceled after the last check.
+    if ( true == this->canceled() )
+      _document->_loadDone ( true );
+  }
+
+  virtual void _cancelled()
+  {
+    _document->_loadDone ( true );
+  }
+
+  virtual void _error()
+  {
+    _document->_loadDone ( true );
+  }
+
+private:
+
+  Document::RefPtr _document;
+  std::string _name;
+  Unknown::RefPtr _caller;
+};
+
+class Document::BuildJob : public Usul::Jobs::Job
+{
+public:
+
+  typedef Usul::Jobs::Job BaseClass;
+
+  BuildJob ( Document *document, const std::string &name, Unknown *caller ) : BaseClass ( caller ),
+    _document ( document ),
+    _name ( name ),
+    _caller ( caller )
+  {
+  }
+
+protected:
+
+  virtual ~BuildJob()
+  {
+  }
+
+  virtual void _started()
+  {
+    // The reading failed before this job was added, so it was not cancelled.
+    if ( false == _document->loading() )
+    {
+      this->cancel();
+      return;
+    }
+
+    _document->_loadBuildAndFinish ( _name, _caller.get() );
+  }
+
+  virtual void _cancelled()
+  {
+    _document->_loadDone ( true );
+  }
+
+  virtual void _error()
+  {
+    _document->_loadDone ( true );
+  }
+
+private:
+
+  Document::RefPtr _document;
+  std::string _name;
+  Unknown::RefPtr _caller;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Open the file with jobs. Does what open() does, but the document's scene
+//  can be shown before it is done if the document publishes it. Cancelling
+//  the returned job cancels the rest.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Jobs::Job::RefPtr Document::openAsync ( const std::string &file, Unknown *caller, Usul::Jobs::Job::RefPtr finished, Usul::Jobs::Manager *manager )
+{
+  USUL_TRACE_SCOPE;
+
+  Usul::Jobs::Manager &jobs ( ( 0x0 != manager ) ? *manager : Usul::Jobs::Manager::instance() );
+
+  Usul::Jobs::Job::RefPtr read ( new Document::ReadJob ( this, file, caller ) );
+  Usul::Jobs::Job::RefPtr build ( new Document::BuildJob ( this, file, caller ) );
+
+  {
+    Guard guard ( this );
+    if ( true == _loadJob.valid() )
+      throw std::runtime_error ( "Error 1693248750: Document is already loading, cannot open: " + file );
+    _loadJob = read;
+    _loadBuildJob = build;
+    _loadCaller = caller;
+  }
+
+  // Make the chain before the first job can finish.
+  jobs.then ( read, build );
+  if ( true == finished.valid() )
+    jobs.then ( build, finished );
+  jobs.addJob ( read );
+
+  return read;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Clear and read the file. Called in the first job of openAsync().
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_loadRead ( const std::string &file, Unknown *caller, Unknown *progress )
+{
+  USUL_TRACE_SCOPE;
+  Usul::Trace::Recorder::Scope event ( ( true == Usul::Trace::Recorder::enabled() ) ? Usul::Trace::Recorder::intern ( "Read " + this->typeName() ) : 0 );
+
+  // Jobs that are canceled before they start still run.
+  this->checkLoadCanceled();
+
+  this->clear();
+  this->read ( file, caller, progress );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build and finish the open. Called in the second job of openAsync().
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_loadBuildAndFinish ( const std::string &file, Unknown *caller )
+{
+  USUL_TRACE_SCOPE;
+  Usul::Trace::Recorder::Scope event ( ( true == Usul::Trace::Recorder::enabled() ) ? Usul::Trace::Recorder::intern ( "Build " + this->typeName() ) : 0 );
+
+  this->checkLoadCanceled();
+  this->_loadBuild ( caller );
+
+  // Do not keep what was built if it was canceled while building.
+  this->checkLoadCanceled();
+
+  this->fileName ( file );
+  this->fileValid ( true );
+  this->modified ( false );
+
+  this->_loadDone ( false );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build the scene after reading. Default does nothing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_loadBuild ( Unknown * )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The load is done. Canceled loads do not keep what was read.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_loadDone ( bool canceled )
+{
+  USUL_TRACE_SCOPE;
+
+  {
+    Guard guard ( this );
+    if ( false == _loadJob.valid() )
+      return;
+  }
+
+  if ( true == canceled )
+  {
+    Usul::Functions::safeCallV1 ( Usul::Adaptors::memberFunction ( this, &Document::clear ), static_cast < Unknown * > ( 0x0 ), "2385126940" );
+  }
+
+  Usul::Functions::safeCallV1 ( Usul::Adaptors::memberFunction ( this, &Document::_loadFinished ), canceled, "4106921703" );
+
+  // Not loading anymore before anyone is told, so that they build the whole scene.
+  {
+    Guard guard ( this );
+    _loadJob = 0x0;
+    _loadBuildJob = 0x0;
+  }
+
+  this->_notifyScenePublished ( true );
+
+  {
+    Guard guard ( this );
+    _loadCaller = 0x0;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called when the load is done or canceled. Default does nothing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_loadFinished ( bool )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the document being loaded with openAsync()?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Document::loading() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _loadJob.valid();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel the load.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::cancelLoad()
+{
+  USUL_TRACE_SCOPE;
+
+  Usul::Jobs::Job::RefPtr read, build;
+  {
+    Guard guard ( this );
+    read = _loadJob;
+    build = _loadBuildJob;
+  }
+
+  if ( true == read.valid() )
+    read->cancel();
+  if ( true == build.valid() )
+    build->cancel();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Throw if the load was canceled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::checkLoadCanceled() const
+{
+  USUL_TRACE_SCOPE;
+
+  Usul::Jobs::Job::RefPtr read, build;
+  {
+    Guard guard ( this );
+    read = _loadJob;
+    build = _loadBuildJob;
+  }
+
+  if ( ( true == read.valid() ) && ( true == read->canceled() ) )
+    throw Usul::Exceptions::Canceled ( "Loading was canceled" );
+  if ( ( true == build.valid() ) && ( true == build->canceled() ) )
+    throw Usul::Exceptions::Canceled ( "Loading was canceled" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  There is more of the scene to show.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::publishScene()
+{
+  USUL_TRACE_SCOPE;
+  this->_notifyScenePublished ( false );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Tell the observers and the caller of openAsync() about the scene.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Document::_notifyScenePublished ( bool finished )
+{
+  USUL_TRACE_SCOPE;
+
+  typedef Usul::Interfaces::IScenePublished IScenePublished;
+  typedef std::vector < IScenePublished::RefPtr > Listeners;
+
+  Listeners listeners;
+  {
+    Guard guard ( this );
+    IScenePublished::QueryPtr listener ( _loadCaller.get() );
+    if ( true == listener.valid() )
+      listeners.push_back ( listener.get() );
+  }
+
+  {
+    ModifiedObservers::ValueType observers ( _modifiedObservers.getCopy() );
+    for ( ModifiedObservers::ValueType::iterator iter = observers.begin(); iter != observers.end(); ++iter )
+    {
+      IScenePublished::QueryPtr listener ( iter->get() );
+      if ( true == listener.valid() )
+        listeners.push_back ( listener.get() );
+    }
+  }
+
+  for ( Listeners::iterator i = listeners.begin(); i != listeners.end(); ++i )
+  {
+    (*i)->scenePublished ( this, finished );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Save the document to existing file name.
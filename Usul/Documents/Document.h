@@ -33,6 +33,7 @@
 #include "Usul/Interfaces/IModifiedObserver.h"
 #include "Usul/Interfaces/IRenderListener.h"
 #include "Usul/Interfaces/IRedraw.h"
+#include "Usul/Jobs/Job.h"
 #include "Usul/Pointers/Pointers.h"
 #include "Usul/Threads/Object.h"
 
@@ -43,6 +44,8 @@
 #include <iosfwd>
 #include <set>
 
+namespace Usul { namespace Jobs { class Manager; } }
+
 
 namespace Usul {
 namespace Documents {
@@ -118,6 +121,14 @@ public:
   /// Clear any existing data.
   virtual void                clear ( Unknown *caller = 0x0 ) = 0;
 
+  /// Cancel the load started with openAsync(), if any. Reading stops the
+  /// next time the reader checks.
+  void                        cancelLoad();
+
+  /// Throws Usul::Exceptions::Canceled if the load was canceled. Readers
+  /// call this between chunks. Does nothing for open().
+  void                        checkLoadCanceled() const;
+
   /// Close all referenced windows except one specified
   bool                        closeWindows( Unknown *caller = 0x0, const Window* skip = 0x0 );
 
@@ -156,6 +167,9 @@ public:
   /// Prompt user for documents to export.
   void                        exportDocument ( Unknown *caller = 0x0 );
 
+  /// Is the document being loaded with openAsync()?
+  bool                        loading() const;
+
 	/// Do we have this option?
   bool                        hasOption ( const std::string &key, const std::string &value ) const;
 
@@ -173,9 +187,17 @@ public:
   /// Open the file. Clears any data this document already has.
   void                        open ( const std::string &filename, Unknown *caller = 0x0, Unknown *progress = 0x0 );
 
+  /// Open the file with jobs: one reads, the next builds, and then the
+  /// given job, if any, runs. Returns the job that reads.
+  Usul::Jobs::Job::RefPtr     openAsync ( const std::string &filename, Unknown *caller = 0x0, Usul::Jobs::Job::RefPtr finished = Usul::Jobs::Job::RefPtr ( 0x0 ), Usul::Jobs::Manager *manager = 0x0 );
+
   /// Get the options
   Options                     options() const;
 
+  /// Tell the observers and the caller of openAsync() that there is more to
+  /// show. Readers call this from the loading thread between chunks.
+  void                        publishScene();
+
   /// Read the file and add it to existing document's data.
   virtual void                read ( const std::string &filename, Unknown *caller = 0x0, Unknown *progress = 0x0 ) = 0;
 
@@ -240,6 +262,13 @@ protected:
 
   std::string                 _getSaveAsFileName ( Unknown *caller = 0x0 );
 
+  /// Called by openAsync() after reading, in its own job. Overload to build
+  /// the scene off of the GUI thread. Default does nothing.
+  virtual void                _loadBuild ( Unknown *caller );
+
+  /// Called when the load started with openAsync() is done or canceled.
+  virtual void                _loadFinished ( bool canceled );
+
   void                        _save ( const std::string &filename, Unknown *caller, Unknown *progress, std::ostream *out = 0x0 );
 
   // Overload to sort the files before reading.
@@ -262,6 +291,15 @@ protected:
 
 private:
 
+  class ReadJob;
+  class BuildJob;
+
+  void                        _loadRead ( const std::string &filename, Unknown *caller, Unknown *progress );
+  void                        _loadBuildAndFinish ( const std::string &filename, Unknown *caller );
+  void                        _loadDone ( bool canceled );
+
+  void                        _notifyScenePublished ( bool finished );
+
   typedef Usul::Interfaces::IModifiedObserver::ValidRefPtr ModifiedObserverPtr;
   typedef std::set < ModifiedObserverPtr > ModifiedObserversSet;
   typedef Usul::Threads::Object<bool> AllowRequestRedraw;
@@ -275,6 +313,9 @@ private:
   Options _options;
   ModifiedObservers _modifiedObservers;
   AllowRequestRedraw _allowRequestRedraw;
+  Usul::Jobs::Job::RefPtr _loadJob;
+  Usul::Jobs::Job::RefPtr _loadBuildJob;
+  Unknown::RefPtr _loadCaller;
 };
 
 
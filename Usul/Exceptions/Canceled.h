@@ -40,7 +40,7 @@ public:
   Canceled ( const std::string &message ) : BaseClass(), _message ( message.empty() ? CANCELED_MESSAGE_STRING : message.c_str() )
   {
   }
-  Canceled ( const Canceled &e ) : BaseClass ( e )
+  Canceled ( const Canceled &e ) : BaseClass ( e ), _message ( e._message )
   {
   }
 
@@ -53,6 +53,7 @@ public:
   Canceled &operator = ( const Canceled &e )
   {
     BaseClass::operator = ( e );
+    _message = e._message;
     return *this;
   }
 
@@ -0,0 +1,110 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read-only memory map of a whole file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/File/MemoryMap.h"
+#include "Usul/File/Stats.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Trace/Trace.h"
+
+#include "boost/bind.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
+#include <stdexcept>
+
+using namespace Usul::File;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The mapping. Kept out of the header so that users do not need the
+//  interprocess headers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct MemoryMap::Impl
+{
+  Impl ( const std::string &file ) :
+    mapping ( file.c_str(), boost::interprocess::read_only ),
+    region()
+  {
+    // An empty file cannot be mapped, but it is not an error.
+    if ( Usul::File::size ( file ) > 0 )
+    {
+      boost::interprocess::mapped_region r ( mapping, boost::interprocess::read_only );
+      region.swap ( r );
+    }
+  }
+
+  boost::interprocess::file_mapping mapping;
+  boost::interprocess::mapped_region region;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MemoryMap::MemoryMap ( const std::string &file ) : BaseClass(),
+  _file  ( file ),
+  _impl  ( 0x0 ),
+  _begin ( 0x0 ),
+  _size  ( 0 )
+{
+  USUL_TRACE_SCOPE;
+
+  try
+  {
+    _impl = new Impl ( file );
+  }
+  catch ( const boost::interprocess::interprocess_exception &e )
+  {
+    throw std::runtime_error ( std::string ( "Error 1596043372: Failed to map file: " ) + file + ", " + e.what() );
+  }
+
+  _begin = static_cast < const char * > ( _impl->region.get_address() );
+  _size = static_cast < SizeType > ( _impl->region.get_size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MemoryMap::~MemoryMap()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( boost::bind ( &MemoryMap::_destroy, this ), "3290837155" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy this instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MemoryMap::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  delete _impl;
+  _impl = 0x0;
+  _begin = 0x0;
+  _size = 0;
+}
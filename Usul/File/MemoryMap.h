@@ -0,0 +1,83 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read-only memory map of a whole file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_FILE_MEMORY_MAP_CLASS_H_
+#define _USUL_FILE_MEMORY_MAP_CLASS_H_
+
+#include "Usul/Base/Referenced.h"
+#include "Usul/Pointers/Pointers.h"
+#include "Usul/Types/Types.h"
+
+#include <string>
+
+
+namespace Usul {
+namespace File {
+
+
+class USUL_EXPORT MemoryMap : public Usul::Base::Referenced
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Referenced BaseClass;
+  typedef Usul::Types::Uint64 SizeType;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( MemoryMap );
+
+  // Map the file. Throws if it cannot.
+  MemoryMap ( const std::string &file );
+
+  // Get the first byte, or null if the file is empty.
+  const char *          begin() const { return _begin; }
+  const char *          end() const { return _begin + _size; }
+
+  // Is the file empty?
+  bool                  empty() const { return ( 0 == _size ); }
+
+  // Get the file name.
+  const std::string &   file() const { return _file; }
+
+  // Get the number of bytes.
+  SizeType              size() const { return _size; }
+
+protected:
+
+  // Use reference counting.
+  virtual ~MemoryMap();
+
+private:
+
+  // No copying or assignment.
+  MemoryMap ( const MemoryMap & );
+  MemoryMap &operator = ( const MemoryMap & );
+
+  void                  _destroy();
+
+  struct Impl;
+
+  std::string _file;
+  Impl *_impl;
+  const char *_begin;
+  SizeType _size;
+};
+
+
+} // namespace File
+} // namespace Usul
+
+
+#endif // _USUL_FILE_MEMORY_MAP_CLASS_H_
@@ -0,0 +1,50 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Interface for the pieces of the scene that a document publishes while
+//  it loads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __USUL_INTERFACES_SCENE_CHUNKS_H__
+#define __USUL_INTERFACES_SCENE_CHUNKS_H__
+
+#include "Usul/Interfaces/IUnknown.h"
+
+namespace osg { class Node; }
+
+namespace Usul {
+namespace Interfaces {
+
+
+struct ISceneChunks : public Usul::Interfaces::IUnknown
+{
+  /// Smart-pointer definitions.
+  USUL_DECLARE_QUERY_POINTERS ( ISceneChunks );
+
+  /// Id for this interface.
+  enum { IID = 1560274839u };
+
+  /// Get the number of chunks published so far.
+  virtual unsigned int        numSceneChunks() const = 0;
+
+  /// Get the i'th chunk. Chunks do not change once published. They are let
+  /// go the first time the whole scene is built, after which this is null.
+  virtual osg::Node *         sceneChunk ( unsigned int i ) = 0;
+
+}; // struct ISceneChunks
+
+
+} // end namespace Interfaces
+} // end namespace Usul
+
+
+#endif // __USUL_INTERFACES_SCENE_CHUNKS_H__
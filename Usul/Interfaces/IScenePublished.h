@@ -0,0 +1,46 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Interface for being told that a loading document has more to show.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __USUL_INTERFACES_SCENE_PUBLISHED_H__
+#define __USUL_INTERFACES_SCENE_PUBLISHED_H__
+
+#include "Usul/Interfaces/IUnknown.h"
+
+namespace Usul { namespace Documents { class Document; } }
+
+namespace Usul {
+namespace Interfaces {
+
+
+struct IScenePublished : public Usul::Interfaces::IUnknown
+{
+  /// Smart-pointer definitions.
+  USUL_DECLARE_QUERY_POINTERS ( IScenePublished );
+
+  /// Id for this interface.
+  enum { IID = 2847130596u };
+
+  /// Called from the loading thread. The finished flag is set once, when the
+  /// load is done or canceled, after which the whole scene can be built.
+  virtual void                scenePublished ( Usul::Documents::Document *document, bool finished ) = 0;
+
+}; // struct IScenePublished
+
+
+} // end namespace Interfaces
+} // end namespace Usul
+
+
+#endif // __USUL_INTERFACES_SCENE_PUBLISHED_H__
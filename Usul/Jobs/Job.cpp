@@ -23,7 +23,16 @@
 #include "Usul/Threads/ThreadId.h"
 #include "Usul/Trace/Trace.h"
 
+#include "boost/thread/mutex.hpp"
+
+#ifdef __GNUC__
+# include <cxxabi.h>
+# include <cstdlib>
+#endif
+
+#include <map>
 #include <stdexcept>
+#include <typeinfo>
 
 using namespace Usul::Jobs;
 
@@ -41,9 +50,12 @@ Job::Job ( Usul::Interfaces::IUnknown *caller, bool showProgressBar ) : BaseClas
   _id          ( 0 ),
   _done        ( false ),
   _canceled    ( false ),
+  _failed      ( false ),
   _progress    ( static_cast < ProgressBar * > ( 0x0 ) ),
   _label       ( static_cast < StatusBar  * > ( 0x0 ) ),
-  _priority    ( 0 )
+  _priority    ( 0 ),
+  _successors  (),
+  _numPredecessors ( 0 )
 {
   USUL_TRACE_SCOPE;
 
@@ -176,6 +188,10 @@ void Job::_cancelled()
 void Job::_threadError()
 {
   USUL_TRACE_SCOPE;
+  {
+    Guard guard ( this );
+    _failed = true;
+  }
   ScopedDone done ( *this, true );
   this->_error();
 }
@@ -227,6 +243,62 @@ void Job::_finished()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper function to return the recorded name for the type. The name is
+//  demangled and interned the first time, and found by the type's name
+//  pointer after that.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Usul
+{
+  namespace Jobs
+  {
+    namespace Helper
+    {
+      inline std::string demangle ( const char *s )
+      {
+#ifdef __GNUC__
+        std::string result ( s );
+
+        int status ( -1 );
+        char *demangledName ( abi::__cxa_demangle ( s, 0x0, 0x0, &status ) );
+        if ( 0 == status && 0x0 != demangledName )
+        {
+          result = std::string ( demangledName );
+          ::free ( demangledName );
+        }
+
+        return result;
+
+#else
+        return std::string ( s );
+#endif
+      }
+
+      typedef std::map < const char *, Usul::Types::Uint32 > Names;
+      static boost::mutex namesMutex;
+      static Names names;
+
+      inline Usul::Types::Uint32 typeName ( const std::type_info &type )
+      {
+        const char *key ( type.name() );
+        boost::mutex::scoped_lock lock ( namesMutex );
+
+        Names::const_iterator i ( names.find ( key ) );
+        if ( names.end() != i )
+          return i->second;
+
+        const Usul::Types::Uint32 id ( Usul::Trace::Recorder::intern ( Helper::demangle ( key ) ) );
+        names.insert ( Names::value_type ( key, id ) );
+        return id;
+      }
+    }
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Called when the thread starts.
@@ -240,6 +312,10 @@ void Job::_threadStarted()
   if ( true == this->canceled() )
     this->cancel();
 
+  // Record the time the job runs under its type, because names can be 
+  // anything. Only look up the name when recording.
+  Usul::Trace::Recorder::Scope event ( ( true == Usul::Trace::Recorder::enabled() ) ? Helper::typeName ( typeid ( *this ) ) : 0 );
+
   this->_started();
 }
 
@@ -270,6 +346,24 @@ void Job::_setDone ( bool done )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Did the job have an error, or say that it did not succeed?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Job::_hasFailed() const
+{
+  USUL_TRACE_SCOPE;
+  {
+    Guard guard ( this );
+    if ( true == _failed )
+      return true;
+  }
+  return ( false == this->success() );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Cancel this job.
@@ -23,6 +23,7 @@
 #include "Usul/Interfaces/ICanceledStateGet.h"
 
 #include <iosfwd>
+#include <vector>
 
 namespace Usul { namespace Jobs { class Manager; } }
 namespace Usul { namespace Jobs { namespace Detail { class Task; } } }
@@ -52,6 +53,9 @@ public:
   // Smart-pointer definitions.
   USUL_DECLARE_REF_POINTERS ( Job );
 
+  // Jobs that are waiting on this one.
+  typedef std::vector < Job::RefPtr > Successors;
+
   // Usul::Interfaces::IUnknown members.
   USUL_DECLARE_IUNKNOWN_MEMBERS;
 
@@ -120,6 +124,8 @@ private:
 
   void                      _destroy();
 
+  bool                      _hasFailed() const;
+
   void                      _setDone ( bool );
 
   void                      _threadCancelled();
@@ -135,9 +141,14 @@ private:
   unsigned long _id;
   bool _done;
   bool _canceled;
+  bool _failed;
   ProgressBar::QueryPtr _progress;
   StatusBar::QueryPtr   _label;
   int _priority;
+
+  // Dependency graph. Guarded by the job manager's mutex, not this job's.
+  Successors _successors;
+  unsigned int _numPredecessors;
 };
 
 
@@ -58,11 +58,13 @@ namespace Usul
         typedef Usul::Threads::Task BaseClass;
 
         Task ( Usul::Jobs::Job *job, Manager* manager ) : 
-        BaseClass ( job->id(), boost::bind ( &Job::_threadStarted, job ), Task::Callback(), boost::bind ( &Job::_threadCancelled, job ), boost::bind ( &Job::_threadError, job ) ), 
+        BaseClass ( job->id(), boost::bind ( &Job::_threadStarted, job ), Task::Callback(), Task::Callback(), Task::Callback() ), 
           _job ( job ),
           _manager ( manager )
         {
           _finishedCB = boost::bind ( &Task::_taskFinished, this );
+          _cancelledCB = boost::bind ( &Task::_taskCancelled, this );
+          _errorCB = boost::bind ( &Task::_taskError, this );
 
           BaseClass::name ( ( true == _job.valid() ) ? _job->name() : std::string() );
         }
@@ -91,6 +93,30 @@ namespace Usul
           _finishedCB = Task::Callback();
         }
 
+        void _taskCancelled()
+        {
+          if ( _job.valid() )
+            _job->_threadCancelled();
+
+          // Jobs waiting on this one will never run.
+          if ( 0x0 != _manager )
+            _manager->_jobCancelled ( _job );
+
+          _cancelledCB = Task::Callback();
+        }
+
+        void _taskError()
+        {
+          if ( _job.valid() )
+            _job->_threadError();
+
+          // Jobs waiting on this one will never run.
+          if ( 0x0 != _manager )
+            _manager->_jobCancelled ( _job );
+
+          _errorCB = Task::Callback();
+        }
+
       private:
 
         Usul::Jobs::Job::RefPtr _job;
@@ -110,6 +136,8 @@ namespace Usul
 Manager::Manager ( const std::string &name, unsigned int poolSize ) :
   _mutex     (),
   _pool      ( name, poolSize ),
+  _graphMutex(),
+  _waiting   (),
   _log       ( 0x0 )
 #if BOOST_VERSION >= 103900
   , _jobFinishedListeners()
@@ -188,6 +216,9 @@ void Manager::_destroy()
   USUL_TRACE_SCOPE;
   Guard guard ( this );
   _log = 0x0;
+
+  Guard graphGuard ( _graphMutex );
+  _waiting.clear();
 }
 
 
@@ -204,13 +235,111 @@ void Manager::addJob ( Job::RefPtr job )
   if ( true == job.valid() )
   {
     job->_setId ( this->nextJobId() );
-    Usul::Jobs::Detail::Task::RefPtr task ( new Usul::Jobs::Detail::Task ( job.get(), this ) );
+    this->_dispatch ( job );
+  }
+}
 
-    this->_logEvent ( "Adding job", job );
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a job that starts after all of the given jobs have finished.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::addJob ( Job::RefPtr job, const Jobs &predecessors )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( false == job.valid() )
+    return;
+
+  job->_setId ( this->nextJobId() );
+
+  bool cancelled ( false );
+  {
+    // The graph is only changed while this is locked, so a predecessor
+    // that is not done yet will see this job when it finishes.
+    Guard guard ( _graphMutex );
+
+    unsigned int count ( 0 );
+    for ( Jobs::const_iterator i = predecessors.begin(); i != predecessors.end(); ++i )
     {
-      Guard guard ( this );
-      _pool.addTask ( job->priority(), task.get() );
+      Job::RefPtr predecessor ( *i );
+      if ( ( false == predecessor.valid() ) || ( job == predecessor ) )
+        continue;
+
+      // One that was cancelled or failed already cancels this job, the same
+      // as when that happens after this job is added.
+      if ( ( true == predecessor->canceled() ) || ( ( true == predecessor->isDone() ) && ( true == predecessor->_hasFailed() ) ) )
+      {
+        cancelled = true;
+        break;
+      }
+
+      if ( false == predecessor->isDone() )
+      {
+        predecessor->_successors.push_back ( job );
+        ++count;
+      }
     }
+
+    if ( false == cancelled )
+    {
+      job->_numPredecessors = count;
+      if ( count > 0 )
+      {
+        this->_logEvent ( "Job is waiting on other jobs", job );
+        _waiting.insert ( job );
+        return;
+      }
+    }
+  }
+
+  if ( true == cancelled )
+  {
+    this->_logEvent ( "Predecessor was cancelled, cancelling job", job );
+    job->cancel();
+    job->_threadCancelled();
+    this->_jobCancelled ( job );
+    return;
+  }
+
+  this->_dispatch ( job );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the continuation so that it starts after the job finishes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Job::RefPtr Manager::then ( Job::RefPtr job, Job::RefPtr continuation )
+{
+  USUL_TRACE_SCOPE;
+  this->addJob ( continuation, Jobs ( 1, job ) );
+  return continuation;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Give the job to the thread pool.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::_dispatch ( Job::RefPtr job )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( true == job.valid() )
+  {
+    Usul::Jobs::Detail::Task::RefPtr task ( new Usul::Jobs::Detail::Task ( job.get(), this ) );
+
+    // No need to lock, the pool is thread-safe. This is also called from
+    // the pool's threads when a job's predecessors finish.
+    this->_logEvent ( "Adding job", job );
+    _pool.addTask ( job->priority(), task.get() );
     this->_logEvent ( "Done adding job", job );
   }
 }
@@ -228,11 +357,25 @@ void Manager::removeQueuedJob ( Job::RefPtr job )
 
   if ( true == job.valid() )
   {
-    Usul::Threads::Pool::TaskHandle task ( job->priority(), job->id() );
+    ThreadPool::TaskHandle task ( job->priority(), job->id() );
     this->_logEvent ( "Removing queued job", job );
+    bool removed ( false );
     {
       Guard guard ( this );
-      _pool.removeQueuedTask ( task );
+      removed = _pool.removeQueuedTask ( task );
+    }
+    {
+      Guard guard ( _graphMutex );
+      removed = ( ( _waiting.erase ( job ) > 0 ) || removed );
+    }
+
+    // Otherwise, anyone waiting for it to be done waits forever. It says it
+    // was canceled before it says it is done, like the others that never run.
+    if ( true == removed )
+    {
+      job->cancel();
+      job->_threadCancelled();
+      this->_jobCancelled ( job );
     }
     this->_logEvent ( "Done removing queued job", job );
   }
@@ -276,10 +419,10 @@ void Manager::wait()
 {
   USUL_TRACE_SCOPE;
   this->_logEvent ( "Waiting for tasks... " );
-  {
-    Guard guard ( this );
-    _pool.waitForTasks();
-  }
+
+  // Do not lock here. Jobs that finish may add their successors.
+  _pool.waitForTasks();
+
   this->_logEvent ( "Done waiting for tasks" );
 }
 
@@ -312,6 +455,7 @@ void Manager::cancel()
     Guard guard ( this );
     _pool.cancel();
   }
+  this->_cancelWaiting();
   this->_logEvent ( "Done canceling thread pool" );
 }
 
@@ -331,6 +475,7 @@ void Manager::cancel ( Job::RefPtr job )
     this->removeQueuedJob ( job );
     this->_logEvent ( "Canceling job", job );
     job->cancel();
+    this->_cancelSuccessors ( job );
     this->_logEvent ( "Done canceling job", job );
   }
 }
@@ -352,10 +497,40 @@ void Manager::clearQueuedJobs()
     Guard guard ( this );
     _pool.clearQueuedTasks();
   }
+  this->_cancelWaiting();
   this->_logEvent ( "Done clearing queued tasks" );
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel the jobs that are waiting on other jobs. They are done once this
+//  returns, so nothing waits for them forever.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::_cancelWaiting()
+{
+  USUL_TRACE_SCOPE;
+
+  Jobs waiting;
+  {
+    Guard guard ( _graphMutex );
+    waiting.assign ( _waiting.begin(), _waiting.end() );
+    _waiting.clear();
+  }
+
+  for ( Jobs::iterator i = waiting.begin(); i != waiting.end(); ++i )
+  {
+    Job::RefPtr job ( *i );
+    this->_logEvent ( "Cancelling waiting job", job );
+    job->cancel();
+    job->_threadCancelled();
+    this->_jobCancelled ( job );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Number of jobs queued.
@@ -366,7 +541,8 @@ unsigned int Manager::numJobsQueued() const
 {
   USUL_TRACE_SCOPE;
   Guard guard ( this );
-  return _pool.numTasksQueued();
+  Guard graphGuard ( _graphMutex );
+  return ( _pool.numTasksQueued() + _waiting.size() );
 }
 
 
@@ -425,6 +601,97 @@ void Manager::_jobFinished ( Job::RefPtr job )
 #if BOOST_VERSION >= 103900
   _jobFinishedListeners ( job.get() );
 #endif
+
+  if ( false == job.valid() )
+    return;
+
+  // A job that noticed it was cancelled, or that failed, still returns
+  // normally.
+  if ( ( true == job->canceled() ) || ( true == job->_hasFailed() ) )
+  {
+    this->_cancelSuccessors ( job );
+    return;
+  }
+
+  // Find the jobs that were only waiting on this one.
+  Jobs ready;
+  {
+    Guard guard ( _graphMutex );
+    Job::Successors successors;
+    successors.swap ( job->_successors );
+    for ( Job::Successors::iterator i = successors.begin(); i != successors.end(); ++i )
+    {
+      Job::RefPtr successor ( *i );
+      if ( successor->_numPredecessors > 0 )
+      {
+        --successor->_numPredecessors;
+        if ( ( 0 == successor->_numPredecessors ) && ( _waiting.erase ( successor ) > 0 ) )
+        {
+          ready.push_back ( successor );
+        }
+      }
+    }
+  }
+
+  // Start them.
+  for ( Jobs::iterator i = ready.begin(); i != ready.end(); ++i )
+  {
+    this->_logEvent ( "Predecessors finished, starting job", *i );
+    this->_dispatch ( *i );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A job was cancelled or had an error.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::_jobCancelled ( Job::RefPtr job )
+{
+  USUL_TRACE_SCOPE;
+  this->_cancelSuccessors ( job );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel everything downstream of the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::_cancelSuccessors ( Job::RefPtr job )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( false == job.valid() )
+    return;
+
+  // Only the ones still waiting are cancelled here. The others were already
+  // cancelled through another predecessor, or by clearing the queue.
+  Jobs cancelled;
+  {
+    Guard guard ( _graphMutex );
+    Job::Successors successors;
+    successors.swap ( job->_successors );
+    for ( Job::Successors::iterator i = successors.begin(); i != successors.end(); ++i )
+    {
+      if ( _waiting.erase ( *i ) > 0 )
+      {
+        cancelled.push_back ( *i );
+      }
+    }
+  }
+
+  for ( Jobs::iterator i = cancelled.begin(); i != cancelled.end(); ++i )
+  {
+    Job::RefPtr successor ( *i );
+    this->_logEvent ( "Predecessor cancelled, cancelling job", successor );
+    successor->cancel();
+    successor->_threadCancelled();
+    this->_jobCancelled ( successor );
+  }
 }
 
 
@@ -16,17 +16,20 @@
 #ifndef _USUL_JOBS_JOB_MANAGER_CLASS_H_
 #define _USUL_JOBS_JOB_MANAGER_CLASS_H_
 
+#include "Usul/Config/Config.h"
 #include "Usul/File/Log.h"
 #include "Usul/Jobs/Job.h"
 #include "Usul/Threads/RecursiveMutex.h"
 #include "Usul/Threads/Guard.h"
 #include "Usul/Threads/Pool.h"
+#include "Usul/Threads/WorkStealingPool.h"
 
 #include "boost/version.hpp"
 #if BOOST_VERSION >= 103900
 #include "boost/signals2/signal.hpp"
 #endif
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -41,9 +44,15 @@ public:
   // Useful typedefs.
   typedef Usul::Threads::RecursiveMutex Mutex;
   typedef Usul::Threads::Guard<Mutex> Guard;
+#ifdef USUL_USE_WORK_STEALING_POOL
+  typedef Usul::Threads::WorkStealingPool ThreadPool;
+#else
   typedef Usul::Threads::Pool ThreadPool;
+#endif
   typedef ThreadPool::Strings Strings;
   typedef Usul::File::Log::RefPtr LogPtr;
+  typedef std::vector < Job::RefPtr > Jobs;
+  typedef std::set < Job::RefPtr > JobSet;
   
 #if BOOST_VERSION >= 103900
   typedef boost::signals2::signal<void ( Job* )> JobFinishedListeners;
@@ -55,16 +64,21 @@ public:
 
   // Add a job to the list.
   void                    addJob ( Job::RefPtr );
+
+  // Add a job that starts only after all of the given jobs have finished.
+  // If any of them is cancelled or fails then this job is cancelled too.
+  void                    addJob ( Job::RefPtr, const Jobs &predecessors );
   
   // Add a job finished listener.
   template<class Slot>
   void                    addJobFinishedListener ( const Slot& subscriber );
 
-  // Cancel the job(s).
+  // Cancel the job(s). Cancelling a job also cancels the jobs waiting on it.
   void                    cancel();
   void                    cancel ( Job::RefPtr );
 
-  // Clear any jobs that are queued, but not running.
+  // Clear any jobs that are queued, but not running. Jobs waiting on other
+  // jobs are cancelled, so they are done.
   void                    clearQueuedJobs();
 
   // This will delete the singleton instance, if any.
@@ -107,9 +121,15 @@ public:
   template<class Slot>
   void                    removeJobFinishedListener ( const Slot& subscriber );
 
-  // Remove the queued job. Has no effect on running jobs.
+  // Remove the queued job. Has no effect on running jobs. A job that is
+  // removed never runs, so it is cancelled and done, its _cancelled() is
+  // called, and its successors are cancelled.
   void                    removeQueuedJob ( Job::RefPtr );
 
+  // Add the continuation so that it starts after the job finishes.
+  // Returns the continuation.
+  Job::RefPtr             then ( Job::RefPtr job, Job::RefPtr continuation );
+
   // Wait for all jobs to complete.
   void                    wait();
 
@@ -119,8 +139,13 @@ private:
   Manager ( const Manager & );
   Manager &operator = ( const Manager & );
 
+  void                    _cancelSuccessors ( Job::RefPtr );
+  void                    _cancelWaiting();
+
   void                    _destroy();
+  void                    _dispatch ( Job::RefPtr );
 
+  void                    _jobCancelled ( Job::RefPtr );
   void                    _jobFinished ( Job::RefPtr );
 
   void                    _logEvent ( const std::string &s, Job::RefPtr job = Job::RefPtr ( 0x0 ) );
@@ -132,6 +157,8 @@ private:
   static Manager *_instance;
   mutable Mutex _mutex;
   ThreadPool _pool;
+  mutable Mutex _graphMutex;
+  JobSet _waiting;
   LogPtr _log;
 #if BOOST_VERSION >= 103900
   JobFinishedListeners _jobFinishedListeners;
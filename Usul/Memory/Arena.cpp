@@ -0,0 +1,540 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Thread-safe arena for small objects.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Memory/Arena.h"
+#include "Usul/Errors/Assert.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Trace/Trace.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <set>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+# include <malloc.h>
+#endif
+
+using namespace Usul::Memory;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Every arena gets a serial number. Threads find their cache with it, so
+//  an arena that is created at the address of a deleted one never sees the
+//  old caches.
+//
+//  Every thread's caches are also in a registry. A deleted arena takes its
+//  entries out, and a thread that ends gives its cached slots back. Both
+//  hold the registry's mutex, so neither sees the other half done.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  boost::atomic<unsigned long> nextSerial ( 1 );
+}
+
+struct Arena::ThreadCaches
+{
+  typedef std::pair < Arena *, Cache * > Entry;
+  typedef std::map < unsigned long, Entry > Map;
+  typedef std::set < ThreadCaches * > Registry;
+
+  ThreadCaches() : serial ( 0 ), cache ( 0x0 ), mutex(), all(){}
+
+  static void ended ( ThreadCaches * );
+
+  unsigned long serial;
+  Cache *cache;
+  boost::mutex mutex;
+  Map all;
+
+  static boost::mutex registryMutex;
+  static Registry registry;
+  static boost::thread_specific_ptr < ThreadCaches > current;
+};
+
+boost::mutex Arena::ThreadCaches::registryMutex;
+Arena::ThreadCaches::Registry Arena::ThreadCaches::registry;
+boost::thread_specific_ptr < Arena::ThreadCaches > Arena::ThreadCaches::current ( &Arena::ThreadCaches::ended );
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Written at the start of every chunk.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct ChunkHeader
+  {
+    Usul::Memory::Arena *arena;
+    unsigned int sizeClass;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Allocate and free memory that is aligned to its size.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  void *alignedMalloc ( std::size_t size )
+  {
+    #ifdef _MSC_VER
+    return ::_aligned_malloc ( size, size );
+    #else
+    void *memory ( 0x0 );
+    return ( ( 0 == ::posix_memalign ( &memory, size, size ) ) ? memory : 0x0 );
+    #endif
+  }
+
+  void alignedFree ( void *memory )
+  {
+    #ifdef _MSC_VER
+    ::_aligned_free ( memory );
+    #else
+    ::free ( memory );
+    #endif
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Arena::Cache::Cache()
+{
+  for ( unsigned int i = 0; i < NUM_CLASSES; ++i )
+  {
+    free[i] = 0x0;
+    count[i] = 0;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Arena::Arena() : BaseClass(),
+  _serial ( nextSerial++ ),
+  _cachesMutex(),
+  _caches(),
+  _bytesReserved ( 0 )
+{
+  USUL_TRACE_SCOPE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Arena::~Arena()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( boost::bind ( &Arena::_destroy, this ), "2750913406" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy this instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_destroy()
+{
+  USUL_TRACE_SCOPE;
+
+  // So that threads that end later do not come back to us.
+  {
+    boost::lock_guard<boost::mutex> lock ( ThreadCaches::registryMutex );
+    for ( ThreadCaches::Registry::iterator i = ThreadCaches::registry.begin(); i != ThreadCaches::registry.end(); ++i )
+    {
+      ThreadCaches &tc ( **i );
+      boost::lock_guard<boost::mutex> tcLock ( tc.mutex );
+      tc.all.erase ( _serial );
+    }
+  }
+
+  this->_release();
+
+  boost::lock_guard<boost::mutex> lock ( _cachesMutex );
+  for ( Caches::iterator i = _caches.begin(); i != _caches.end(); ++i )
+  {
+    delete *i;
+  }
+  _caches.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of bytes taken from the system.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Arena::SizeType Arena::bytesReserved() const
+{
+  return _bytesReserved;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the calling thread's cache, making it if needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Arena::Cache *Arena::_cache()
+{
+  ThreadCaches *tc ( ThreadCaches::current.get() );
+  if ( 0x0 == tc )
+  {
+    tc = new ThreadCaches;
+    ThreadCaches::current.reset ( tc );
+
+    boost::lock_guard<boost::mutex> lock ( ThreadCaches::registryMutex );
+    ThreadCaches::registry.insert ( tc );
+  }
+
+  // Most of the time it is the same arena as last time.
+  if ( _serial == tc->serial )
+  {
+    return tc->cache;
+  }
+
+  Cache *cache ( 0x0 );
+  {
+    boost::lock_guard<boost::mutex> tcLock ( tc->mutex );
+    ThreadCaches::Map::iterator i ( tc->all.find ( _serial ) );
+    if ( tc->all.end() != i )
+    {
+      cache = i->second.second;
+    }
+    else
+    {
+      // The arena owns the caches because threads may end before it does.
+      cache = new Cache;
+      {
+        boost::lock_guard<boost::mutex> lock ( _cachesMutex );
+        _caches.push_back ( cache );
+      }
+      tc->all[_serial] = ThreadCaches::Entry ( this, cache );
+    }
+  }
+
+  tc->serial = _serial;
+  tc->cache = cache;
+  return cache;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return memory for one object.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void *Arena::malloc ( SizeType size )
+{
+  if ( size > MAX_SIZE )
+    throw std::invalid_argument ( "Error 3356402711: Size is too large for the arena" );
+
+  const unsigned int sizeClass ( ( size > 0 ) ? static_cast < unsigned int > ( ( size - 1 ) / GRANULARITY ) : 0 );
+
+  Cache &cache ( *this->_cache() );
+  if ( 0x0 == cache.free[sizeClass] )
+  {
+    this->_refill ( cache, sizeClass );
+  }
+
+  FreeNode *node ( cache.free[sizeClass] );
+  USUL_ASSERT ( 0x0 != node );
+  cache.free[sizeClass] = node->next;
+  --cache.count[sizeClass];
+  return node;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Give the memory back to the arena it came from.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::free ( void *memory )
+{
+  if ( 0x0 == memory )
+    return;
+
+  const std::size_t mask ( ~( static_cast < std::size_t > ( CHUNK_SIZE ) - 1 ) );
+  const ChunkHeader *header ( reinterpret_cast < const ChunkHeader * > ( reinterpret_cast < std::size_t > ( memory ) & mask ) );
+  USUL_ASSERT ( 0x0 != header->arena );
+
+  header->arena->_free ( memory, header->sizeClass );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Put the memory in this thread's cache.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_free ( void *memory, unsigned int sizeClass )
+{
+  Cache &cache ( *this->_cache() );
+
+  FreeNode *node ( static_cast < FreeNode * > ( memory ) );
+  node->next = cache.free[sizeClass];
+  cache.free[sizeClass] = node;
+  ++cache.count[sizeClass];
+
+  // Do not let one thread hoard what the others need.
+  if ( cache.count[sizeClass] > 2 * BATCH_SIZE )
+  {
+    this->_flush ( cache, sizeClass );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move a batch of free slots from the size class to the cache.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_refill ( Cache &cache, unsigned int sizeClass )
+{
+  SizeClass &sc ( _classes[sizeClass] );
+  const SizeType slot ( ( sizeClass + 1 ) * GRANULARITY );
+
+  boost::lock_guard<boost::mutex> lock ( sc.mutex );
+
+  // Reuse freed slots first.
+  unsigned int count ( 0 );
+  while ( ( 0x0 != sc.free ) && ( count < BATCH_SIZE ) )
+  {
+    FreeNode *node ( sc.free );
+    sc.free = node->next;
+    node->next = cache.free[sizeClass];
+    cache.free[sizeClass] = node;
+    ++count;
+  }
+
+  // Then cut new ones from the current chunk.
+  while ( count < BATCH_SIZE )
+  {
+    if ( ( 0x0 == sc.current ) || ( sc.current + slot > sc.end ) )
+    {
+      // Do not take another chunk if we already have something.
+      if ( count > 0 )
+        break;
+      this->_newChunk ( sc, sizeClass );
+    }
+
+    FreeNode *node ( reinterpret_cast < FreeNode * > ( sc.current ) );
+    sc.current += slot;
+    node->next = cache.free[sizeClass];
+    cache.free[sizeClass] = node;
+    ++count;
+  }
+
+  cache.count[sizeClass] += count;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move a batch of free slots from the cache to the size class.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_flush ( Cache &cache, unsigned int sizeClass )
+{
+  // Unlink the batch before taking the lock.
+  FreeNode *first ( cache.free[sizeClass] );
+  FreeNode *last ( first );
+  for ( unsigned int i = 1; i < BATCH_SIZE; ++i )
+  {
+    last = last->next;
+  }
+  cache.free[sizeClass] = last->next;
+  cache.count[sizeClass] -= BATCH_SIZE;
+
+  SizeClass &sc ( _classes[sizeClass] );
+  boost::lock_guard<boost::mutex> lock ( sc.mutex );
+  last->next = sc.free;
+  sc.free = first;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Give all of the cache's slots back to the size classes and delete it.
+//  Called when the thread that used the cache ends.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_threadEnded ( Cache *cache )
+{
+  // Hold this the whole time so that reset() does not free the chunks
+  // while the slots are moved.
+  boost::lock_guard<boost::mutex> cachesLock ( _cachesMutex );
+
+  Caches::iterator found ( std::find ( _caches.begin(), _caches.end(), cache ) );
+  if ( _caches.end() == found )
+    return;
+  _caches.erase ( found );
+
+  for ( unsigned int i = 0; i < NUM_CLASSES; ++i )
+  {
+    FreeNode *first ( cache->free[i] );
+    if ( 0x0 == first )
+      continue;
+
+    FreeNode *last ( first );
+    while ( 0x0 != last->next )
+    {
+      last = last->next;
+    }
+
+    SizeClass &sc ( _classes[i] );
+    boost::lock_guard<boost::mutex> lock ( sc.mutex );
+    last->next = sc.free;
+    sc.free = first;
+  }
+
+  delete cache;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called by the thread-specific pointer when a thread ends.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::ThreadCaches::ended ( ThreadCaches *tc )
+{
+  if ( 0x0 == tc )
+    return;
+
+  {
+    boost::lock_guard<boost::mutex> lock ( registryMutex );
+    registry.erase ( tc );
+
+    // The arenas are still alive because they take this mutex to go away.
+    for ( Map::iterator i = tc->all.begin(); i != tc->all.end(); ++i )
+    {
+      Usul::Functions::safeCallV1 ( boost::bind ( &Arena::_threadEnded, i->second.first, _1 ), i->second.second, "1803392657" );
+    }
+  }
+
+  delete tc;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a chunk to the size class. Call with the class's mutex locked.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_newChunk ( SizeClass &sc, unsigned int sizeClass )
+{
+  char *chunk ( static_cast < char * > ( alignedMalloc ( CHUNK_SIZE ) ) );
+  if ( 0x0 == chunk )
+    throw std::bad_alloc();
+
+  ChunkHeader *header ( reinterpret_cast < ChunkHeader * > ( chunk ) );
+  header->arena = this;
+  header->sizeClass = sizeClass;
+
+  sc.chunks.push_back ( chunk );
+  sc.current = chunk + HEADER_SIZE;
+  sc.end = chunk + CHUNK_SIZE;
+
+  _bytesReserved += CHUNK_SIZE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Give all chunks back to the system.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::reset()
+{
+  USUL_TRACE_SCOPE;
+  this->_release();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Give all chunks back to the system and empty the caches.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Arena::_release()
+{
+  USUL_TRACE_SCOPE;
+
+  // Hold this until the chunks are gone, see _threadEnded().
+  boost::lock_guard<boost::mutex> cachesLock ( _cachesMutex );
+  for ( Caches::iterator i = _caches.begin(); i != _caches.end(); ++i )
+  {
+    *(*i) = Cache();
+  }
+
+  for ( unsigned int i = 0; i < NUM_CLASSES; ++i )
+  {
+    SizeClass &sc ( _classes[i] );
+    boost::lock_guard<boost::mutex> lock ( sc.mutex );
+    for ( std::vector < void * >::iterator j = sc.chunks.begin(); j != sc.chunks.end(); ++j )
+    {
+      alignedFree ( *j );
+    }
+    sc.chunks.clear();
+    sc.free = 0x0;
+    sc.current = 0x0;
+    sc.end = 0x0;
+  }
+
+  _bytesReserved = 0;
+}
@@ -0,0 +1,155 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Thread-safe arena for small objects.
+//
+//  Requests are rounded up to a size class (multiples of 16 bytes up to
+//  MAX_SIZE). Every size class has its own chunks and its own free list, so
+//  freed memory is reused by the next object of the same class. Each thread
+//  keeps a small cache of free slots per class and only takes the class's
+//  lock to move a batch in or out of that cache. When the thread ends the
+//  slots in its cache go back to the classes.
+//
+//  Chunks are aligned to their size, and the first bytes of a chunk say
+//  which arena and size class it belongs to. That is why free() does not
+//  need the size or the arena.
+//
+//  reset() gives all chunks back at once. Nothing allocated from the arena
+//  may be used, or freed, after that.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_LIBRARY_MEMORY_ARENA_H_
+#define _USUL_LIBRARY_MEMORY_ARENA_H_
+
+#include "Usul/Export/Export.h"
+#include "Usul/Base/Referenced.h"
+#include "Usul/Pointers/Pointers.h"
+
+#include "boost/atomic.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace Usul {
+namespace Memory {
+
+
+class USUL_EXPORT Arena : public Usul::Base::Referenced
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Base::Referenced BaseClass;
+  typedef std::size_t SizeType;
+
+  // Smart-pointer definitions.
+  USUL_DECLARE_REF_POINTERS ( Arena );
+
+  // Sizes.
+  enum
+  {
+    GRANULARITY = 16,
+    MAX_SIZE    = 256,
+    NUM_CLASSES = MAX_SIZE / GRANULARITY,
+    CHUNK_SIZE  = 65536,
+    HEADER_SIZE = 64,
+    BATCH_SIZE  = 64
+  };
+
+  // Constructor.
+  Arena();
+
+  // Number of bytes taken from the system.
+  SizeType                bytesReserved() const;
+
+  // Return memory for one object of the given size. Throws std::bad_alloc if
+  // the system is out of memory and std::invalid_argument if the size is
+  // larger than MAX_SIZE.
+  void *                  malloc ( SizeType size );
+
+  // Give the memory back to the arena it came from.
+  static void             free ( void * );
+
+  // Give all chunks back to the system.
+  void                    reset();
+
+protected:
+
+  // Use reference counting.
+  virtual ~Arena();
+
+private:
+
+  // Singly-linked list of free slots.
+  struct FreeNode
+  {
+    FreeNode *next;
+  };
+
+  // Free slots and chunks of one size class.
+  struct SizeClass
+  {
+    SizeClass() : mutex(), free ( 0x0 ), current ( 0x0 ), end ( 0x0 ), chunks(){}
+    boost::mutex mutex;
+    FreeNode *free;
+    char *current;
+    char *end;
+    std::vector < void * > chunks;
+  };
+
+  // Free slots of one thread, per size class.
+  struct Cache
+  {
+    Cache();
+    FreeNode *free[NUM_CLASSES];
+    unsigned int count[NUM_CLASSES];
+  };
+  typedef std::vector < Cache * > Caches;
+
+  // Caches of one thread, for every arena it has used.
+  struct ThreadCaches;
+  friend struct ThreadCaches;
+
+  // No copying or assigning.
+  Arena ( const Arena & );
+  Arena &operator = ( const Arena & );
+
+  Cache *                 _cache();
+
+  void                    _destroy();
+
+  void                    _flush ( Cache &, unsigned int sizeClass );
+  void                    _free ( void *, unsigned int sizeClass );
+
+  void                    _newChunk ( SizeClass &, unsigned int sizeClass );
+
+  void                    _refill ( Cache &, unsigned int sizeClass );
+  void                    _release();
+
+  void                    _threadEnded ( Cache * );
+
+  // Data members.
+  const unsigned long _serial;
+  SizeClass _classes[NUM_CLASSES];
+  boost::mutex _cachesMutex;
+  Caches _caches;
+  boost::atomic<SizeType> _bytesReserved;
+};
+
+
+} // namespace Memory
+} // namespace Usul
+
+
+#endif // _USUL_LIBRARY_MEMORY_ARENA_H_
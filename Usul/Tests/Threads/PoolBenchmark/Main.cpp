@@ -0,0 +1,165 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Compares the thread pools. For 1, 4 and all cores it reports the number
+//  of tasks per second and the time between queueing a task and starting it.
+//
+//  Usage: PoolBenchmark [num tasks] [work per task]
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Threads/Pool.h"
+#include "Usul/Threads/WorkStealingPool.h"
+
+#include "boost/bind.hpp"
+#include "boost/date_time/posix_time/posix_time_types.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Time a task was queued and the time it started.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  typedef boost::posix_time::ptime Time;
+  typedef boost::posix_time::microsec_clock Clock;
+
+  struct Sample
+  {
+    Time queued;
+    Time started;
+  };
+  typedef std::vector < Sample > Samples;
+
+  unsigned int work ( 0 );
+
+  void started ( Samples *samples, unsigned int index )
+  {
+    (*samples)[index].started = Clock::universal_time();
+
+    // Some busy work so that the tasks are not empty.
+    volatile double sum ( 0 );
+    for ( unsigned int i = 0; i < work; ++i )
+    {
+      sum += static_cast < double > ( i ) * 0.5;
+    }
+  }
+
+  void nothing()
+  {
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run all the tasks through the pool and print the numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class PoolType > void _run ( const std::string &name, unsigned int numThreads, unsigned int numTasks )
+{
+  typedef Usul::Threads::Task Task;
+
+  Detail::Samples samples ( numTasks );
+  PoolType pool ( name, numThreads );
+
+  const Detail::Time start ( Detail::Clock::universal_time() );
+
+  for ( unsigned int i = 0; i < numTasks; ++i )
+  {
+    Task::RefPtr task ( new Task ( pool.nextTaskId(),
+                                   boost::bind ( &Detail::started, &samples, i ),
+                                   Task::Callback ( &Detail::nothing ),
+                                   Task::Callback(),
+                                   Task::Callback() ) );
+    samples[i].queued = Detail::Clock::universal_time();
+    pool.addTask ( 0, task.get() );
+  }
+
+  pool.waitForTasks();
+
+  const double seconds ( static_cast < double > ( ( Detail::Clock::universal_time() - start ).total_microseconds() ) * 1e-6 );
+
+  // Queue-to-start latency in microseconds.
+  std::vector < double > latency;
+  latency.reserve ( numTasks );
+  for ( Detail::Samples::const_iterator i = samples.begin(); i != samples.end(); ++i )
+  {
+    latency.push_back ( static_cast < double > ( ( i->started - i->queued ).total_microseconds() ) );
+  }
+  std::sort ( latency.begin(), latency.end() );
+
+  const double p50 ( latency.empty() ? 0 : latency.at ( latency.size() / 2 ) );
+  const double p99 ( latency.empty() ? 0 : latency.at ( ( latency.size() * 99 ) / 100 ) );
+
+  std::cout << std::setw ( 20 ) << name
+            << std::setw ( 10 ) << numThreads
+            << std::setw ( 15 ) << std::fixed << std::setprecision ( 0 ) << ( ( seconds > 0 ) ? ( numTasks / seconds ) : 0 )
+            << std::setw ( 15 ) << p50
+            << std::setw ( 15 ) << p99
+            << std::endl;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run the benchmark.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void _test ( int argc, char **argv )
+{
+  const unsigned int numTasks ( ( argc > 1 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[1] ) ) ) : 100000 );
+  Detail::work = ( ( argc > 2 ) ? static_cast < unsigned int > ( std::abs ( ::atoi ( argv[2] ) ) ) : 1000 );
+
+  std::vector < unsigned int > threads;
+  threads.push_back ( 1 );
+  threads.push_back ( 4 );
+  threads.push_back ( std::max ( 1u, boost::thread::hardware_concurrency() ) );
+
+  std::cout << "Tasks: " << numTasks << ", work per task: " << Detail::work << '\n';
+  std::cout << std::setw ( 20 ) << "Pool"
+            << std::setw ( 10 ) << "Threads"
+            << std::setw ( 15 ) << "Tasks/sec"
+            << std::setw ( 15 ) << "p50 (usec)"
+            << std::setw ( 15 ) << "p99 (usec)"
+            << std::endl;
+
+  for ( std::vector < unsigned int >::const_iterator i = threads.begin(); i != threads.end(); ++i )
+  {
+    _run < Usul::Threads::Pool >             ( "Pool",             *i, numTasks );
+    _run < Usul::Threads::WorkStealingPool > ( "WorkStealingPool", *i, numTasks );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Main function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+int main ( int argc, char **argv )
+{
+  Usul::Functions::safeCallV1V2 ( _test, argc, argv, "3922187062" );
+  return 0;
+}
@@ -270,7 +270,7 @@ unsigned int Pool::numTasks() const
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Pool::removeQueuedTask ( TaskHandle id )
+bool Pool::removeQueuedTask ( TaskHandle id )
 {
   USUL_TRACE_SCOPE;
   Guard guard ( this );
@@ -281,10 +281,12 @@ void Pool::removeQueuedTask ( TaskHandle id )
     Task::RefPtr task ( i->second );
     USUL_TRACE_6 ( "Task: priority = ", id.first, ", id = ", id.second, ( ( false == task->name().empty() ) ? ( ", name = '" + task->name() + "'" ) : "" ), " <-- Removed\n" );
     _queue.erase ( i );
+    return true;
   }
   else
   {
     USUL_TRACE_5 ( "Task: priority = ", id.first, ", id = ", id.second, " <-- Failed to remove" );
+    return false;
   }
 }
 
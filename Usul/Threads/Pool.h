@@ -94,7 +94,8 @@ public:
   unsigned int            numTasksQueued() const;
 
   // Remove the task from the queue. Has no effect on running tasks.
-  void                    removeQueuedTask ( TaskHandle );
+  // Returns true if it was in the queue.
+  bool                    removeQueuedTask ( TaskHandle );
 
   // Set/get the sleep duration. This is the amount of time (in milliseconds) 
   // that the internal worker threads will sleep during a loop.
@@ -0,0 +1,813 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Thread pool where every worker owns a queue and idle workers steal.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Threads/WorkStealingPool.h"
+#include "Usul/Errors/Assert.h"
+#include "Usul/Exceptions/Canceled.h"
+#include "Usul/Functions/SafeCall.h"
+#include "Usul/Strings/Format.h"
+#include "Usul/Trace/Trace.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <ctime>
+
+using namespace Usul::Threads;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The pool and worker that the calling thread belongs to, if any. Used to
+//  put tasks that are added from inside a task onto the same worker's queue.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct CurrentWorker
+  {
+    CurrentWorker ( const WorkStealingPool *p, unsigned int i ) : pool ( p ), index ( i ){}
+    const WorkStealingPool *pool;
+    unsigned int index;
+  };
+  boost::thread_specific_ptr < CurrentWorker > currentWorker;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+WorkStealingPool::WorkStealingPool ( const std::string &n, unsigned int numThreads ) :
+  _mutex(),
+  _pool         (),
+  _workers      (),
+  _idleMutex    (),
+  _workAdded    (),
+  _allDone      (),
+  _numQueued    ( 0 ),
+  _numExecuting ( 0 ),
+  _numIdle      ( 0 ),
+  _nextWorker   ( 0 ),
+  _nextTaskId   ( 0 ),
+  _sleep        ( 100 ), // Only a safety net. Workers are woken when tasks arrive.
+  _runThreads   ( true ),
+  _started      ( false ),
+  _log          ( 0x0 ),
+  _name ( n )
+{
+  USUL_TRACE_SCOPE;
+
+  // Always have at least one worker so that there is a queue.
+  const unsigned int numWorkers ( ( numThreads > 0 ) ? numThreads : 1 );
+  _workers.reserve ( numWorkers );
+  for ( unsigned int i = 0; i < numWorkers; ++i )
+  {
+    _workers.push_back ( new Worker );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+WorkStealingPool::~WorkStealingPool()
+{
+  USUL_TRACE_SCOPE;
+  Usul::Functions::safeCall ( boost::bind ( &WorkStealingPool::_destroy, this ), "1457193420" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy the members.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_destroy()
+{
+  USUL_TRACE_SCOPE;
+  // Do not lock mutex up here! Threads waiting for this mutex will never finish.
+
+  // Turn off the switch.
+  _runThreads = false;
+
+  // Clear all queued tasks and cancel running threads.
+  this->cancel();
+
+  // Wake up everybody so that they see the switch.
+  this->_wakeWorkers ( true );
+
+  // Wait for threads to finish.
+  this->_waitForThreads();
+
+  // Should be true.
+  USUL_ASSERT ( 0 == _numQueued );
+  USUL_ASSERT ( 0 == _numExecuting );
+
+  for ( ThreadPool::iterator iter = _pool.begin(); iter != _pool.end(); ++iter )
+  {
+    delete *iter;
+    *iter = 0x0;
+  }
+  _pool.clear();
+
+  for ( Workers::iterator iter = _workers.begin(); iter != _workers.end(); ++iter )
+  {
+    delete *iter;
+    *iter = 0x0;
+  }
+  _workers.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a task.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+WorkStealingPool::TaskHandle WorkStealingPool::addTask ( int priority, Task *task )
+{
+  USUL_TRACE_SCOPE;
+
+  // Check input.
+  if ( 0x0 == task )
+    throw std::invalid_argument ( "Error 2640329511: null task given" );
+
+  // Make handle.
+  TaskHandle key ( priority, task->id() );
+
+  // Tasks added from one of our own threads stay with that thread.
+  // All others are dealt out round-robin.
+  const unsigned int numWorkers ( _workers.size() );
+  const CurrentWorker *current ( currentWorker.get() );
+  const unsigned int index ( ( ( 0x0 != current ) && ( this == current->pool ) ) ?
+                             current->index : ( _nextWorker++ % numWorkers ) );
+
+  // Add task. Local reference may help with stability.
+  {
+    Worker &worker ( *_workers.at ( index ) );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    worker.queue[key] = Task::RefPtr ( task );
+    ++_numQueued;
+  }
+
+  // Make sure the threads are started.
+  this->_startThreads();
+
+  // Wake up an idle worker.
+  this->_wakeWorkers ( false );
+
+  // Return key.
+  return key;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Wake idle workers. Only touches the shared mutex if someone is waiting.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_wakeWorkers ( bool all )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( ( false == all ) && ( 0 == _numIdle ) )
+    return;
+
+  boost::lock_guard<boost::mutex> lock ( _idleMutex );
+  if ( true == all )
+    _workAdded.notify_all();
+  else
+    _workAdded.notify_one();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove the queued tasks and cancel the running threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::cancel()
+{
+  USUL_TRACE_SCOPE;
+
+  // Clear all queued tasks. Has no effect on running threads.
+  // Do this before cancelling the threads.
+  this->clearQueuedTasks();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Does the pool have the task.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingPool::hasQueuedTask ( TaskHandle id ) const
+{
+  USUL_TRACE_SCOPE;
+
+  for ( Workers::const_iterator i = _workers.begin(); i != _workers.end(); ++i )
+  {
+    const Worker &worker ( **i );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    if ( worker.queue.end() != worker.queue.find ( id ) )
+      return true;
+  }
+
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string WorkStealingPool::name() const
+{
+  USUL_TRACE_SCOPE;
+  return std::string ( _name.begin(), _name.end() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of threads in the pool.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int WorkStealingPool::numThreads() const
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return _pool.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of tasks that are waiting for idle threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int WorkStealingPool::numTasksQueued() const
+{
+  USUL_TRACE_SCOPE;
+  return _numQueued;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of tasks that are executing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int WorkStealingPool::numTasksExecuting() const
+{
+  USUL_TRACE_SCOPE;
+  return _numExecuting;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the names of the executing tasks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::executingNames ( Strings &names ) const
+{
+  USUL_TRACE_SCOPE;
+
+  // Grab the tasks and then ask for the names without holding any locks.
+  typedef std::vector < Task::RefPtr > Tasks;
+  Tasks executing;
+  executing.reserve ( _workers.size() );
+  for ( Workers::const_iterator i = _workers.begin(); i != _workers.end(); ++i )
+  {
+    const Worker &worker ( **i );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    if ( true == worker.executing.valid() )
+      executing.push_back ( worker.executing );
+  }
+
+  names.clear();
+  names.reserve ( executing.size() );
+  for ( Tasks::const_iterator i = executing.begin(); i != executing.end(); ++i )
+  {
+    Task::RefPtr task ( *i );
+    names.push_back ( task->name() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of tasks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int WorkStealingPool::numTasks() const
+{
+  USUL_TRACE_SCOPE;
+
+  // Read executing first. A task moves from queued to executing by
+  // incrementing executing before decrementing queued, so this order
+  // never misses a task in transit.
+  const unsigned int executing ( this->numTasksExecuting() );
+  const unsigned int queued ( this->numTasksQueued() );
+
+  // Return the sum.
+  return ( queued + executing );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove the queued task.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingPool::removeQueuedTask ( TaskHandle id )
+{
+  USUL_TRACE_SCOPE;
+
+  // Release the task after the lock is gone.
+  Task::RefPtr task ( 0x0 );
+
+  for ( Workers::iterator i = _workers.begin(); i != _workers.end(); ++i )
+  {
+    Worker &worker ( **i );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    TaskMap::iterator t ( worker.queue.find ( id ) );
+    if ( worker.queue.end() != t )
+    {
+      task = t->second;
+      worker.queue.erase ( t );
+      --_numQueued;
+      break;
+    }
+  }
+
+  if ( true == task.valid() )
+  {
+    USUL_TRACE_6 ( "Task: priority = ", id.first, ", id = ", id.second, ( ( false == task->name().empty() ) ? ( ", name = '" + task->name() + "'" ) : "" ), " <-- Removed\n" );
+    boost::lock_guard<boost::mutex> lock ( _idleMutex );
+    _allDone.notify_all();
+    return true;
+  }
+  else
+  {
+    USUL_TRACE_5 ( "Task: priority = ", id.first, ", id = ", id.second, " <-- Failed to remove" );
+    return false;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called when the internal thread starts.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_threadStarted ( unsigned int index )
+{
+  USUL_TRACE_SCOPE;
+  // Do not lock mutex here!
+
+  // So that tasks added from this thread go to this worker.
+  currentWorker.reset ( new CurrentWorker ( this, index ) );
+
+  Worker &worker ( *_workers.at ( index ) );
+
+  // Loop until told otherwise.
+  while ( true == _runThreads )
+  {
+    // Get the next task.
+    Task::RefPtr task ( this->_nextTask ( index ) );
+    if ( true == task.valid() )
+    {
+      USUL_TRACE_3 ( "Starting task: id = ", task->id(), ( ( false == task->name().empty() ) ? ( ", name = '" + task->name() + "'" ) : "" ) );
+
+      // Process any queued tasks. Catch and eat all exceptions.
+      Usul::Functions::safeCallV1 ( boost::bind ( &WorkStealingPool::_threadProcessTask, this, _1 ), task.get(), "3346089165" );
+
+      // Always decrement.
+      {
+        boost::lock_guard<boost::mutex> lock ( worker.mutex );
+        worker.executing = 0x0;
+      }
+      USUL_ASSERT ( _numExecuting > 0 );
+      if ( ( 1 == _numExecuting-- ) && ( 0 == _numQueued ) )
+      {
+        boost::lock_guard<boost::mutex> lock ( _idleMutex );
+        _allDone.notify_all();
+      }
+
+      task = 0x0;
+    }
+
+    // We have no work to do, so wait until some arrives.
+    else
+    {
+      boost::unique_lock<boost::mutex> lock ( _idleMutex );
+      ++_numIdle;
+      if ( ( 0 == _numQueued ) && ( true == _runThreads ) )
+      {
+        _workAdded.timed_wait ( lock, boost::posix_time::milliseconds ( this->sleepDuration() ) );
+      }
+      --_numIdle;
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called in the task processing loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_threadProcessTask ( Usul::Threads::Task *task )
+{
+  USUL_TRACE_SCOPE;
+  // Do not lock mutex here!
+
+  // Handle bad input.
+  if ( 0x0 == task )
+    return;
+
+  // Safely...
+  USUL_TRY_BLOCK
+  {
+    task->started();
+    task->finished();
+  }
+
+  // Handle special exception.
+  catch ( const Usul::Exceptions::Cancelled & )
+  {
+    task->cancelled();
+  }
+
+  // Handle standard exceptions.
+  catch ( const std::exception &e )
+  {
+    // Feedback.
+    const Thread::id threadId ( boost::this_thread::get_id() );
+    std::cout << Usul::Strings::format ( "Error 1919640383: standard exception caught while running thread ", threadId, ", ", e.what(), '\n' ) << std::flush;
+
+    // Call the error callback.
+    task->error();
+  }
+
+  // Handle all other exceptions.
+  catch ( ... )
+  {
+    task->error();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the next task for the given worker. Looks at the front of every
+//  queue, starting with the worker's own, and takes the one with the
+//  highest priority. Ties go to the worker's own queue, then its
+//  neighbours. Other queues are only tried, never waited on.
+//
+//  Make sure you return a copy of the smart-pointer! Otherwise, with
+//  multiple threads running at once, the task could be decremented by a
+//  different thread but after it's released here.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Threads::Task::RefPtr WorkStealingPool::_nextTask ( unsigned int index )
+{
+  USUL_TRACE_SCOPE;
+
+  // Nothing to do.
+  if ( 0 == _numQueued )
+    return Task::RefPtr ( 0x0 );
+
+  const unsigned int numWorkers ( _workers.size() );
+  Worker *victim ( 0x0 );
+  int best ( 0 );
+
+  for ( unsigned int i = 0; i < numWorkers; ++i )
+  {
+    Worker *worker ( _workers[( index + i ) % numWorkers] );
+    boost::unique_lock<boost::mutex> lock ( worker->mutex, boost::defer_lock );
+    if ( 0 == i )
+      lock.lock();
+    else if ( false == lock.try_lock() )
+      continue;
+
+    if ( false == worker->queue.empty() )
+    {
+      const int priority ( worker->queue.begin()->first.first );
+      if ( ( 0x0 == victim ) || ( priority < best ) )
+      {
+        victim = worker;
+        best = priority;
+      }
+    }
+  }
+
+  if ( 0x0 == victim )
+    return Task::RefPtr ( 0x0 );
+
+  Task::RefPtr task ( 0x0 );
+  {
+    boost::lock_guard<boost::mutex> lock ( victim->mutex );
+
+    // Somebody else may have beaten us to it.
+    if ( true == victim->queue.empty() )
+      return Task::RefPtr ( 0x0 );
+
+    // Since the task id numbers always increase, the map acts like
+    // a queue if we always grab from the beginning.
+    task = victim->queue.begin()->second;
+    victim->queue.erase ( victim->queue.begin() );
+
+    // Executing first, see numTasks().
+    ++_numExecuting;
+    --_numQueued;
+  }
+
+  {
+    Worker &worker ( *_workers[index] );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    worker.executing = task;
+  }
+
+  return task;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the sleep duration.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long WorkStealingPool::sleepDuration() const
+{
+  USUL_TRACE_SCOPE;
+  return _sleep;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the sleep duration.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::sleepDuration ( unsigned long duration )
+{
+  USUL_TRACE_SCOPE;
+  _sleep = duration;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Clear all queued tasks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::clearQueuedTasks()
+{
+  USUL_TRACE_SCOPE;
+
+  // Release the tasks after the locks are gone.
+  typedef std::list < TaskMap > Removed;
+  Removed removed;
+
+  for ( Workers::iterator i = _workers.begin(); i != _workers.end(); ++i )
+  {
+    Worker &worker ( **i );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    removed.push_back ( TaskMap() );
+    removed.back().swap ( worker.queue );
+    _numQueued -= removed.back().size();
+  }
+
+  boost::lock_guard<boost::mutex> lock ( _idleMutex );
+  _allDone.notify_all();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Wait for all tasks to complete.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::waitForTasks()
+{
+  USUL_TRACE_SCOPE;
+
+  boost::unique_lock<boost::mutex> lock ( _idleMutex );
+  unsigned int num ( this->numTasks() );
+  while ( num > 0 )
+  {
+    USUL_TRACE_3 ( "Trace 2105834741: Waiting on ", num, " tasks\n" );
+    _allDone.timed_wait ( lock, boost::posix_time::milliseconds ( this->sleepDuration() ) );
+    num = this->numTasks();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Wait for all threads in the pool to complete.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_waitForThreads()
+{
+  USUL_TRACE_SCOPE;
+
+  // Copy the pool.
+  typedef std::list<Thread*> ThreadList;
+  ThreadList pool;
+  {
+    Guard guard ( this );
+    pool.assign ( _pool.begin(), _pool.end() );
+  }
+
+  for ( ThreadList::const_iterator i = pool.begin(); i != pool.end(); ++i )
+  {
+    Thread* thread ( *i );
+    if ( 0x0 != thread )
+    {
+      thread->join();
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the next task id. This will also increment the internal counter.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long WorkStealingPool::nextTaskId()
+{
+  USUL_TRACE_SCOPE;
+  return _nextTaskId++;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start the threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_startThreads()
+{
+  USUL_TRACE_SCOPE;
+
+  // This is called for every task, so only lock the first time.
+  if ( true == _started.load ( boost::memory_order_acquire ) )
+    return;
+
+  Guard guard ( this );
+
+  // Only start once.
+  if ( false == _started.load ( boost::memory_order_relaxed ) )
+  {
+    const unsigned int numWorkers ( _workers.size() );
+    _pool.reserve ( numWorkers );
+    for ( unsigned int i = 0; i < numWorkers; ++i )
+    {
+      _pool.push_back ( new Thread ( boost::bind ( &WorkStealingPool::_threadStarted, this, i ) ) );
+    }
+
+    _started.store ( true, boost::memory_order_release );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the log.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::logSet ( LogPtr lp )
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  _log = lp;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the log.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+WorkStealingPool::LogPtr WorkStealingPool::logGet()
+{
+  USUL_TRACE_SCOPE;
+  Guard guard ( this );
+  return LogPtr ( _log );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Log the event.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void WorkStealingPool::_logEvent ( const std::string &s, std::ostream *stream )
+{
+  USUL_TRACE_SCOPE;
+
+  if ( true == s.empty() )
+    return;
+
+  LogPtr file ( this->logGet() );
+  std::string message ( Usul::Strings::format ( "clock: ", ::clock(), ", system thread: ", boost::this_thread::get_id(), ", event: ", s ) );
+
+  if ( 0x0 != stream )
+  {
+    (*stream) << message << std::endl;
+  }
+
+  if ( true == file.valid() )
+  {
+    file->write ( message );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  See if a higher-priority task is waiting.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool WorkStealingPool::isHigherPriorityTaskWaiting ( int priority ) const
+{
+  USUL_TRACE_SCOPE;
+
+  for ( Workers::const_iterator i = _workers.begin(); i != _workers.end(); ++i )
+  {
+    const Worker &worker ( **i );
+    boost::lock_guard<boost::mutex> lock ( worker.mutex );
+    if ( ( false == worker.queue.empty() ) && ( worker.queue.begin()->first.first < priority ) )
+      return true;
+  }
+
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+WorkStealingPool::Mutex& WorkStealingPool::mutex() const
+{
+  USUL_TRACE_SCOPE;
+  return _mutex;
+}
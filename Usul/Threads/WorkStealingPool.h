@@ -0,0 +1,172 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2002, Perry L. Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Thread pool where every worker owns a queue and idle workers steal from
+//  the others. Has the same interface as Usul::Threads::Pool so that the
+//  job manager can use either one.
+//
+//  Each worker's queue is ordered by ( priority, id ), exactly like the
+//  single queue in Usul::Threads::Pool. A worker takes from the front of
+//  its own queue unless another worker has a task with a higher priority
+//  (smaller number) waiting, in which case it steals that one. Idle workers
+//  block on a condition variable instead of sleeping in a loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_THREADS_WORK_STEALING_POOL_CLASS_H_
+#define _USUL_THREADS_WORK_STEALING_POOL_CLASS_H_
+
+#include "Usul/File/Log.h"
+#include "Usul/Threads/Task.h"
+#include "Usul/Threads/RecursiveMutex.h"
+#include "Usul/Threads/Guard.h"
+
+#include "boost/atomic.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+#include <map>
+#include <vector>
+
+namespace boost { class thread; }
+
+namespace Usul {
+namespace Threads {
+
+
+class USUL_EXPORT WorkStealingPool
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::Threads::RecursiveMutex Mutex;
+  typedef Usul::Threads::Guard<Mutex> Guard;
+  typedef boost::thread Thread;
+  typedef std::vector < Thread* > ThreadPool;
+  typedef std::pair < int, unsigned long > TaskHandle;
+  typedef std::map < TaskHandle, Task::RefPtr > TaskMap;
+  typedef std::vector < std::string > Strings;
+  typedef Usul::File::Log::RefPtr LogPtr;
+
+  // Constructor
+  WorkStealingPool ( const std::string &name, unsigned int numThreads );
+  ~WorkStealingPool();
+
+  // Add a task.
+  TaskHandle              addTask ( int priority, Task *task );
+
+  // Cancel all running threads and remove all queued tasks.
+  void                    cancel();
+
+  // Clear the queued tasks. Has no effect on tasks currently being executed.
+  void                    clearQueuedTasks();
+
+  // Get the names of the executing tasks.
+  void                    executingNames ( Strings & ) const;
+
+  // Does the pool have the task?
+  bool                    hasQueuedTask ( TaskHandle ) const;
+
+  // See if a higher-priority job is waiting.
+  bool                    isHigherPriorityTaskWaiting ( int priority ) const;
+
+  // Set/get the log.
+  void                    logSet ( LogPtr );
+  LogPtr                  logGet();
+
+  // Get the mutex.
+  Mutex &                 mutex() const;
+
+  // Get the name.
+  std::string             name() const;
+
+  // Get the next task id. This will also increment the internal counter.
+  unsigned long           nextTaskId();
+
+  // Get the number of threads in the pool.
+  unsigned int            numThreads() const;
+
+  // Get the number of tasks.
+  unsigned int            numTasks() const;
+
+  // Get the number of tasks that are executing.
+  unsigned int            numTasksExecuting() const;
+
+  // Get the number of tasks that are waiting to be executed.
+  unsigned int            numTasksQueued() const;
+
+  // Remove the task from the queue. Has no effect on running tasks.
+  // Returns true if it was in the queue.
+  bool                    removeQueuedTask ( TaskHandle );
+
+  // Set/get the sleep duration. Idle workers are woken when a task is added,
+  // so this is only the upper limit (in milliseconds) of a single wait.
+  void                    sleepDuration ( unsigned long );
+  unsigned long           sleepDuration() const;
+
+  // Wait for all tasks to complete.
+  void                    waitForTasks();
+
+private:
+
+  // Queue and currently running task of one worker thread.
+  struct Worker
+  {
+    Worker() : mutex(), queue(), executing ( 0x0 ){}
+    mutable boost::mutex mutex;
+    TaskMap queue;
+    Task::RefPtr executing;
+  };
+  typedef std::vector < Worker* > Workers;
+
+  // No copying or assigning.
+  WorkStealingPool ( const WorkStealingPool & );
+  WorkStealingPool &operator = ( const WorkStealingPool & );
+
+  void                    _destroy();
+
+  void                    _logEvent ( const std::string &s, std::ostream *optional = 0x0 );
+
+  Task::RefPtr            _nextTask ( unsigned int index );
+
+  void                    _startThreads();
+
+  void                    _threadProcessTask ( Usul::Threads::Task *task );
+  void                    _threadStarted ( unsigned int index );
+
+  void                    _waitForThreads();
+  void                    _wakeWorkers ( bool all );
+
+  // Data members.
+  mutable Mutex _mutex;
+  ThreadPool _pool;
+  Workers _workers;
+  boost::mutex _idleMutex;
+  boost::condition_variable _workAdded;
+  boost::condition_variable _allDone;
+  boost::atomic<unsigned int> _numQueued;
+  boost::atomic<unsigned int> _numExecuting;
+  boost::atomic<unsigned int> _numIdle;
+  boost::atomic<unsigned int> _nextWorker;
+  boost::atomic<unsigned long> _nextTaskId;
+  boost::atomic<unsigned long> _sleep;
+  boost::atomic<bool> _runThreads;
+  boost::atomic<bool> _started;
+  LogPtr _log;
+  const std::string _name;
+};
+
+
+} // namespace Threads
+} // namespace Usul
+
+
+#endif // _USUL_THREADS_WORK_STEALING_POOL_CLASS_H_
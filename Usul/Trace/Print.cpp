@@ -183,6 +183,18 @@ void Print::stream ( std::ostream *s )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the stream to print to.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::ostream *Print::stream()
+{
+  return Detail::_stream;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Add a filter. With no filters everything gets through.
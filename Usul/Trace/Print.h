@@ -50,8 +50,9 @@ struct USUL_EXPORT Print
   // This function is not thread safe! It's best to call it at startup.
   static void printing ( bool );
 
-  // Initialize the stream.
+  // Set/get the stream. Nothing is printed when it is null.
   static void stream ( std::ostream * );
+  static std::ostream *stream();
 };
 
 
@@ -0,0 +1,508 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records timed events in binary, for looking at later.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Trace/Recorder.h"
+#include "Usul/System/Process.h"
+#include "Usul/Threads/ThreadId.h"
+
+#include "boost/atomic.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include "windows.h"
+#else
+# include <sys/time.h>
+# include <time.h>
+#endif
+
+using namespace Usul::Trace;
+
+typedef Recorder::Uint32 Uint32;
+typedef Recorder::Uint64 Uint64;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The ring buffer of one thread. Only the thread that owns the buffer
+//  writes to it. The count only grows, and it is stored after the event is
+//  written, so a reader knows which events are complete.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct Buffer
+  {
+    Buffer() : events(), mask ( 0 ), count ( 0 ), thread ( 0 ), inUse ( false ){}
+    Recorder::Events events;
+    Uint64 mask;
+    boost::atomic<Uint64> count;
+    Uint32 thread;
+    bool inUse;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Everything shared. Made once and never deleted, because threads may
+//  still record while the program is exiting.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct Shared
+  {
+    typedef std::vector < Buffer * > Buffers;
+    typedef std::map < std::string, Uint32 > NameMap;
+    typedef std::vector < std::string > Names;
+    typedef std::vector < unsigned long > Threads;
+
+    Shared() : mutex(), buffers(), names(), nameMap(), threads(), capacity ( 65536 ){}
+
+    boost::mutex mutex;
+    Buffers buffers;
+    Names names;
+    NameMap nameMap;
+    Threads threads;
+    unsigned int capacity;
+  };
+
+  Shared &shared()
+  {
+    static Shared *s ( new Shared );
+    return *s;
+  }
+
+  // Make it before there are threads.
+  Shared &sharedAtStartup ( shared() );
+
+  boost::atomic<bool> recording ( false );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Gives the buffer back when the thread ends. The events stay in it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct Owner
+  {
+    explicit Owner ( Buffer *b ) : buffer ( b ){}
+    ~Owner()
+    {
+      boost::lock_guard<boost::mutex> lock ( shared().mutex );
+      buffer->inUse = false;
+    }
+    Buffer *buffer;
+  };
+
+  boost::thread_specific_ptr < Owner > owner;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the calling thread's buffer. The first time a thread records it
+//  takes a buffer that a finished thread gave back, or makes a new one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  Buffer &threadBuffer()
+  {
+    Owner *o ( owner.get() );
+    if ( 0x0 != o )
+    {
+      return *o->buffer;
+    }
+
+    Shared &s ( shared() );
+    Buffer *buffer ( 0x0 );
+    {
+      boost::lock_guard<boost::mutex> lock ( s.mutex );
+
+      for ( Shared::Buffers::iterator i = s.buffers.begin(); i != s.buffers.end(); ++i )
+      {
+        if ( false == (*i)->inUse )
+        {
+          buffer = *i;
+          break;
+        }
+      }
+
+      if ( 0x0 == buffer )
+      {
+        buffer = new Buffer;
+        s.buffers.push_back ( buffer );
+      }
+
+      // Nobody writes to a buffer that isn't in use, so it can be resized.
+      if ( buffer->events.size() != s.capacity )
+      {
+        buffer->events.assign ( s.capacity, Recorder::Event() );
+        buffer->mask = s.capacity - 1;
+        buffer->count = 0;
+      }
+
+      // Events that the last thread left keep their own thread number.
+      buffer->thread = static_cast < Uint32 > ( s.threads.size() );
+      buffer->inUse = true;
+      s.threads.push_back ( Usul::Threads::currentThreadId() );
+    }
+
+    owner.reset ( new Owner ( buffer ) );
+    return *buffer;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the number of events per thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::capacity ( unsigned int value )
+{
+  unsigned int power ( 1 );
+  while ( ( power < value ) && ( power < 0x80000000 ) )
+  {
+    power <<= 1;
+  }
+
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+  s.capacity = power;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the number of events per thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Recorder::capacity()
+{
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+  return s.capacity;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Drop all recorded events.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::clear()
+{
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+  for ( Shared::Buffers::iterator i = s.buffers.begin(); i != s.buffers.end(); ++i )
+  {
+    (*i)->count = 0;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the recording state.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::enabled ( bool state )
+{
+  recording.store ( state, boost::memory_order_release );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the recording state.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Recorder::enabled()
+{
+  return recording.load ( boost::memory_order_relaxed );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy the events. The owners keep writing while we copy, so after the
+//  copy we drop the ones that may have been written over.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::events ( Events &answer )
+{
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+
+  for ( Shared::Buffers::const_iterator i = s.buffers.begin(); i != s.buffers.end(); ++i )
+  {
+    const Buffer &buffer ( **i );
+    const Uint64 capacity ( buffer.events.size() );
+    if ( 0 == capacity )
+      continue;
+
+    const Uint64 end ( buffer.count.load ( boost::memory_order_acquire ) );
+    const Uint64 begin ( ( end > capacity ) ? ( end - capacity ) : 0 );
+
+    Events copy;
+    copy.reserve ( static_cast < Events::size_type > ( end - begin ) );
+    for ( Uint64 j = begin; j < end; ++j )
+    {
+      copy.push_back ( buffer.events[j & buffer.mask] );
+    }
+
+    // If the thread is still going, the event after the last one we saw 
+    // may be half written, over the oldest one that is left.
+    const Uint64 after ( buffer.count.load ( boost::memory_order_acquire ) + ( ( true == buffer.inUse ) ? 1 : 0 ) );
+    const Uint64 valid ( ( after > capacity ) ? ( after - capacity ) : 0 );
+    const Uint64 skip ( ( valid > begin ) ? std::min ( valid - begin, end - begin ) : 0 );
+
+    answer.insert ( answer.end(), copy.begin() + static_cast < Events::difference_type > ( skip ), copy.end() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number for the name, adding it if needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 Recorder::intern ( const std::string &name )
+{
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+
+  Shared::NameMap::const_iterator i ( s.nameMap.find ( name ) );
+  if ( s.nameMap.end() != i )
+  {
+    return i->second;
+  }
+
+  const Uint32 id ( static_cast < Uint32 > ( s.names.size() ) );
+  s.names.push_back ( name );
+  s.nameMap.insert ( Shared::NameMap::value_type ( name, id ) );
+  return id;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number for the name, adding it if needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Uint32 Recorder::intern ( const char *name )
+{
+  return Recorder::intern ( std::string ( ( 0x0 == name ) ? "" : name ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the name for the number.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string Recorder::name ( Uint32 id )
+{
+  Shared &s ( shared() );
+  boost::lock_guard<boost::mutex> lock ( s.mutex );
+  return ( ( id < s.names.size() ) ? s.names[id] : std::string() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Microseconds from a fixed point in the past. Unlike the time of day,
+//  this clock does not jump.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Uint64 Recorder::now()
+{
+#ifdef _WIN32
+  static LARGE_INTEGER frequency = { 0 };
+  if ( 0 == frequency.QuadPart )
+  {
+    ::QueryPerformanceFrequency ( &frequency );
+  }
+  LARGE_INTEGER count;
+  ::QueryPerformanceCounter ( &count );
+  return static_cast < Uint64 > ( count.QuadPart / ( frequency.QuadPart / 1000000.0 ) );
+#elif defined ( __APPLE__ )
+  struct timeval t;
+  ::gettimeofday ( &t, 0x0 );
+  return static_cast < Uint64 > ( t.tv_sec ) * 1000000 + t.tv_usec;
+#else
+  struct timespec t;
+  ::clock_gettime ( CLOCK_MONOTONIC, &t );
+  return static_cast < Uint64 > ( t.tv_sec ) * 1000000 + t.tv_nsec / 1000;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add an event for the calling thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::record ( Uint32 name, Uint64 start, Uint64 end )
+{
+  Buffer &buffer ( threadBuffer() );
+
+  const Uint64 count ( buffer.count.load ( boost::memory_order_relaxed ) );
+  Event &event ( buffer.events[count & buffer.mask] );
+  event.start = start;
+  event.duration = ( ( end > start ) ? ( end - start ) : 0 );
+  event.name = name;
+  event.thread = buffer.thread;
+
+  buffer.count.store ( count + 1, boost::memory_order_release );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the string as a JSON string.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  void writeString ( std::ostream &out, const std::string &s )
+  {
+    const char *hex ( "0123456789abcdef" );
+    out << '"';
+    for ( std::string::const_iterator i = s.begin(); i != s.end(); ++i )
+    {
+      const unsigned char c ( static_cast < unsigned char > ( *i ) );
+      if ( ( '"' == c ) || ( '\\' == c ) )
+      {
+        out << '\\' << c;
+      }
+      else if ( c < 0x20 )
+      {
+        out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+      }
+      else
+      {
+        out << c;
+      }
+    }
+    out << '"';
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the events as Chrome trace JSON. Times are from the first event.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::write ( std::ostream &out )
+{
+  Events events;
+  Recorder::events ( events );
+
+  Shared::Names names;
+  Shared::Threads threads;
+  {
+    Shared &s ( shared() );
+    boost::lock_guard<boost::mutex> lock ( s.mutex );
+    names = s.names;
+    threads = s.threads;
+  }
+
+  Uint64 first ( 0 );
+  for ( Events::const_iterator i = events.begin(); i != events.end(); ++i )
+  {
+    first = ( ( events.begin() == i ) ? i->start : std::min ( first, i->start ) );
+  }
+
+  const unsigned long pid ( static_cast < unsigned long > ( Usul::System::Process::currentProcessId() ) );
+  const std::string separator ( ",\n" );
+  std::string comma;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  for ( unsigned int i = 0; i < threads.size(); ++i )
+  {
+    out << comma << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << i
+        << ",\"args\":{\"name\":\"Thread " << threads[i] << "\"}}";
+    comma = separator;
+  }
+
+  for ( Events::const_iterator i = events.begin(); i != events.end(); ++i )
+  {
+    out << comma << "{\"name\":";
+    writeString ( out, ( ( i->name < names.size() ) ? names[i->name] : std::string() ) );
+    out << ",\"cat\":\"usul\",\"ph\":\"X\",\"ts\":" << ( i->start - first ) << ",\"dur\":" << i->duration
+        << ",\"pid\":" << pid << ",\"tid\":" << i->thread << '}';
+    comma = separator;
+  }
+
+  out << "\n]}\n";
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the events as Chrome trace JSON.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Recorder::write ( const std::string &file )
+{
+  std::ofstream out ( file.c_str() );
+  if ( false == out.is_open() )
+  {
+    throw std::runtime_error ( "Error 3386147205: Failed to open trace file for writing: " + file );
+  }
+
+  Recorder::write ( out );
+}
@@ -0,0 +1,132 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2007, Arizona State University
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//  Author: Perry L Miller IV
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records timed events in binary, for looking at later.
+//
+//  Every thread writes its events into its own ring buffer, so recording
+//  takes no lock and never waits. When a buffer is full the oldest events
+//  are written over. Scope names are interned once and events only hold
+//  the number. The events are written as Chrome "trace_event" JSON, which
+//  chrome://tracing and other viewers read.
+//
+//  Recording is off until enabled. When it is off, a recorded scope costs
+//  one check of a flag.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_TRACE_RECORDER_H_
+#define _USUL_TRACE_RECORDER_H_
+
+#include "Usul/Export/Export.h"
+#include "Usul/Types/Types.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace Usul {
+namespace Trace {
+
+
+struct USUL_EXPORT Recorder
+{
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 Uint64;
+
+  // What is written for every scope. Times are in microseconds.
+  struct Event
+  {
+    Uint64 start;
+    Uint64 duration;
+    Uint32 name;
+    Uint32 thread;
+  };
+  typedef std::vector < Event > Events;
+
+  // Records the time between construction and destruction.
+  class Scope
+  {
+  public:
+
+    explicit Scope ( Uint32 name ) : _name ( name ), _start ( ( true == Recorder::enabled() ) ? Recorder::now() : 0 )
+    {
+    }
+
+    ~Scope()
+    {
+      if ( 0 != _start )
+      {
+        Recorder::record ( _name, _start, Recorder::now() );
+      }
+    }
+
+  private:
+
+    Scope ( const Scope & );
+    Scope &operator = ( const Scope & );
+
+    const Uint32 _name;
+    const Uint64 _start;
+  };
+
+  // Set/get the number of events each thread keeps. It is rounded up to a
+  // power of two, and applies to buffers made after it is set.
+  static void               capacity ( unsigned int );
+  static unsigned int       capacity();
+
+  // Drop all recorded events. Call when no other thread is recording.
+  static void               clear();
+
+  // Set/get the recording state. The default is false.
+  static void               enabled ( bool );
+  static bool               enabled();
+
+  // Copy the recorded events, oldest first for each thread.
+  static void               events ( Events & );
+
+  // Return the number for the name, adding it if needed.
+  static Uint32             intern ( const char * );
+  static Uint32             intern ( const std::string & );
+
+  // Return the name for the number.
+  static std::string        name ( Uint32 );
+
+  // Microseconds from a fixed point in the past.
+  static Uint64             now();
+
+  // Add an event for the calling thread.
+  static void               record ( Uint32 name, Uint64 start, Uint64 end );
+
+  // Write the events as Chrome trace JSON.
+  static void               write ( std::ostream & );
+  static void               write ( const std::string &file );
+};
+
+
+}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Record the time spent in the enclosing scope. The name is interned the
+//  first time through. Use at most once per scope.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define USUL_TRACE_EVENT(name)\
+  static const Usul::Types::Uint32 trace_event_name ( Usul::Trace::Recorder::intern ( name ) );\
+  Usul::Trace::Recorder::Scope trace_event ( trace_event_name )
+
+
+#endif // _USUL_TRACE_RECORDER_H_
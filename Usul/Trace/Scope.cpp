@@ -16,6 +16,7 @@
 
 #include "Usul/Trace/Scope.h"
 #include "Usul/Trace/Print.h"
+#include "Usul/Trace/Recorder.h"
 #include "Usul/System/Clock.h"
 #include "Usul/Threads/ThreadId.h"
 
@@ -32,10 +33,11 @@ using namespace Usul::Trace;
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Scope::Scope ( const void *object, const std::string &n ) : 
+Scope::Scope ( const void *object, Uint32 n ) : 
   _name   ( n ), 
   _object ( object ),
-  _thread ( Usul::Threads::currentThreadId() )
+  _thread ( Usul::Threads::currentThreadId() ),
+  _start  ( 0 )
 {
   this->_begin();
 }
@@ -47,10 +49,43 @@ Scope::Scope ( const void *object, const std::string &n ) :
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Scope::Scope ( const std::string &n ) : 
+Scope::Scope ( Uint32 n ) : 
   _name   ( n ), 
   _object ( 0x0 ),
-  _thread ( Usul::Threads::currentThreadId() )
+  _thread ( Usul::Threads::currentThreadId() ),
+  _start  ( 0 )
+{
+  this->_begin();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Scope::Scope ( const void *object, const std::string &n ) : 
+  _name   ( Usul::Trace::Recorder::intern ( n ) ), 
+  _object ( object ),
+  _thread ( Usul::Threads::currentThreadId() ),
+  _start  ( 0 )
+{
+  this->_begin();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Scope::Scope ( const std::string &n ) : 
+  _name   ( Usul::Trace::Recorder::intern ( n ) ), 
+  _object ( 0x0 ),
+  _thread ( Usul::Threads::currentThreadId() ),
+  _start  ( 0 )
 {
   this->_begin();
 }
@@ -79,27 +114,45 @@ Scope::~Scope()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Print the beginning of a scope.
+//  Start the event, and print the beginning of a scope if there is a 
+//  stream. Formatting the text is the slow part, so skip it when there's 
+//  nowhere to print it.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Scope::_begin() const
+void Scope::_begin()
 {
-  std::ostringstream out;
-  out << "Begin, " << SET_WIDTH << _thread << ", " << SET_WIDTH << Usul::System::Clock::milliseconds() << ", " << _object << ", " << _name << '\n';
-  Usul::Trace::Print::execute ( out.str() );
+  if ( true == Usul::Trace::Recorder::enabled() )
+  {
+    _start = Usul::Trace::Recorder::now();
+  }
+
+  if ( 0x0 != Usul::Trace::Print::stream() )
+  {
+    std::ostringstream out;
+    out << "Begin, " << SET_WIDTH << _thread << ", " << SET_WIDTH << Usul::System::Clock::milliseconds() << ", " << _object << ", " << Usul::Trace::Recorder::name ( _name ) << '\n';
+    Usul::Trace::Print::execute ( out.str() );
+  }
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Print the end of a scope.
+//  Record the event, and print the end of a scope if there is a stream.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void Scope::_end() const
 {
-  std::ostringstream out;
-  out << "  End, " << SET_WIDTH << _thread << ", " << SET_WIDTH << Usul::System::Clock::milliseconds() << ", " << _object << ", " << _name << '\n';
-  Usul::Trace::Print::execute ( out.str() );
+  if ( 0 != _start )
+  {
+    Usul::Trace::Recorder::record ( _name, _start, Usul::Trace::Recorder::now() );
+  }
+
+  if ( 0x0 != Usul::Trace::Print::stream() )
+  {
+    std::ostringstream out;
+    out << "  End, " << SET_WIDTH << _thread << ", " << SET_WIDTH << Usul::System::Clock::milliseconds() << ", " << _object << ", " << Usul::Trace::Recorder::name ( _name ) << '\n';
+    Usul::Trace::Print::execute ( out.str() );
+  }
 }
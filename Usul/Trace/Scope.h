@@ -18,6 +18,7 @@
 #define _USUL_DEBUG_TRACE_SCOPE_H_
 
 #include "Usul/Export/Export.h"
+#include "Usul/Types/Types.h"
 
 #include <string>
 
@@ -30,18 +31,28 @@ class USUL_EXPORT Scope
 {
 public:
 
+  typedef Usul::Types::Uint32 Uint32;
+  typedef Usul::Types::Uint64 Uint64;
+
+  // The name is a number from Recorder::intern().
+  Scope ( const void *object, Uint32 name );
+  Scope ( Uint32 name );
+
+  // These intern the name every time.
   Scope ( const void *object, const std::string &name );
   Scope ( const std::string &name );
+
   ~Scope();
 
 private:
 
-  void              _begin() const;
+  void              _begin();
   void              _end() const;
 
-  std::string _name;
+  Uint32 _name;
   const void *_object;
   unsigned long _thread;
+  Uint64 _start;
 };
 
 
@@ -19,9 +19,23 @@
 
 #include "Usul/Strings/Format.h"
 #include "Usul/Trace/Print.h"
+#include "Usul/Trace/Recorder.h"
 #include "Usul/Trace/Scope.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Name of the current function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#define __USUL_FUNCTION__ __FUNCTION__
+#else
+#define __USUL_FUNCTION__ __PRETTY_FUNCTION__
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Define macros for tracing.
@@ -60,17 +74,14 @@
 #define USUL_TRACE_10(exp1,exp2,exp3,exp4,exp5,exp6,exp7,exp8,exp9,exp10)\
   Usul::Trace::Print::execute ( Usul::Strings::format ( exp1, exp2, exp3, exp4, exp5, exp6, exp7, exp8, exp9, exp10 ) )
 
-#ifdef _MSC_VER
-#define __USUL_FUNCTION__ __FUNCTION__
-#else
-#define __USUL_FUNCTION__ __PRETTY_FUNCTION__
-#endif
-
+// The function's name is interned the first time through.
 #define USUL_TRACE_SCOPE\
-  Usul::Trace::Scope trace_scope ( this, __USUL_FUNCTION__ )
+  static const Usul::Types::Uint32 trace_scope_name ( Usul::Trace::Recorder::intern ( __USUL_FUNCTION__ ) );\
+  Usul::Trace::Scope trace_scope ( this, trace_scope_name )
 
 #define USUL_TRACE_SCOPE_STATIC\
-  Usul::Trace::Scope trace_scope ( __USUL_FUNCTION__ )
+  static const Usul::Types::Uint32 trace_scope_name ( Usul::Trace::Recorder::intern ( __USUL_FUNCTION__ ) );\
+  Usul::Trace::Scope trace_scope ( trace_scope_name )
 
 #else
 
@@ -0,0 +1,142 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The attributes of a node.
+//
+//  Nodes have few attributes, so they are kept in one vector sorted by name
+//  rather than a map with an allocation per attribute. The interface is the
+//  part of std::map that is used with nodes, and iterating visits the
+//  attributes in the same order as the map did.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _XML_TREE_ATTRIBUTES_H_
+#define _XML_TREE_ATTRIBUTES_H_
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace XmlTree {
+
+
+class Attributes
+{
+public:
+
+  // Typedefs.
+  typedef std::string key_type;
+  typedef std::string mapped_type;
+  typedef std::pair < std::string, std::string > value_type;
+  typedef std::vector < value_type > Values;
+  typedef Values::iterator iterator;
+  typedef Values::const_iterator const_iterator;
+  typedef Values::size_type size_type;
+  typedef std::map < std::string, std::string > Map;
+
+  // Construction.
+  Attributes() : _values()
+  {
+  }
+  Attributes ( const Map &m ) : _values ( m.begin(), m.end() )
+  {
+  }
+
+  // Make a map of the attributes.
+  operator Map() const
+  {
+    return Map ( _values.begin(), _values.end() );
+  }
+
+  // Iterators to the attributes, sorted by name.
+  iterator                begin()       { return _values.begin(); }
+  const_iterator          begin() const { return _values.begin(); }
+  iterator                end()       { return _values.end(); }
+  const_iterator          end() const { return _values.end(); }
+
+  // Remove all attributes.
+  void                    clear() { _values.clear(); }
+
+  // Return the number of attributes with the name, which is zero or one.
+  size_type               count ( const std::string &name ) const
+  {
+    return ( ( this->end() == this->find ( name ) ) ? 0 : 1 );
+  }
+
+  // Is it empty?
+  bool                    empty() const { return _values.empty(); }
+
+  // Remove the attribute. Returns the number removed.
+  size_type               erase ( const std::string &name )
+  {
+    iterator i ( this->find ( name ) );
+    if ( this->end() == i )
+      return 0;
+    _values.erase ( i );
+    return 1;
+  }
+  void                    erase ( iterator i ) { _values.erase ( i ); }
+
+  // Find the attribute. Returns end() if it's not there.
+  iterator                find ( const std::string &name )
+  {
+    iterator i ( std::lower_bound ( _values.begin(), _values.end(), name, Attributes::_less ) );
+    return ( ( _values.end() != i && name == i->first ) ? i : _values.end() );
+  }
+  const_iterator          find ( const std::string &name ) const
+  {
+    const_iterator i ( std::lower_bound ( _values.begin(), _values.end(), name, Attributes::_less ) );
+    return ( ( _values.end() != i && name == i->first ) ? i : _values.end() );
+  }
+
+  // Add the attribute if it's not there. Returns where it is, and true if
+  // it was added.
+  std::pair < iterator, bool > insert ( const value_type &v )
+  {
+    iterator i ( std::lower_bound ( _values.begin(), _values.end(), v.first, Attributes::_less ) );
+    if ( _values.end() != i && v.first == i->first )
+      return std::make_pair ( i, false );
+    return std::make_pair ( _values.insert ( i, v ), true );
+  }
+
+  // Return the number of attributes.
+  size_type               size() const { return _values.size(); }
+
+  // Swap the attributes.
+  void                    swap ( Attributes &a ) { _values.swap ( a._values ); }
+
+  // Get the value, adding the attribute if needed.
+  std::string &           operator [] ( const std::string &name )
+  {
+    iterator i ( std::lower_bound ( _values.begin(), _values.end(), name, Attributes::_less ) );
+    if ( _values.end() == i || name != i->first )
+      i = _values.insert ( i, value_type ( name, std::string() ) );
+    return i->second;
+  }
+
+private:
+
+  static bool             _less ( const value_type &v, const std::string &name )
+  {
+    return ( v.first < name );
+  }
+
+  Values _values;
+};
+
+
+} // namespace XmlTree
+
+
+#endif // _XML_TREE_ATTRIBUTES_H_
@@ -0,0 +1,141 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Memory for nodes and their names.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "XmlTree/Detail/NodeStore.h"
+
+#include <new>
+
+using namespace XmlTree::Detail;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+NodeStore::NodeStore() :
+  _arena ( new Arena ),
+  _names(),
+  _mutex(),
+  _objects ( 0 ),
+  _generation ( 1 ),
+  _threadNames()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get memory for an object. Objects too big for the arena use the heap.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void *NodeStore::allocate ( std::size_t size )
+{
+  void *memory ( ( size <= Arena::MAX_SIZE ) ? _arena->malloc ( size ) : ::operator new ( size ) );
+
+  // Counted before the object looks up its name. See release().
+  ++_objects;
+
+  return memory;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the memory.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeStore::deallocate ( void *memory, std::size_t size )
+{
+  if ( 0x0 == memory )
+    return;
+
+  if ( size <= Arena::MAX_SIZE )
+    Arena::free ( memory );
+  else
+    ::operator delete ( memory );
+
+  if ( 0 == --_objects )
+    this->_release();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the shared copy of the name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const std::string &NodeStore::intern ( const std::string &name )
+{
+  ThreadNames *mine ( _threadNames.get() );
+  if ( 0x0 == mine )
+  {
+    mine = new ThreadNames;
+    _threadNames.reset ( mine );
+  }
+
+  // Forget the names from before the last release.
+  const unsigned long generation ( _generation );
+  if ( generation != mine->generation )
+  {
+    mine->names.clear();
+    mine->generation = generation;
+  }
+
+  ThreadNames::Map::const_iterator i ( mine->names.find ( name ) );
+  if ( mine->names.end() != i )
+    return *( i->second );
+
+  const std::string *shared ( 0x0 );
+  {
+    Guard guard ( _mutex );
+    shared = &( *( _names.insert ( name ).first ) );
+  }
+
+  mine->names.insert ( ThreadNames::Map::value_type ( name, shared ) );
+  return *shared;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Free the names if there are no objects.
+//
+//  The generation changes before the objects are counted. An object is 
+//  counted before it reads the generation. So if a thread read the old 
+//  generation, its object is counted here and the names stay. Another 
+//  thread may have made a node since the count went to zero, so it has 
+//  to be checked again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeStore::_release()
+{
+  Guard guard ( _mutex );
+
+  // Nothing to free, and nothing any thread remembers.
+  if ( true == _names.empty() )
+    return;
+
+  ++_generation;
+  if ( 0 != _objects )
+    return;
+
+  Names().swap ( _names );
+}
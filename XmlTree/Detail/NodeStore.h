@@ -0,0 +1,99 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Memory for nodes and their names.
+//
+//  Nodes are placed in an arena, so a document's nodes sit together in a 
+//  few chunks and freed nodes are reused by the next document. Names are 
+//  interned, so every node with the same name shares one string.
+//
+//  Each thread remembers the names it has looked up, so only the first 
+//  lookup of a name in a thread takes the lock. The names are freed when 
+//  the last node is returned. That starts a new generation, and a thread 
+//  drops what it remembers when it sees the generation change.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _XML_TREE_NODE_STORE_H_
+#define _XML_TREE_NODE_STORE_H_
+
+#include "Usul/Memory/Arena.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+
+#include "boost/atomic.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+
+
+namespace XmlTree {
+namespace Detail {
+
+
+class NodeStore
+{
+public:
+
+  // Typedefs.
+  typedef Usul::Memory::Arena Arena;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+
+  // Construction.
+  NodeStore();
+
+  // Get memory for an object. Throws if out of memory.
+  void *                              allocate ( std::size_t size );
+
+  // Return the memory. The size is what was passed to allocate(). The 
+  // last one frees the names.
+  void                                deallocate ( void *, std::size_t size );
+
+  // Return the shared copy of the name.
+  const std::string &                 intern ( const std::string & );
+
+private:
+
+  // Do not copy.
+  NodeStore ( const NodeStore & );
+  NodeStore &operator = ( const NodeStore & );
+
+  typedef std::set < std::string > Names;
+
+  void                                _release();
+
+  // The names one thread has looked up.
+  struct ThreadNames
+  {
+    typedef std::map < std::string, const std::string * > Map;
+    ThreadNames() : generation ( 0 ), names(){}
+    unsigned long generation;
+    Map names;
+  };
+
+  Arena::RefPtr _arena;
+  Names _names;
+  Mutex _mutex;
+  boost::atomic<unsigned long> _objects;
+  boost::atomic<unsigned long> _generation;
+  boost::thread_specific_ptr < ThreadNames > _threadNames;
+};
+
+
+} // namespace Detail
+} // namespace XmlTree
+
+
+#endif // _XML_TREE_NODE_STORE_H_
@@ -16,6 +16,7 @@
 #include "XmlTree/Loader.h"
 #include "XmlTree/Functions.h"
 #include "XmlTree/Document.h"
+#include "XmlTree/StreamHandler.h"
 #include "XmlTree/XercesLife.h"
 #include "XmlTree/XercesString.h"
 
@@ -26,6 +27,12 @@
 #include "xercesc/dom/DOM.hpp"
 #include "xercesc/dom/DOMNodeList.hpp"
 #include "xercesc/parsers/XercesDOMParser.hpp"
+#include "xercesc/sax/SAXParseException.hpp"
+#include "xercesc/sax2/Attributes.hpp"
+#include "xercesc/sax2/DefaultHandler.hpp"
+#include "xercesc/sax2/SAX2XMLReader.hpp"
+#include "xercesc/sax2/XMLReaderFactory.hpp"
+#include "xercesc/util/XMLUni.hpp"
 #include "xercesc/util/OutOfMemoryException.hpp"
 #include "xercesc/framework/LocalFileInputSource.hpp"
 #include "xercesc/framework/MemBufInputSource.hpp"
@@ -34,6 +41,7 @@
 #include <memory>
 #include <iostream>
 #include <iterator>
+#include <vector>
 
 using namespace XmlTree;
 
@@ -340,3 +348,182 @@ void Loader::loadFromMemory ( const std::string& buffer, Document *doc ) const
   // Populate the XmlTree::Document from the loaded xercesc document.
   Helper::loadFromXercesDocument ( dom.get(), doc );
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Turns the SAX events into the handler's calls, and builds the sub-trees
+//  it asks for. Names are the qualified names, like the DOM gives.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  class StreamAdapter : public xercesc::DefaultHandler
+  {
+  public:
+
+    typedef xercesc::DefaultHandler BaseClass;
+    typedef XmlTree::StreamHandler::Attributes Attributes;
+    typedef std::vector < XmlTree::Node::RefPtr > Nodes;
+
+    StreamAdapter ( XmlTree::StreamHandler &handler ) : BaseClass(),
+      _handler ( handler ),
+      _depth ( 0 ),
+      _text(),
+      _nodes()
+    {
+    }
+
+    virtual void startElement ( const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname, const xercesc::Attributes &attributes )
+    {
+      this->_flush();
+      ++_depth;
+
+      const std::string name ( XmlTree::toNative ( qname ) );
+
+      Attributes a;
+      const XMLSize_t num ( attributes.getLength() );
+      for ( XMLSize_t i = 0; i < num; ++i )
+      {
+        a[XmlTree::toNative ( attributes.getQName ( i ) )] = XmlTree::toNative ( attributes.getValue ( i ) );
+      }
+
+      // Inside a sub-tree, or starting one?
+      if ( ( false == _nodes.empty() ) || ( true == _handler.startElement ( name, a, _depth ) ) )
+      {
+        XmlTree::Node::RefPtr node ( new XmlTree::Node ( name ) );
+        node->attributes().swap ( a );
+        if ( false == _nodes.empty() )
+          _nodes.back()->children().push_back ( XmlTree::Node::ValidRefPtr ( node.get() ) );
+        _nodes.push_back ( node );
+      }
+    }
+
+    virtual void characters ( const XMLCh* const chars, const XMLSize_t length )
+    {
+      _text.append ( chars, length );
+    }
+
+    virtual void endElement ( const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname )
+    {
+      this->_flush();
+
+      if ( false == _nodes.empty() )
+      {
+        XmlTree::Node::RefPtr node ( _nodes.back() );
+        _nodes.pop_back();
+        if ( true == _nodes.empty() )
+          _handler.subTree ( *node, _depth );
+      }
+      else
+      {
+        _handler.endElement ( XmlTree::toNative ( qname ), _depth );
+      }
+
+      --_depth;
+    }
+
+  private:
+
+    // Give the text so far to the current element. Like the DOM loader, 
+    // text that is only white space is ignored.
+    void _flush()
+    {
+      if ( true == _text.empty() )
+        return;
+
+      const std::string v ( XmlTree::toNative ( _text ) );
+      _text.clear();
+
+      if ( false == XmlTree::Functions::hasContent ( v ) )
+        return;
+
+      if ( false == _nodes.empty() )
+        _nodes.back()->value ( v );
+      else
+        _handler.text ( v, _depth );
+    }
+
+    XmlTree::StreamHandler &_handler;
+    unsigned int _depth;
+    XmlTree::XercesString _text;
+    Nodes _nodes;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper function to stream the input to the handler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  void parse ( xercesc::InputSource& input, XmlTree::StreamHandler &handler, const std::string &name )
+  {
+    // Exceptions from the handler go through as they are.
+    try
+    {
+      std::auto_ptr<xercesc::SAX2XMLReader> reader ( xercesc::XMLReaderFactory::createXMLReader() );
+      reader->setFeature ( xercesc::XMLUni::fgSAX2CoreNameSpaces, false );
+      reader->setFeature ( xercesc::XMLUni::fgSAX2CoreValidation, false );
+
+      Helper::StreamAdapter adapter ( handler );
+      reader->setContentHandler ( &adapter );
+      reader->setErrorHandler ( &adapter );
+
+      reader->parse ( input );
+    }
+    catch ( const xercesc::OutOfMemoryException & )
+    {
+      Usul::Exceptions::Thrower<std::runtime_error> 
+        ( "Error 3170521634: Ran out of memory while parsing XML: ", name );
+    }
+    catch ( const xercesc::SAXParseException &e )
+    {
+      Usul::Exceptions::Thrower<std::runtime_error> 
+        ( "Error 2358704917: Failed to parse XML '", name, "' at line ", e.getLineNumber(), ", ", XmlTree::Functions::translate ( e.getMessage() ) );
+    }
+    catch ( const xercesc::XMLException &e )
+    {
+      Usul::Exceptions::Thrower<std::runtime_error> 
+        ( "Error 1043967528: Failed to parse XML '", name, "', ", XmlTree::Functions::translate ( e.getMessage() ) );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the file and give its elements to the handler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Loader::parse ( const std::string &file, StreamHandler &handler ) const
+{
+  // A file that does not exist is an error.
+  if ( false == Usul::Predicates::FileExists::test ( file ) )
+    Usul::Exceptions::Thrower<std::runtime_error> ( "Error 2907114853: Given file does not exist: ", file );
+
+  // Empty files are ok.
+  if ( 0 == Usul::File::size ( file ) )
+    return;
+
+  xercesc::LocalFileInputSource input ( XmlTree::fromNative ( file ).c_str() );
+  Helper::parse ( input, handler, file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the buffer and give its elements to the handler.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Loader::parseFromMemory ( const std::string& buffer, StreamHandler &handler ) const
+{
+  xercesc::MemBufInputSource input ( (const XMLByte*) buffer.c_str(), buffer.length(), "xml in memory parse", false  );
+  Helper::parse ( input, handler, "xml in memory parse" );
+}
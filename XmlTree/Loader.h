@@ -24,6 +24,7 @@
 namespace XmlTree {
 
 class Document;
+class StreamHandler;
 
 class XML_TREE_EXPORT Loader
 {
@@ -39,6 +40,11 @@ public:
 
   // Load from a file already loaded in memory.
   void loadFromMemory ( const std::string& buffer, Document * ) const;
+
+  // Read the file and give its elements to the handler, without building
+  // the document.
+  void parse ( const std::string &file, StreamHandler & ) const;
+  void parseFromMemory ( const std::string& buffer, StreamHandler & ) const;
 };
 
 
@@ -14,6 +14,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "XmlTree/Node.h"
+#include "XmlTree/Detail/NodeStore.h"
 
 #include "Usul/Math/MinMax.h"
 #include "Usul/Strings/Format.h"
@@ -28,6 +29,26 @@ using namespace XmlTree;
 USUL_IMPLEMENT_TYPE_ID ( Node );
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The store for all nodes. It is never deleted because nodes may be 
+//  released while static objects are destroyed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  XmlTree::Detail::NodeStore &store()
+  {
+    static XmlTree::Detail::NodeStore *store ( new XmlTree::Detail::NodeStore );
+    return *store;
+  }
+
+  // Make the store before there are threads.
+  XmlTree::Detail::NodeStore &initStore ( Helper::store() );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor.
@@ -35,7 +56,7 @@ USUL_IMPLEMENT_TYPE_ID ( Node );
 ///////////////////////////////////////////////////////////////////////////////
 
 Node::Node ( const std::string &name, const std::string &value ) : BaseClass(),
-  _name       ( name  ),
+  _name       ( Node::_intern ( name ) ),
   _value      ( value ),
   _attributes (),
   _children   ()
@@ -76,7 +97,43 @@ void Node::clear()
 
 void Node::name ( const std::string &n )
 {
-  _name = n;
+  _name = Node::_intern ( n );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the shared copy of the name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const std::string *Node::_intern ( const std::string &name )
+{
+  return &( Helper::store().intern ( name ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Allocate from the store.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void *Node::operator new ( std::size_t size )
+{
+  return Helper::store().allocate ( size );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the memory.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Node::operator delete ( void *p, std::size_t size )
+{
+  Helper::store().deallocate ( p, size );
 }
 
 
@@ -373,10 +430,12 @@ Node::RefPtr Node::child ( const std::string &name, bool createIfNeeded )
 
 Node::RefPtr Node::child ( const std::string &name ) const
 {
-  Children kids ( this->find ( name, false ) );
-  if ( false == kids.empty() )
+  for ( Children::const_iterator i = _children.begin(); i != _children.end(); ++i )
   {
-    return kids.front().get();
+    if ( name == (*i)->name() )
+    {
+      return Node::RefPtr ( const_cast < Node * > ( i->get() ) );
+    }
   }
 
   return 0x0;
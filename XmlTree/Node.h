@@ -17,13 +17,14 @@
 #define _XML_TREE_NODE_H_
 
 #include "XmlTree/Export.h"
+#include "XmlTree/Attributes.h"
 
 #include "Usul/Base/Referenced.h"
 #include "Usul/Convert/Convert.h"
 #include "Usul/Pointers/Pointers.h"
 
+#include <cstddef>
 #include <string>
-#include <map>
 #include <vector>
 
 
@@ -39,7 +40,7 @@ public:
 
   // Typedefs.
   typedef Usul::Base::Referenced BaseClass;
-  typedef std::map < std::string, std::string > Attributes;
+  typedef XmlTree::Attributes Attributes;
   typedef std::vector < Node::ValidRefPtr > Children;
 
   // Type id.
@@ -93,13 +94,18 @@ public:
   Children                findIf ( bool traverse, const Predicate& ) const;
 
   // Access the name.
-  const std::string &     name() const { return _name; }
+  const std::string &     name() const { return *_name; }
   void                    name ( const std::string &n );
 
   // Access the value.
   const std::string &     value() const { return _value; }
   void                    value ( const std::string &v );
 
+  // Nodes come from a shared store rather than one heap allocation each. 
+  // The names they share are freed when the last node is deleted.
+  static void *           operator new ( std::size_t );
+  static void             operator delete ( void *, std::size_t );
+
 protected:
 
   // Use reference counting.
@@ -107,13 +113,15 @@ protected:
 
   Node *                  _child ( unsigned int i, const std::string &name, bool createIfNeeded );
 
+  static const std::string *_intern ( const std::string &name );
+
 private:
 
   // Do not copy.
   Node ( const Node & );
   Node &operator = ( const Node & );
 
-  std::string _name;
+  const std::string *_name;
   std::string _value;
   Attributes _attributes;
   Children _children;
@@ -127,7 +135,7 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 template < class T > inline Node::Node ( const std::string &name, T value ) : BaseClass(),
-  _name       ( name ),
+  _name       ( Node::_intern ( name ) ),
   _value      ( Usul::Convert::Type<T,std::string>::convert ( value ) ),
   _attributes (),
   _children   ()
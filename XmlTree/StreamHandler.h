@@ -0,0 +1,72 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2005, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Receives the elements of an XML file as they are read.
+//
+//  Pass one to Loader::parse() to read a file without building a document.
+//  The depth of the root element is one. Text is only given when it has
+//  more than white space, and comes before the next element starts or ends.
+//
+//  If startElement() returns true, that element and everything in it is
+//  built as a node and given to subTree() instead of to the other
+//  functions. This builds the small pieces that are easier to read as
+//  nodes while the rest of the file streams by.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _XML_TREE_STREAM_HANDLER_H_
+#define _XML_TREE_STREAM_HANDLER_H_
+
+#include "XmlTree/Node.h"
+
+#include <string>
+
+namespace XmlTree {
+
+
+class StreamHandler
+{
+public:
+
+  // Typedefs.
+  typedef Node::Attributes Attributes;
+
+  virtual ~StreamHandler()
+  {
+  }
+
+  // An element started. Return true to get it as a node.
+  virtual bool            startElement ( const std::string &name, const Attributes &attributes, unsigned int depth )
+  {
+    return false;
+  }
+
+  // The text of the element at the given depth.
+  virtual void            text ( const std::string &value, unsigned int depth )
+  {
+  }
+
+  // An element ended.
+  virtual void            endElement ( const std::string &name, unsigned int depth )
+  {
+  }
+
+  // An element that startElement() asked for, with all that was in it.
+  virtual void            subTree ( Node &node, unsigned int depth )
+  {
+  }
+};
+
+
+} // namespace XmlTree
+
+
+#endif // _XML_TREE_STREAM_HANDLER_H_